@@ -10,19 +10,27 @@
 #include <sys/select.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <csignal>
 #include <cstdlib>  // for setenv
 #include <cstring>
 #include <ctime>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
+#include "ConsoleMonitors.h"
 #include "TelemetryClient.h"
 
 using namespace TelemetryAPI;
@@ -176,6 +184,9 @@ int main(int argc, char* argv[]) {
     bool locationOnly = false;      // Subscribe only to location data
     bool statusOnly = false;        // Subscribe only to status data
     bool debugMode = false;         // Enable debug output
+    bool dashboardMode = false;     // Redraw a per-UAV table instead of printing every packet
+    int dashboardFps = 10;          // Dashboard refresh rate
+    bool statsMode = false;         // Print per-topic statistics once a second instead of every packet
     bool interactiveMode = false;   // Enable interactive subscription management
     std::string target_uav;
 
@@ -193,6 +204,12 @@ int main(int argc, char* argv[]) {
             statusOnly = true;
         } else if (std::string(argv[i]) == "--debug") {
             debugMode = true;
+        } else if (std::string(argv[i]) == "--dashboard") {
+            dashboardMode = true;
+        } else if (std::string(argv[i]) == "--fps" && i + 1 < argc) {
+            dashboardFps = std::atoi(argv[++i]);
+        } else if (std::string(argv[i]) == "--stats") {
+            statsMode = true;
         } else if (std::string(argv[i]) == "--interactive") {
             interactiveMode = true;
         } else if (std::string(argv[i]) == "--help") {
@@ -205,6 +222,9 @@ int main(int argc, char* argv[]) {
             std::cout << "  --location-only    : Subscribe only to location data (telemetry.*.*.location)\n";
             std::cout << "  --status-only      : Subscribe only to status data (telemetry.*.*.status)\n";
             std::cout << "  --debug            : Enable debug output to see internal filtering\n";
+            std::cout << "  --dashboard        : Per-UAV table redrawn at a fixed rate, no per-packet output\n";
+            std::cout << "  --fps N            : Dashboard refresh rate, 1-60 (default: 10)\n";
+            std::cout << "  --stats            : Headless: per-topic rate, bytes/s, jitter, errors per second\n";
             std::cout << "  --interactive      : Enable interactive subscription management\n";
             std::cout << "  --help             : Show this help message\n";
             std::cout << "\nSubscription modes:\n";
@@ -228,7 +248,21 @@ int main(int argc, char* argv[]) {
     if (modeCount > 1) {
         std::cerr << "Error: --all-targets, --location-only, and --status-only are mutually exclusive\n";
         return 1;
-    }  // Validate protocol argument
+    }
+    if (dashboardMode && (enableSender || interactiveMode)) {
+        std::cerr << "Error: --dashboard cannot be combined with --send or --interactive\n";
+        return 1;
+    }
+    if (statsMode && (dashboardMode || interactiveMode)) {
+        std::cerr << "Error: --stats cannot be combined with --dashboard or --interactive\n";
+        return 1;
+    }
+    if (dashboardFps < 1 || dashboardFps > 60) {
+        std::cerr << "Error: --fps must be 1-60\n";
+        return 1;
+    }
+
+    // Validate protocol argument
     Protocol client_protocol;
     if (protocol == "tcp") {
         client_protocol = Protocol::TCP;
@@ -258,6 +292,12 @@ int main(int argc, char* argv[]) {
     if (debugMode) {
         std::cout << "Debug: Enabled (will show internal filtering messages)" << std::endl;
     }
+    if (dashboardMode) {
+        std::cout << "Display: dashboard at " << dashboardFps << " frames per second" << std::endl;
+    }
+    if (statsMode) {
+        std::cout << "Display: per-topic statistics once a second (no per-packet output)" << std::endl;
+    }
     std::cout << std::endl;
 
     // Enable debug mode if requested
@@ -265,13 +305,34 @@ int main(int argc, char* argv[]) {
         setenv("TELEMETRY_DEBUG", "1", 1);  // Set environment variable for library
     }
 
+    // The dashboard is created before the client, whose callbacks use it
+    std::unique_ptr<Dashboard> dashboard;
+    if (dashboardMode) {
+        dashboard = std::make_unique<Dashboard>(
+            "📸 Camera UI", dashboardFps,
+            std::vector<std::string>{"Idle", "Takeoff", "Mission", "Landing", "Emergency"});
+    }
+    Dashboard* board = dashboard.get();
+    std::unique_ptr<TopicStats> stats;
+    if (statsMode) {
+        stats = std::make_unique<TopicStats>();
+    }
+    TopicStats* counters = stats.get();
+
     // Create telemetry client
     TelemetryClient client("camera_ui");
 
     // Set up connection status callback
-    client.setConnectionCallback([](bool connected, const std::string& error_message) {
-        if (connected) {
-            std::cout << "✅ Connected to telemetry service" << std::endl;
+    client.setConnectionCallback([board](bool connected, const std::string& error_message) {
+        if (board) {
+            board->setNotice((connected ? "Connected to telemetry service " : "Disconnected from telemetry service ")
+                             + error_message);
+        } else if (connected) {
+            std::cout << "✅ Connected to telemetry service";
+            if (!error_message.empty()) {
+                std::cout << " - " << error_message;  // e.g. "Reconnected after 1200 ms"
+            }
+            std::cout << std::endl;
         } else {
             std::cout << "❌ Disconnected from telemetry service";
             if (!error_message.empty()) {
@@ -283,8 +344,17 @@ int main(int argc, char* argv[]) {
 
     // Set up telemetry data callback
     client.setTelemetryCallback(
-        [enableAllTargets, locationOnly, statusOnly](const std::string& topic, const std::vector<uint8_t>& data) {
+        [enableAllTargets, locationOnly, statusOnly, board, counters](const std::string& topic,
+                                                                      const std::vector<uint8_t>& data) {
             int count = g_packet_count.fetch_add(1) + 1;
+            if (counters) {
+                counters->record(topic, data.size(), !isDecodable(data));
+                return;
+            }
+            if (board) {
+                board->update(topic, data);
+                return;
+            }
 
             std::cout << std::endl;
             std::cout << "📡 [" << count << "] " << GetTimestamp() << " - " << topic << std::endl;
@@ -390,6 +460,9 @@ int main(int argc, char* argv[]) {
     }
     std::cout << "Press Ctrl+C to stop" << std::endl;
     std::cout << "===============================================" << std::endl;
+    if (dashboard) {
+        dashboard->start();
+    }
 
     // Start command sender thread if enabled
     std::thread senderThread;
@@ -427,7 +500,9 @@ int main(int argc, char* argv[]) {
                             // Check for subscription management commands
                             std::istringstream iss(line);
                             std::string command, topic;
-                            iss >> command >> topic;
+                            iss >> command;
+                            // Rest of the line: "?<filter>" suffixes may contain spaces
+                            std::getline(iss >> std::ws, topic);
 
                             if (command == "sub" && !topic.empty()) {
                                 if (client.subscribe(topic)) {
@@ -448,11 +523,24 @@ int main(int argc, char* argv[]) {
                                 std::cout << "📋 [" << GetTimestamp() << "] Current subscriptions:" << std::endl;
                                 std::cout << "   (Note: Use --debug to see internal subscription details)" << std::endl;
                             } else {
-                                // Regular UAV command
-                                if (client.sendCommand(target_uav, line)) {
+                                // Regular UAV command. A single UAV acknowledges it and the outcome and round trip
+                                // are printed when they arrive; group targets are fire-and-forget.
+                                std::string sent_line = line;
+                                auto on_result = [target_uav, sent_line](const CommandResult& result) {
+                                    static const char* const status_names[] = {
+                                        "acknowledged", "rejected", "timed out", "undelivered"};
+                                    std::cout << (result.status == CommandStatus::ACKNOWLEDGED ? "📬 [" : "⚠️  [")
+                                              << GetTimestamp() << "] " << target_uav << " " << sent_line << ": "
+                                              << status_names[static_cast<int>(result.status)] << " ("
+                                              << result.round_trip.count() / 1000.0 << " ms)" << std::endl;
+                                };
+                                bool group_target = target_uav == "*" || target_uav.find(':') != std::string::npos;
+                                bool sent = group_target ? client.sendCommand(target_uav, line)
+                                                         : client.sendCommandWithAck(target_uav, line, on_result);
+                                if (sent) {
                                     std::cout << "✅ [" << GetTimestamp() << "] Sent command to " << target_uav << ": "
                                               << line << std::endl;
-                                } else {
+                                } else if (group_target) {
                                     std::cout << "❌ [" << GetTimestamp() << "] Failed to send command: " << line
                                               << std::endl;
                                 }
@@ -500,7 +588,9 @@ int main(int argc, char* argv[]) {
                         if (!line.empty()) {
                             std::istringstream iss(line);
                             std::string command, topic;
-                            iss >> command >> topic;
+                            iss >> command;
+                            // Rest of the line: "?<filter>" suffixes may contain spaces
+                            std::getline(iss >> std::ws, topic);
 
                             if (command == "sub" && !topic.empty()) {
                                 if (client.subscribe(topic)) {
@@ -533,11 +623,20 @@ int main(int argc, char* argv[]) {
         });
     }
 
-    // Main loop - just wait for shutdown signal
+    // Main loop - wait for shutdown signal (printing the statistics once a second in --stats mode)
+    auto last_report = std::chrono::steady_clock::now();
     while (g_running && client.isConnected()) {
+        auto now = std::chrono::steady_clock::now();
+        if (stats && now - last_report >= std::chrono::seconds(1)) {
+            stats->report(std::chrono::duration<double>(now - last_report).count());
+            last_report = now;
+        }
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
+    if (dashboard) {
+        dashboard->stop();
+    }
     std::cout << std::endl;
     std::cout << "🔄 Shutting down Camera UI..." << std::endl;
 
@@ -29,7 +29,7 @@ trap 'cleanup_background 2>/dev/null || true' EXIT
 #
 # Runtime Commands:
 #   run <target> [args...]  - Run a specific executable with arguments.
-#     <target>: telemetry_service, uav_sim, camera_ui, mapping_ui
+#     <target>: telemetry_service, uav_sim, camera_ui, mapping_ui, journal_tool, journal_replay, journal_export
 #     For UI apps, use: --protocol tcp|udp [--location-only|--status-only|--all-targets] [--send UAV_NAME] [--debug]
 #
 #   up [UAVs...] [args...]  - Launch service, UIs, and specified UAVs in new terminals.
@@ -55,6 +55,7 @@ trap 'cleanup_background 2>/dev/null || true' EXIT
 #   service-start           - Start the systemd service.
 #   service-stop            - Stop the systemd service.
 #   service-restart         - Restart the systemd service.
+#   service-reload          - Reload service_config.json without restarting (SIGHUP).
 #   service-status          - Check the status of the systemd service.
 #   service-logs [-f]       - View the systemd service logs with journalctl.
 #
@@ -721,6 +722,9 @@ clean() {
   find "${ROOT_DIR}/uav_sim" -maxdepth 1 -type f -name "uav_sim" -executable -delete
   find "${ROOT_DIR}/camera_ui" -maxdepth 1 -type f -name "camera_ui" -executable -delete
   find "${ROOT_DIR}/mapping_ui" -maxdepth 1 -type f -name "mapping_ui" -executable -delete
+  find "${ROOT_DIR}/journal_tool" -maxdepth 1 -type f -name "journal_tool" -executable -delete
+  find "${ROOT_DIR}/journal_replay" -maxdepth 1 -type f -name "journal_replay" -executable -delete
+  find "${ROOT_DIR}/journal_export" -maxdepth 1 -type f -name "journal_export" -executable -delete
   echo "Clean complete."
 }
 
@@ -1103,6 +1107,9 @@ run() {
     uav_sim)           exe="${ROOT_DIR}/uav_sim/uav_sim" ;;
     camera_ui)         exe="${ROOT_DIR}/camera_ui/camera_ui" ;;
     mapping_ui)        exe="${ROOT_DIR}/mapping_ui/mapping_ui" ;;
+    journal_tool)      exe="${ROOT_DIR}/journal_tool/journal_tool" ;;
+    journal_replay)    exe="${ROOT_DIR}/journal_replay/journal_replay" ;;
+    journal_export)    exe="${ROOT_DIR}/journal_export/journal_export" ;;
     *) echo "Unknown target: $target"; exit 1 ;;
   esac
 
@@ -1296,6 +1303,14 @@ case "$cmd" in
       echo "🔍 Use './dev.sh service-status' to check what went wrong"
     fi
     ;;
+  service-reload)
+    echo "🔁 Reloading telemetry service configuration..."
+    if sudo systemctl reload telemetry_service.service; then
+      echo "✅ Reload signal sent (check './dev.sh service-logs' for the applied changes)"
+    else
+      echo "❌ Failed to reload telemetry service"
+    fi
+    ;;
   service-status) sudo systemctl status telemetry_service.service ;;
   service-logs)
     shift || true
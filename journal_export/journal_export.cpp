@@ -0,0 +1,446 @@
+/**
+ * @file journal_export.cpp
+ * @brief Converts a telemetry journal into per-field column files
+ *
+ * This tool reads the journal recorded by the telemetry service and writes the
+ * location and status packets of every UAV as columns: one fixed-width file per
+ * payload field (see ColumnFormat.h), described by a manifest.json. Analysis
+ * that needs a single field, such as altitude over a day of flights, reads just
+ * that field's files instead of every packet.
+ */
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+#include "ColumnFormat.h"
+#include "JournalReader.h"
+
+using json = nlohmann::json;
+using namespace TelemetryAPI;
+using namespace TelemetryJournal;
+
+/**
+ * @struct LocationColumns
+ * @brief Location packets of one UAV, one vector per LocationPayload field
+ */
+struct LocationColumns {
+    std::vector<int64_t> receivedNs;  ///< Receive time (ns since the Unix epoch)
+    std::vector<uint8_t> targetId;    ///< Packet target (1: Camera, 2: Mapping)
+    std::vector<double> latitude;     ///< LocationPayload::latitude
+    std::vector<double> longitude;    ///< LocationPayload::longitude
+    std::vector<float> altitude;      ///< LocationPayload::altitude
+    std::vector<float> heading;       ///< LocationPayload::heading
+    std::vector<float> speed;         ///< LocationPayload::speed
+};
+
+/**
+ * @struct StatusColumns
+ * @brief Status packets of one UAV, one vector per StatusPayload field
+ */
+struct StatusColumns {
+    std::vector<int64_t> receivedNs;    ///< Receive time (ns since the Unix epoch)
+    std::vector<uint8_t> targetId;      ///< Packet target (1: Camera, 2: Mapping)
+    std::vector<uint8_t> systemHealth;  ///< StatusPayload::systemHealth
+    std::vector<uint8_t> missionState;  ///< StatusPayload::missionState
+    std::vector<uint16_t> flightTime;   ///< StatusPayload::flightTime
+    std::vector<float> cpuUsage;        ///< StatusPayload::cpuUsage
+    std::vector<float> memoryUsage;     ///< StatusPayload::memoryUsage
+};
+
+/**
+ * @struct UavColumns
+ * @brief Everything exported for one UAV
+ */
+struct UavColumns {
+    LocationColumns location;  ///< Location packets
+    StatusColumns status;      ///< Status packets
+};
+
+/**
+ * @struct EncodedColumn
+ * @brief A column ready to be written (header fields plus payload bytes)
+ */
+struct EncodedColumn {
+    uint8_t encoding{ColumnEncoding::PLAIN};  ///< Chosen ColumnEncoding
+    uint8_t storedWidth{0};                   ///< Bytes per stored element
+    int64_t deltaBase{0};                     ///< Row 0 value (DELTA)
+    uint32_t dictionarySize{0};               ///< Dictionary entries (DICTIONARY)
+    std::vector<uint8_t> dictionary;          ///< Dictionary values (DICTIONARY)
+    std::vector<uint8_t> elements;            ///< rowCount elements of storedWidth bytes
+};
+
+/**
+ * @brief Smallest signed width that holds a value
+ * @param value Value to store
+ * @return 1, 2, 4 or 8
+ */
+uint8_t signedWidth(int64_t value) {
+    if (value >= INT8_MIN && value <= INT8_MAX) {
+        return 1;
+    }
+    if (value >= INT16_MIN && value <= INT16_MAX) {
+        return 2;
+    }
+    if (value >= INT32_MIN && value <= INT32_MAX) {
+        return 4;
+    }
+    return 8;
+}
+
+/**
+ * @brief Encode one column
+ * @param values Column values
+ * @param allowEncodings Consider DELTA and DICTIONARY; false always writes PLAIN
+ * @return The smallest of the applicable encodings
+ *
+ * DELTA applies to integer columns (timestamps, flight time) and stores the
+ * differences between rows in the narrowest signed width that fits them all.
+ * DICTIONARY applies to columns with at most 256 distinct values wider than a
+ * byte and stores one-byte indexes. Both keep elements fixed width.
+ */
+template <typename T>
+EncodedColumn encodeColumn(const std::vector<T>& values, bool allowEncodings) {
+    EncodedColumn plain;
+    plain.storedWidth = sizeof(T);
+    plain.elements.resize(values.size() * sizeof(T));
+    std::memcpy(plain.elements.data(), values.data(), plain.elements.size());
+    if (!allowEncodings || values.empty()) {
+        return plain;
+    }
+    size_t best_size = plain.elements.size();
+    EncodedColumn best = std::move(plain);
+
+    if constexpr (std::is_integral_v<T>) {
+        uint8_t width = 1;
+        for (size_t row = 1; row < values.size(); ++row) {
+            int64_t delta = static_cast<int64_t>(values[row]) - static_cast<int64_t>(values[row - 1]);
+            width = std::max(width, signedWidth(delta));
+        }
+        if (values.size() * width < best_size) {
+            EncodedColumn delta;
+            delta.encoding = ColumnEncoding::DELTA;
+            delta.storedWidth = width;
+            delta.deltaBase = static_cast<int64_t>(values[0]);
+            delta.elements.resize(values.size() * width);
+            for (size_t row = 1; row < values.size(); ++row) {
+                int64_t difference = static_cast<int64_t>(values[row]) - static_cast<int64_t>(values[row - 1]);
+                // Little-endian: the low bytes of the two's complement value are the narrow value
+                std::memcpy(delta.elements.data() + row * width, &difference, width);
+            }
+            best_size = delta.elements.size();
+            best = std::move(delta);
+        }
+    }
+
+    if (sizeof(T) > 1) {
+        // Compare bit patterns so floats like -0.0 / NaN keep their exact value
+        std::unordered_map<uint64_t, uint8_t> indexes;
+        std::vector<uint8_t> codes(values.size());
+        EncodedColumn dictionary;
+        for (size_t row = 0; row < values.size(); ++row) {
+            uint64_t bits = 0;
+            std::memcpy(&bits, &values[row], sizeof(T));
+            auto [it, inserted] = indexes.emplace(bits, static_cast<uint8_t>(indexes.size()));
+            if (inserted) {
+                if (indexes.size() > ColumnFormat::MAX_DICTIONARY) {
+                    return best;
+                }
+                const auto* bytes = reinterpret_cast<const uint8_t*>(&values[row]);
+                dictionary.dictionary.insert(dictionary.dictionary.end(), bytes, bytes + sizeof(T));
+            }
+            codes[row] = it->second;
+        }
+        if (dictionary.dictionary.size() + codes.size() < best_size) {
+            dictionary.encoding = ColumnEncoding::DICTIONARY;
+            dictionary.storedWidth = 1;
+            dictionary.dictionarySize = static_cast<uint32_t>(indexes.size());
+            dictionary.elements = std::move(codes);
+            best = std::move(dictionary);
+        }
+    }
+    return best;
+}
+
+/**
+ * @brief Value type tag of a C++ column type
+ */
+template <typename T>
+constexpr uint8_t columnTypeOf() {
+    if constexpr (std::is_same_v<T, uint8_t>) {
+        return ColumnType::U8;
+    } else if constexpr (std::is_same_v<T, uint16_t>) {
+        return ColumnType::U16;
+    } else if constexpr (std::is_same_v<T, int64_t>) {
+        return ColumnType::I64;
+    } else if constexpr (std::is_same_v<T, float>) {
+        return ColumnType::F32;
+    } else {
+        static_assert(std::is_same_v<T, double>, "unsupported column type");
+        return ColumnType::F64;
+    }
+}
+
+/**
+ * @class ColumnWriter
+ * @brief Writes the column files of one export and collects its manifest
+ */
+class ColumnWriter {
+   public:
+    /**
+     * @brief Constructor
+     * @param outputDirectory Export directory (created if needed)
+     * @param allowEncodings Use DELTA / DICTIONARY where they are smaller
+     */
+    ColumnWriter(std::filesystem::path outputDirectory, bool allowEncodings)
+        : outputDirectory_(std::move(outputDirectory)), allowEncodings_(allowEncodings) {}
+
+    /**
+     * @brief Encode and write one column
+     * @param group Manifest object of the UAV's packet type (receives the column entry)
+     * @param relativeDirectory Directory of the column, relative to the export
+     * @param field Field name (file name without extension)
+     * @param values Column values
+     * @throws std::runtime_error on I/O errors
+     */
+    template <typename T>
+    void write(json& group,
+               const std::filesystem::path& relativeDirectory,
+               const std::string& field,
+               const std::vector<T>& values) {
+        EncodedColumn column = encodeColumn(values, allowEncodings_);
+
+        ColumnFileHeader header{};
+        std::memcpy(header.magic, ColumnFormat::MAGIC, sizeof(header.magic));
+        header.version = ColumnFormat::VERSION;
+        header.valueType = columnTypeOf<T>();
+        header.encoding = column.encoding;
+        header.storedWidth = column.storedWidth;
+        header.rowCount = values.size();
+        header.deltaBase = column.deltaBase;
+        header.dictionarySize = column.dictionarySize;
+        header.dataOffset = static_cast<uint32_t>(ColumnFormat::align(sizeof(header) + column.dictionary.size()));
+
+        std::filesystem::path relative = relativeDirectory / (field + ColumnFormat::FILE_EXTENSION);
+        std::filesystem::path path = outputDirectory_ / relative;
+        std::filesystem::create_directories(path.parent_path());
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        if (!file) {
+            throw std::runtime_error("cannot create " + path.string());
+        }
+        static const char padding[ColumnFormat::COLUMN_ALIGNMENT] = {};
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(column.dictionary.data()),
+                   static_cast<std::streamsize>(column.dictionary.size()));
+        size_t padding_bytes = header.dataOffset - sizeof(header) - column.dictionary.size();
+        file.write(padding, static_cast<std::streamsize>(padding_bytes));
+        file.write(reinterpret_cast<const char*>(column.elements.data()),
+                   static_cast<std::streamsize>(column.elements.size()));
+        if (!file) {
+            throw std::runtime_error("write failed: " + path.string());
+        }
+
+        uint64_t file_bytes = header.dataOffset + column.elements.size();
+        group["columns"][field] = {{"file", relative.generic_string()},
+                                   {"type", ColumnType::name(header.valueType)},
+                                   {"encoding", ColumnEncoding::name(column.encoding)},
+                                   {"stored_width", column.storedWidth},
+                                   {"bytes", file_bytes}};
+        rawBytes_ += values.size() * sizeof(T);
+        writtenBytes_ += file_bytes;
+    }
+
+    /**
+     * @brief Get the value bytes exported so far (as plain arrays)
+     */
+    [[nodiscard]] uint64_t rawBytes() const {
+        return rawBytes_;
+    }
+
+    /**
+     * @brief Get the column file bytes written so far
+     */
+    [[nodiscard]] uint64_t writtenBytes() const {
+        return writtenBytes_;
+    }
+
+   private:
+    std::filesystem::path outputDirectory_;  ///< Export directory
+    bool allowEncodings_;                    ///< DELTA / DICTIONARY enabled
+    uint64_t rawBytes_{0};                   ///< Sum of plain value bytes
+    uint64_t writtenBytes_{0};               ///< Sum of column file sizes
+};
+
+/**
+ * @brief Print usage information
+ * @param program Program name
+ */
+void printUsage(const char* program) {
+    std::cout << "Journal Export - Convert a telemetry journal to column files\n";
+    std::cout << "Usage: " << program << " [options] OUTPUT_DIR\n";
+    std::cout << "Options:\n";
+    std::cout << "  --dir PATH              : Journal directory (default: telemetry_service/journal)\n";
+    std::cout << "  --from TIME             : First packet to export (default: start)\n";
+    std::cout << "  --to TIME               : Last packet to export (default: end)\n";
+    std::cout << "  --uav NAME              : Export only this UAV (repeatable)\n";
+    std::cout << "  --encoding auto|plain   : Delta/dictionary encode where smaller (default: auto)\n";
+    std::cout << "  --help                  : Show this help message\n";
+    std::cout << "\nTimes are Unix seconds, local time YYYY-MM-DDTHH:MM:SS, 'start' or 'end'.\n";
+}
+
+/**
+ * @brief Main function - Journal export entry point
+ */
+int main(int argc, char* argv[]) {
+    std::string directory = "telemetry_service/journal";
+    std::string output;
+    int64_t from_ns = JournalReader::BEGINNING;
+    int64_t to_ns = JournalReader::END;
+    std::vector<std::string> uav_filter;
+    bool allow_encodings = true;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--dir" && i + 1 < argc) {
+                directory = argv[++i];
+            } else if (arg == "--from" && i + 1 < argc) {
+                from_ns = parseTime(argv[++i]);
+            } else if (arg == "--to" && i + 1 < argc) {
+                to_ns = parseTime(argv[++i]);
+            } else if (arg == "--uav" && i + 1 < argc) {
+                uav_filter.emplace_back(argv[++i]);
+            } else if (arg == "--encoding" && i + 1 < argc) {
+                std::string encoding = argv[++i];
+                if (encoding != "auto" && encoding != "plain") {
+                    throw std::invalid_argument("encoding must be 'auto' or 'plain'");
+                }
+                allow_encodings = encoding == "auto";
+            } else if (arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else if (output.empty() && arg.rfind("--", 0) != 0) {
+                output = arg;
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+        if (output.empty()) {
+            printUsage(argv[0]);
+            return 1;
+        }
+
+        JournalReader reader(directory);
+        std::map<uint16_t, bool> selected;
+        for (const auto& name : uav_filter) {
+            std::optional<uint16_t> id = reader.uavId(name);
+            if (!id) {
+                throw std::invalid_argument("UAV not found in journal: " + name);
+            }
+            selected[*id] = true;
+        }
+
+        // Split packets by UAV and packet type, in receive order
+        std::map<uint16_t, UavColumns> uavs;
+        uint64_t other_packets = 0;
+        reader.forEach(from_ns, to_ns, [&](const JournalRecord& record) {
+            if (!selected.empty() && selected.count(record.uavId) == 0) {
+                return true;
+            }
+            UavColumns& columns = uavs[record.uavId];
+            if (auto location = record.packet.location()) {
+                LocationColumns& out = columns.location;
+                out.receivedNs.push_back(record.receivedNs);
+                out.targetId.push_back(record.packet.targetId());
+                out.latitude.push_back(location->latitude);
+                out.longitude.push_back(location->longitude);
+                out.altitude.push_back(location->altitude);
+                out.heading.push_back(location->heading);
+                out.speed.push_back(location->speed);
+            } else if (auto status = record.packet.status()) {
+                StatusColumns& out = columns.status;
+                out.receivedNs.push_back(record.receivedNs);
+                out.targetId.push_back(record.packet.targetId());
+                out.systemHealth.push_back(status->systemHealth);
+                out.missionState.push_back(status->missionState);
+                out.flightTime.push_back(status->flightTime);
+                out.cpuUsage.push_back(status->cpuUsage);
+                out.memoryUsage.push_back(status->memoryUsage);
+            } else {
+                ++other_packets;
+            }
+            return true;
+        });
+
+        ColumnWriter writer(output, allow_encodings);
+        json manifest;
+        manifest["format_version"] = ColumnFormat::VERSION;
+        manifest["source"] = std::filesystem::absolute(directory).string();
+        manifest["uavs"] = json::object();
+        for (const auto& [uav_id, columns] : uavs) {
+            std::string name = reader.uavName(uav_id);
+            json& uav = manifest["uavs"][name];
+            uav["id"] = uav_id;
+
+            const LocationColumns& location = columns.location;
+            if (!location.receivedNs.empty()) {
+                json& group = uav["location"];
+                group["rows"] = location.receivedNs.size();
+                std::filesystem::path base = std::filesystem::path(name) / "location";
+                writer.write(group, base, "receivedNs", location.receivedNs);
+                writer.write(group, base, "targetId", location.targetId);
+                writer.write(group, base, "latitude", location.latitude);
+                writer.write(group, base, "longitude", location.longitude);
+                writer.write(group, base, "altitude", location.altitude);
+                writer.write(group, base, "heading", location.heading);
+                writer.write(group, base, "speed", location.speed);
+            }
+
+            const StatusColumns& status = columns.status;
+            if (!status.receivedNs.empty()) {
+                json& group = uav["status"];
+                group["rows"] = status.receivedNs.size();
+                std::filesystem::path base = std::filesystem::path(name) / "status";
+                writer.write(group, base, "receivedNs", status.receivedNs);
+                writer.write(group, base, "targetId", status.targetId);
+                writer.write(group, base, "systemHealth", status.systemHealth);
+                writer.write(group, base, "missionState", status.missionState);
+                writer.write(group, base, "flightTime", status.flightTime);
+                writer.write(group, base, "cpuUsage", status.cpuUsage);
+                writer.write(group, base, "memoryUsage", status.memoryUsage);
+            }
+        }
+
+        std::filesystem::path manifest_path = std::filesystem::path(output) / ColumnFormat::MANIFEST;
+        std::filesystem::create_directories(output);
+        std::ofstream manifest_file(manifest_path);
+        manifest_file << manifest.dump(2) << '\n';
+        if (!manifest_file) {
+            throw std::runtime_error("cannot write " + manifest_path.string());
+        }
+
+        std::cout << "Exported " << uavs.size() << " UAVs to " << output << ": " << writer.writtenBytes()
+                  << " bytes of columns (" << writer.rawBytes() << " bytes unencoded)";
+        if (other_packets > 0) {
+            std::cout << ", " << other_packets << " packets of other types skipped";
+        }
+        std::cout << "\n";
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,570 @@
+/**
+ * @file journal_replay.cpp
+ * @brief Replays a recorded telemetry journal into a running telemetry service
+ *
+ * This application reads the journal written by the service's recorder and
+ * sends every packet back to the service's ingest ports, as if the UAVs were
+ * flying again. Packets keep their recorded spacing (optionally sped up), so a
+ * replay reproduces real traffic shapes for regression tests, incident analysis
+ * and load generation.
+ */
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <boost/asio.hpp>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <nlohmann/json.hpp>
+#include <optional>
+#include <string>
+#include <system_error>
+#include <thread>
+#include <vector>
+#include <zmq.hpp>
+
+#include "JournalReader.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
+
+using json = nlohmann::json;
+using boost::asio::ip::udp;
+using TelemetryJournal::JournalReader;
+using TelemetryJournal::JournalRecord;
+using TelemetryJournal::parseTime;
+
+// Global flag for graceful shutdown
+std::atomic<bool> g_running(true);      // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+std::atomic<int> g_signal_received(0);  // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+// Configuration constants
+namespace {
+    constexpr uint8_t ingest_magic = 0xA7;
+    // The pacer sleeps until this close to a send time, then spins for the rest
+    constexpr std::chrono::microseconds spin_window{500};
+    // Longest single sleep of the pacer, so Ctrl+C interrupts a long recorded gap promptly
+    constexpr std::chrono::milliseconds sleep_slice{100};
+    constexpr std::chrono::seconds progress_interval{5};
+    // Bounded waits so a stopped service cannot hang the replay
+    constexpr int send_timeout_ms = 1000;
+    constexpr int close_linger_ms = 2000;
+}  // namespace
+
+// Envelope prepended to datagrams sent to the service's shared UDP ingest port (must match service)
+#pragma pack(push, 1)
+struct ReplayIngestHeader {
+    uint8_t magic;   ///< Always ingest_magic
+    uint16_t uavId;  ///< UAV id from service_config.json
+};
+#pragma pack(pop)
+
+/**
+ * @struct ReplayTarget
+ * @brief Service ingest endpoints of one UAV, plus its lazily opened sockets
+ *
+ * Channels without a dedicated port use the service's shared ingest endpoints,
+ * exactly as uav_sim does.
+ */
+struct ReplayTarget {
+    std::string name;                           ///< UAV identifier (e.g., "UAV_1")
+    std::string ip;                             ///< IP address of the telemetry service
+    uint16_t id{0};                             ///< Numeric UAV id used in shared-ingest UDP packets
+    int tcp_telemetry_port{0};                  ///< Dedicated TCP telemetry port (0 = shared)
+    int udp_telemetry_port{0};                  ///< Dedicated UDP telemetry port (0 = shared)
+    int shared_tcp_telemetry_port{0};           ///< Service's shared telemetry ROUTER port
+    int shared_udp_telemetry_port{0};           ///< Service's shared UDP ingest port
+    std::unique_ptr<zmq::socket_t> tcp_socket;  ///< Connected on first TCP packet
+    std::optional<udp::endpoint> udp_endpoint;  ///< Resolved on first UDP packet
+};
+
+/**
+ * @struct ReplayStats
+ * @brief Counters reported while and after replaying
+ */
+struct ReplayStats {
+    uint64_t sent{0};                           ///< Packets handed to a socket
+    uint64_t skipped{0};                        ///< Packets of UAVs missing from the configuration
+    uint64_t failed{0};                         ///< Packets the service did not take (send timeout or error)
+    uint64_t bytes{0};                          ///< Packet bytes sent
+    std::chrono::nanoseconds maxLateness{0};    ///< Worst delay behind the paced schedule
+    std::chrono::nanoseconds totalLateness{0};  ///< Sum of delays (for the average)
+};
+
+/**
+ * @class Pacer
+ * @brief Reproduces recorded packet spacing on the steady clock
+ *
+ * The first packet anchors the schedule; every later packet is due at
+ * anchor + (recorded offset / speed). Waiting sleeps until shortly before the
+ * due time and spins the remainder, which keeps sub-millisecond spacing that a
+ * plain sleep would round up to the scheduler tick. Sleeps are cut into slices
+ * so a shutdown request ends the wait early. A sender that falls behind
+ * catches up by sending immediately instead of drifting, and idle gaps longer
+ * than maxGap are shortened so a journal spanning several flights replays
+ * without waiting out the time between them.
+ */
+class Pacer {
+   public:
+    /**
+     * @brief Constructor
+     * @param speed Replay speed factor (0 = as fast as possible)
+     * @param maxGap Longest recorded silence to reproduce (scaled by speed)
+     */
+    Pacer(double speed, std::chrono::nanoseconds maxGap) : speed_(speed), maxGap_(maxGap) {}
+
+    /**
+     * @brief Forget the schedule; the next packet is sent at once and re-anchors it
+     */
+    void reset() {
+        anchored_ = false;
+    }
+
+    /**
+     * @brief Wait until a recorded packet is due
+     * @param receivedNs Recorded receive time of the packet
+     * @return How late the wait returned (0 when pacing is off or the wait was interrupted)
+     */
+    std::chrono::nanoseconds waitFor(int64_t receivedNs) {
+        if (speed_ <= 0.0) {
+            return std::chrono::nanoseconds{0};
+        }
+        auto now = std::chrono::steady_clock::now();
+        if (!anchored_) {
+            anchored_ = true;
+            anchorTime_ = now;
+            anchorNs_ = receivedNs;
+            previousNs_ = receivedNs;
+            return std::chrono::nanoseconds{0};
+        }
+
+        // Cut long silences down to maxGap by moving the anchor forward
+        int64_t gap = receivedNs - previousNs_;
+        if (gap > maxGap_.count()) {
+            anchorNs_ += gap - maxGap_.count();
+        }
+        previousNs_ = receivedNs;
+
+        auto offset =
+            std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(receivedNs - anchorNs_) / speed_));
+        auto due = anchorTime_ + std::chrono::duration_cast<std::chrono::steady_clock::duration>(offset);
+        while (now < due - spin_window) {
+            if (!g_running.load()) {
+                return std::chrono::nanoseconds{0};
+            }
+            auto slice_end = std::min<std::chrono::steady_clock::time_point>(due - spin_window, now + sleep_slice);
+            std::this_thread::sleep_until(slice_end);
+            now = std::chrono::steady_clock::now();
+        }
+        while ((now = std::chrono::steady_clock::now()) < due) {
+            std::this_thread::yield();
+        }
+        return now - due;
+    }
+
+   private:
+    double speed_;                                      ///< Speed factor (0 = unpaced)
+    std::chrono::nanoseconds maxGap_;                   ///< Longest silence reproduced
+    bool anchored_{false};                              ///< Schedule has been anchored
+    std::chrono::steady_clock::time_point anchorTime_;  ///< Steady time of the anchor packet
+    int64_t anchorNs_{0};                               ///< Recorded time of the anchor (gap-adjusted)
+    int64_t previousNs_{0};                             ///< Recorded time of the previous packet
+};
+
+/**
+ * @brief Signal handler for graceful shutdown
+ * @param signum The signal number received
+ */
+void signalHandler(int signum) {
+    g_signal_received.store(signum);
+    g_running.store(false);
+}
+
+/**
+ * @brief Get the directory containing the executable
+ * @return Path to the executable directory (current directory if unknown)
+ */
+std::filesystem::path getExecutableDir() {
+    try {
+#if defined(_WIN32)
+        char path[MAX_PATH];
+        DWORD len = GetModuleFileNameA(nullptr, path, MAX_PATH);
+        if (len == 0 || len == MAX_PATH)
+            return std::filesystem::current_path();
+        return std::filesystem::path(path).parent_path();
+#else
+        std::array<char, 4096> buf{};
+        ssize_t len = readlink("/proc/self/exe", buf.data(), buf.size() - 1);
+        if (len == -1)
+            return std::filesystem::current_path();
+        buf.at(static_cast<size_t>(len)) = '\0';
+        return std::filesystem::path(buf.data()).parent_path();
+#endif
+    } catch (const std::exception&) {
+        return std::filesystem::current_path();
+    }
+}
+
+/**
+ * @brief Resolve the configuration file path
+ * @return Path to service_config.json
+ *
+ * Checks SERVICE_CONFIG, the current directory, the executable directory and
+ * its parent, like the other applications.
+ */
+std::string resolveConfigPath() {
+    if (const char* env = std::getenv("SERVICE_CONFIG")) {
+        std::error_code error_code;
+        if (std::filesystem::exists(env, error_code) && !error_code)
+            return {env};
+    }
+
+    std::filesystem::path exe_dir = getExecutableDir();
+    for (const auto& path : {std::filesystem::path("service_config.json"), exe_dir / "service_config.json",
+                             exe_dir.parent_path() / "service_config.json"}) {
+        std::error_code error_code;
+        if (std::filesystem::exists(path, error_code) && !error_code)
+            return path.string();
+    }
+    return {"service_config.json"};
+}
+
+/**
+ * @brief Load the ingest endpoints of every configured UAV
+ * @param config_file Path to the JSON configuration file
+ * @return UAV name -> target
+ * @throws std::runtime_error for file access or parsing errors
+ */
+std::map<std::string, ReplayTarget> loadReplayTargets(const std::string& config_file) {
+    std::ifstream file(config_file);
+    if (!file.is_open()) {
+        throw std::runtime_error("Cannot open config file: " + config_file);
+    }
+
+    json json_data;
+    try {
+        file >> json_data;
+    } catch (const json::exception& e) {
+        throw std::runtime_error("Invalid JSON in config file: " + std::string(e.what()));
+    }
+    if (!json_data.contains("uavs") || !json_data["uavs"].is_array()) {
+        throw std::runtime_error("Config file missing 'uavs' array");
+    }
+
+    int shared_tcp_telemetry_port = 0;
+    int shared_udp_telemetry_port = 0;
+    if (json_data.contains("shared_ingest")) {
+        shared_tcp_telemetry_port = json_data["shared_ingest"].value("tcp_telemetry_port", 0);
+        shared_udp_telemetry_port = json_data["shared_ingest"].value("udp_telemetry_port", 0);
+    }
+
+    std::map<std::string, ReplayTarget> targets;
+    int position = 0;
+    for (const auto& uav_json : json_data["uavs"]) {
+        ++position;
+        if (!uav_json.contains("name") || !uav_json["name"].is_string()) {
+            continue;  // Skip invalid entries
+        }
+        ReplayTarget target;
+        target.name = uav_json["name"];
+        target.ip = uav_json.value("ip", "localhost");
+        target.id = static_cast<uint16_t>(uav_json.value("id", position));
+        target.tcp_telemetry_port = uav_json.value("tcp_telemetry_port", 0);
+        target.udp_telemetry_port = uav_json.value("udp_telemetry_port", 0);
+        target.shared_tcp_telemetry_port = shared_tcp_telemetry_port;
+        target.shared_udp_telemetry_port = shared_udp_telemetry_port;
+        std::string name = target.name;
+        targets.emplace(name, std::move(target));
+    }
+    return targets;
+}
+
+/**
+ * @brief Send one packet to the service's TCP ingest for its UAV
+ * @param context ZeroMQ context for the socket
+ * @param target UAV the packet belongs to
+ * @param data Packet bytes
+ * @param size Packet size
+ * @return true if the socket took the packet
+ *
+ * Dedicated ports get a PUSH socket; the shared ROUTER gets a DEALER whose
+ * routing ID is the UAV name, as in uav_sim.
+ */
+bool sendTcp(zmq::context_t& context, ReplayTarget& target, const uint8_t* data, size_t size) {
+    if (!target.tcp_socket) {
+        const bool shared = target.tcp_telemetry_port == 0;
+        int port = shared ? target.shared_tcp_telemetry_port : target.tcp_telemetry_port;
+        if (port == 0) {
+            return false;
+        }
+        auto socket =
+            std::make_unique<zmq::socket_t>(context, shared ? zmq::socket_type::dealer : zmq::socket_type::push);
+        socket->set(zmq::sockopt::linger, close_linger_ms);
+        socket->set(zmq::sockopt::sndtimeo, send_timeout_ms);
+        if (shared) {
+            socket->set(zmq::sockopt::routing_id, target.name);
+        }
+        socket->connect("tcp://" + target.ip + ":" + std::to_string(port));
+        target.tcp_socket = std::move(socket);
+    }
+    try {
+        return target.tcp_socket->send(zmq::buffer(data, size), zmq::send_flags::none).has_value();
+    } catch (const zmq::error_t&) {
+        return false;
+    }
+}
+
+/**
+ * @brief Send one packet to the service's UDP ingest for its UAV
+ * @param io_context Boost.Asio I/O context for the resolver
+ * @param socket UDP socket to send from
+ * @param target UAV the packet belongs to
+ * @param data Packet bytes
+ * @param size Packet size
+ * @return true if the datagram was sent
+ *
+ * On the shared ingest port the packet is prefixed with the ingest header.
+ */
+bool sendUdp(boost::asio::io_context& io_context,
+             udp::socket& socket,
+             ReplayTarget& target,
+             const uint8_t* data,
+             size_t size) {
+    const bool shared = target.udp_telemetry_port == 0;
+    if (!target.udp_endpoint) {
+        int port = shared ? target.shared_udp_telemetry_port : target.udp_telemetry_port;
+        if (port == 0) {
+            return false;
+        }
+        udp::resolver resolver(io_context);
+        target.udp_endpoint = *resolver.resolve(udp::v4(), target.ip, std::to_string(port)).begin();
+    }
+
+    boost::system::error_code error;
+    if (shared) {
+        ReplayIngestHeader ingest{ingest_magic, target.id};
+        std::array<boost::asio::const_buffer, 2> buffers{boost::asio::buffer(&ingest, sizeof(ingest)),
+                                                         boost::asio::buffer(data, size)};
+        socket.send_to(buffers, *target.udp_endpoint, 0, error);
+    } else {
+        socket.send_to(boost::asio::buffer(data, size), *target.udp_endpoint, 0, error);
+    }
+    return !error;
+}
+
+/**
+ * @brief Print replay progress
+ * @param stats Counters so far
+ * @param elapsed Wall time since the replay started
+ */
+void printProgress(const ReplayStats& stats, std::chrono::steady_clock::duration elapsed) {
+    double seconds = std::chrono::duration<double>(elapsed).count();
+    double average_lateness_us =
+        stats.sent > 0 ? std::chrono::duration<double, std::micro>(stats.totalLateness).count() / stats.sent : 0.0;
+    std::cout << "[replay] " << stats.sent << " sent, " << stats.failed << " failed, " << stats.skipped
+              << " skipped | " << std::fixed << std::setprecision(0)
+              << (seconds > 0 ? stats.sent / seconds : 0.0) << " pkt/s | lateness avg " << std::setprecision(1)
+              << average_lateness_us << " us, max "
+              << std::chrono::duration<double, std::micro>(stats.maxLateness).count() << " us" << std::defaultfloat
+              << std::endl;
+}
+
+/**
+ * @brief Print usage information
+ * @param program Program name
+ */
+void printUsage(const char* program) {
+    std::cout << "Journal Replay - Re-inject recorded telemetry into the service\n";
+    std::cout << "Usage: " << program << " [options]\n";
+    std::cout << "Options:\n";
+    std::cout << "  --dir PATH          : Journal directory (default: telemetry_service/journal)\n";
+    std::cout << "  --speed N|max       : Replay speed factor (default: 1 = recorded timing)\n";
+    std::cout << "  --from TIME         : First packet to replay (default: start)\n";
+    std::cout << "  --to TIME           : Last packet to replay (default: end)\n";
+    std::cout << "  --uav NAME          : Replay only this UAV (repeatable)\n";
+    std::cout << "  --protocol tcp|udp  : Send everything over one protocol (default: as recorded)\n";
+    std::cout << "  --max-gap SECONDS   : Shorten recorded silences to this (default: 5)\n";
+    std::cout << "  --loop N            : Replay N times, 0 = until Ctrl+C (default: 1)\n";
+    std::cout << "  --help              : Show this help message\n";
+    std::cout << "\nTimes are Unix seconds, local time YYYY-MM-DDTHH:MM:SS, 'start' or 'end'.\n";
+    std::cout << "Ingest ports are taken from service_config.json (SERVICE_CONFIG overrides the path).\n";
+}
+
+/**
+ * @brief Main function - Journal replay entry point
+ */
+int main(int argc, char* argv[]) {
+    std::signal(SIGINT, signalHandler);
+    std::signal(SIGTERM, signalHandler);
+
+    // Parse command line arguments
+    std::string directory = "telemetry_service/journal";
+    double speed = 1.0;
+    int64_t from_ns = JournalReader::BEGINNING;
+    int64_t to_ns = JournalReader::END;
+    std::vector<std::string> uav_filter;
+    std::string protocol;  // Empty = as recorded
+    double max_gap_seconds = 5.0;
+    int loops = 1;
+
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            if (arg == "--dir" && i + 1 < argc) {
+                directory = argv[++i];
+            } else if (arg == "--speed" && i + 1 < argc) {
+                std::string value = argv[++i];
+                speed = value == "max" ? 0.0 : std::stod(value);
+                if (speed <= 0.0 && value != "max") {
+                    throw std::invalid_argument("speed must be positive or 'max'");
+                }
+            } else if (arg == "--from" && i + 1 < argc) {
+                from_ns = parseTime(argv[++i]);
+            } else if (arg == "--to" && i + 1 < argc) {
+                to_ns = parseTime(argv[++i]);
+            } else if (arg == "--uav" && i + 1 < argc) {
+                uav_filter.emplace_back(argv[++i]);
+            } else if (arg == "--protocol" && i + 1 < argc) {
+                protocol = argv[++i];
+                if (protocol != "tcp" && protocol != "udp") {
+                    throw std::invalid_argument("protocol must be 'tcp' or 'udp'");
+                }
+            } else if (arg == "--max-gap" && i + 1 < argc) {
+                max_gap_seconds = std::stod(argv[++i]);
+            } else if (arg == "--loop" && i + 1 < argc) {
+                loops = std::stoi(argv[++i]);
+            } else if (arg == "--help") {
+                printUsage(argv[0]);
+                return 0;
+            } else {
+                std::cerr << "Unknown option: " << arg << "\n";
+                printUsage(argv[0]);
+                return 1;
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+
+    try {
+        JournalReader reader(directory);
+        std::string config_path = resolveConfigPath();
+        std::map<std::string, ReplayTarget> targets = loadReplayTargets(config_path);
+
+        // Resolve the UAV filter to journal ids up front so typos fail fast
+        std::vector<uint16_t> uav_ids;
+        for (const auto& name : uav_filter) {
+            std::optional<uint16_t> id = reader.uavId(name);
+            if (!id) {
+                throw std::invalid_argument("UAV not found in journal: " + name);
+            }
+            uav_ids.push_back(*id);
+        }
+
+        std::cout << "Replaying " << directory << " into the service from " << config_path << " at "
+                  << (speed > 0.0 ? std::to_string(speed) + "x" : std::string("max speed")) << "\n";
+
+        zmq::context_t context(1);
+        boost::asio::io_context io_context;
+        udp::socket udp_socket(io_context, udp::endpoint(udp::v4(), 0));
+
+        // Journal ids map to names through the journal, names to endpoints through the config
+        std::map<uint16_t, ReplayTarget*> target_by_id;
+        auto find_target = [&](uint16_t uav_id) -> ReplayTarget* {
+            auto cached = target_by_id.find(uav_id);
+            if (cached != target_by_id.end()) {
+                return cached->second;
+            }
+            ReplayTarget* target = nullptr;
+            auto by_name = targets.find(reader.uavName(uav_id));
+            if (by_name != targets.end()) {
+                target = &by_name->second;
+            } else {
+                for (auto& [name, candidate] : targets) {
+                    if (candidate.id == uav_id) {
+                        target = &candidate;
+                        break;
+                    }
+                }
+            }
+            if (target == nullptr) {
+                std::cerr << "Warning: " << reader.uavName(uav_id)
+                          << " is not in the configuration; its packets are skipped\n";
+            }
+            target_by_id[uav_id] = target;
+            return target;
+        };
+
+        Pacer pacer(speed, std::chrono::duration_cast<std::chrono::nanoseconds>(
+                               std::chrono::duration<double>(max_gap_seconds)));
+        ReplayStats stats;
+        const auto started = std::chrono::steady_clock::now();
+        auto next_progress = started + progress_interval;
+
+        for (int pass = 0; g_running.load() && (loops == 0 || pass < loops); ++pass) {
+            pacer.reset();
+            reader.forEach(from_ns, to_ns, [&](const JournalRecord& record) {
+                if (!uav_ids.empty() && std::find(uav_ids.begin(), uav_ids.end(), record.uavId) == uav_ids.end()) {
+                    return g_running.load();
+                }
+                ReplayTarget* target = find_target(record.uavId);
+                if (target == nullptr) {
+                    ++stats.skipped;
+                    return g_running.load();
+                }
+
+                auto lateness = pacer.waitFor(record.receivedNs);
+                if (!g_running.load()) {
+                    return false;  // Interrupted while waiting: do not send
+                }
+                stats.totalLateness += lateness;
+                stats.maxLateness = std::max(stats.maxLateness, lateness);
+
+                bool use_udp = protocol.empty() ? record.protocol == JournalProtocol::UDP : protocol == "udp";
+                const uint8_t* data = record.packet.data();
+                size_t size = record.packet.size();
+                bool sent = use_udp ? sendUdp(io_context, udp_socket, *target, data, size)
+                                    : sendTcp(context, *target, data, size);
+                if (sent) {
+                    ++stats.sent;
+                    stats.bytes += size;
+                } else {
+                    ++stats.failed;
+                }
+
+                auto now = std::chrono::steady_clock::now();
+                if (now >= next_progress) {
+                    printProgress(stats, now - started);
+                    next_progress = now + progress_interval;
+                }
+                return g_running.load();
+            });
+        }
+
+        printProgress(stats, std::chrono::steady_clock::now() - started);
+        std::cout << "Replay " << (g_running.load() ? "complete" : "interrupted") << ": " << stats.bytes
+                  << " bytes\n";
+
+        // Sockets linger briefly so queued TCP packets still reach the service
+        for (auto& [name, target] : targets) {
+            target.tcp_socket.reset();
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,194 @@
+/**
+ * @file journal_tool.cpp
+ * @brief Command line access to recorded telemetry journals
+ *
+ * This tool opens a journal directory written by the telemetry service's
+ * recorder and prints a summary, the packets of one UAV in a time range, or
+ * the most recent packets. Lookups go through the journal's time and per-UAV
+ * indexes, so queries stay fast on large journals.
+ */
+
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <exception>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+
+#include "JournalReader.h"
+
+using namespace TelemetryAPI;
+using namespace TelemetryJournal;
+
+/**
+ * @brief Format a journal timestamp as local time with millisecond precision
+ * @param receivedNs Nanoseconds since the Unix epoch
+ * @return Timestamp string in format "YYYY-MM-DD HH:MM:SS.mmm"
+ */
+std::string formatTime(int64_t receivedNs) {
+    std::time_t seconds = static_cast<std::time_t>(receivedNs / 1000000000);
+    int64_t milliseconds = (receivedNs / 1000000) % 1000;
+    struct tm time_info;
+
+    // Use platform-specific thread-safe time conversion
+#if defined(_WIN32)
+    localtime_s(&time_info, &seconds);
+#else
+    localtime_r(&seconds, &time_info);
+#endif
+
+    std::ostringstream oss;
+    oss << std::put_time(&time_info, "%Y-%m-%d %H:%M:%S") << '.' << std::setfill('0') << std::setw(3) << milliseconds;
+    return oss.str();
+}
+
+/**
+ * @brief Parse a packet type filter
+ * @param text "location" or "status"
+ * @return The packet type, or nothing if the text is not a packet type
+ */
+std::optional<uint8_t> parsePacketType(const std::string& text) {
+    if (text == "location") {
+        return PacketTypes::LOCATION;
+    }
+    if (text == "status") {
+        return PacketTypes::STATUS;
+    }
+    return std::nullopt;
+}
+
+/**
+ * @brief Print one journaled packet
+ * @param reader Reader the record came from (for the UAV name)
+ * @param record Record to print
+ */
+void printRecord(const JournalReader& reader, const JournalRecord& record) {
+    std::cout << formatTime(record.receivedNs) << " #" << record.sequence << " " << reader.uavName(record.uavId)
+              << (record.protocol == JournalProtocol::UDP ? " udp " : " tcp ");
+
+    const PacketView& packet = record.packet;
+    std::string target = packet.targetId() == TargetIDs::CAMERA    ? "camera"
+                         : packet.targetId() == TargetIDs::MAPPING ? "mapping"
+                                                                   : "target " + std::to_string(packet.targetId());
+    if (auto location = packet.location()) {
+        std::cout << target << " location " << std::fixed << std::setprecision(6) << location->latitude << ", "
+                  << location->longitude << " | Alt: " << std::setprecision(1) << location->altitude
+                  << "m | Heading: " << std::setprecision(0) << location->heading
+                  << " | Speed: " << std::setprecision(1) << location->speed << "m/s";
+    } else if (auto status = packet.status()) {
+        std::cout << target << " status health " << static_cast<int>(status->systemHealth) << " | mission "
+                  << static_cast<int>(status->missionState) << " | Flight: " << status->flightTime << "s"
+                  << " | CPU: " << std::fixed << std::setprecision(1) << status->cpuUsage
+                  << "% | Mem: " << status->memoryUsage << "%";
+    } else {
+        std::cout << target << " type " << static_cast<int>(packet.packetType()) << " (" << packet.size()
+                  << " bytes)";
+    }
+    std::cout << std::defaultfloat << '\n';
+}
+
+/**
+ * @brief Print a summary of every segment and UAV in the journal
+ * @param reader Open journal
+ */
+void printInfo(const JournalReader& reader) {
+    uint64_t total = 0;
+    for (const auto& segment : reader.segments()) {
+        const JournalSegmentHeader& header = segment->header();
+        total += header.recordCount;
+        std::cout << JournalFormat::segmentFileName(header.segmentIndex) << "  " << std::setw(9)
+                  << header.recordCount << " records  " << formatTime(header.firstTimestampNs) << " .. "
+                  << formatTime(header.lastTimestampNs) << (segment->sealed() ? "" : "  (unsealed)") << '\n';
+    }
+    std::cout << reader.segments().size() << " segments, " << total << " records\n";
+    for (const auto& [id, name] : reader.uavNames()) {
+        std::cout << "  " << name << " (id " << id << ")\n";
+    }
+}
+
+/**
+ * @brief Print usage information
+ * @param program Program name
+ */
+void printUsage(const char* program) {
+    std::cout << "Journal Tool - Query recorded telemetry\n";
+    std::cout << "Usage: " << program << " [--dir PATH] <command>\n";
+    std::cout << "Commands:\n";
+    std::cout << "  info                                  : List segments and UAVs\n";
+    std::cout << "  range UAV FROM TO [location|status]   : Packets of UAV received between FROM and TO\n";
+    std::cout << "  last N [UAV|all] [location|status]    : The N most recent packets\n";
+    std::cout << "Options:\n";
+    std::cout << "  --dir PATH : Journal directory (default: telemetry_service/journal)\n";
+    std::cout << "  --help     : Show this help message\n";
+    std::cout << "\nTimes are Unix seconds, local time YYYY-MM-DDTHH:MM:SS, 'start' or 'end'.\n";
+    std::cout << "UAVs are given by name, or as #ID for segments that were never sealed.\n";
+}
+
+/**
+ * @brief Main function - Journal tool entry point
+ */
+int main(int argc, char* argv[]) {
+    std::string directory = "telemetry_service/journal";
+    int first = 1;
+    while (first < argc) {
+        std::string arg = argv[first];
+        if (arg == "--dir" && first + 1 < argc) {
+            directory = argv[first + 1];
+            first += 2;
+        } else if (arg == "--help") {
+            printUsage(argv[0]);
+            return 0;
+        } else {
+            break;
+        }
+    }
+    if (first >= argc) {
+        printUsage(argv[0]);
+        return 1;
+    }
+
+    std::string command = argv[first];
+    int remaining = argc - first - 1;
+    char** args = argv + first + 1;
+
+    try {
+        JournalReader reader(directory);
+
+        if (command == "info") {
+            printInfo(reader);
+        } else if (command == "range" && (remaining == 3 || remaining == 4)) {
+            std::optional<uint8_t> type;
+            if (remaining == 4 && !(type = parsePacketType(args[3]))) {
+                std::cerr << "Error: unknown packet type " << args[3] << "\n";
+                return 1;
+            }
+            for (const auto& record : reader.query(args[0], parseTime(args[1]), parseTime(args[2]), type)) {
+                printRecord(reader, record);
+            }
+        } else if (command == "last" && remaining >= 1 && remaining <= 3) {
+            size_t count = std::stoul(args[0]);
+            std::string uav;
+            std::optional<uint8_t> type;
+            for (int i = 1; i < remaining; ++i) {
+                if (auto parsed = parsePacketType(args[i])) {
+                    type = parsed;
+                } else if (std::string(args[i]) != "all") {
+                    uav = args[i];
+                }
+            }
+            for (const auto& record : reader.last(count, uav, type)) {
+                printRecord(reader, record);
+            }
+        } else {
+            printUsage(argv[0]);
+            return 1;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << "Error: " << e.what() << "\n";
+        return 1;
+    }
+    return 0;
+}
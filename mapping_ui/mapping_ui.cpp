@@ -7,23 +7,33 @@
  * and navigation data for real-time mapping visualization.
  */
 
+#include <sys/ioctl.h>
 #include <sys/select.h>
 #include <unistd.h>
 
+#include <algorithm>
+#include <array>
 #include <atomic>
 #include <chrono>
+#include <cctype>
 #include <cmath>
 #include <csignal>
 #include <cstdlib>  // for setenv
 #include <cstring>
 #include <ctime>
+#include <functional>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
 #include <thread>
+#include <utility>
+#include <vector>
 
+#include "ConsoleMonitors.h"
 #include "TelemetryClient.h"
 
 using namespace TelemetryAPI;
@@ -106,6 +116,26 @@ void displayMappingLocationData(const std::vector<uint8_t>& data, const std::str
     std::cout << "       Distance from reference: " << std::setprecision(2) << distance_km << " km" << std::endl;
 }
 
+/**
+ * @brief Display the UAVs a fleet query found in the watched area
+ * @param result Answer of TelemetryClient::queryBox()
+ */
+void displayAreaQueryResult(const QueryResult& result) {
+    std::cout << std::endl;
+    if (!result.ok) {
+        std::cout << "⚠️  [" << GetTimestamp() << "] Area query failed: " << result.error << std::endl;
+        return;
+    }
+    std::cout << "🗺️ [" << GetTimestamp() << "] " << result.uavs.size() << " UAV(s) in area (" << std::fixed
+              << std::setprecision(1) << result.round_trip.count() / 1000.0 << " ms)" << std::endl;
+    for (const auto& uav : result.uavs) {
+        std::cout << "   📍 [" << uav.uav_name << "] GPS: " << std::setprecision(7) << uav.latitude << ", "
+                  << uav.longitude << " | Alt: " << std::setprecision(1) << uav.altitude << "m | Course: "
+                  << std::setprecision(0) << uav.heading << "° | Speed: " << std::setprecision(1) << uav.speed
+                  << "m/s | " << uav.age.count() << " ms old" << std::endl;
+    }
+}
+
 /**
  * @brief Parse and display mapping-specific status data
  * @param data Raw telemetry data
@@ -191,6 +221,371 @@ std::string extractUAVName(const std::string& topic) {
     return topic.substr(first_dot + 1, second_dot - first_dot - 1);
 }
 
+/**
+ * @struct TrackPoint
+ * @brief One recorded position
+ */
+struct TrackPoint {
+    double latitude{0};   ///< Latitude in degrees
+    double longitude{0};  ///< Longitude in degrees
+};
+
+/**
+ * @class Track
+ * @brief Bounded position history of one UAV
+ *
+ * The latest positions are kept at full resolution in a ring buffer. A point
+ * leaving the ring moves to the history, which keeps only every stride-th
+ * such point; when the history fills up, every other point is dropped and the
+ * stride doubles. Both buffers are allocated once, so however long the flight,
+ * a track holds at most recentCapacity + historyCapacity points and the recent
+ * part stays exact while older parts thin out.
+ */
+class Track {
+   public:
+    /**
+     * @brief Constructor - allocates the whole storage
+     * @param recentCapacity Positions kept at full resolution
+     * @param historyCapacity Decimated older positions kept
+     */
+    explicit Track(size_t recentCapacity = 512, size_t historyCapacity = 512)
+        : recent_(recentCapacity), history_(historyCapacity) {}
+
+    /**
+     * @brief Record the latest position
+     */
+    void add(const TrackPoint& point) {
+        if (recentSize_ == recent_.size()) {
+            keepOld(recent_[recentStart_]);
+            recent_[recentStart_] = point;
+            recentStart_ = (recentStart_ + 1) % recent_.size();
+        } else {
+            recent_[(recentStart_ + recentSize_) % recent_.size()] = point;
+            ++recentSize_;
+        }
+    }
+
+    /**
+     * @brief Call a function for every point, oldest first
+     */
+    template <typename Function>
+    void forEach(Function function) const {
+        for (size_t i = 0; i < historySize_; ++i) {
+            function(history_[i]);
+        }
+        for (size_t i = 0; i < recentSize_; ++i) {
+            function(recent_[(recentStart_ + i) % recent_.size()]);
+        }
+    }
+
+    /**
+     * @brief Get the latest position (only valid once a point was added)
+     */
+    [[nodiscard]] const TrackPoint& latest() const {
+        return recent_[(recentStart_ + recentSize_ - 1) % recent_.size()];
+    }
+
+   private:
+    /**
+     * @brief Offer a point evicted from the ring to the decimated history
+     */
+    void keepOld(const TrackPoint& point) {
+        if (++evicted_ % stride_ != 0) {
+            return;
+        }
+        if (historySize_ == history_.size()) {
+            // Halve the resolution of the whole history to make room
+            for (size_t i = 1; i < historySize_ / 2; ++i) {
+                history_[i] = history_[i * 2];
+            }
+            historySize_ /= 2;
+            stride_ *= 2;
+            evicted_ = 0;
+        }
+        history_[historySize_++] = point;
+    }
+
+    std::vector<TrackPoint> recent_;   ///< Ring buffer of the latest positions
+    size_t recentStart_{0};            ///< Index of the oldest point in recent_
+    size_t recentSize_{0};             ///< Points in recent_
+    std::vector<TrackPoint> history_;  ///< Decimated older positions, oldest first
+    size_t historySize_{0};            ///< Points in history_
+    size_t stride_{1};                 ///< Only every stride-th evicted point is kept
+    size_t evicted_{0};                ///< Points evicted since the stride last changed
+};
+
+/**
+ * @class TrackMap
+ * @brief Terminal map of the UAV tracks, redrawn incrementally at a fixed frame rate
+ *
+ * Location packets are appended to their UAV's Track from the telemetry
+ * callback. A render thread rasterizes every track into a character grid
+ * (lowercase trail, uppercase latest position, one letter per UAV) and writes
+ * only the cells that differ from the previous frame, in one buffered write.
+ * The map keeps its scale until a point falls outside it, then zooms out.
+ * Memory and rendering cost are bounded by the track capacity and the
+ * terminal size, whatever the flight length or packet rate.
+ */
+class TrackMap {
+   public:
+    /**
+     * @brief Constructor
+     * @param fps Frames per second
+     */
+    explicit TrackMap(int fps) : period_(std::chrono::milliseconds(1000 / fps)) {}
+
+    /**
+     * @brief Destructor - stops the render thread
+     */
+    ~TrackMap() {
+        stop();
+    }
+
+    /**
+     * @brief Start the render thread
+     */
+    void start() {
+        running_ = true;
+        renderThread_ = std::thread([this]() { renderLoop(); });
+    }
+
+    /**
+     * @brief Stop the render thread and move the cursor below the map
+     */
+    void stop() {
+        running_ = false;
+        if (renderThread_.joinable()) {
+            renderThread_.join();
+            std::cout << "\033[" << rows_ + 1 << ";1H" << std::flush;
+        }
+    }
+
+    /**
+     * @brief Record a location packet in its UAV's track (other packets are ignored)
+     * @param uavName UAV the packet came from
+     * @param data Raw telemetry data
+     */
+    void update(const std::string& uavName, const std::vector<uint8_t>& data) {
+        const auto* header = TelemetryClient::parseHeader(data);
+        if (!header || header->packetType != PacketTypes::LOCATION
+            || data.size() < sizeof(PacketHeader) + sizeof(double) * 2 + sizeof(float) * 3) {
+            return;
+        }
+        TrackPoint point;
+        memcpy(&point.latitude, data.data() + sizeof(PacketHeader), sizeof(double));
+        memcpy(&point.longitude, data.data() + sizeof(PacketHeader) + sizeof(double), sizeof(double));
+        if (!std::isfinite(point.latitude) || !std::isfinite(point.longitude)) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto it = tracks_.find(uavName);
+        if (it == tracks_.end()) {
+            // Letters in order of appearance, so a UAV keeps its letter when others join
+            char symbol = static_cast<char>('A' + tracks_.size() % 26);
+            it = tracks_.emplace(uavName, UavTrack{symbol, Track()}).first;
+        }
+        it->second.track.add(point);
+    }
+
+   private:
+    static constexpr int HEADER_ROWS = 2;  ///< Title and legend rows above the map
+
+    static constexpr double RADIANS_PER_DEGREE = 3.14159265358979323846 / 180.0;  ///< M_PI is not standard C++
+
+    /**
+     * @struct UavTrack
+     * @brief Track of one UAV and its map letter
+     */
+    struct UavTrack {
+        char symbol;  ///< Letter of the latest position (lowercase for the trail)
+        Track track;  ///< Position history
+    };
+
+    /**
+     * @brief Redraw the changed cells every frame period until stopped
+     */
+    void renderLoop() {
+        auto next_frame = std::chrono::steady_clock::now();
+        std::string frame;
+        while (running_) {
+            struct winsize window {};
+            int rows = 24;
+            int cols = 80;
+            if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &window) == 0 && window.ws_row > HEADER_ROWS + 4
+                && window.ws_col > 20) {
+                rows = window.ws_row - 1;  // Keep the last line free so the terminal never scrolls
+                cols = window.ws_col;
+            }
+            if (rows != rows_ || cols != cols_) {
+                // New terminal size: start from a blank screen
+                rows_ = rows;
+                cols_ = cols;
+                shown_.assign(static_cast<size_t>(rows_) * cols_, ' ');
+                frame += "\033[2J";
+            }
+            cells_.assign(shown_.size(), ' ');
+            rasterize();
+
+            // Emit only the changed cells, moving the cursor once per run of changes
+            for (int row = 0; row < rows_; ++row) {
+                int col = 0;
+                while (col < cols_) {
+                    size_t index = static_cast<size_t>(row) * cols_ + col;
+                    if (cells_[index] == shown_[index]) {
+                        ++col;
+                        continue;
+                    }
+                    frame += "\033[" + std::to_string(row + 1) + ";" + std::to_string(col + 1) + "H";
+                    while (col < cols_ && cells_[index] != shown_[index]) {
+                        frame += cells_[index];
+                        ++col;
+                        ++index;
+                    }
+                }
+            }
+            shown_.swap(cells_);
+            if (!frame.empty()) {
+                std::cout.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+                std::cout.flush();
+                frame.clear();
+            }
+
+            next_frame += period_;
+            std::this_thread::sleep_until(next_frame);
+        }
+    }
+
+    /**
+     * @brief Draw the header, legend and every track into cells_
+     *
+     * Works on a copy of the tracks taken under the lock, so the telemetry
+     * callback only waits for the copy, not for the drawing.
+     */
+    void rasterize() {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            snapshot_ = tracks_;  // Reuses the snapshot's nodes and buffers from the previous frame
+        }
+        int map_rows = rows_ - HEADER_ROWS;
+
+        // Grow the map area to hold every point, with a margin so it does not change every frame
+        bool first = !hasBounds_;
+        for (const auto& [name, uav] : snapshot_) {
+            uav.track.forEach([&](const TrackPoint& point) {
+                if (!hasBounds_) {
+                    minLat_ = maxLat_ = point.latitude;
+                    minLon_ = maxLon_ = point.longitude;
+                    hasBounds_ = true;
+                } else if (point.latitude < minLat_ || point.latitude > maxLat_ || point.longitude < minLon_
+                           || point.longitude > maxLon_) {
+                    double lat_margin = std::max(maxLat_ - minLat_, 0.001) * 0.25;
+                    double lon_margin = std::max(maxLon_ - minLon_, 0.001) * 0.25;
+                    minLat_ = std::min(minLat_, point.latitude - lat_margin);
+                    maxLat_ = std::max(maxLat_, point.latitude + lat_margin);
+                    minLon_ = std::min(minLon_, point.longitude - lon_margin);
+                    maxLon_ = std::max(maxLon_, point.longitude + lon_margin);
+                }
+            });
+        }
+        if (first && hasBounds_) {
+            minLat_ -= 0.001;
+            maxLat_ += 0.001;
+            minLon_ -= 0.001;
+            maxLon_ += 0.001;
+        }
+
+        // Equal distances per cell in both directions; a terminal cell is about twice as high as wide
+        double center_lat = (minLat_ + maxLat_) / 2;
+        double center_lon = (minLon_ + maxLon_) / 2;
+        double lon_factor = std::max(std::cos(center_lat * RADIANS_PER_DEGREE), 0.01);
+        double degrees_per_row =
+            std::max((maxLat_ - minLat_) / map_rows, (maxLon_ - minLon_) * lon_factor / (cols_ / 2.0));
+        if (degrees_per_row <= 0) {
+            degrees_per_row = 1e-5;
+        }
+        auto to_cell = [&](const TrackPoint& point) {
+            double rows_up = (point.latitude - center_lat) / degrees_per_row;
+            double cols_right = (point.longitude - center_lon) * lon_factor * 2 / degrees_per_row;
+            int row = map_rows / 2 - static_cast<int>(std::lround(rows_up));
+            int col = cols_ / 2 + static_cast<int>(std::lround(cols_right));
+            return std::make_pair(std::clamp(row, 0, map_rows - 1), std::clamp(col, 0, cols_ - 1));
+        };
+        auto put = [&](int row, int col, char symbol) {
+            cells_[static_cast<size_t>(row + HEADER_ROWS) * cols_ + col] = symbol;
+        };
+        auto text = [&](int row, const std::string& line) {
+            for (size_t col = 0; col < line.size() && col < static_cast<size_t>(cols_); ++col) {
+                cells_[static_cast<size_t>(row) * cols_ + col] = line[col];
+            }
+        };
+
+        std::ostringstream title;
+        title << "Mapping UI tracks - " << GetTimestamp().substr(11, 8) << " - " << snapshot_.size() << " UAV(s)";
+        if (hasBounds_) {
+            title << std::fixed << std::setprecision(4) << " - lat " << minLat_ << ".." << maxLat_ << " lon "
+                  << minLon_ << ".." << maxLon_ << " - " << std::setprecision(0)
+                  << degrees_per_row * 111000.0 << " m/row";
+        }
+        text(0, title.str());
+
+        std::string legend;
+        for (const auto& [name, uav] : snapshot_) {
+            legend += std::string(1, uav.symbol) + "=" + name + "  ";
+            // Trail as Bresenham lines between consecutive points, the latest position on top
+            bool has_previous = false;
+            std::pair<int, int> previous;
+            char trail = static_cast<char>(std::tolower(uav.symbol));
+            uav.track.forEach([&](const TrackPoint& point) {
+                auto cell = to_cell(point);
+                if (has_previous) {
+                    auto [row, col] = previous;
+                    int d_row = std::abs(cell.first - row);
+                    int d_col = -std::abs(cell.second - col);
+                    int step_row = row < cell.first ? 1 : -1;
+                    int step_col = col < cell.second ? 1 : -1;
+                    int error = d_row + d_col;
+                    while (true) {
+                        put(row, col, trail);
+                        if (row == cell.first && col == cell.second) {
+                            break;
+                        }
+                        int doubled = 2 * error;
+                        if (doubled >= d_col) {
+                            error += d_col;
+                            row += step_row;
+                        }
+                        if (doubled <= d_row) {
+                            error += d_row;
+                            col += step_col;
+                        }
+                    }
+                } else {
+                    put(cell.first, cell.second, trail);
+                }
+                previous = cell;
+                has_previous = true;
+            });
+            auto head = to_cell(uav.track.latest());
+            put(head.first, head.second, uav.symbol);
+        }
+        text(1, legend);
+    }
+
+    std::chrono::milliseconds period_;          ///< Frame period
+    std::mutex mutex_;                          ///< Guards tracks_
+    std::map<std::string, UavTrack> tracks_;    ///< UAV name -> track (sorted for the legend)
+    std::map<std::string, UavTrack> snapshot_;  ///< Copy of tracks_ being drawn (render thread only)
+    bool hasBounds_{false};                     ///< Map bounds set by the first point
+    double minLat_{0}, maxLat_{0};              ///< Latitude range of the map
+    double minLon_{0}, maxLon_{0};              ///< Longitude range of the map
+    int rows_{0}, cols_{0};                     ///< Terminal size of the current layout
+    std::string cells_;                         ///< Frame being drawn (rows_ x cols_)
+    std::string shown_;                         ///< Frame currently on screen
+    std::atomic<bool> running_{false};          ///< Render thread keeps running while set
+    std::thread renderThread_;                  ///< Render thread
+};
+
 /**
  * @brief Main function - Mapping UI application entry point
  */
@@ -206,6 +601,12 @@ int main(int argc, char* argv[]) {
     bool locationOnly = false;      // Subscribe only to location data
     bool statusOnly = false;        // Subscribe only to status data
     bool debugMode = false;         // Enable debug output
+    bool dashboardMode = false;     // Redraw a per-UAV table instead of printing every packet
+    int dashboardFps = 10;          // Dashboard refresh rate
+    bool statsMode = false;         // Print per-topic statistics once a second instead of every packet
+    bool tracksMode = false;        // Draw the UAV tracks on a terminal map instead of printing every packet
+    bool areaMode = false;          // Poll the UAVs inside a box instead of subscribing
+    double area[4] = {0, 0, 0, 0};  // min_lat, min_lon, max_lat, max_lon
     std::string target_uav;
 
     for (int i = 1; i < argc; i++) {
@@ -222,6 +623,19 @@ int main(int argc, char* argv[]) {
             statusOnly = true;
         } else if (std::string(argv[i]) == "--debug") {
             debugMode = true;
+        } else if (std::string(argv[i]) == "--dashboard") {
+            dashboardMode = true;
+        } else if (std::string(argv[i]) == "--fps" && i + 1 < argc) {
+            dashboardFps = std::atoi(argv[++i]);
+        } else if (std::string(argv[i]) == "--stats") {
+            statsMode = true;
+        } else if (std::string(argv[i]) == "--tracks") {
+            tracksMode = true;
+        } else if (std::string(argv[i]) == "--area" && i + 4 < argc) {
+            areaMode = true;
+            for (double& edge : area) {
+                edge = std::atof(argv[++i]);
+            }
         } else if (std::string(argv[i]) == "--help") {
             std::cout << "Mapping UI - UAV Location Tracking\n";
             std::cout << "Usage: " << argv[0] << " [options]\n";
@@ -232,6 +646,13 @@ int main(int argc, char* argv[]) {
             std::cout << "  --location-only    : Subscribe only to location data (telemetry.*.*.location)\n";
             std::cout << "  --status-only      : Subscribe only to status data (telemetry.*.*.status)\n";
             std::cout << "  --debug            : Enable debug output to see internal filtering\n";
+            std::cout << "  --dashboard        : Per-UAV table redrawn at a fixed rate, no per-packet output\n";
+            std::cout << "  --fps N            : Dashboard refresh rate, 1-60 (default: 10)\n";
+            std::cout << "  --stats            : Headless: per-topic rate, bytes/s, jitter, errors per second\n";
+            std::cout << "  --tracks           : Draw the UAV tracks on a terminal map (refreshed at --fps)\n";
+            std::cout << "  --area MIN_LAT MIN_LON MAX_LAT MAX_LON\n";
+            std::cout << "                     : Show only the UAVs inside this box, asked from the service once a\n";
+            std::cout << "                       second (tcp only, needs \"state_store\" in the service config)\n";
             std::cout << "  --help             : Show this help message\n";
             std::cout << "\nSubscription modes:\n";
             std::cout << "  Default: Mapping data only (telemetry.*.mapping.*)\n";
@@ -255,6 +676,26 @@ int main(int argc, char* argv[]) {
         std::cerr << "Error: --all-targets, --location-only, and --status-only are mutually exclusive\n";
         return 1;
     }
+    if (areaMode && (modeCount > 0 || protocol != "tcp")) {
+        std::cerr << "Error: --area needs tcp and cannot be combined with subscription modes\n";
+        return 1;
+    }
+    if (dashboardMode && (enableSender || areaMode)) {
+        std::cerr << "Error: --dashboard cannot be combined with --send or --area\n";
+        return 1;
+    }
+    if (statsMode && (dashboardMode || areaMode)) {
+        std::cerr << "Error: --stats cannot be combined with --dashboard or --area\n";
+        return 1;
+    }
+    if (tracksMode && (dashboardMode || statsMode || enableSender || areaMode)) {
+        std::cerr << "Error: --tracks cannot be combined with --dashboard, --stats, --send or --area\n";
+        return 1;
+    }
+    if (dashboardFps < 1 || dashboardFps > 60) {
+        std::cerr << "Error: --fps must be 1-60\n";
+        return 1;
+    }
 
     // Validate protocol argument
     Protocol client_protocol;
@@ -274,7 +715,10 @@ int main(int argc, char* argv[]) {
     if (enableSender) {
         std::cout << "Command target: " << target_uav << std::endl;
     }
-    if (enableAllTargets) {
+    if (areaMode) {
+        std::cout << "Mode: UAVs in area " << area[0] << "," << area[1] << " .. " << area[2] << "," << area[3]
+                  << std::endl;
+    } else if (enableAllTargets) {
         std::cout << "Mode: Monitoring ALL target types (camera, mapping)" << std::endl;
     } else if (locationOnly) {
         std::cout << "Mode: Location data only from all UAVs and targets" << std::endl;
@@ -286,6 +730,15 @@ int main(int argc, char* argv[]) {
     if (debugMode) {
         std::cout << "Debug: Enabled (will show internal filtering messages)" << std::endl;
     }
+    if (dashboardMode) {
+        std::cout << "Display: dashboard at " << dashboardFps << " frames per second" << std::endl;
+    }
+    if (statsMode) {
+        std::cout << "Display: per-topic statistics once a second (no per-packet output)" << std::endl;
+    }
+    if (tracksMode) {
+        std::cout << "Display: track map at " << dashboardFps << " frames per second" << std::endl;
+    }
     std::cout << std::endl;
 
     // Enable debug mode if requested
@@ -293,13 +746,42 @@ int main(int argc, char* argv[]) {
         setenv("TELEMETRY_DEBUG", "1", 1);  // Set environment variable for library
     }
 
+    // The dashboard is created before the client, whose callbacks use it
+    std::unique_ptr<Dashboard> dashboard;
+    if (dashboardMode) {
+        dashboard = std::make_unique<Dashboard>(
+            "🗺️ Mapping UI", dashboardFps,
+            std::vector<std::string>{"Idle", "Takeoff", "Mapping", "Landing", "Emergency"}, 7);
+    }
+    Dashboard* board = dashboard.get();
+    std::unique_ptr<TopicStats> stats;
+    if (statsMode) {
+        stats = std::make_unique<TopicStats>();
+    }
+    TopicStats* counters = stats.get();
+    std::unique_ptr<TrackMap> trackMap;
+    if (tracksMode) {
+        trackMap = std::make_unique<TrackMap>(dashboardFps);
+    }
+    TrackMap* map = trackMap.get();
+
     // Create telemetry client
     TelemetryClient client("mapping_ui");
 
     // Set up connection status callback
-    client.setConnectionCallback([](bool connected, const std::string& error_message) {
-        if (connected) {
-            std::cout << "✅ Connected to telemetry service" << std::endl;
+    client.setConnectionCallback([board, map](bool connected, const std::string& error_message) {
+        if (map) {
+            return;  // The map only redraws changed cells and would not paint over the message
+        }
+        if (board) {
+            board->setNotice((connected ? "Connected to telemetry service " : "Disconnected from telemetry service ")
+                             + error_message);
+        } else if (connected) {
+            std::cout << "✅ Connected to telemetry service";
+            if (!error_message.empty()) {
+                std::cout << " - " << error_message;  // e.g. "Reconnected after 1200 ms"
+            }
+            std::cout << std::endl;
         } else {
             std::cout << "❌ Disconnected from telemetry service";
             if (!error_message.empty()) {
@@ -311,8 +793,21 @@ int main(int argc, char* argv[]) {
 
     // Set up telemetry data callback
     client.setTelemetryCallback(
-        [enableAllTargets, locationOnly, statusOnly](const std::string& topic, const std::vector<uint8_t>& data) {
+        [enableAllTargets, locationOnly, statusOnly, board, counters, map](const std::string& topic,
+                                                                           const std::vector<uint8_t>& data) {
             int count = g_packet_count.fetch_add(1) + 1;
+            if (map) {
+                map->update(extractUAVName(topic), data);
+                return;
+            }
+            if (counters) {
+                counters->record(topic, data.size(), !isDecodable(data));
+                return;
+            }
+            if (board) {
+                board->update(topic, data);
+                return;
+            }
             std::string uav_name = extractUAVName(topic);
 
             std::cout << std::endl;
@@ -377,7 +872,10 @@ int main(int argc, char* argv[]) {
     std::cout << std::endl;
     std::cout << "Subscribing to telemetry..." << std::endl;
 
-    if (locationOnly) {
+    if (areaMode) {
+        // Nothing to subscribe to: the service answers area queries from its spatial index
+        std::cout << "✅ Querying the service for the watched area" << std::endl;
+    } else if (locationOnly) {
         // Subscribe only to location data from all UAVs and targets
         if (client.subscribe("telemetry.*.*.location")) {
             std::cout << "✅ Subscribed to location data: telemetry.*.*.location" << std::endl;
@@ -408,7 +906,9 @@ int main(int argc, char* argv[]) {
     }
 
     std::cout << std::endl;
-    if (locationOnly) {
+    if (areaMode) {
+        std::cout << "🗺️ Mapping UI ready - tracking UAVs in the watched area..." << std::endl;
+    } else if (locationOnly) {
         std::cout << "🗺️ Mapping UI ready - tracking location data from all UAVs..." << std::endl;
     } else if (statusOnly) {
         std::cout << "🗺️ Mapping UI ready - tracking status data from all UAVs..." << std::endl;
@@ -419,6 +919,12 @@ int main(int argc, char* argv[]) {
     }
     std::cout << "Press Ctrl+C to stop" << std::endl;
     std::cout << "===============================================" << std::endl;
+    if (dashboard) {
+        dashboard->start();
+    }
+    if (trackMap) {
+        trackMap->start();
+    }
 
     // Start command sender thread if enabled
     std::thread senderThread;
@@ -455,7 +961,9 @@ int main(int argc, char* argv[]) {
                             // Check for subscription management commands
                             std::istringstream iss(line);
                             std::string command, topic;
-                            iss >> command >> topic;
+                            iss >> command;
+                            // Rest of the line: "?<filter>" suffixes may contain spaces
+                            std::getline(iss >> std::ws, topic);
 
                             if (command == "sub" && !topic.empty()) {
                                 if (client.subscribe(topic)) {
@@ -476,11 +984,24 @@ int main(int argc, char* argv[]) {
                                 std::cout << "📋 [" << GetTimestamp() << "] Current subscriptions:" << std::endl;
                                 std::cout << "   (Note: Use --debug to see internal subscription details)" << std::endl;
                             } else {
-                                // Regular navigation command
-                                if (client.sendCommand(target_uav, line)) {
+                                // Regular navigation command. A single UAV acknowledges it and the outcome and
+                                // round trip are printed when they arrive; group targets are fire-and-forget.
+                                std::string sent_line = line;
+                                auto on_result = [target_uav, sent_line](const CommandResult& result) {
+                                    static const char* const status_names[] = {
+                                        "acknowledged", "rejected", "timed out", "undelivered"};
+                                    std::cout << (result.status == CommandStatus::ACKNOWLEDGED ? "📬 [" : "⚠️  [")
+                                              << GetTimestamp() << "] " << target_uav << " " << sent_line << ": "
+                                              << status_names[static_cast<int>(result.status)] << " ("
+                                              << result.round_trip.count() / 1000.0 << " ms)" << std::endl;
+                                };
+                                bool group_target = target_uav == "*" || target_uav.find(':') != std::string::npos;
+                                bool sent = group_target ? client.sendCommand(target_uav, line)
+                                                         : client.sendCommandWithAck(target_uav, line, on_result);
+                                if (sent) {
                                     std::cout << "✅ [" << GetTimestamp() << "] Sent navigation command to "
                                               << target_uav << ": " << line << std::endl;
-                                } else {
+                                } else if (group_target) {
                                     std::cout << "❌ [" << GetTimestamp() << "] Failed to send command: " << line
                                               << std::endl;
                                 }
@@ -496,11 +1017,28 @@ int main(int argc, char* argv[]) {
         std::cout << "⚠️ Command sending not supported with UDP protocol" << std::endl;
     }
 
-    // Main loop - just wait for shutdown signal
+    // Main loop - wait for shutdown signal (refreshing the watched area or printing the statistics once a second)
+    auto next_area_query = std::chrono::steady_clock::now();
+    auto last_report = next_area_query;
     while (g_running && client.isConnected()) {
+        auto now = std::chrono::steady_clock::now();
+        if (areaMode && now >= next_area_query) {
+            displayAreaQueryResult(client.queryBox(area[0], area[1], area[2], area[3]).get());
+            next_area_query += std::chrono::seconds(1);
+        }
+        if (stats && now - last_report >= std::chrono::seconds(1)) {
+            stats->report(std::chrono::duration<double>(now - last_report).count());
+            last_report = now;
+        }
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
+    if (dashboard) {
+        dashboard->stop();
+    }
+    if (trackMap) {
+        trackMap->stop();
+    }
     std::cout << std::endl;
     std::cout << "🔄 Shutting down Mapping UI..." << std::endl;
 
@@ -0,0 +1,165 @@
+/**
+ * @file BatchDecoder.h
+ * @brief Batch decoding of location and status payloads into column buffers
+ *
+ * This header defines structure-of-arrays buffers for location and status
+ * telemetry and a decoder that fills them from many packets at once. On x86-64
+ * CPUs with AVX2 the decoder uses vector gathers (four records per step); other
+ * CPUs use a scalar loop. Both produce identical results.
+ */
+
+#ifndef BATCH_DECODER_H
+#define BATCH_DECODER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "PacketViews.h"
+#include "TelemetryClient.h"
+
+namespace TelemetryAPI {
+
+    /**
+     * @brief Location payloads as one array per field
+     *
+     * Row i of every array belongs to the same packet.
+     */
+    struct LocationBatch {
+        std::vector<double> latitude;   ///< Latitude in decimal degrees
+        std::vector<double> longitude;  ///< Longitude in decimal degrees
+        std::vector<float> altitude;    ///< Altitude in meters above sea level
+        std::vector<float> heading;     ///< Heading in degrees (0-359)
+        std::vector<float> speed;       ///< Ground speed in m/s
+
+        /**
+         * @brief Get the number of rows
+         */
+        [[nodiscard]] size_t size() const {
+            return latitude.size();
+        }
+
+        /**
+         * @brief Remove all rows (keeps the capacity for the next batch)
+         */
+        void clear() {
+            resize(0);
+        }
+
+        /**
+         * @brief Resize every array to the same number of rows
+         * @param rows New number of rows
+         */
+        void resize(size_t rows) {
+            latitude.resize(rows);
+            longitude.resize(rows);
+            altitude.resize(rows);
+            heading.resize(rows);
+            speed.resize(rows);
+        }
+    };
+
+    /**
+     * @brief Status payloads as one array per field
+     *
+     * Row i of every array belongs to the same packet.
+     */
+    struct StatusBatch {
+        std::vector<uint8_t> systemHealth;  ///< System health (0: Critical, 1: Warning, 2: Good, 3: Excellent)
+        std::vector<uint8_t> missionState;  ///< Mission state (see StatusPayload::missionState)
+        std::vector<uint16_t> flightTime;   ///< Flight time in seconds
+        std::vector<float> cpuUsage;        ///< CPU usage percentage (0.0-100.0)
+        std::vector<float> memoryUsage;     ///< Memory usage percentage (0.0-100.0)
+
+        /**
+         * @brief Get the number of rows
+         */
+        [[nodiscard]] size_t size() const {
+            return systemHealth.size();
+        }
+
+        /**
+         * @brief Remove all rows (keeps the capacity for the next batch)
+         */
+        void clear() {
+            resize(0);
+        }
+
+        /**
+         * @brief Resize every array to the same number of rows
+         * @param rows New number of rows
+         */
+        void resize(size_t rows) {
+            systemHealth.resize(rows);
+            missionState.resize(rows);
+            flightTime.resize(rows);
+            cpuUsage.resize(rows);
+            memoryUsage.resize(rows);
+        }
+    };
+
+    /**
+     * @class BatchDecoder
+     * @brief Transposes packed payloads into LocationBatch / StatusBatch buffers
+     *
+     * All functions append to the output batch, so one batch can collect several
+     * calls; call clear() to reuse its memory. The input is never modified and
+     * may sit at any alignment.
+     *
+     * Example usage:
+     * ```cpp
+     * TelemetryAPI::LocationBatch batch;
+     * TelemetryAPI::BatchDecoder::decodeLocations(packets, batch);  // std::vector<PacketView>
+     * float peak = *std::max_element(batch.altitude.begin(), batch.altitude.end());
+     * ```
+     */
+    class TELEMETRY_API BatchDecoder {
+       public:
+        /**
+         * @brief Decode location payloads laid out at a fixed stride
+         * @param data First byte of the first payload
+         * @param count Number of payloads
+         * @param stride Distance between payloads in bytes (sizeof(LocationPayload) when tightly packed,
+         *               sizeof(PacketHeader) + sizeof(LocationPayload) for whole packets)
+         * @param out Batch the rows are appended to
+         */
+        static void decodeLocations(const uint8_t* data, size_t count, size_t stride, LocationBatch& out);
+
+        /**
+         * @brief Decode status payloads laid out at a fixed stride
+         * @param data First byte of the first payload
+         * @param count Number of payloads
+         * @param stride Distance between payloads in bytes
+         * @param out Batch the rows are appended to
+         */
+        static void decodeStatuses(const uint8_t* data, size_t count, size_t stride, StatusBatch& out);
+
+        /**
+         * @brief Decode the location packets among scattered packets
+         * @param packets Packets of any type (e.g. journal records or received messages)
+         * @param out Batch the rows are appended to
+         * @return Number of rows appended (packets of other types or too short are skipped)
+         */
+        static size_t decodeLocations(const std::vector<PacketView>& packets, LocationBatch& out);
+
+        /**
+         * @brief Decode the status packets among scattered packets
+         * @param packets Packets of any type
+         * @param out Batch the rows are appended to
+         * @return Number of rows appended (packets of other types or too short are skipped)
+         */
+        static size_t decodeStatuses(const std::vector<PacketView>& packets, StatusBatch& out);
+
+        /**
+         * @brief Get the code path selected for this CPU
+         * @return "avx2" or "scalar"
+         *
+         * Setting TELEMETRY_BATCH_DECODER=scalar in the environment forces the
+         * scalar path (for comparisons and debugging).
+         */
+        static const char* implementation();
+    };
+
+}  // namespace TelemetryAPI
+
+#endif  // BATCH_DECODER_H
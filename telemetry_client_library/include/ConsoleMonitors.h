@@ -0,0 +1,462 @@
+/**
+ * @file ConsoleMonitors.h
+ * @brief Console views of the telemetry stream shared by the UI applications
+ *
+ * This header defines the full-screen per-UAV dashboard and the per-topic
+ * statistics used by the camera and mapping UIs. Header-only; it uses only the
+ * static helpers of TelemetryClient.
+ */
+
+#ifndef CONSOLE_MONITORS_H
+#define CONSOLE_MONITORS_H
+
+#if !defined(_WIN32)
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "TelemetryClient.h"
+
+namespace TelemetryAPI {
+
+    namespace detail {
+
+        /**
+         * @brief Format the current local time as "YYYY-MM-DD HH:MM:SS.mmm"
+         */
+        inline std::string consoleTimestamp() {
+            const auto now = std::chrono::system_clock::now();
+            const auto time_t_now = std::chrono::system_clock::to_time_t(now);
+            const auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(now.time_since_epoch()) % 1000;
+
+            struct tm time_info;
+#if defined(_WIN32)
+            localtime_s(&time_info, &time_t_now);
+#else
+            localtime_r(&time_t_now, &time_info);
+#endif
+            std::ostringstream oss;
+            oss << std::put_time(&time_info, "%Y-%m-%d %H:%M:%S") << '.' << std::setfill('0') << std::setw(3)
+                << ms.count();
+            return oss.str();
+        }
+
+    }  // namespace detail
+
+    /**
+     * @brief Check whether a packet decodes (valid header and, for known types, a complete payload)
+     * @param data Raw telemetry data
+     */
+    inline bool isDecodable(const std::vector<uint8_t>& data) {
+        const auto* header = TelemetryClient::parseHeader(data);
+        if (!header) {
+            return false;
+        }
+        switch (header->packetType) {
+            case PacketTypes::LOCATION:
+                return data.size() >= sizeof(PacketHeader) + sizeof(double) * 2 + sizeof(float) * 3;
+            case PacketTypes::STATUS:
+                return data.size() >=
+                       sizeof(PacketHeader) + sizeof(uint8_t) * 2 + sizeof(uint16_t) + sizeof(float) * 2;
+            default:
+                return true;
+        }
+    }
+
+    /**
+     * @class TopicStats
+     * @brief Lock-free per-topic packet counters for the headless --stats mode
+     *
+     * A fixed table of atomic counters, addressed by topic hash with linear
+     * probing. A new topic claims a free slot with a compare-and-swap, so
+     * recording a packet never takes a lock and never allocates after the topic's
+     * first packet. The inter-arrival jitter is the RFC 3550 estimator applied to
+     * arrival gaps (J += (|D| - J) / 16, with D the change between consecutive
+     * gaps); it assumes, like the client, one receive thread per topic.
+     */
+    class TopicStats {
+       public:
+        /**
+         * @brief Count one packet (called from the telemetry callback)
+         * @param topic Topic the packet arrived on
+         * @param bytes Packet size
+         * @param decodeError true if the packet did not decode
+         */
+        void record(const std::string& topic, size_t bytes, bool decodeError) {
+            Counter* counter = find(topic);
+            if (!counter) {
+                untracked_.fetch_add(1, std::memory_order_relaxed);
+                return;
+            }
+            counter->packets.fetch_add(1, std::memory_order_relaxed);
+            counter->bytes.fetch_add(bytes, std::memory_order_relaxed);
+            if (decodeError) {
+                counter->decodeErrors.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            int64_t now_us = std::chrono::duration_cast<std::chrono::microseconds>(
+                                 std::chrono::steady_clock::now().time_since_epoch())
+                                 .count();
+            int64_t last_us = counter->lastArrivalUs.exchange(now_us, std::memory_order_relaxed);
+            if (last_us != 0) {
+                int64_t gap_us = now_us - last_us;
+                int64_t previous_gap_us = counter->lastGapUs.exchange(gap_us, std::memory_order_relaxed);
+                if (previous_gap_us != 0) {
+                    // Jitter is kept scaled by 16 so the 1/16 gain stays in integers
+                    int64_t change_us = gap_us > previous_gap_us ? gap_us - previous_gap_us : previous_gap_us - gap_us;
+                    int64_t jitter = counter->jitterUs16.load(std::memory_order_relaxed);
+                    counter->jitterUs16.store(jitter + change_us - ((jitter + 8) >> 4), std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /**
+         * @brief Print one line per topic with the rates since the previous report
+         * @param elapsedSeconds Time since the previous report
+         */
+        void report(double elapsedSeconds) {
+            struct Line {
+                const std::string* topic;
+                uint64_t packets, bytes, errors;
+                double jitterMs;
+            };
+            std::vector<Line> lines;
+            uint64_t untracked = untracked_.load(std::memory_order_relaxed);
+            uint64_t total_packets = untracked;
+            for (auto& counter : counters_) {
+                if (!counter.ready.load(std::memory_order_acquire)) {
+                    continue;
+                }
+                uint64_t packets = counter.packets.load(std::memory_order_relaxed);
+                uint64_t bytes = counter.bytes.load(std::memory_order_relaxed);
+                uint64_t errors = counter.decodeErrors.load(std::memory_order_relaxed);
+                total_packets += packets;
+                double jitter_ms = counter.jitterUs16.load(std::memory_order_relaxed) / 16.0 / 1000.0;
+                lines.push_back(Line{&counter.topic, packets - counter.reportedPackets, bytes - counter.reportedBytes,
+                                     errors - counter.reportedErrors, jitter_ms});
+                counter.reportedPackets = packets;
+                counter.reportedBytes = bytes;
+                counter.reportedErrors = errors;
+            }
+            std::sort(lines.begin(), lines.end(), [](const Line& a, const Line& b) { return *a.topic < *b.topic; });
+
+            std::ostringstream out;
+            out << "📈 [" << detail::consoleTimestamp() << "] " << lines.size() << " topic(s), " << total_packets
+                << " packets total";
+            if (untracked > 0) {
+                out << ", " << untracked << " on untracked topics (table full)";
+            }
+            out << "\n" << std::fixed;
+            for (const auto& line : lines) {
+                out << "   " << std::left << std::setw(40) << *line.topic << std::right << std::setprecision(1)
+                    << std::setw(9) << line.packets / elapsedSeconds << " pkt/s" << std::setprecision(0)
+                    << std::setw(11) << line.bytes / elapsedSeconds << " B/s" << "  jitter " << std::setprecision(2)
+                    << std::setw(8) << line.jitterMs << " ms" << "  decode errors " << line.errors << "\n";
+            }
+            std::cout << out.str() << std::flush;
+        }
+
+       private:
+        static constexpr size_t CAPACITY = 1024;  ///< Distinct topics tracked
+
+        /**
+         * @struct Counter
+         * @brief Counters of one topic
+         */
+        struct Counter {
+            std::atomic<size_t> hash{0};            ///< Topic hash (0 = free slot)
+            std::atomic<bool> ready{false};         ///< topic is written and may be read
+            std::string topic;                      ///< Topic (written once, before ready is set)
+            std::atomic<uint64_t> packets{0};       ///< Packets received
+            std::atomic<uint64_t> bytes{0};         ///< Bytes received
+            std::atomic<uint64_t> decodeErrors{0};  ///< Packets that did not decode
+            std::atomic<int64_t> lastArrivalUs{0};  ///< Arrival of the latest packet (steady clock)
+            std::atomic<int64_t> lastGapUs{0};      ///< Latest inter-arrival gap
+            std::atomic<int64_t> jitterUs16{0};     ///< Inter-arrival jitter in microseconds, times 16
+            uint64_t reportedPackets{0};            ///< packets at the previous report (reporting thread only)
+            uint64_t reportedBytes{0};              ///< bytes at the previous report (reporting thread only)
+            uint64_t reportedErrors{0};             ///< decodeErrors at the previous report (reporting thread only)
+        };
+
+        /**
+         * @brief Find the topic's counter, claiming a free slot on its first packet
+         * @return Counter, or nullptr if the table is full
+         */
+        Counter* find(const std::string& topic) {
+            size_t hash = std::hash<std::string>{}(topic) | 1;  // Never 0, which marks a free slot
+            for (size_t probe = 0; probe < CAPACITY; ++probe) {
+                Counter& counter = counters_[(hash + probe) % CAPACITY];
+                size_t slot_hash = counter.hash.load(std::memory_order_acquire);
+                if (slot_hash == 0) {
+                    size_t expected = 0;
+                    if (counter.hash.compare_exchange_strong(expected, hash, std::memory_order_acq_rel)) {
+                        counter.topic = topic;
+                        counter.ready.store(true, std::memory_order_release);
+                        return &counter;
+                    }
+                    slot_hash = expected;  // Claimed by another thread meanwhile
+                }
+                if (slot_hash == hash) {
+                    while (!counter.ready.load(std::memory_order_acquire)) {
+                        std::this_thread::yield();  // Another thread is writing the topic
+                    }
+                    if (counter.topic == topic) {
+                        return &counter;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        std::array<Counter, CAPACITY> counters_;  ///< Hash table of counters
+        std::atomic<uint64_t> untracked_{0};      ///< Packets not counted because the table was full
+    };
+
+    /**
+     * @class Dashboard
+     * @brief Full-screen table of the latest state per UAV, redrawn at a fixed frame rate
+     *
+     * Telemetry callbacks only decode the packet into the UAV's row under a mutex;
+     * a render thread formats the whole screen into one string and writes it with
+     * a single flush per frame. The console cost therefore depends on the refresh
+     * rate and the number of UAVs, not on the packet rate, and the client's
+     * receive thread never waits for the terminal.
+     */
+    class Dashboard {
+       public:
+        /**
+         * @brief Constructor
+         * @param title Title shown in the first line of every frame
+         * @param fps Frames per second
+         * @param missionNames Display names of the STATUS mission states, indexed by state
+         * @param coordinatePrecision Decimal places shown for latitude and longitude
+         */
+        Dashboard(std::string title, int fps, std::vector<std::string> missionNames, int coordinatePrecision = 6)
+            : title_(std::move(title)),
+              period_(std::chrono::milliseconds(1000 / fps)),
+              missionNames_(std::move(missionNames)),
+              coordinatePrecision_(coordinatePrecision) {}
+
+        /**
+         * @brief Destructor - stops the render thread
+         */
+        ~Dashboard() {
+            stop();
+        }
+
+        /**
+         * @brief Start the render thread
+         */
+        void start() {
+            running_ = true;
+            renderThread_ = std::thread([this]() { renderLoop(); });
+        }
+
+        /**
+         * @brief Stop the render thread (the last frame stays on screen)
+         */
+        void stop() {
+            running_ = false;
+            if (renderThread_.joinable()) {
+                renderThread_.join();
+            }
+        }
+
+        /**
+         * @brief Show a one-line notice (e.g. connection changes) below the title
+         */
+        void setNotice(const std::string& notice) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            notice_ = detail::consoleTimestamp() + " " + notice;
+        }
+
+        /**
+         * @brief Record a telemetry packet in its UAV's row (called from the telemetry callback)
+         * @param topic Topic the packet arrived on
+         * @param data Raw telemetry data
+         */
+        void update(const std::string& topic, const std::vector<uint8_t>& data) {
+            // "telemetry.<UAV>.<target>.<type>"
+            size_t first_dot = topic.find('.');
+            size_t second_dot = first_dot == std::string::npos ? first_dot : topic.find('.', first_dot + 1);
+            std::string uav_name =
+                second_dot == std::string::npos ? topic : topic.substr(first_dot + 1, second_dot - first_dot - 1);
+            const auto* header = TelemetryClient::parseHeader(data);
+            constexpr size_t LOCATION_SIZE = sizeof(PacketHeader) + sizeof(double) * 2 + sizeof(float) * 3;
+            constexpr size_t STATUS_SIZE =
+                sizeof(PacketHeader) + sizeof(uint8_t) * 2 + sizeof(uint16_t) + sizeof(float) * 2;
+
+            std::lock_guard<std::mutex> lock(mutex_);
+            UavRow& row = rows_[uav_name];
+            ++row.packets;
+            row.lastUpdate = std::chrono::steady_clock::now();
+            if (!header) {
+                ++row.invalid;
+                return;
+            }
+            row.target = TelemetryClient::getTargetName(header->targetID);
+            const uint8_t* payload = data.data() + sizeof(PacketHeader);
+            if (header->packetType == PacketTypes::LOCATION && data.size() >= LOCATION_SIZE) {
+                memcpy(&row.latitude, payload, sizeof(double));
+                memcpy(&row.longitude, payload + sizeof(double), sizeof(double));
+                memcpy(&row.altitude, payload + sizeof(double) * 2, sizeof(float));
+                memcpy(&row.heading, payload + sizeof(double) * 2 + sizeof(float), sizeof(float));
+                memcpy(&row.speed, payload + sizeof(double) * 2 + sizeof(float) * 2, sizeof(float));
+                row.hasLocation = true;
+            } else if (header->packetType == PacketTypes::STATUS && data.size() >= STATUS_SIZE) {
+                row.health = payload[0];
+                row.mission = payload[1];
+                memcpy(&row.flightTime, payload + 2, sizeof(uint16_t));
+                memcpy(&row.cpuUsage, payload + 4, sizeof(float));
+                memcpy(&row.memoryUsage, payload + 8, sizeof(float));
+                row.hasStatus = true;
+            }
+        }
+
+       private:
+        /**
+         * @struct UavRow
+         * @brief Latest decoded state of one UAV
+         */
+        struct UavRow {
+            std::string target;                                ///< Target of the latest packet
+            double latitude{0}, longitude{0};                  ///< Latest position
+            float altitude{0}, heading{0}, speed{0};           ///< Latest altitude, heading and speed
+            uint8_t health{0}, mission{0};                     ///< Latest system health and mission state
+            uint16_t flightTime{0};                            ///< Latest flight time (s)
+            float cpuUsage{0}, memoryUsage{0};                 ///< Latest resource usage (%)
+            bool hasLocation{false}, hasStatus{false};         ///< Which packet types were seen
+            uint64_t packets{0};                               ///< Packets received
+            uint64_t invalid{0};                               ///< Packets with an invalid header
+            uint64_t packetsAtLastRate{0};                     ///< Packet count at the previous rate sample
+            double rate{0};                                    ///< Packets per second over the previous second
+            std::chrono::steady_clock::time_point lastUpdate;  ///< Arrival of the latest packet
+        };
+
+        /**
+         * @brief Redraw the screen every frame period until stopped
+         */
+        void renderLoop() {
+            auto next_frame = std::chrono::steady_clock::now();
+            auto next_rate = next_frame + std::chrono::seconds(1);
+            std::string frame = "\033[2J";  // Clear the screen once, later frames overwrite in place
+            while (running_) {
+                auto now = std::chrono::steady_clock::now();
+                std::vector<std::pair<std::string, UavRow>> snapshot;
+                std::string notice;
+                {
+                    std::lock_guard<std::mutex> lock(mutex_);
+                    if (now >= next_rate) {
+                        for (auto& [name, row] : rows_) {
+                            row.rate = static_cast<double>(row.packets - row.packetsAtLastRate);
+                            row.packetsAtLastRate = row.packets;
+                        }
+                        next_rate += std::chrono::seconds(1);
+                    }
+                    snapshot.assign(rows_.begin(), rows_.end());
+                    notice = notice_;
+                }
+                frame += renderFrame(snapshot, notice, now);
+                std::cout.write(frame.data(), static_cast<std::streamsize>(frame.size()));
+                std::cout.flush();
+                frame.clear();
+
+                next_frame += period_;
+                std::this_thread::sleep_until(next_frame);
+            }
+        }
+
+        /**
+         * @brief Format one frame: cursor home, title, table, and clear below
+         */
+        std::string renderFrame(const std::vector<std::pair<std::string, UavRow>>& rows,
+                                const std::string& notice,
+                                std::chrono::steady_clock::time_point now) const {
+            static const char* const health_names[] = {"Critical", "Warning", "Good", "Excellent"};
+
+            // Keep the table within the terminal so it never scrolls
+            size_t max_rows = 40;
+#if !defined(_WIN32)
+            struct winsize window {};
+            if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &window) == 0 && window.ws_row > 6) {
+                max_rows = window.ws_row - 6;
+            }
+#endif
+            uint64_t total_packets = 0;
+            for (const auto& entry : rows) {
+                total_packets += entry.second.packets;
+            }
+
+            std::ostringstream out;
+            out << "\033[H" << title_ << " - " << detail::consoleTimestamp() << " - " << rows.size() << " UAV(s), "
+                << total_packets << " packets\033[K\n";
+            out << notice << "\033[K\n\033[K\n";
+            out << std::left << std::setw(12) << "UAV" << std::setw(9) << "Target" << std::right << std::setw(12)
+                << "Latitude" << std::setw(13) << "Longitude" << std::setw(8) << "Alt m" << std::setw(6) << "Hdg"
+                << std::setw(7) << "m/s" << "  " << std::left << std::setw(10) << "Health" << std::setw(10)
+                << "Mission" << std::right << std::setw(7) << "CPU %" << std::setw(7) << "Mem %" << std::setw(8)
+                << "Pkt/s" << std::setw(8) << "Age ms" << "\033[K\n";
+            out << std::fixed;
+            size_t shown = 0;
+            for (const auto& [name, row] : rows) {
+                if (shown++ == max_rows) {
+                    out << "... " << rows.size() - max_rows << " more\033[K\n";
+                    break;
+                }
+                out << std::left << std::setw(12) << name.substr(0, 11) << std::setw(9) << row.target.substr(0, 8)
+                    << std::right;
+                if (row.hasLocation) {
+                    out << std::setprecision(coordinatePrecision_) << std::setw(12) << row.latitude << std::setw(13)
+                        << row.longitude << std::setprecision(1) << std::setw(8) << row.altitude
+                        << std::setprecision(0) << std::setw(6) << row.heading << std::setprecision(1) << std::setw(7)
+                        << row.speed;
+                } else {
+                    out << std::setw(46) << "-";
+                }
+                out << "  " << std::left;
+                if (row.hasStatus) {
+                    out << std::setw(10) << (row.health < 4 ? health_names[row.health] : "Unknown") << std::setw(10)
+                        << (row.mission < missionNames_.size() ? missionNames_[row.mission] : "Unknown") << std::right
+                        << std::setprecision(1) << std::setw(7) << row.cpuUsage << std::setw(7) << row.memoryUsage;
+                } else {
+                    out << std::setw(20) << "-" << std::right << std::setw(14) << "";
+                }
+                auto age = std::chrono::duration_cast<std::chrono::milliseconds>(now - row.lastUpdate).count();
+                out << std::setprecision(0) << std::setw(8) << row.rate << std::setw(8) << age << "\033[K\n";
+            }
+            out << "\033[J";  // Clear what is left of a longer previous frame
+            return out.str();
+        }
+
+        std::string title_;                      ///< Title line
+        std::chrono::milliseconds period_;       ///< Frame period
+        std::vector<std::string> missionNames_;  ///< Mission state -> display name
+        int coordinatePrecision_;                ///< Decimal places of latitude and longitude
+        std::mutex mutex_;                       ///< Guards rows_ and notice_
+        std::map<std::string, UavRow> rows_;     ///< UAV name -> latest state (sorted for a stable table)
+        std::string notice_;                     ///< Latest notice line
+        std::atomic<bool> running_{false};       ///< Render thread keeps running while set
+        std::thread renderThread_;               ///< Render thread
+    };
+
+}  // namespace TelemetryAPI
+
+#endif  // CONSOLE_MONITORS_H
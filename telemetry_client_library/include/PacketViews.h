@@ -0,0 +1,163 @@
+/**
+ * @file PacketViews.h
+ * @brief Zero-copy views over raw telemetry packets
+ *
+ * This header defines the payload layouts sent by the UAVs and a small view
+ * class that interprets a packet in place, wherever its bytes live (a received
+ * message, a memory-mapped journal, ...). Header-only; no library symbols.
+ */
+
+#ifndef PACKET_VIEWS_H
+#define PACKET_VIEWS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <vector>
+
+#include "TelemetryClient.h"
+
+namespace TelemetryAPI {
+
+#pragma pack(push, 1)
+    /**
+     * @brief Payload of a LOCATION packet (follows the PacketHeader)
+     */
+    struct LocationPayload {
+        double latitude;   ///< Latitude in decimal degrees
+        double longitude;  ///< Longitude in decimal degrees
+        float altitude;    ///< Altitude in meters above sea level
+        float heading;     ///< Heading in degrees (0-359)
+        float speed;       ///< Ground speed in m/s
+    };
+
+    /**
+     * @brief Payload of a STATUS packet (follows the PacketHeader)
+     */
+    struct StatusPayload {
+        uint8_t systemHealth;  ///< System health (0: Critical, 1: Warning, 2: Good, 3: Excellent)
+        uint8_t missionState;  ///< Mission state (0: Idle, 1: Takeoff, 2: Mission, 3: Landing, 4: Emergency)
+        uint16_t flightTime;   ///< Flight time in seconds
+        float cpuUsage;        ///< CPU usage percentage (0.0-100.0)
+        float memoryUsage;     ///< Memory usage percentage (0.0-100.0)
+    };
+#pragma pack(pop)
+
+    /**
+     * @brief Non-owning view of one telemetry packet (PacketHeader + payload)
+     *
+     * The view does not copy the packet; the bytes must outlive it. Payloads are
+     * decoded with memcpy, so the packet may sit at any alignment.
+     */
+    class PacketView {
+       public:
+        /**
+         * @brief Construct an empty (invalid) view
+         */
+        PacketView() = default;
+
+        /**
+         * @brief Construct a view over raw bytes
+         * @param data First byte of the packet
+         * @param size Packet size in bytes
+         */
+        PacketView(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+        /**
+         * @brief Construct a view over a received message
+         * @param data Packet bytes (must outlive the view)
+         */
+        explicit PacketView(const std::vector<uint8_t>& data) : data_(data.data()), size_(data.size()) {}
+
+        /**
+         * @brief Check whether the packet is large enough for a header
+         * @return true if targetId() and packetType() can be read
+         */
+        [[nodiscard]] bool valid() const {
+            return data_ != nullptr && size_ >= sizeof(PacketHeader);
+        }
+
+        /**
+         * @brief Get the target ID (1: Camera, 2: Mapping), 0 if the view is invalid
+         */
+        [[nodiscard]] uint8_t targetId() const {
+            return valid() ? data_[0] : 0;
+        }
+
+        /**
+         * @brief Get the packet type (see PacketTypes), 0 if the view is invalid
+         */
+        [[nodiscard]] uint8_t packetType() const {
+            return valid() ? data_[1] : 0;
+        }
+
+        /**
+         * @brief Get the whole packet
+         * @return Pointer to the first byte (the PacketHeader)
+         */
+        [[nodiscard]] const uint8_t* data() const {
+            return data_;
+        }
+
+        /**
+         * @brief Get the packet size in bytes
+         */
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+        /**
+         * @brief Get the payload after the PacketHeader
+         * @return Pointer to the payload, nullptr if the view is invalid
+         */
+        [[nodiscard]] const uint8_t* payload() const {
+            return valid() ? data_ + sizeof(PacketHeader) : nullptr;
+        }
+
+        /**
+         * @brief Get the payload size in bytes
+         */
+        [[nodiscard]] size_t payloadSize() const {
+            return valid() ? size_ - sizeof(PacketHeader) : 0;
+        }
+
+        /**
+         * @brief Decode a LOCATION payload
+         * @return The payload, or nothing if this is not a complete location packet
+         */
+        [[nodiscard]] std::optional<LocationPayload> location() const {
+            return decode<LocationPayload>(PacketTypes::LOCATION);
+        }
+
+        /**
+         * @brief Decode a STATUS payload
+         * @return The payload, or nothing if this is not a complete status packet
+         */
+        [[nodiscard]] std::optional<StatusPayload> status() const {
+            return decode<StatusPayload>(PacketTypes::STATUS);
+        }
+
+       private:
+        /**
+         * @brief Copy the payload out if the packet has the expected type and size
+         * @param type Expected packet type
+         * @return The payload, or nothing
+         */
+        template <typename Payload>
+        [[nodiscard]] std::optional<Payload> decode(uint8_t type) const {
+            if (packetType() != type || payloadSize() < sizeof(Payload)) {
+                return std::nullopt;
+            }
+            Payload result{};
+            std::memcpy(&result, payload(), sizeof(result));
+            return result;
+        }
+
+        const uint8_t* data_{nullptr};  ///< First byte of the packet
+        size_t size_{0};                ///< Packet size in bytes
+    };
+
+}  // namespace TelemetryAPI
+
+#endif  // PACKET_VIEWS_H
@@ -10,8 +10,10 @@
 #ifndef TELEMETRY_CLIENT_H
 #define TELEMETRY_CLIENT_H
 
+#include <chrono>
 #include <cstdint>
 #include <functional>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -44,6 +46,22 @@ namespace TelemetryAPI {
         UDP   ///< UDP using Boost.Asio - low latency, telemetry only
     };
 
+    /**
+     * @brief How a client uses several service instances, see TelemetryClient::connect(endpoints, ...)
+     */
+    enum class Redundancy {
+        FAILOVER,      ///< Telemetry from one endpoint; the next reachable one takes over when it goes down
+        ACTIVE_ACTIVE  ///< Telemetry from all endpoints, copies of the same packet dropped
+    };
+
+    /**
+     * @brief Address of one telemetry service instance
+     */
+    struct ServiceEndpoint {
+        std::string host;  ///< Hostname or IP address
+        int port{0};       ///< UI publish port for the chosen protocol
+    };
+
 /**
  * @brief Telemetry packet header structure (same as service)
  */
@@ -66,9 +84,65 @@ namespace TelemetryAPI {
         LOCATION = 4,
         STATUS = 5,
         IMU_PACKET = 6,
-        BATTERY_PACKET = 7
+        BATTERY_PACKET = 7,
+        COMMAND_ACK = 8
     };
 
+    /**
+     * @brief Outcome of a command sent with sendCommandWithAck() (must match CommandStatus in TelemetryPackets.h)
+     */
+    enum class CommandStatus : uint8_t {
+        ACKNOWLEDGED = 0,  ///< The UAV accepted the command
+        REJECTED = 1,      ///< The UAV refused the command
+        TIMEOUT = 2,       ///< No acknowledgement arrived in time
+        UNDELIVERED = 3    ///< Unknown target, not connected, or dropped before reaching the service
+    };
+
+    /**
+     * @brief Result of an acknowledged command
+     */
+    struct CommandResult {
+        uint32_t command_id{0};                            ///< Id assigned by sendCommandWithAck()
+        CommandStatus status{CommandStatus::UNDELIVERED};  ///< Outcome
+        std::chrono::microseconds round_trip{0};           ///< Time from sending to receiving the outcome
+    };
+
+    /**
+     * @brief Callback function type for acknowledged command results
+     * @param result Outcome and round-trip time of the command
+     */
+    using CommandCallback = std::function<void(const CommandResult& result)>;
+
+    /**
+     * @brief Latest known position of one UAV, as returned by fleet queries
+     */
+    struct FleetPosition {
+        std::string uav_name;              ///< UAV name
+        double latitude{0};                ///< Latitude in decimal degrees
+        double longitude{0};               ///< Longitude in decimal degrees
+        float altitude{0};                 ///< Altitude in meters above sea level
+        float heading{0};                  ///< Heading in degrees
+        float speed{0};                    ///< Ground speed in m/s
+        std::chrono::milliseconds age{0};  ///< Age of the position when the service answered
+    };
+
+    /**
+     * @brief Result of a fleet query sent with queryRadius() or queryBox()
+     */
+    struct QueryResult {
+        uint32_t query_id{0};                     ///< Id assigned to the query
+        bool ok{false};                           ///< False on timeout, disconnect or a rejected query
+        std::string error;                        ///< Reason when ok is false
+        std::vector<FleetPosition> uavs;          ///< Matching UAVs
+        std::chrono::microseconds round_trip{0};  ///< Time from sending to receiving the answer
+    };
+
+    /**
+     * @brief Callback function type for fleet query results
+     * @param result Matching UAVs or the reason the query failed
+     */
+    using QueryCallback = std::function<void(const QueryResult& result)>;
+
     /**
      * @brief Callback function type for receiving telemetry data
      * @param topic The topic the data was published on (e.g., "telemetry.UAV_1.camera.location")
@@ -79,10 +153,27 @@ namespace TelemetryAPI {
     /**
      * @brief Callback function type for connection status changes
      * @param connected True if connected, false if disconnected
-     * @param error_message Error message if disconnected due to error (empty if normal disconnect)
+     * @param error_message Error message if disconnected due to error (empty if normal disconnect);
+     *                      when the link drops and recovers on its own, the reason ("..., reconnecting")
+     *                      and the measured outage ("Reconnected after N ms")
      */
     using ConnectionCallback = std::function<void(bool connected, const std::string& error_message)>;
 
+    /**
+     * @brief Reconnection statistics of a client, see TelemetryClient::getConnectionStats()
+     */
+    struct ConnectionStats {
+        bool link_up{false};                         ///< The service is reachable, as far as the client can tell
+        uint32_t reconnects{0};                      ///< Outages recovered from since connect()
+        std::chrono::milliseconds last_outage{0};    ///< Duration of the latest recovered outage
+        std::chrono::milliseconds total_outage{0};   ///< Sum of all recovered outages
+        size_t active_endpoint{0};                   ///< Endpoint that commands (and, in failover mode, telemetry) use
+        uint32_t failovers{0};                       ///< A delivering endpoint went down while another one was up
+        std::chrono::milliseconds last_failover{0};  ///< Telemetry gap of the latest failover
+        std::chrono::milliseconds max_failover{0};   ///< Longest telemetry gap of a failover
+        uint64_t duplicates_dropped{0};              ///< Active/active: packet copies dropped as already delivered
+    };
+
     /**
      * @brief Simple telemetry client for UI applications
      *
@@ -135,13 +226,45 @@ namespace TelemetryAPI {
          */
         bool connect(const std::string& host, int port, Protocol protocol = Protocol::TCP);
 
+        /**
+         * @brief Connect to several redundant service instances
+         * @param endpoints Service instances in priority order (1 to 8)
+         * @param protocol Protocol to use (TCP or UDP)
+         * @param redundancy FAILOVER or ACTIVE_ACTIVE
+         * @return True if at least one endpoint could be set up, false otherwise
+         *
+         * Every endpoint is connected and subscribed to the same topics, and each one
+         * reconnects on its own (see setReconnectBackoff()).
+         * - FAILOVER: telemetry comes from one endpoint (the first to come up); the others
+         *   are hot standbys. When the active link drops, the next reachable endpoint in
+         *   priority order takes over at once and stays active when the failed one returns. The gap is the time
+         *   needed to notice the outage (a closed connection at once, a silent TCP
+         *   service within 3 s of ZeroMQ heartbeats, a UDP service within the 3 s lease).
+         * - ACTIVE_ACTIVE: UAV telemetry ("telemetry.*" topics) comes from every endpoint
+         *   and copies of the same packet (same topic and payload) are dropped, so losing
+         *   an instance leaves no gap. Costs the traffic of all endpoints. Messages each
+         *   instance computes itself (derived "@<spec>" streams, "fleet.*" analytics,
+         *   "uav.*.link" events, alerts) differ between instances and come from the
+         *   active endpoint only, as in failover mode.
+         * Commands and queries go to the active endpoint. The duration of every failover
+         * as seen by the application (last packet before it to first packet after it) is
+         * reported by getConnectionStats(). The instances must receive the same UAV
+         * telemetry.
+         */
+        bool connect(const std::vector<ServiceEndpoint>& endpoints,
+                     Protocol protocol = Protocol::TCP,
+                     Redundancy redundancy = Redundancy::FAILOVER);
+
         /**
          * @brief Connect using configuration file
          * @param config_file Path to service_config.json file
          * @param protocol Protocol to use (TCP or UDP)
          * @return True if connection successful, false otherwise
          *
-         * Automatically reads the UI ports from the configuration file
+         * Automatically reads the UI ports from the configuration file. An optional
+         * "service.endpoints" list ([{"ip": ..., "tcp_publish_port": ...}, ...], ports
+         * defaulting to "ui_ports") connects to redundant instances, in the mode given by
+         * "service.redundancy" ("failover" or "active_active", default "failover").
          */
         bool connectFromConfig(const std::string& config_file = "service_config.json",
                                Protocol protocol = Protocol::TCP);
@@ -156,10 +279,37 @@ namespace TelemetryAPI {
 
         /**
          * @brief Check if currently connected
-         * @return True if connected, false otherwise
+         * @return True from a successful connect() until disconnect()
+         *
+         * Stays true while the client reconnects on its own after the service became
+         * unreachable (e.g. restarted); getConnectionStats() tells whether the link is up.
          */
         bool isConnected() const;
 
+        /**
+         * @brief Set the delays between reconnection attempts (call before connect())
+         * @param initial Delay before the first attempt after an outage is noticed
+         * @param maximum Upper bound of the delay, which doubles after every failed attempt
+         *
+         * When the service becomes unreachable the client keeps the session and
+         * reconnects by itself, retrying with exponential backoff, and restores all
+         * subscriptions once the service answers again:
+         * - TCP: ZeroMQ reconnects and resubscribes the socket; the client registers its
+         *   filtered and derived subscriptions with the service again.
+         * - UDP: the client renews its subscriptions every second; the service confirms
+         *   them, so a service that stops answering is reported down and retried with
+         *   backoff, and a restarted one gets the subscriptions back within a second.
+         * Outages and recoveries are reported through the connection callback and
+         * counted in getConnectionStats(). Defaults: 100 ms initial, 5 s maximum.
+         */
+        void setReconnectBackoff(std::chrono::milliseconds initial, std::chrono::milliseconds maximum);
+
+        /**
+         * @brief Get the reconnection statistics
+         * @return Whether the link is up, and the number and duration of recovered outages
+         */
+        ConnectionStats getConnectionStats() const;
+
         /**
          * @brief Subscribe to a telemetry topic
          * @param topic Topic pattern to subscribe to (supports wildcards with '*')
@@ -170,10 +320,28 @@ namespace TelemetryAPI {
          * - "telemetry.UAV_1.*" - All data from UAV_1
          * - "telemetry.*.camera.*" - All camera data from all UAVs
          * - "telemetry.UAV_1.camera.location" - Specific data type
+         * - "telemetry.*.*.status?systemHealth <= 1" - Status packets with warning or critical health
+         * - "telemetry.*.*.location?altitude > 120 and speed > 20" - Fast, high location packets
+         *
+         * A "?<expression>" suffix filters on payload fields in the service, so only matching
+         * packets are sent. Fields are those of the location payload (latitude, longitude,
+         * altitude, heading, speed) or of the status payload (systemHealth, missionState,
+         * flightTime, cpuUsage, memoryUsage); comparisons (<, <=, >, >=, ==, !=) combine with
+         * "and", "or", "not" and parentheses. An invalid expression is logged by the service and
+         * the subscription receives nothing. Unsubscribe with the same string.
+         *
+         * An "@<spec>" suffix asks the service for a derived stream instead of every packet,
+         * delivered on "<topic>@<spec>":
+         * - "telemetry.*.mapping.location@1Hz" - at most one packet per second per topic
+         * - "telemetry.*.*.status@10s:cpuUsage" - JSON with count/min/max/avg of the field per
+         *   topic over each 10 s window
+         * The suffix may follow an expression ("...status?systemHealth <= 1@1Hz").
          *
          * Implementation notes:
-         * - TCP: Uses ZeroMQ prefix matching + client-side wildcard filtering
-         * - UDP: Uses server-side wildcard pattern matching
+         * - TCP: Uses ZeroMQ prefix matching + client-side wildcard filtering; filtered
+         *   and derived subscriptions are registered with the service and arrive on a
+         *   per-client prefix
+         * - UDP: Uses server-side wildcard pattern matching (and expression filtering)
          * - Both protocols provide identical wildcard behavior to the application
          */
         bool subscribe(const std::string& topic);
@@ -187,14 +355,78 @@ namespace TelemetryAPI {
 
         /**
          * @brief Send a command to a UAV (TCP only)
-         * @param uav_name Name of the UAV to send command to (e.g., "UAV_1")
+         * @param uav_name Name of the UAV to send command to (e.g., "UAV_1"), or a group
+         *                 target: "*", "group:<name>" or "tag:<tag>"
          * @param command Command string to send
-         * @return True if command sent successfully, false otherwise
+         * @return True if the command was queued, false if not connected or dropped because the
+         *         send queue is full
          *
-         * Only works with TCP protocol. Commands are forwarded by the service to the UAV.
+         * Only works with TCP protocol. Commands are forwarded by the service to the UAV,
+         * or to every UAV selected by a group target. Delivery is not confirmed; use
+         * sendCommandWithAck() for that.
          */
         bool sendCommand(const std::string& uav_name, const std::string& command);
 
+        /**
+         * @brief Send a command to one UAV and wait for its acknowledgement asynchronously (TCP only)
+         * @param uav_name Name of the UAV to send command to (group targets cannot be acknowledged)
+         * @param command Command string to send
+         * @param timeout Time to wait for the outcome before reporting TIMEOUT
+         * @return Future that becomes ready with the command's outcome and round-trip time
+         *
+         * The future is always satisfied: with the UAV's answer, TIMEOUT, or UNDELIVERED
+         * if the command could not be queued.
+         */
+        std::future<CommandResult> sendCommandWithAck(const std::string& uav_name,
+                                                      const std::string& command,
+                                                      std::chrono::milliseconds timeout = std::chrono::seconds(3));
+
+        /**
+         * @brief Send a command to one UAV and get its acknowledgement through a callback (TCP only)
+         * @param uav_name Name of the UAV to send command to (group targets cannot be acknowledged)
+         * @param command Command string to send
+         * @param callback Called exactly once with the outcome, from a background thread
+         * @param timeout Time to wait for the outcome before reporting TIMEOUT
+         * @return True if the command was queued (the callback has not run yet), false if it was not
+         *         (the callback has already been called with UNDELIVERED)
+         */
+        bool sendCommandWithAck(const std::string& uav_name,
+                                const std::string& command,
+                                CommandCallback callback,
+                                std::chrono::milliseconds timeout = std::chrono::seconds(3));
+
+        /**
+         * @brief Ask the service for the UAVs within a distance of a point (TCP only)
+         * @param latitude Latitude of the center in decimal degrees
+         * @param longitude Longitude of the center in decimal degrees
+         * @param radius_m Radius in meters
+         * @param timeout Time to wait for the answer
+         * @return Future that becomes ready with the matching UAVs, nearest first
+         *
+         * Answered from the service's spatial index over the latest positions, so a
+         * map can fetch only the UAVs it shows instead of subscribing to every
+         * location. Needs the "state_store" section in the service configuration.
+         */
+        std::future<QueryResult> queryRadius(double latitude,
+                                             double longitude,
+                                             double radius_m,
+                                             std::chrono::milliseconds timeout = std::chrono::seconds(3));
+
+        /**
+         * @brief Ask the service for the UAVs inside a latitude/longitude box (TCP only)
+         * @param min_latitude Southern edge
+         * @param min_longitude Western edge
+         * @param max_latitude Northern edge
+         * @param max_longitude Eastern edge (less than min_longitude for a box across the antimeridian)
+         * @param timeout Time to wait for the answer
+         * @return Future that becomes ready with the matching UAVs
+         */
+        std::future<QueryResult> queryBox(double min_latitude,
+                                          double min_longitude,
+                                          double max_latitude,
+                                          double max_longitude,
+                                          std::chrono::milliseconds timeout = std::chrono::seconds(3));
+
         /**
          * @brief Set callback for receiving telemetry data
          * @param callback Function to call when telemetry data is received
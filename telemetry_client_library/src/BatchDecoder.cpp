@@ -0,0 +1,368 @@
+/**
+ * @file BatchDecoder.cpp
+ * @brief Implementation of the batch payload decoder
+ *
+ * The AVX2 kernels handle four records per step: each field of the four
+ * records is fetched with one gather (the records are 28 or 12 bytes and
+ * packed, so no aligned vector load lines up with them) and stored with one
+ * vector store into its column. Byte and 16-bit status fields share one
+ * 32-bit gather and are split with byte shuffles. The AVX2 code is compiled
+ * for that instruction set only and selected at run time.
+ */
+
+#include "BatchDecoder.h"
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define BATCH_DECODER_HAS_AVX2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define BATCH_DECODER_AVX2_TARGET
+#else
+#define BATCH_DECODER_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#else
+#define BATCH_DECODER_HAS_AVX2 0
+#endif
+
+namespace TelemetryAPI {
+
+    namespace {
+
+        /**
+         * @brief Output pointers for location rows
+         */
+        struct LocationColumns {
+            double* latitude;
+            double* longitude;
+            float* altitude;
+            float* heading;
+            float* speed;
+        };
+
+        /**
+         * @brief Output pointers for status rows
+         */
+        struct StatusColumns {
+            uint8_t* systemHealth;
+            uint8_t* missionState;
+            uint16_t* flightTime;
+            float* cpuUsage;
+            float* memoryUsage;
+        };
+
+        /**
+         * @brief Point at the rows of a batch starting at a given row
+         * @param batch Batch already resized to hold the rows
+         * @param first First row to write
+         */
+        LocationColumns columnsOf(LocationBatch& batch, size_t first) {
+            return {batch.latitude.data() + first, batch.longitude.data() + first, batch.altitude.data() + first,
+                    batch.heading.data() + first, batch.speed.data() + first};
+        }
+
+        /**
+         * @brief Point at the rows of a batch starting at a given row
+         * @param batch Batch already resized to hold the rows
+         * @param first First row to write
+         */
+        StatusColumns columnsOf(StatusBatch& batch, size_t first) {
+            return {batch.systemHealth.data() + first, batch.missionState.data() + first,
+                    batch.flightTime.data() + first, batch.cpuUsage.data() + first, batch.memoryUsage.data() + first};
+        }
+
+        /**
+         * @brief Decode one location payload (scalar path and vector tails)
+         * @param payload First byte of the payload
+         * @param out Output columns
+         * @param row Row to write
+         */
+        inline void decodeLocation(const uint8_t* payload, const LocationColumns& out, size_t row) {
+            std::memcpy(&out.latitude[row], payload + offsetof(LocationPayload, latitude), sizeof(double));
+            std::memcpy(&out.longitude[row], payload + offsetof(LocationPayload, longitude), sizeof(double));
+            std::memcpy(&out.altitude[row], payload + offsetof(LocationPayload, altitude), sizeof(float));
+            std::memcpy(&out.heading[row], payload + offsetof(LocationPayload, heading), sizeof(float));
+            std::memcpy(&out.speed[row], payload + offsetof(LocationPayload, speed), sizeof(float));
+        }
+
+        /**
+         * @brief Decode one status payload (scalar path and vector tails)
+         * @param payload First byte of the payload
+         * @param out Output columns
+         * @param row Row to write
+         */
+        inline void decodeStatus(const uint8_t* payload, const StatusColumns& out, size_t row) {
+            out.systemHealth[row] = payload[offsetof(StatusPayload, systemHealth)];
+            out.missionState[row] = payload[offsetof(StatusPayload, missionState)];
+            std::memcpy(&out.flightTime[row], payload + offsetof(StatusPayload, flightTime), sizeof(uint16_t));
+            std::memcpy(&out.cpuUsage[row], payload + offsetof(StatusPayload, cpuUsage), sizeof(float));
+            std::memcpy(&out.memoryUsage[row], payload + offsetof(StatusPayload, memoryUsage), sizeof(float));
+        }
+
+#if BATCH_DECODER_HAS_AVX2
+        /**
+         * @brief Decode four location payloads
+         * @param base Address the offsets are relative to
+         * @param offsets Byte offsets of the four payloads from base
+         * @param out Output columns
+         * @param row First of the four rows to write
+         */
+        BATCH_DECODER_AVX2_TARGET inline void
+        locationBlock(const uint8_t* base, __m256i offsets, const LocationColumns& out, size_t row) {
+            auto doubles = [base](size_t field) { return reinterpret_cast<const double*>(base + field); };
+            auto floats = [base](size_t field) { return reinterpret_cast<const float*>(base + field); };
+            _mm256_storeu_pd(out.latitude + row,
+                             _mm256_i64gather_pd(doubles(offsetof(LocationPayload, latitude)), offsets, 1));
+            _mm256_storeu_pd(out.longitude + row,
+                             _mm256_i64gather_pd(doubles(offsetof(LocationPayload, longitude)), offsets, 1));
+            _mm_storeu_ps(out.altitude + row,
+                          _mm256_i64gather_ps(floats(offsetof(LocationPayload, altitude)), offsets, 1));
+            _mm_storeu_ps(out.heading + row,
+                          _mm256_i64gather_ps(floats(offsetof(LocationPayload, heading)), offsets, 1));
+            _mm_storeu_ps(out.speed + row, _mm256_i64gather_ps(floats(offsetof(LocationPayload, speed)), offsets, 1));
+        }
+
+        /**
+         * @brief Decode four status payloads
+         * @param base Address the offsets are relative to
+         * @param offsets Byte offsets of the four payloads from base
+         * @param out Output columns
+         * @param row First of the four rows to write
+         *
+         * The first 32-bit word of a status payload holds health, mission state and
+         * flight time; one gather fetches it for all four records and shuffles pick
+         * the fields apart.
+         */
+        BATCH_DECODER_AVX2_TARGET inline void
+        statusBlock(const uint8_t* base, __m256i offsets, const StatusColumns& out, size_t row) {
+            const __m128i health_bytes = _mm_setr_epi8(0, 4, 8, 12, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+            const __m128i mission_bytes = _mm_setr_epi8(1, 5, 9, 13, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+            const __m128i flight_bytes = _mm_setr_epi8(2, 3, 6, 7, 10, 11, 14, 15, -1, -1, -1, -1, -1, -1, -1, -1);
+
+            __m128i words = _mm256_i64gather_epi32(reinterpret_cast<const int*>(base), offsets, 1);
+            int health = _mm_cvtsi128_si32(_mm_shuffle_epi8(words, health_bytes));
+            int mission = _mm_cvtsi128_si32(_mm_shuffle_epi8(words, mission_bytes));
+            std::memcpy(out.systemHealth + row, &health, 4);
+            std::memcpy(out.missionState + row, &mission, 4);
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out.flightTime + row), _mm_shuffle_epi8(words, flight_bytes));
+
+            auto floats = [base](size_t field) { return reinterpret_cast<const float*>(base + field); };
+            _mm_storeu_ps(out.cpuUsage + row,
+                          _mm256_i64gather_ps(floats(offsetof(StatusPayload, cpuUsage)), offsets, 1));
+            _mm_storeu_ps(out.memoryUsage + row,
+                          _mm256_i64gather_ps(floats(offsetof(StatusPayload, memoryUsage)), offsets, 1));
+        }
+
+        /**
+         * @brief AVX2 kernel for payloads at a fixed stride
+         */
+        template <typename Columns, void (*Block)(const uint8_t*, __m256i, const Columns&, size_t),
+                  void (*Scalar)(const uint8_t*, const Columns&, size_t)>
+        BATCH_DECODER_AVX2_TARGET void
+        decodeStridedAvx2(const uint8_t* data, size_t count, size_t stride, const Columns& out) {
+            const auto step = static_cast<long long>(stride);
+            __m256i offsets = _mm256_setr_epi64x(0, step, 2 * step, 3 * step);
+            const __m256i advance = _mm256_set1_epi64x(4 * step);
+            size_t row = 0;
+            for (; row + 4 <= count; row += 4) {
+                Block(data, offsets, out, row);
+                offsets = _mm256_add_epi64(offsets, advance);
+            }
+            for (; row < count; ++row) {
+                Scalar(data + row * stride, out, row);
+            }
+        }
+
+        /**
+         * @brief AVX2 kernel for payloads at arbitrary addresses
+         *
+         * The addresses are turned into offsets from the first payload, which
+         * the gathers add back; no pointer array is copied.
+         */
+        template <typename Columns, void (*Block)(const uint8_t*, __m256i, const Columns&, size_t),
+                  void (*Scalar)(const uint8_t*, const Columns&, size_t)>
+        BATCH_DECODER_AVX2_TARGET void
+        decodeIndirectAvx2(const uint8_t* const* payloads, size_t count, const Columns& out) {
+            if (count == 0) {
+                return;
+            }
+            const uint8_t* base = payloads[0];
+            const __m256i base_address = _mm256_set1_epi64x(static_cast<long long>(reinterpret_cast<uintptr_t>(base)));
+            size_t row = 0;
+            for (; row + 4 <= count; row += 4) {
+                __m256i addresses = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(payloads + row));
+                Block(base, _mm256_sub_epi64(addresses, base_address), out, row);
+            }
+            for (; row < count; ++row) {
+                Scalar(payloads[row], out, row);
+            }
+        }
+
+        /**
+         * @brief Check whether the CPU and OS support AVX2
+         */
+        bool cpuSupportsAvx2() {
+#if defined(_MSC_VER) && !defined(__clang__)
+            int info[4];
+            __cpuid(info, 0);
+            if (info[0] < 7) {
+                return false;
+            }
+            __cpuid(info, 1);
+            const bool os_saves_avx = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0;
+            if (!os_saves_avx || (_xgetbv(0) & 0x6) != 0x6) {
+                return false;
+            }
+            __cpuidex(info, 7, 0);
+            return (info[1] & (1 << 5)) != 0;
+#else
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+#endif
+        }
+#endif
+
+        /**
+         * @brief Decide once whether the AVX2 kernels are used
+         */
+        bool useAvx2() {
+#if BATCH_DECODER_HAS_AVX2
+            static const bool enabled = [] {
+                const char* forced = std::getenv("TELEMETRY_BATCH_DECODER");
+                if (forced != nullptr && std::string(forced) == "scalar") {
+                    return false;
+                }
+                return cpuSupportsAvx2();
+            }();
+            return enabled;
+#else
+            return false;
+#endif
+        }
+
+        /**
+         * @brief Collect the payloads of the packets of one type
+         * @param packets Packets of any type
+         * @param type Packet type to keep
+         * @param payloadSize Minimum payload size
+         * @return Payload addresses in packet order
+         */
+        std::vector<const uint8_t*>
+        collectPayloads(const std::vector<PacketView>& packets, uint8_t type, size_t payloadSize) {
+            std::vector<const uint8_t*> payloads;
+            payloads.reserve(packets.size());
+            for (const auto& packet : packets) {
+                if (packet.packetType() == type && packet.payloadSize() >= payloadSize) {
+                    payloads.push_back(packet.payload());
+                }
+            }
+            return payloads;
+        }
+
+    }  // namespace
+
+    /**
+     * @brief Decode location payloads laid out at a fixed stride
+     * @param data First byte of the first payload
+     * @param count Number of payloads
+     * @param stride Distance between payloads in bytes
+     * @param out Batch the rows are appended to
+     */
+    void BatchDecoder::decodeLocations(const uint8_t* data, size_t count, size_t stride, LocationBatch& out) {
+        size_t first = out.size();
+        out.resize(first + count);
+        LocationColumns columns = columnsOf(out, first);
+#if BATCH_DECODER_HAS_AVX2
+        if (useAvx2()) {
+            decodeStridedAvx2<LocationColumns, locationBlock, decodeLocation>(data, count, stride, columns);
+            return;
+        }
+#endif
+        for (size_t row = 0; row < count; ++row) {
+            decodeLocation(data + row * stride, columns, row);
+        }
+    }
+
+    /**
+     * @brief Decode status payloads laid out at a fixed stride
+     * @param data First byte of the first payload
+     * @param count Number of payloads
+     * @param stride Distance between payloads in bytes
+     * @param out Batch the rows are appended to
+     */
+    void BatchDecoder::decodeStatuses(const uint8_t* data, size_t count, size_t stride, StatusBatch& out) {
+        size_t first = out.size();
+        out.resize(first + count);
+        StatusColumns columns = columnsOf(out, first);
+#if BATCH_DECODER_HAS_AVX2
+        if (useAvx2()) {
+            decodeStridedAvx2<StatusColumns, statusBlock, decodeStatus>(data, count, stride, columns);
+            return;
+        }
+#endif
+        for (size_t row = 0; row < count; ++row) {
+            decodeStatus(data + row * stride, columns, row);
+        }
+    }
+
+    /**
+     * @brief Decode the location packets among scattered packets
+     * @param packets Packets of any type
+     * @param out Batch the rows are appended to
+     * @return Number of rows appended
+     */
+    size_t BatchDecoder::decodeLocations(const std::vector<PacketView>& packets, LocationBatch& out) {
+        std::vector<const uint8_t*> payloads = collectPayloads(packets, PacketTypes::LOCATION, sizeof(LocationPayload));
+        size_t first = out.size();
+        out.resize(first + payloads.size());
+        LocationColumns columns = columnsOf(out, first);
+#if BATCH_DECODER_HAS_AVX2
+        if (useAvx2()) {
+            decodeIndirectAvx2<LocationColumns, locationBlock, decodeLocation>(payloads.data(), payloads.size(),
+                                                                               columns);
+            return payloads.size();
+        }
+#endif
+        for (size_t row = 0; row < payloads.size(); ++row) {
+            decodeLocation(payloads[row], columns, row);
+        }
+        return payloads.size();
+    }
+
+    /**
+     * @brief Decode the status packets among scattered packets
+     * @param packets Packets of any type
+     * @param out Batch the rows are appended to
+     * @return Number of rows appended
+     */
+    size_t BatchDecoder::decodeStatuses(const std::vector<PacketView>& packets, StatusBatch& out) {
+        std::vector<const uint8_t*> payloads = collectPayloads(packets, PacketTypes::STATUS, sizeof(StatusPayload));
+        size_t first = out.size();
+        out.resize(first + payloads.size());
+        StatusColumns columns = columnsOf(out, first);
+#if BATCH_DECODER_HAS_AVX2
+        if (useAvx2()) {
+            decodeIndirectAvx2<StatusColumns, statusBlock, decodeStatus>(payloads.data(), payloads.size(), columns);
+            return payloads.size();
+        }
+#endif
+        for (size_t row = 0; row < payloads.size(); ++row) {
+            decodeStatus(payloads[row], columns, row);
+        }
+        return payloads.size();
+    }
+
+    /**
+     * @brief Get the code path selected for this CPU
+     * @return "avx2" or "scalar"
+     */
+    const char* BatchDecoder::implementation() {
+        return useAvx2() ? "avx2" : "scalar";
+    }
+
+}  // namespace TelemetryAPI
@@ -9,17 +9,22 @@
 #include "TelemetryClient.h"
 
 #include <algorithm>
+#include <array>
 #include <atomic>
 #include <boost/asio.hpp>
 #include <chrono>
 #include <cstddef>
 #include <cstdlib>  // for getenv
+#include <cstring>
+#include <deque>
 #include <fstream>
+#include <iomanip>
 #include <iostream>
 #include <mutex>
 #include <nlohmann/json.hpp>
 #include <sstream>
 #include <thread>
+#include <unordered_map>
 #include <unordered_set>
 #include <zmq.hpp>
 
@@ -40,15 +45,25 @@ static void debugLog(const std::string& message) {
 
 namespace TelemetryAPI {
 
+/**
+ * @brief Command outcome published by the service on "ack.<client_id>" (same as CommandAckPayload)
+ */
+#pragma pack(push, 1)
+    struct CommandAckPayload {
+        uint32_t commandId;  ///< Id assigned by sendCommandWithAck()
+        uint8_t status;      ///< CommandStatus value
+    };
+#pragma pack(pop)
+
     /**
-     * @brief Implementation class using PIMPL pattern to hide dependencies
+     * @brief Connection to one service instance: sockets, receive thread, subscriptions and pending requests
      */
-    class TelemetryClientImpl {
+    class ServiceConnection {
        public:
-        explicit TelemetryClientImpl(const std::string& client_id)
+        explicit ServiceConnection(const std::string& client_id)
             : client_id_(client_id), protocol_(Protocol::TCP), connected_(false), running_(false) {}
 
-        ~TelemetryClientImpl() {
+        ~ServiceConnection() {
             disconnect();
         }
 
@@ -75,56 +90,20 @@ namespace TelemetryAPI {
             }
         }
 
-        bool connectFromConfig(const std::string& config_file, Protocol protocol) {
-            try {
-                std::ifstream file(config_file);
-                if (!file.is_open()) {
-                    if (connection_callback_) {
-                        connection_callback_(false, "Cannot open config file: " + config_file);
-                    }
-                    return false;
-                }
-
-                json config_json;
-                file >> config_json;
-                file.close();
-
-                if (!config_json.contains("ui_ports")) {
-                    if (connection_callback_) {
-                        connection_callback_(false, "Config file missing 'ui_ports' section");
-                    }
-                    return false;
-                }
-
-                const auto& ui_ports = config_json["ui_ports"];
-                int port;
-
-                if (protocol == Protocol::TCP) {
-                    port = ui_ports.at("tcp_publish_port");
-                } else {
-                    port = ui_ports.at("udp_publish_port");
-                }
-
-                std::string host = "localhost";  // Default for local service
-                if (config_json.contains("service") && config_json["service"].contains("ip")) {
-                    host = config_json["service"]["ip"];
-                }
-
-                return connect(host, port, protocol);
-
-            } catch (const std::exception& e) {
-                if (connection_callback_) {
-                    connection_callback_(false, "Config parsing error: " + std::string(e.what()));
-                }
-                return false;
-            }
-        }
-
         void disconnect() {
             if (!connected_) {
                 return;
             }
 
+            // Drop our content-based filters in the service while the command socket still works
+            if (protocol_ == Protocol::TCP) {
+                std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                for (const auto& [subscription, filter_id] : filter_ids_) {
+                    queueCommand("UNFILTER|" + client_id_ + "|" + std::to_string(filter_id));
+                }
+                filter_ids_.clear();
+            }
+
             running_ = false;
             connected_ = false;
 
@@ -144,6 +123,15 @@ namespace TelemetryAPI {
                 disconnectUDP();
             }
 
+            // No acknowledgement or query answer can arrive any more
+            failPendingCommands();
+            failPendingQueries();
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                stats_.link_up = false;
+                ever_up_ = false;
+            }
+
             if (connection_callback_) {
                 connection_callback_(false, "");  // Normal disconnect
             }
@@ -190,27 +178,47 @@ namespace TelemetryAPI {
         }
 
         bool sendCommand(const std::string& uav_name, const std::string& command) {
-            if (!connected_ || protocol_ != Protocol::TCP) {
-                return false;  // Commands only work with TCP
-            }
+            // Format: "uav_name:command"
+            return queueCommand(uav_name + ":" + command);
+        }
 
-            try {
-                if (!command_socket_) {
-                    // Create command socket on demand
-                    command_socket_ = std::make_unique<zmq::socket_t>(*zmq_context_, zmq::socket_type::push);
-                    std::string command_addr =
-                        "tcp://" + host_ + ":" + std::to_string(port_ + 1);  // Command port is usually +1
-                    command_socket_->connect(command_addr);
-                }
+        bool sendCommandWithAck(const std::string& uav_name,
+                                const std::string& command,
+                                CommandCallback callback,
+                                std::chrono::milliseconds timeout) {
+            uint32_t command_id = next_command_id_++;
+            auto now = std::chrono::steady_clock::now();
+            {
+                // Registered before sending so even an immediate acknowledgement finds it
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                pending_commands_[command_id] = PendingCommand{std::move(callback), now, now + timeout};
+            }
 
-                // Format: "uav_name:command"
-                std::string message = uav_name + ":" + command;
-                command_socket_->send(zmq::buffer(message.data(), message.size()), zmq::send_flags::dontwait);
+            // Format: "CMD|client_id|command_id|uav_name:command"
+            std::string message =
+                "CMD|" + client_id_ + "|" + std::to_string(command_id) + "|" + uav_name + ":" + command;
+            if (queueCommand(message)) {
                 return true;
+            }
+            completeCommand(command_id, CommandStatus::UNDELIVERED);
+            return false;
+        }
 
-            } catch (const std::exception&) {
-                return false;
+        bool sendQuery(const std::string& query, QueryCallback callback, std::chrono::milliseconds timeout) {
+            uint32_t query_id = next_query_id_++;
+            auto now = std::chrono::steady_clock::now();
+            {
+                // Registered before sending so even an immediate answer finds it
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                pending_queries_[query_id] = PendingQuery{std::move(callback), now, now + timeout};
+            }
+
+            // Format: "QUERY|client_id|query_id|query"
+            if (queueCommand("QUERY|" + client_id_ + "|" + std::to_string(query_id) + "|" + query)) {
+                return true;
             }
+            completeQuery(query_id, "not connected or send queue full", {});
+            return false;
         }
 
         void setTelemetryCallback(TelemetryCallback callback) {
@@ -223,6 +231,21 @@ namespace TelemetryAPI {
             connection_callback_ = std::move(callback);
         }
 
+        void setReconnectBackoff(std::chrono::milliseconds initial, std::chrono::milliseconds maximum) {
+            initial_backoff_ = std::max(initial, std::chrono::milliseconds(1));
+            max_backoff_ = std::max(maximum, initial_backoff_);
+        }
+
+        ConnectionStats getConnectionStats() const {
+            std::lock_guard<std::mutex> lock(stats_mutex_);
+            return stats_;
+        }
+
+        // Called on every link transition, including the first "up" (set before connect())
+        void setLinkObserver(std::function<void(bool)> observer) {
+            link_observer_ = std::move(observer);
+        }
+
         const std::string& getClientId() const {
             return client_id_;
         }
@@ -252,34 +275,355 @@ namespace TelemetryAPI {
         // Subscriptions
         std::unordered_set<std::string> subscriptions_;
 
+        // Acknowledged commands
+        struct PendingCommand {
+            CommandCallback callback;
+            std::chrono::steady_clock::time_point sent_at;
+            std::chrono::steady_clock::time_point deadline;
+        };
+        std::mutex command_mutex_;  // Guards command_socket_
+        std::mutex pending_mutex_;  // Guards pending_commands_ and pending_queries_
+        std::unordered_map<uint32_t, PendingCommand> pending_commands_;
+        std::atomic<uint32_t> next_command_id_{1};
+        std::string ack_topic_;  // "ack.<client_id>", where the service publishes command outcomes
+
+        // Fleet queries (share pending_mutex_ with the acknowledged commands)
+        struct PendingQuery {
+            QueryCallback callback;
+            std::chrono::steady_clock::time_point sent_at;
+            std::chrono::steady_clock::time_point deadline;
+        };
+        std::unordered_map<uint32_t, PendingQuery> pending_queries_;
+        std::atomic<uint32_t> next_query_id_{1};
+        std::string query_topic_;  // "query.<client_id>", where the service publishes query answers
+
+        // Content-based subscriptions over TCP ("<pattern>?<expression>", guarded by subscriptions_mutex_)
+        std::unordered_map<std::string, uint32_t> filter_ids_;  // Subscription -> filter id in the service
+        std::atomic<uint32_t> next_filter_id_{1};
+        std::string filter_topic_prefix_;  // "filter.<client_id>.", prefix of filtered packets
+
+        // Automatic reconnection (backoff set before connect(); the rest guarded by stats_mutex_)
+        std::chrono::milliseconds initial_backoff_{100};
+        std::chrono::milliseconds max_backoff_{5000};
+        mutable std::mutex stats_mutex_;
+        ConnectionStats stats_;
+        bool ever_up_{false};  // The link was up once, so the next "up" is a recovery
+        std::chrono::steady_clock::time_point outage_start_;
+        std::function<void(bool)> link_observer_;
+
         // TCP (ZeroMQ) members
         std::unique_ptr<zmq::context_t> zmq_context_;
         std::unique_ptr<zmq::socket_t> subscriber_socket_;
         std::unique_ptr<zmq::socket_t> command_socket_;
+        std::unique_ptr<zmq::socket_t> monitor_socket_;     // Connect/disconnect events of subscriber_socket_
+        uint32_t monitor_generation_{0};                    // Makes every monitor address unique
+        static constexpr int HEARTBEAT_INTERVAL_MS = 1000;  // ZMTP ping interval on the subscriber
+        static constexpr int HEARTBEAT_TIMEOUT_MS = 3000;   // No traffic for this long: disconnected
 
         // UDP (Boost.Asio) members
         std::unique_ptr<boost::asio::io_context> io_context_;
         std::unique_ptr<udp::socket> udp_socket_;
         std::unique_ptr<udp::socket> subscription_socket_;
 
+        // UDP subscription renewal (receive thread only)
+        static constexpr std::chrono::seconds UDP_RENEW_INTERVAL{1};  // Subscriptions are re-sent this often
+        static constexpr std::chrono::seconds UDP_LEASE_TIMEOUT{3};   // No confirmation for this long: link down
+        bool udp_confirmed_{false};  // The service confirms subscriptions (older services do not)
+        std::chrono::steady_clock::time_point last_confirmation_;
+        std::chrono::steady_clock::time_point next_renewal_;
+        std::chrono::milliseconds renewal_backoff_{0};
+        bool confirmation_pending_{false};  // An async receive for confirmations is outstanding
+        std::array<char, 512> confirmation_buffer_{};
+        udp::endpoint confirmation_sender_;
+
+        // Command helpers
+        bool queueCommand(const std::string& message) {
+            if (!connected_ || protocol_ != Protocol::TCP) {
+                return false;  // Commands only work with TCP
+            }
+
+            try {
+                std::lock_guard<std::mutex> lock(command_mutex_);
+                if (!command_socket_) {
+                    // Create command socket on demand
+                    command_socket_ = std::make_unique<zmq::socket_t>(*zmq_context_, zmq::socket_type::push);
+                    std::string command_addr =
+                        "tcp://" + host_ + ":" + std::to_string(port_ + 1);  // Command port is usually +1
+                    command_socket_->connect(command_addr);
+                }
+
+                // An empty result means the message was dropped (send queue full or no peer yet)
+                auto sent =
+                    command_socket_->send(zmq::buffer(message.data(), message.size()), zmq::send_flags::dontwait);
+                return sent.has_value();
+
+            } catch (const std::exception&) {
+                return false;
+            }
+        }
+
+        // Resolve a pending command and run its callback outside the lock
+        bool completeCommand(uint32_t command_id, CommandStatus status) {
+            PendingCommand pending;
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                auto pending_it = pending_commands_.find(command_id);
+                if (pending_it == pending_commands_.end()) {
+                    return false;  // Already resolved (e.g. timed out locally)
+                }
+                pending = std::move(pending_it->second);
+                pending_commands_.erase(pending_it);
+            }
+
+            CommandResult result;
+            result.command_id = command_id;
+            result.status = status;
+            result.round_trip = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - pending.sent_at);
+            if (pending.callback) {
+                pending.callback(result);
+            }
+            return true;
+        }
+
+        void handleCommandAck(const std::vector<uint8_t>& data) {
+            if (data.size() < sizeof(CommandAckPayload)) {
+                debugLog("Truncated command acknowledgement");
+                return;
+            }
+            CommandAckPayload ack{};
+            std::memcpy(&ack, data.data(), sizeof(ack));
+            if (ack.status > static_cast<uint8_t>(CommandStatus::UNDELIVERED)) {
+                ack.status = static_cast<uint8_t>(CommandStatus::REJECTED);  // Unknown codes count as refusals
+            }
+            completeCommand(ack.commandId, static_cast<CommandStatus>(ack.status));
+        }
+
+        void expirePendingCommands() {
+            std::vector<uint32_t> expired;
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                if (pending_commands_.empty()) {
+                    return;
+                }
+                auto now = std::chrono::steady_clock::now();
+                for (const auto& [command_id, pending] : pending_commands_) {
+                    if (pending.deadline <= now) {
+                        expired.push_back(command_id);
+                    }
+                }
+            }
+            for (uint32_t command_id : expired) {
+                completeCommand(command_id, CommandStatus::TIMEOUT);
+            }
+        }
+
+        void failPendingCommands() {
+            std::vector<uint32_t> pending_ids;
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                for (const auto& entry : pending_commands_) {
+                    pending_ids.push_back(entry.first);
+                }
+            }
+            for (uint32_t command_id : pending_ids) {
+                completeCommand(command_id, CommandStatus::UNDELIVERED);
+            }
+        }
+
+        // Resolve a pending query and run its callback outside the lock (empty error = success)
+        void completeQuery(uint32_t query_id, const std::string& error, std::vector<FleetPosition> uavs) {
+            PendingQuery pending;
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                auto pending_it = pending_queries_.find(query_id);
+                if (pending_it == pending_queries_.end()) {
+                    return;  // Already resolved (e.g. timed out locally)
+                }
+                pending = std::move(pending_it->second);
+                pending_queries_.erase(pending_it);
+            }
+
+            QueryResult result;
+            result.query_id = query_id;
+            result.ok = error.empty();
+            result.error = error;
+            result.uavs = std::move(uavs);
+            result.round_trip = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - pending.sent_at);
+            if (pending.callback) {
+                pending.callback(result);
+            }
+        }
+
+        void handleQueryReply(const std::vector<uint8_t>& data) {
+            uint32_t query_id = 0;
+            std::string error;
+            std::vector<FleetPosition> uavs;
+            try {
+                json reply = json::parse(data.begin(), data.end());
+                query_id = reply.at("id").get<uint32_t>();
+                if (reply.contains("error")) {
+                    error = reply["error"].get<std::string>();
+                } else {
+                    for (const auto& entry : reply.at("uavs")) {
+                        FleetPosition position;
+                        position.uav_name = entry.at("name").get<std::string>();
+                        position.latitude = entry.at("latitude").get<double>();
+                        position.longitude = entry.at("longitude").get<double>();
+                        position.altitude = entry.value("altitude", 0.0f);
+                        position.heading = entry.value("heading", 0.0f);
+                        position.speed = entry.value("speed", 0.0f);
+                        position.age = std::chrono::milliseconds(entry.value("age_ms", int64_t{0}));
+                        uavs.push_back(std::move(position));
+                    }
+                }
+            } catch (const std::exception& e) {
+                debugLog("Malformed query reply: " + std::string(e.what()));
+                if (query_id == 0) {
+                    return;
+                }
+                error = "malformed reply";
+            }
+            completeQuery(query_id, error, std::move(uavs));
+        }
+
+        void expirePendingQueries() {
+            std::vector<uint32_t> expired;
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                if (pending_queries_.empty()) {
+                    return;
+                }
+                auto now = std::chrono::steady_clock::now();
+                for (const auto& [query_id, pending] : pending_queries_) {
+                    if (pending.deadline <= now) {
+                        expired.push_back(query_id);
+                    }
+                }
+            }
+            for (uint32_t query_id : expired) {
+                completeQuery(query_id, "timeout", {});
+            }
+        }
+
+        void failPendingQueries() {
+            std::vector<uint32_t> pending_ids;
+            {
+                std::lock_guard<std::mutex> lock(pending_mutex_);
+                for (const auto& entry : pending_queries_) {
+                    pending_ids.push_back(entry.first);
+                }
+            }
+            for (uint32_t query_id : pending_ids) {
+                completeQuery(query_id, "disconnected", {});
+            }
+        }
+
+        // The service became unreachable: start measuring the outage and tell the application
+        void linkLost(const std::string& reason) {
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                if (!stats_.link_up) {
+                    return;  // Already down
+                }
+                stats_.link_up = false;
+                outage_start_ = std::chrono::steady_clock::now();
+            }
+            debugLog("Link lost: " + reason);
+            if (link_observer_) {
+                link_observer_(false);
+            }
+            if (connection_callback_) {
+                connection_callback_(false, reason + ", reconnecting");
+            }
+        }
+
+        // The service answers (again): record the outage and restore the service-side subscriptions
+        void linkRestored() {
+            std::chrono::milliseconds outage{0};
+            bool first = false;
+            {
+                std::lock_guard<std::mutex> lock(stats_mutex_);
+                if (stats_.link_up) {
+                    return;
+                }
+                stats_.link_up = true;
+                if (!ever_up_) {
+                    ever_up_ = true;
+                    first = true;
+                } else {
+                    outage = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now()
+                                                                                   - outage_start_);
+                    ++stats_.reconnects;
+                    stats_.last_outage = outage;
+                    stats_.total_outage += outage;
+                }
+            }
+            if (link_observer_) {
+                link_observer_(true);
+            }
+            if (first) {
+                return;  // First connection, already reported by connect()
+            }
+            if (protocol_ == Protocol::TCP) {
+                std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                registerFiltersTCP();
+            }
+            debugLog("Link restored after " + std::to_string(outage.count()) + " ms");
+            if (connection_callback_) {
+                connection_callback_(true, "Reconnected after " + std::to_string(outage.count()) + " ms");
+            }
+        }
+
+        // Sleep in short steps so disconnect() is not delayed; false if the client is shutting down
+        bool sleepWhileRunning(std::chrono::milliseconds duration) {
+            auto until = std::chrono::steady_clock::now() + duration;
+            while (running_ && std::chrono::steady_clock::now() < until) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            }
+            return running_;
+        }
+
+        // Rebuild the receive socket after a socket error, retrying with exponential backoff, and
+        // re-apply every subscription to it
+        void recoverReceiver(const std::string& reason) {
+            linkLost(reason);
+            auto backoff = initial_backoff_;
+            while (sleepWhileRunning(backoff)) {
+                try {
+                    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                    if (protocol_ == Protocol::TCP) {
+                        openSubscriberTCP();  // Up again (and filters registered) on its connect event
+                    } else {
+                        openReceiverUDP();
+                        renewSubscriptionsUDP();
+                    }
+                    return;
+                } catch (const std::exception& e) {
+                    debugLog("Reconnect attempt failed: " + std::string(e.what()));
+                    backoff = std::min(backoff * 2, max_backoff_);
+                }
+            }
+        }
+
         // TCP Implementation
         bool connectTCP() {
             try {
                 zmq_context_ = std::make_unique<zmq::context_t>(1);
-                subscriber_socket_ = std::make_unique<zmq::socket_t>(*zmq_context_, zmq::socket_type::sub);
-
-                // Set socket options
-                int linger = 1000;  // 1 second linger
-                subscriber_socket_->set(zmq::sockopt::linger, linger);
-
-                std::string subscribe_addr = "tcp://" + host_ + ":" + std::to_string(port_);
-                subscriber_socket_->connect(subscribe_addr);
+                ack_topic_ = "ack." + client_id_;
+                query_topic_ = "query." + client_id_;
+                filter_topic_prefix_ = "filter." + client_id_ + ".";
+                {
+                    std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                    openSubscriberTCP();
+                }
 
                 connected_ = true;
                 running_ = true;
 
                 // Start receive thread
-                receive_thread_ = std::thread(&TelemetryClientImpl::tcpReceiveLoop, this);
+                receive_thread_ = std::thread(&ServiceConnection::tcpReceiveLoop, this);
 
                 if (connection_callback_) {
                     connection_callback_(true, "");
@@ -298,10 +642,7 @@ namespace TelemetryAPI {
 
         void disconnectTCP() {
             try {
-                if (subscriber_socket_) {
-                    subscriber_socket_->close();
-                    subscriber_socket_.reset();
-                }
+                closeSubscriberTCP();
                 if (command_socket_) {
                     command_socket_->close();
                     command_socket_.reset();
@@ -315,25 +656,124 @@ namespace TelemetryAPI {
             }
         }
 
+        // (Re)create the subscriber socket with a monitor for its connection events, and subscribe it to
+        // everything this client receives (caller holds subscriptions_mutex_)
+        void openSubscriberTCP() {
+            closeSubscriberTCP();
+            subscriber_socket_ = std::make_unique<zmq::socket_t>(*zmq_context_, zmq::socket_type::sub);
+
+            // Set socket options
+            int linger = 1000;  // 1 second linger
+            subscriber_socket_->set(zmq::sockopt::linger, linger);
+            // ZeroMQ reconnects by itself, doubling the interval up to the maximum
+            subscriber_socket_->set(zmq::sockopt::reconnect_ivl, static_cast<int>(initial_backoff_.count()));
+            subscriber_socket_->set(zmq::sockopt::reconnect_ivl_max, static_cast<int>(max_backoff_.count()));
+            // Heartbeats make a hung or unreachable service count as disconnected, not only a closed connection
+            subscriber_socket_->set(zmq::sockopt::heartbeat_ivl, HEARTBEAT_INTERVAL_MS);
+            subscriber_socket_->set(zmq::sockopt::heartbeat_timeout, HEARTBEAT_TIMEOUT_MS);
+
+            // Connection events of the subscriber arrive on an inproc pair socket polled by the receive loop
+            std::ostringstream monitor_addr;
+            monitor_addr << "inproc://monitor." << client_id_ << "." << static_cast<const void*>(this) << "."
+                         << ++monitor_generation_;
+            if (zmq_socket_monitor(subscriber_socket_->handle(), monitor_addr.str().c_str(),
+                                   ZMQ_EVENT_CONNECTED | ZMQ_EVENT_DISCONNECTED)
+                != 0) {
+                throw zmq::error_t();
+            }
+            monitor_socket_ = std::make_unique<zmq::socket_t>(*zmq_context_, zmq::socket_type::pair);
+            monitor_socket_->connect(monitor_addr.str());
+
+            std::string subscribe_addr = "tcp://" + host_ + ":" + std::to_string(port_);
+            subscriber_socket_->connect(subscribe_addr);
+
+            // Command outcomes and query answers for this client arrive on the same socket; after a
+            // rebuild, the existing subscriptions are applied to the new socket
+            subscriber_socket_->set(zmq::sockopt::subscribe, ack_topic_);
+            subscriber_socket_->set(zmq::sockopt::subscribe, query_topic_);
+            for (const auto& subscription : subscriptions_) {
+                if (subscription.find_first_of("?@") == std::string::npos) {
+                    subscriber_socket_->set(zmq::sockopt::subscribe, zmqPrefix(subscription));
+                }
+            }
+            for (const auto& [subscription, filter_id] : filter_ids_) {
+                subscriber_socket_->set(zmq::sockopt::subscribe,
+                                        filter_topic_prefix_ + std::to_string(filter_id) + ".");
+            }
+        }
+
+        // Close the subscriber socket and its monitor (caller holds subscriptions_mutex_ or has joined the
+        // receive thread)
+        void closeSubscriberTCP() {
+            if (subscriber_socket_) {
+                zmq_socket_monitor(subscriber_socket_->handle(), nullptr, 0);
+            }
+            if (monitor_socket_) {
+                monitor_socket_->close();
+                monitor_socket_.reset();
+            }
+            if (subscriber_socket_) {
+                subscriber_socket_->close();
+                subscriber_socket_.reset();
+            }
+        }
+
+        // Handle one event of the subscriber's monitor: the service went away or answers again
+        void handleMonitorEvent() {
+            zmq::message_t event_msg;
+            zmq::message_t address_msg;
+            if (!monitor_socket_->recv(event_msg, zmq::recv_flags::dontwait)) {
+                return;
+            }
+            // Two frames: 16-bit event id and 32-bit value, then the endpoint address
+            (void)monitor_socket_->recv(address_msg, zmq::recv_flags::dontwait);
+            uint16_t event = 0;
+            if (event_msg.size() >= sizeof(event)) {
+                std::memcpy(&event, event_msg.data(), sizeof(event));
+            }
+            if (event == ZMQ_EVENT_DISCONNECTED) {
+                linkLost("Connection to the service lost");
+            } else if (event == ZMQ_EVENT_CONNECTED) {
+                linkRestored();
+            }
+        }
+
+        // Register every filtered and derived subscription with the service again, under its existing id
+        // (a restarted service has forgotten them; caller holds subscriptions_mutex_)
+        void registerFiltersTCP() {
+            for (const auto& [subscription, filter_id] : filter_ids_) {
+                if (!queueCommand("FILTER|" + client_id_ + "|" + std::to_string(filter_id) + "|" + subscription)) {
+                    debugLog("Could not re-register filter " + std::to_string(filter_id));
+                }
+            }
+        }
+
+        // ZeroMQ only supports prefix matching, not wildcard patterns: subscribe to the prefix and filter
+        // on the client, so wildcards behave as with UDP
+        static std::string zmqPrefix(const std::string& topic) {
+            if (topic == "telemetry.*" || topic.find("telemetry.*.") == 0) {
+                // For any telemetry wildcard pattern, subscribe to the full prefix
+                return "telemetry.";
+            }
+            if (topic.find("telemetry.") == 0) {
+                // For specific telemetry topics, subscribe to exact prefix
+                return topic;
+            }
+            if (topic.find('*') != std::string::npos) {
+                // Other wildcard patterns (e.g. "alert.*.geofence.*"): prefix before the first wildcard
+                return topic.substr(0, topic.find('*'));
+            }
+            // For non-telemetry topics, use as-is
+            return topic;
+        }
+
         bool subscribeTCP(const std::string& topic) {
+            if (topic.find_first_of("?@") != std::string::npos) {
+                return subscribeFilterTCP(topic);
+            }
             try {
                 if (subscriber_socket_) {
-                    // ZeroMQ only supports prefix matching, not wildcard patterns
-                    // We always subscribe to "telemetry." prefix and do client-side filtering
-                    // This ensures consistent behavior with UDP wildcard patterns
-                    std::string zmq_topic;
-
-                    if (topic == "telemetry.*" || topic.find("telemetry.*.") == 0) {
-                        // For any telemetry wildcard pattern, subscribe to the full prefix
-                        zmq_topic = "telemetry.";
-                    } else if (topic.find("telemetry.") == 0) {
-                        // For specific telemetry topics, subscribe to exact prefix
-                        zmq_topic = topic;
-                    } else {
-                        // For non-telemetry topics, use as-is
-                        zmq_topic = topic;
-                    }
-
+                    std::string zmq_topic = zmqPrefix(topic);
                     subscriber_socket_->set(zmq::sockopt::subscribe, zmq_topic);
                     subscriptions_.insert(topic);  // Keep original pattern for client-side filtering
 
@@ -347,23 +787,79 @@ namespace TelemetryAPI {
             return false;
         }
 
-        bool unsubscribeTCP(const std::string& topic) {
+        // Content-based or derived-stream subscription: the service evaluates the expression (or computes the
+        // stream) and publishes on "filter.<client_id>.<filter_id>.<topic>", the only prefix we subscribe to
+        bool subscribeFilterTCP(const std::string& subscription) {
             try {
                 if (subscriber_socket_) {
-                    // Use the same logic as subscribe to determine ZMQ prefix
-                    std::string zmq_topic;
-
-                    if (topic == "telemetry.*" || topic.find("telemetry.*.") == 0) {
-                        // For any telemetry wildcard pattern, use the full prefix
-                        zmq_topic = "telemetry.";
-                    } else if (topic.find("telemetry.") == 0) {
-                        // For specific telemetry topics, use exact prefix
-                        zmq_topic = topic;
-                    } else {
-                        // For non-telemetry topics, use as-is
-                        zmq_topic = topic;
+                    uint32_t filter_id = next_filter_id_++;
+                    std::string prefix = filter_topic_prefix_ + std::to_string(filter_id) + ".";
+                    subscriber_socket_->set(zmq::sockopt::subscribe, prefix);
+                    if (!queueCommand("FILTER|" + client_id_ + "|" + std::to_string(filter_id) + "|" + subscription)) {
+                        subscriber_socket_->set(zmq::sockopt::unsubscribe, prefix);
+                        return false;
                     }
+                    filter_ids_[subscription] = filter_id;
+                    subscriptions_.insert(subscription);
+                    debugLog("TCP filter " + std::to_string(filter_id) + " registered: '" + subscription + "'");
+                    return true;
+                }
+            } catch (const std::exception& e) {
+                std::cerr << "TCP filter subscription error for '" << subscription << "': " << e.what() << std::endl;
+            }
+            return false;
+        }
+
+        bool unsubscribeFilterTCP(const std::string& subscription) {
+            auto it = filter_ids_.find(subscription);
+            if (it == filter_ids_.end()) {
+                return false;
+            }
+            uint32_t filter_id = it->second;
+            filter_ids_.erase(it);
+            subscriptions_.erase(subscription);
+            queueCommand("UNFILTER|" + client_id_ + "|" + std::to_string(filter_id));
+            try {
+                if (subscriber_socket_) {
+                    subscriber_socket_->set(zmq::sockopt::unsubscribe,
+                                            filter_topic_prefix_ + std::to_string(filter_id) + ".");
+                }
+            } catch (const std::exception&) {
+                // Ignore unsubscription errors
+            }
+            return true;
+        }
+
+        // Map a packet received on "filter.<client_id>.<filter_id>.<topic>" back to <topic>
+        // (empty if the filter is no longer ours)
+        std::string unwrapFilteredTopic(const std::string& topic) const {
+            size_t id_end = topic.find('.', filter_topic_prefix_.size());
+            if (id_end == std::string::npos) {
+                return {};
+            }
+            uint32_t filter_id = 0;
+            try {
+                filter_id = static_cast<uint32_t>(
+                    std::stoul(topic.substr(filter_topic_prefix_.size(), id_end - filter_topic_prefix_.size())));
+            } catch (const std::exception&) {
+                return {};
+            }
+            std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+            for (const auto& entry : filter_ids_) {
+                if (entry.second == filter_id) {
+                    return topic.substr(id_end + 1);
+                }
+            }
+            return {};
+        }
 
+        bool unsubscribeTCP(const std::string& topic) {
+            if (topic.find_first_of("?@") != std::string::npos) {
+                return unsubscribeFilterTCP(topic);
+            }
+            try {
+                if (subscriber_socket_) {
+                    std::string zmq_topic = zmqPrefix(topic);
                     subscriber_socket_->set(zmq::sockopt::unsubscribe, zmq_topic);
                     subscriptions_.erase(topic);
 
@@ -384,8 +880,15 @@ namespace TelemetryAPI {
                     zmq::message_t data_msg;
 
                     // Use polling to avoid blocking indefinitely
-                    zmq::pollitem_t items[] = {{*subscriber_socket_, 0, ZMQ_POLLIN, 0}};
-                    int rc = zmq::poll(items, 1, std::chrono::milliseconds(100));
+                    zmq::pollitem_t items[] = {{*subscriber_socket_, 0, ZMQ_POLLIN, 0},
+                                               {*monitor_socket_, 0, ZMQ_POLLIN, 0}};
+                    int rc = zmq::poll(items, 2, std::chrono::milliseconds(100));
+                    expirePendingCommands();
+                    expirePendingQueries();
+
+                    if (rc > 0 && (items[1].revents & ZMQ_POLLIN)) {
+                        handleMonitorEvent();
+                    }
 
                     if (rc > 0 && (items[0].revents & ZMQ_POLLIN)) {
                         debugLog("Message available on TCP socket");
@@ -399,12 +902,34 @@ namespace TelemetryAPI {
 
                                 debugLog("Received topic: " + topic + ", data size: " + std::to_string(data.size()));
 
+                                if (topic == ack_topic_) {
+                                    handleCommandAck(data);
+                                    continue;
+                                }
+                                if (topic == query_topic_) {
+                                    handleQueryReply(data);
+                                    continue;
+                                }
+
+                                // Packets that passed one of our content-based filters in the service
+                                if (topic.rfind(filter_topic_prefix_, 0) == 0) {
+                                    std::string original_topic = unwrapFilteredTopic(topic);
+                                    std::lock_guard<std::mutex> lock(callback_mutex_);
+                                    if (!original_topic.empty() && telemetry_callback_) {
+                                        telemetry_callback_(original_topic, data);
+                                    }
+                                    continue;
+                                }
+
                                 // Check if this topic matches any of our wildcard subscriptions
                                 bool shouldDeliver = false;
                                 {
                                     std::lock_guard<std::mutex> lock(subscriptions_mutex_);
                                     for (const auto& subscription : subscriptions_) {
-                                        if (matchesWildcardPattern(subscription, topic)) {
+                                        // Filtered and derived subscriptions are delivered above, never by
+                                        // pattern alone
+                                        if (subscription.find_first_of("?@") == std::string::npos
+                                            && matchesWildcardPattern(subscription, topic)) {
                                             shouldDeliver = true;
                                             break;
                                         }
@@ -427,12 +952,8 @@ namespace TelemetryAPI {
                 } catch (const std::exception& e) {
                     debugLog("TCP receive error: " + std::string(e.what()));
                     if (running_) {
-                        // Only report error if we're supposed to be running
-                        connected_ = false;
-                        if (connection_callback_) {
-                            connection_callback_(false, "TCP receive error");
-                        }
-                        break;
+                        // Only recover if we're supposed to be running
+                        recoverReceiver("TCP receive error");
                     }
                 }
             }
@@ -491,16 +1012,23 @@ namespace TelemetryAPI {
                 io_context_ = std::make_unique<boost::asio::io_context>();
 
                 // Socket for receiving published telemetry (random port, service will send to this endpoint)
-                udp_socket_ = std::make_unique<udp::socket>(*io_context_, udp::endpoint(udp::v4(), 0));
+                openReceiverUDP();
 
-                // Socket for sending subscription requests (also random port)
+                // Socket for sending subscription requests (also random port; confirmations come back here)
                 subscription_socket_ = std::make_unique<udp::socket>(*io_context_, udp::endpoint(udp::v4(), 0));
 
+                // UDP has no connection: the link counts as up until the service stops confirming
+                udp_confirmed_ = false;
+                confirmation_pending_ = false;
+                renewal_backoff_ = initial_backoff_;
+                next_renewal_ = std::chrono::steady_clock::now() + UDP_RENEW_INTERVAL;
+                linkRestored();
+
                 connected_ = true;
                 running_ = true;
 
                 // Start receive thread
-                receive_thread_ = std::thread(&TelemetryClientImpl::udpReceiveLoop, this);
+                receive_thread_ = std::thread(&ServiceConnection::udpReceiveLoop, this);
 
                 if (connection_callback_) {
                     connection_callback_(true, "");
@@ -536,34 +1064,109 @@ namespace TelemetryAPI {
             }
         }
 
-        bool subscribeUDP(const std::string& topic) {
-            debugLog("UDP subscribing to topic: " + topic);
-            try {
-                if (subscription_socket_ && udp_socket_) {
-                    // Get the local endpoint where we're listening for published data
-                    auto local_endpoint = udp_socket_->local_endpoint();
+        // (Re)create the socket receiving published telemetry (caller holds subscriptions_mutex_ or is connecting)
+        void openReceiverUDP() {
+            if (udp_socket_ && udp_socket_->is_open()) {
+                boost::system::error_code ignored;
+                udp_socket_->close(ignored);
+            }
+            udp_socket_ = std::make_unique<udp::socket>(*io_context_, udp::endpoint(udp::v4(), 0));
+        }
 
-                    // Send subscription request: "SUBSCRIBE|topic|client_id|client_port"
-                    std::string message =
-                        "SUBSCRIBE|" + topic + "|" + client_id_ + "|" + std::to_string(local_endpoint.port());
+        // Service endpoint for subscription requests
+        udp::endpoint serviceEndpointUDP() {
+            // Handle hostname resolution for UDP endpoint
+            boost::asio::ip::address addr;
+            if (host_ == "localhost") {
+                addr = boost::asio::ip::address::from_string("127.0.0.1");
+            } else {
+                try {
+                    addr = boost::asio::ip::address::from_string(host_);
+                } catch (const std::exception&) {
+                    // If not a valid IP, try resolving as hostname
+                    boost::asio::ip::udp::resolver resolver(*io_context_);
+                    auto results = resolver.resolve(host_, std::to_string(port_));
+                    addr = results.begin()->endpoint().address();
+                }
+            }
+            return udp::endpoint(addr, port_);
+        }
 
-                    // Handle hostname resolution for UDP endpoint
-                    boost::asio::ip::address addr;
-                    if (host_ == "localhost") {
-                        addr = boost::asio::ip::address::from_string("127.0.0.1");
-                    } else {
-                        try {
-                            addr = boost::asio::ip::address::from_string(host_);
-                        } catch (const std::exception&) {
-                            // If not a valid IP, try resolving as hostname
-                            boost::asio::ip::udp::resolver resolver(*io_context_);
-                            auto results = resolver.resolve(host_, std::to_string(port_));
-                            addr = results.begin()->endpoint().address();
-                        }
+        // Send "SUBSCRIBE|topic|client_id|client_port" (repeating it is harmless: it renews the subscription)
+        void sendSubscribeUDP(const std::string& topic) {
+            auto local_endpoint = udp_socket_->local_endpoint();
+            std::string message = "SUBSCRIBE|" + topic + "|" + client_id_ + "|" + std::to_string(local_endpoint.port());
+            subscription_socket_->send_to(boost::asio::buffer(message), serviceEndpointUDP());
+        }
+
+        // Re-send every subscription (caller holds subscriptions_mutex_). The service keeps UDP subscriptions
+        // only in memory, so this is what restores them after it restarts.
+        void renewSubscriptionsUDP() {
+            for (const auto& subscription : subscriptions_) {
+                try {
+                    sendSubscribeUDP(subscription);
+                } catch (const std::exception& e) {
+                    debugLog("UDP renewal error for '" + subscription + "': " + e.what());
+                }
+            }
+        }
+
+        // Renew the subscriptions when due: every second while the service confirms them, with exponential
+        // backoff after it stopped doing so (receive thread)
+        void maintainSubscriptionsUDP() {
+            auto now = std::chrono::steady_clock::now();
+            if (now < next_renewal_) {
+                return;
+            }
+            {
+                std::lock_guard<std::mutex> lock(subscriptions_mutex_);
+                if (subscriptions_.empty()) {
+                    next_renewal_ = now + UDP_RENEW_INTERVAL;
+                    return;
+                }
+                renewSubscriptionsUDP();
+            }
+            if (udp_confirmed_ && now - last_confirmation_ > UDP_LEASE_TIMEOUT) {
+                linkLost("No answer from the service");
+            }
+            if (getConnectionStats().link_up) {
+                renewal_backoff_ = initial_backoff_;
+                next_renewal_ = now + UDP_RENEW_INTERVAL;
+            } else {
+                next_renewal_ = now + renewal_backoff_;
+                renewal_backoff_ = std::min(renewal_backoff_ * 2, max_backoff_);
+            }
+        }
+
+        // Keep one receive outstanding for "SUBSCRIBED|topic" confirmations on the subscription socket
+        void receiveConfirmationUDP() {
+            if (confirmation_pending_) {
+                return;
+            }
+            confirmation_pending_ = true;
+            subscription_socket_->async_receive_from(
+                boost::asio::buffer(confirmation_buffer_),
+                confirmation_sender_,
+                [this](boost::system::error_code ec, std::size_t bytes_received) {
+                    confirmation_pending_ = false;
+                    if (ec || !running_) {
+                        return;
                     }
+                    std::string message(confirmation_buffer_.data(), bytes_received);
+                    if (message.rfind("SUBSCRIBED|", 0) == 0) {
+                        udp_confirmed_ = true;
+                        last_confirmation_ = std::chrono::steady_clock::now();
+                        linkRestored();
+                    }
+                });
+        }
 
-                    udp::endpoint service_endpoint(addr, port_);
-                    subscription_socket_->send_to(boost::asio::buffer(message), service_endpoint);
+        bool subscribeUDP(const std::string& topic) {
+            debugLog("UDP subscribing to topic: " + topic);
+            try {
+                if (subscription_socket_ && udp_socket_) {
+                    // Subscription request to the endpoint where we're listening for published data
+                    sendSubscribeUDP(topic);
                     subscriptions_.insert(topic);
                     return true;
                 }
@@ -580,24 +1183,7 @@ namespace TelemetryAPI {
                 if (subscription_socket_) {
                     // Send unsubscription request: "UNSUBSCRIBE|topic|client_id"
                     std::string message = "UNSUBSCRIBE|" + topic + "|" + client_id_;
-
-                    // Handle hostname resolution for UDP endpoint
-                    boost::asio::ip::address addr;
-                    if (host_ == "localhost") {
-                        addr = boost::asio::ip::address::from_string("127.0.0.1");
-                    } else {
-                        try {
-                            addr = boost::asio::ip::address::from_string(host_);
-                        } catch (const std::exception&) {
-                            // If not a valid IP, try resolving as hostname
-                            boost::asio::ip::udp::resolver resolver(*io_context_);
-                            auto results = resolver.resolve(host_, std::to_string(port_));
-                            addr = results.begin()->endpoint().address();
-                        }
-                    }
-
-                    udp::endpoint service_endpoint(addr, port_);
-                    subscription_socket_->send_to(boost::asio::buffer(message), service_endpoint);
+                    subscription_socket_->send_to(boost::asio::buffer(message), serviceEndpointUDP());
                     subscriptions_.erase(topic);
                     return true;
                 }
@@ -645,6 +1231,10 @@ namespace TelemetryAPI {
                             }
                         });
 
+                    // Watch for subscription confirmations, renewing the subscriptions when due
+                    receiveConfirmationUDP();
+                    maintainSubscriptionsUDP();
+
                     // Run for a short time
                     io_context_->run_for(std::chrono::milliseconds(100));
                     io_context_->restart();
@@ -652,11 +1242,7 @@ namespace TelemetryAPI {
                 } catch (const std::exception& e) {
                     debugLog("UDP receive error: " + std::string(e.what()));
                     if (running_) {
-                        connected_ = false;
-                        if (connection_callback_) {
-                            connection_callback_(false, "UDP receive error");
-                        }
-                        break;
+                        recoverReceiver("UDP receive error");
                     }
                 }
             }
@@ -664,6 +1250,472 @@ namespace TelemetryAPI {
         }
     };
 
+    /**
+     * @brief Implementation class using PIMPL pattern to hide dependencies
+     *
+     * Spreads the client over one or more service instances, one ServiceConnection each, all subscribed
+     * to the same topics. In failover mode only the active connection delivers telemetry and the next
+     * reachable one takes over when its link drops; in active/active mode every connection delivers and
+     * copies of the same packet are dropped. Commands and queries go to the active connection.
+     */
+    class TelemetryClientImpl {
+       public:
+        explicit TelemetryClientImpl(const std::string& client_id) : client_id_(client_id) {}
+
+        ~TelemetryClientImpl() {
+            disconnect();
+        }
+
+        bool connect(const std::vector<ServiceEndpoint>& endpoints, Protocol protocol, Redundancy redundancy) {
+            if (!connections_.empty()) {
+                return false;  // Already connected
+            }
+            if (endpoints.empty() || endpoints.size() > MAX_ENDPOINTS) {
+                reportConnection(false, "Expected 1 to " + std::to_string(MAX_ENDPOINTS) + " service endpoints");
+                return false;
+            }
+
+            protocol_ = protocol;
+            redundancy_ = redundancy;
+            names_.clear();
+            for (const auto& endpoint : endpoints) {
+                names_.push_back(endpoint.host + ":" + std::to_string(endpoint.port));
+            }
+            {
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                link_up_.assign(endpoints.size(), false);
+                failovers_ = 0;
+                failover_pending_ = false;
+                last_failover_ = max_failover_ = std::chrono::milliseconds(0);
+            }
+            active_ = 0;
+            duplicates_dropped_ = 0;
+            {
+                std::lock_guard<std::mutex> lock(delivery_mutex_);
+                dedupe_.clear();
+                dedupe_expiry_.clear();
+                returned_endpoints_ = 0;
+            }
+
+            // All connections exist before the first one starts calling back
+            for (size_t index = 0; index < endpoints.size(); ++index) {
+                auto connection = std::make_unique<ServiceConnection>(client_id_);
+                connection->setReconnectBackoff(initial_backoff_, max_backoff_);
+                connection->setTelemetryCallback(
+                    [this, index](const std::string& topic, const std::vector<uint8_t>& data) {
+                        deliver(index, topic, data);
+                    });
+                connection->setConnectionCallback([this, index](bool connected, const std::string& message) {
+                    connectionEvent(index, connected, message);
+                });
+                connection->setLinkObserver([this, index](bool up) { linkChanged(index, up); });
+                connections_.push_back(std::move(connection));
+            }
+
+            bool connected = false;
+            for (size_t index = 0; index < endpoints.size(); ++index) {
+                connected = connections_[index]->connect(endpoints[index].host, endpoints[index].port, protocol)
+                            || connected;
+            }
+            if (!connected) {
+                connections_.clear();
+            }
+            return connected;
+        }
+
+        bool connectFromConfig(const std::string& config_file, Protocol protocol) {
+            try {
+                std::ifstream file(config_file);
+                if (!file.is_open()) {
+                    reportConnection(false, "Cannot open config file: " + config_file);
+                    return false;
+                }
+
+                json config_json;
+                file >> config_json;
+                file.close();
+
+                if (!config_json.contains("ui_ports")) {
+                    reportConnection(false, "Config file missing 'ui_ports' section");
+                    return false;
+                }
+
+                const char* port_key = protocol == Protocol::TCP ? "tcp_publish_port" : "udp_publish_port";
+                int port = config_json["ui_ports"].at(port_key);
+
+                std::string host = "localhost";  // Default for local service
+                std::vector<ServiceEndpoint> endpoints;
+                Redundancy redundancy = Redundancy::FAILOVER;
+                if (config_json.contains("service")) {
+                    const auto& service = config_json["service"];
+                    host = service.value("ip", host);
+
+                    // Redundant instances: "endpoints": [{"ip": ..., "<port key>": ...}, ...], in priority order
+                    if (service.contains("endpoints")) {
+                        for (const auto& endpoint : service.at("endpoints")) {
+                            endpoints.push_back(ServiceEndpoint{endpoint.at("ip").get<std::string>(),
+                                                                endpoint.value(port_key, port)});
+                        }
+                    }
+                    std::string mode = service.value("redundancy", std::string("failover"));
+                    if (mode == "active_active") {
+                        redundancy = Redundancy::ACTIVE_ACTIVE;
+                    } else if (mode != "failover") {
+                        reportConnection(false, "Unknown redundancy mode '" + mode + "'");
+                        return false;
+                    }
+                }
+                if (endpoints.empty()) {
+                    endpoints.push_back(ServiceEndpoint{host, port});
+                }
+
+                return connect(endpoints, protocol, redundancy);
+
+            } catch (const std::exception& e) {
+                reportConnection(false, "Config parsing error: " + std::string(e.what()));
+                return false;
+            }
+        }
+
+        void disconnect() {
+            if (connections_.empty()) {
+                return;
+            }
+
+            // Every connection reports its own disconnect; the application hears about it once
+            disconnecting_ = true;
+            for (auto& connection : connections_) {
+                connection->disconnect();
+            }
+            connections_.clear();
+            {
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                link_up_.clear();
+                failover_pending_ = false;
+            }
+            disconnecting_ = false;
+
+            reportConnection(false, "");  // Normal disconnect
+        }
+
+        bool isConnected() const {
+            for (const auto& connection : connections_) {
+                if (connection->isConnected()) {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        bool subscribe(const std::string& topic) {
+            bool subscribed = false;
+            for (auto& connection : connections_) {
+                subscribed = connection->subscribe(topic) || subscribed;
+            }
+            return subscribed;
+        }
+
+        bool unsubscribe(const std::string& topic) {
+            bool unsubscribed = false;
+            for (auto& connection : connections_) {
+                unsubscribed = connection->unsubscribe(topic) || unsubscribed;
+            }
+            return unsubscribed;
+        }
+
+        bool sendCommand(const std::string& uav_name, const std::string& command) {
+            ServiceConnection* connection = activeConnection();
+            return connection && connection->sendCommand(uav_name, command);
+        }
+
+        bool sendCommandWithAck(const std::string& uav_name,
+                                const std::string& command,
+                                CommandCallback callback,
+                                std::chrono::milliseconds timeout) {
+            ServiceConnection* connection = activeConnection();
+            if (!connection) {
+                if (callback) {
+                    callback(CommandResult{});  // Undelivered
+                }
+                return false;
+            }
+            return connection->sendCommandWithAck(uav_name, command, std::move(callback), timeout);
+        }
+
+        bool sendQuery(const std::string& query, QueryCallback callback, std::chrono::milliseconds timeout) {
+            ServiceConnection* connection = activeConnection();
+            if (!connection) {
+                if (callback) {
+                    QueryResult result;
+                    result.error = "not connected";
+                    callback(result);
+                }
+                return false;
+            }
+            return connection->sendQuery(query, std::move(callback), timeout);
+        }
+
+        void setTelemetryCallback(TelemetryCallback callback) {
+            std::lock_guard<std::mutex> lock(delivery_mutex_);
+            telemetry_callback_ = std::move(callback);
+        }
+
+        void setConnectionCallback(ConnectionCallback callback) {
+            std::lock_guard<std::mutex> lock(callback_mutex_);
+            connection_callback_ = std::move(callback);
+        }
+
+        void setReconnectBackoff(std::chrono::milliseconds initial, std::chrono::milliseconds maximum) {
+            initial_backoff_ = initial;
+            max_backoff_ = maximum;
+        }
+
+        ConnectionStats getConnectionStats() const {
+            ConnectionStats stats;
+            if (connections_.empty()) {
+                return stats;
+            }
+            size_t active = active_;
+            for (size_t index = 0; index < connections_.size(); ++index) {
+                ConnectionStats endpoint_stats = connections_[index]->getConnectionStats();
+                stats.link_up = stats.link_up || endpoint_stats.link_up;
+                stats.reconnects += endpoint_stats.reconnects;
+                stats.total_outage += endpoint_stats.total_outage;
+                if (index == active) {
+                    stats.last_outage = endpoint_stats.last_outage;
+                }
+            }
+            stats.active_endpoint = active;
+            stats.duplicates_dropped = duplicates_dropped_;
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            stats.failovers = failovers_;
+            stats.last_failover = last_failover_;
+            stats.max_failover = max_failover_;
+            return stats;
+        }
+
+        const std::string& getClientId() const {
+            return client_id_;
+        }
+
+        Protocol getProtocol() const {
+            return protocol_;
+        }
+
+       private:
+        static constexpr size_t MAX_ENDPOINTS = 8;
+        static constexpr std::chrono::seconds DEDUPE_WINDOW{2};  // Longest lag between two service instances
+
+        /**
+         * @brief Copies of one packet content seen per endpoint (active/active mode)
+         */
+        struct DedupeEntry {
+            std::array<uint32_t, MAX_ENDPOINTS> copies{};  // Per endpoint
+            uint32_t delivered{0};                         // Largest of copies: the number passed on
+            std::chrono::steady_clock::time_point last_seen;
+        };
+
+        // The connection that commands and queries go to (nullptr if not connected)
+        ServiceConnection* activeConnection() {
+            size_t active = active_;
+            return active < connections_.size() ? connections_[active].get() : nullptr;
+        }
+
+        void reportConnection(bool connected, const std::string& message) {
+            ConnectionCallback callback;
+            {
+                std::lock_guard<std::mutex> lock(callback_mutex_);
+                callback = connection_callback_;
+            }
+            if (callback) {
+                callback(connected, message);
+            }
+        }
+
+        // A connection reports an error, an outage or a recovery. With several endpoints the client stays
+        // connected while any of them is up, and the message says which endpoint it concerns.
+        void connectionEvent(size_t index, bool connected, const std::string& message) {
+            if (disconnecting_) {
+                return;
+            }
+            if (names_.size() == 1) {
+                reportConnection(connected, message);
+                return;
+            }
+            bool any_up;
+            {
+                std::lock_guard<std::mutex> lock(state_mutex_);
+                any_up = std::find(link_up_.begin(), link_up_.end(), true) != link_up_.end();
+            }
+            std::string text = names_[index] + ": " + message;
+            if (any_up) {
+                text += redundancy_ == Redundancy::FAILOVER ? "; receiving from " + names_[active_]
+                                                            : "; commands go to " + names_[active_];
+            }
+            reportConnection(connected || any_up, text);
+        }
+
+        // Link of one endpoint went up or down: pick the active endpoint and start timing a failover
+        void linkChanged(size_t index, bool up) {
+            std::lock_guard<std::mutex> lock(state_mutex_);
+            if (index >= link_up_.size()) {
+                return;
+            }
+            link_up_[index] = up;
+            if (up) {
+                returned_endpoints_ |= 1u << index;  // Its copy counts start over
+                if (!link_up_[active_]) {
+                    active_ = index;
+                }
+                return;
+            }
+            if (index != active_) {
+                if (redundancy_ == Redundancy::ACTIVE_ACTIVE && link_up_[active_]) {
+                    startFailover();  // One of the delivering endpoints dropped out
+                }
+                return;
+            }
+            // Next reachable endpoint in priority order; it stays active when the failed one returns
+            for (size_t step = 1; step < link_up_.size(); ++step) {
+                size_t candidate = (index + step) % link_up_.size();
+                if (link_up_[candidate]) {
+                    active_ = candidate;
+                    startFailover();
+                    return;
+                }
+            }
+        }
+
+        // The gap is measured from the last packet delivered before the failover (caller holds state_mutex_)
+        void startFailover() {
+            ++failovers_;
+            int64_t last_delivery = last_delivery_ns_;
+            failover_start_ = last_delivery != 0 ? std::chrono::steady_clock::time_point(
+                                                       std::chrono::steady_clock::duration(last_delivery))
+                                                 : std::chrono::steady_clock::now();
+            failover_pending_ = true;
+        }
+
+        // Only UAV packets relayed unchanged are byte-identical across instances. Each instance computes its
+        // own derived streams ("...@<spec>" slots and windows), fleet analytics and link events, so copies of
+        // those cannot be matched and are taken from the active endpoint only, even in active/active mode.
+        static bool isRelayedTopic(const std::string& topic) {
+            return topic.rfind("telemetry.", 0) == 0 && topic.find('@') == std::string::npos;
+        }
+
+        // Telemetry from one connection: pass it on unless it comes from a standby or is a copy
+        void deliver(size_t index, const std::string& topic, const std::vector<uint8_t>& data) {
+            bool deduplicated = redundancy_ == Redundancy::ACTIVE_ACTIVE && isRelayedTopic(topic);
+            if (!deduplicated && index != active_) {
+                return;  // Standby: subscribed, so it can take over at once, but not delivering
+            }
+            auto now = std::chrono::steady_clock::now();
+            std::lock_guard<std::mutex> lock(delivery_mutex_);
+            if (deduplicated && names_.size() > 1 && isDuplicate(index, topic, data, now)) {
+                ++duplicates_dropped_;
+                return;
+            }
+
+            last_delivery_ns_ = now.time_since_epoch().count();
+            if (failover_pending_) {
+                std::lock_guard<std::mutex> state_lock(state_mutex_);
+                if (failover_pending_) {
+                    last_failover_ = std::chrono::duration_cast<std::chrono::milliseconds>(now - failover_start_);
+                    max_failover_ = std::max(max_failover_, last_failover_);
+                    failover_pending_ = false;
+                }
+            }
+            if (telemetry_callback_) {
+                telemetry_callback_(topic, data);
+            }
+        }
+
+        // Every packet arrives once per endpoint. The n-th copy of a content from an endpoint passes only if
+        // no endpoint passed n copies of it yet, so identical packets sent repeatedly (a hovering UAV) are
+        // kept, and a packet one endpoint lost still arrives through another (caller holds delivery_mutex_).
+        bool isDuplicate(size_t index,
+                         const std::string& topic,
+                         const std::vector<uint8_t>& data,
+                         std::chrono::steady_clock::time_point now) {
+            // An endpoint that (re)connected starts counting from zero; the copies the others delivered
+            // meanwhile stay, so their lagging copies in flight are still recognized
+            if (uint32_t returned = returned_endpoints_.exchange(0)) {
+                for (auto& [key, entry] : dedupe_) {
+                    for (size_t endpoint = 0; endpoint < MAX_ENDPOINTS; ++endpoint) {
+                        if (returned & (1u << endpoint)) {
+                            entry.copies[endpoint] = 0;
+                        }
+                    }
+                }
+            }
+            while (!dedupe_expiry_.empty() && now - dedupe_expiry_.front().second > DEDUPE_WINDOW) {
+                auto entry_it = dedupe_.find(dedupe_expiry_.front().first);
+                if (entry_it != dedupe_.end() && entry_it->second.last_seen == dedupe_expiry_.front().second) {
+                    dedupe_.erase(entry_it);  // Not seen again within the window
+                }
+                dedupe_expiry_.pop_front();
+            }
+
+            uint64_t key = fingerprint(topic, data);
+            DedupeEntry& entry = dedupe_[key];
+            entry.last_seen = now;
+            dedupe_expiry_.emplace_back(key, now);
+            if (++entry.copies[index] <= entry.delivered) {
+                return true;
+            }
+            entry.delivered = entry.copies[index];
+            return false;
+        }
+
+        // FNV-1a over topic and payload
+        static uint64_t fingerprint(const std::string& topic, const std::vector<uint8_t>& data) {
+            uint64_t hash = 14695981039346656037ULL;
+            auto mix = [&hash](uint8_t byte) {
+                hash ^= byte;
+                hash *= 1099511628211ULL;
+            };
+            for (char c : topic) {
+                mix(static_cast<uint8_t>(c));
+            }
+            mix('|');
+            for (uint8_t byte : data) {
+                mix(byte);
+            }
+            return hash;
+        }
+
+        std::string client_id_;
+        Protocol protocol_{Protocol::TCP};
+        Redundancy redundancy_{Redundancy::FAILOVER};
+        std::chrono::milliseconds initial_backoff_{100};
+        std::chrono::milliseconds max_backoff_{5000};
+        std::vector<std::string> names_;  // "host:port" per endpoint, for messages
+        std::vector<std::unique_ptr<ServiceConnection>> connections_;
+        std::atomic<bool> disconnecting_{false};
+
+        // Which endpoints are up and which one is active; failover timing (guarded by state_mutex_)
+        mutable std::mutex state_mutex_;
+        std::vector<bool> link_up_;
+        std::atomic<size_t> active_{0};
+        uint32_t failovers_{0};
+        std::atomic<bool> failover_pending_{false};
+        std::chrono::steady_clock::time_point failover_start_;
+        std::chrono::milliseconds last_failover_{0};
+        std::chrono::milliseconds max_failover_{0};
+        std::atomic<int64_t> last_delivery_ns_{0};  // steady_clock time of the latest delivered packet
+
+        // Delivery to the application, one packet at a time (guarded by delivery_mutex_)
+        std::mutex delivery_mutex_;
+        TelemetryCallback telemetry_callback_;
+        std::unordered_map<uint64_t, DedupeEntry> dedupe_;
+        std::deque<std::pair<uint64_t, std::chrono::steady_clock::time_point>> dedupe_expiry_;
+        std::atomic<uint32_t> returned_endpoints_{0};  // Bit per endpoint whose link came up again
+        std::atomic<uint64_t> duplicates_dropped_{0};
+
+        std::mutex callback_mutex_;
+        ConnectionCallback connection_callback_;
+    };
+
     // TelemetryClient Implementation
 
     TelemetryClient::TelemetryClient(const std::string& client_id)
@@ -672,7 +1724,13 @@ namespace TelemetryAPI {
     TelemetryClient::~TelemetryClient() = default;
 
     bool TelemetryClient::connect(const std::string& host, int port, Protocol protocol) {
-        return impl_->connect(host, port, protocol);
+        return impl_->connect({ServiceEndpoint{host, port}}, protocol, Redundancy::FAILOVER);
+    }
+
+    bool TelemetryClient::connect(const std::vector<ServiceEndpoint>& endpoints,
+                                  Protocol protocol,
+                                  Redundancy redundancy) {
+        return impl_->connect(endpoints, protocol, redundancy);
     }
 
     bool TelemetryClient::connectFromConfig(const std::string& config_file, Protocol protocol) {
@@ -699,6 +1757,51 @@ namespace TelemetryAPI {
         return impl_->sendCommand(uav_name, command);
     }
 
+    std::future<CommandResult> TelemetryClient::sendCommandWithAck(const std::string& uav_name,
+                                                                   const std::string& command,
+                                                                   std::chrono::milliseconds timeout) {
+        auto promise = std::make_shared<std::promise<CommandResult>>();
+        auto future = promise->get_future();
+        impl_->sendCommandWithAck(
+            uav_name, command, [promise](const CommandResult& result) { promise->set_value(result); }, timeout);
+        return future;
+    }
+
+    bool TelemetryClient::sendCommandWithAck(const std::string& uav_name,
+                                             const std::string& command,
+                                             CommandCallback callback,
+                                             std::chrono::milliseconds timeout) {
+        return impl_->sendCommandWithAck(uav_name, command, std::move(callback), timeout);
+    }
+
+    std::future<QueryResult> TelemetryClient::queryRadius(double latitude,
+                                                          double longitude,
+                                                          double radius_m,
+                                                          std::chrono::milliseconds timeout) {
+        std::ostringstream query;
+        query << std::setprecision(12) << "radius " << latitude << " " << longitude << " " << radius_m;
+        auto promise = std::make_shared<std::promise<QueryResult>>();
+        auto future = promise->get_future();
+        impl_->sendQuery(
+            query.str(), [promise](const QueryResult& result) { promise->set_value(result); }, timeout);
+        return future;
+    }
+
+    std::future<QueryResult> TelemetryClient::queryBox(double min_latitude,
+                                                       double min_longitude,
+                                                       double max_latitude,
+                                                       double max_longitude,
+                                                       std::chrono::milliseconds timeout) {
+        std::ostringstream query;
+        query << std::setprecision(12) << "bbox " << min_latitude << " " << min_longitude << " " << max_latitude
+              << " " << max_longitude;
+        auto promise = std::make_shared<std::promise<QueryResult>>();
+        auto future = promise->get_future();
+        impl_->sendQuery(
+            query.str(), [promise](const QueryResult& result) { promise->set_value(result); }, timeout);
+        return future;
+    }
+
     void TelemetryClient::setTelemetryCallback(TelemetryCallback callback) {
         impl_->setTelemetryCallback(std::move(callback));
     }
@@ -707,6 +1810,14 @@ namespace TelemetryAPI {
         impl_->setConnectionCallback(std::move(callback));
     }
 
+    void TelemetryClient::setReconnectBackoff(std::chrono::milliseconds initial, std::chrono::milliseconds maximum) {
+        impl_->setReconnectBackoff(initial, maximum);
+    }
+
+    ConnectionStats TelemetryClient::getConnectionStats() const {
+        return impl_->getConnectionStats();
+    }
+
     const std::string& TelemetryClient::getClientId() const {
         return impl_->getClientId();
     }
@@ -744,6 +1855,8 @@ namespace TelemetryAPI {
                 return "IMU";
             case PacketTypes::BATTERY_PACKET:
                 return "Battery";
+            case PacketTypes::COMMAND_ACK:
+                return "CommandAck";
             default:
                 return "Unknown(" + std::to_string(packetType) + ")";
         }
@@ -0,0 +1,228 @@
+/**
+ * @file ColumnFormat.h
+ * @brief On-disk layout of columnar journal exports
+ *
+ * This file defines the column files written by journal_export. An export is a
+ * directory with a manifest.json and one file per field, per packet type, per
+ * UAV ("UAV_1/location/altitude.col"). Reading one field of a whole day of
+ * flights therefore touches only that field's files. Each file is:
+ *
+ *   [ColumnFileHeader]
+ *   [dictionary: dictionarySize values of the column type]   DICTIONARY only
+ *   [padding to COLUMN_ALIGNMENT]
+ *   [rowCount elements of storedWidth bytes]
+ *
+ * Elements are fixed width, so row i is at a known offset and a column can be
+ * memory-mapped straight into an array (numpy.memmap, Arrow, ...). All values
+ * are little-endian.
+ */
+
+#ifndef COLUMN_FORMAT_H
+#define COLUMN_FORMAT_H
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+// Ensure struct packing without padding so the layout matches the file byte for byte
+#pragma pack(push, 1)
+
+/**
+ * @brief Header at offset 0 of every column file
+ */
+struct ColumnFileHeader {
+    char magic[8];            ///< ColumnFormat::MAGIC
+    uint16_t version;         ///< ColumnFormat::VERSION
+    uint8_t valueType;        ///< ColumnType of the decoded values
+    uint8_t encoding;         ///< ColumnEncoding of the stored elements
+    uint8_t storedWidth;      ///< Bytes per stored element
+    uint8_t reserved[3];      ///< Always 0
+    uint64_t rowCount;        ///< Number of rows
+    int64_t deltaBase;        ///< Value of row 0 (DELTA only)
+    uint32_t dictionarySize;  ///< Number of dictionary values (DICTIONARY only)
+    uint32_t dataOffset;      ///< File offset of the first stored element
+};
+
+#pragma pack(pop)
+
+// Decoded value types
+namespace ColumnType {
+    constexpr uint8_t U8 = 1;
+    constexpr uint8_t U16 = 2;
+    constexpr uint8_t I64 = 3;
+    constexpr uint8_t F32 = 4;
+    constexpr uint8_t F64 = 5;
+
+    /**
+     * @brief Size of one decoded value
+     * @param type ColumnType
+     * @return Bytes per value (0 for an unknown type)
+     */
+    constexpr uint8_t width(uint8_t type) {
+        switch (type) {
+            case U8:
+                return 1;
+            case U16:
+                return 2;
+            case I64:
+            case F64:
+                return 8;
+            case F32:
+                return 4;
+            default:
+                return 0;
+        }
+    }
+
+    /**
+     * @brief Short type name used in manifest.json
+     * @param type ColumnType
+     * @return "u8", "u16", "i64", "f32", "f64" or "unknown"
+     */
+    constexpr const char* name(uint8_t type) {
+        switch (type) {
+            case U8:
+                return "u8";
+            case U16:
+                return "u16";
+            case I64:
+                return "i64";
+            case F32:
+                return "f32";
+            case F64:
+                return "f64";
+            default:
+                return "unknown";
+        }
+    }
+}  // namespace ColumnType
+
+// Element encodings
+namespace ColumnEncoding {
+    constexpr uint8_t PLAIN = 0;       ///< Elements are the values
+    constexpr uint8_t DELTA = 1;       ///< Signed differences to the previous row (row 0: deltaBase), integers only
+    constexpr uint8_t DICTIONARY = 2;  ///< Unsigned indexes into the dictionary
+
+    /**
+     * @brief Encoding name used in manifest.json
+     * @param encoding ColumnEncoding
+     * @return "plain", "delta", "dictionary" or "unknown"
+     */
+    constexpr const char* name(uint8_t encoding) {
+        switch (encoding) {
+            case PLAIN:
+                return "plain";
+            case DELTA:
+                return "delta";
+            case DICTIONARY:
+                return "dictionary";
+            default:
+                return "unknown";
+        }
+    }
+}  // namespace ColumnEncoding
+
+// Column file layout constants
+namespace ColumnFormat {
+    constexpr char MAGIC[8] = {'T', 'L', 'M', 'C', 'O', 'L', '1', '\0'};
+    constexpr uint16_t VERSION = 1;
+    constexpr uint32_t COLUMN_ALIGNMENT = 8;  ///< Dictionary and elements start 8-byte aligned
+    constexpr uint32_t MAX_DICTIONARY = 256;  ///< Dictionary indexes are one byte
+    constexpr const char* FILE_EXTENSION = ".col";
+    constexpr const char* MANIFEST = "manifest.json";
+
+    /**
+     * @brief Round a file offset up to COLUMN_ALIGNMENT
+     */
+    constexpr uint64_t align(uint64_t offset) {
+        return (offset + COLUMN_ALIGNMENT - 1) & ~uint64_t{COLUMN_ALIGNMENT - 1};
+    }
+
+    /**
+     * @brief Read one stored element as a signed or unsigned integer
+     * @param element First byte of the element
+     * @param width Element width in bytes
+     * @param isSigned Sign-extend the element (DELTA) or not (DICTIONARY)
+     */
+    inline int64_t readElement(const uint8_t* element, uint8_t width, bool isSigned) {
+        switch (width) {
+            case 1: {
+                uint8_t value;
+                std::memcpy(&value, element, 1);
+                return isSigned ? static_cast<int8_t>(value) : value;
+            }
+            case 2: {
+                uint16_t value;
+                std::memcpy(&value, element, 2);
+                return isSigned ? static_cast<int16_t>(value) : value;
+            }
+            case 4: {
+                uint32_t value;
+                std::memcpy(&value, element, 4);
+                return isSigned ? static_cast<int32_t>(value) : value;
+            }
+            default: {
+                int64_t value;
+                std::memcpy(&value, element, 8);
+                return value;
+            }
+        }
+    }
+
+    /**
+     * @brief Decode a whole column file
+     * @param data Column file contents
+     * @param size File size in bytes
+     * @return The column values
+     * @throws std::runtime_error if the file is not a valid column of type T
+     *
+     * T must match the column's ColumnType (uint8_t, uint16_t, int64_t, float or double).
+     */
+    template <typename T>
+    std::vector<T> decode(const uint8_t* data, size_t size) {
+        ColumnFileHeader header{};
+        if (size < sizeof(header)) {
+            throw std::runtime_error("column file too small");
+        }
+        std::memcpy(&header, data, sizeof(header));
+        if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 || header.version != VERSION) {
+            throw std::runtime_error("not a column file");
+        }
+        if (ColumnType::width(header.valueType) != sizeof(T)) {
+            throw std::runtime_error("column type does not match the requested type");
+        }
+        if (header.dataOffset + header.rowCount * header.storedWidth > size) {
+            throw std::runtime_error("column file truncated");
+        }
+
+        std::vector<T> values(static_cast<size_t>(header.rowCount));
+        const uint8_t* elements = data + header.dataOffset;
+        if (header.encoding == ColumnEncoding::PLAIN) {
+            std::memcpy(values.data(), elements, values.size() * sizeof(T));
+        } else if (header.encoding == ColumnEncoding::DELTA) {
+            int64_t value = header.deltaBase;
+            for (size_t row = 0; row < values.size(); ++row) {
+                value += readElement(elements + row * header.storedWidth, header.storedWidth, true);
+                values[row] = static_cast<T>(value);
+            }
+        } else if (header.encoding == ColumnEncoding::DICTIONARY) {
+            const uint8_t* dictionary = data + sizeof(ColumnFileHeader);
+            for (size_t row = 0; row < values.size(); ++row) {
+                const uint8_t* element = elements + row * header.storedWidth;
+                auto index = static_cast<uint32_t>(readElement(element, header.storedWidth, false));
+                if (index >= header.dictionarySize) {
+                    throw std::runtime_error("dictionary index out of range");
+                }
+                std::memcpy(&values[row], dictionary + index * sizeof(T), sizeof(T));
+            }
+        } else {
+            throw std::runtime_error("unknown column encoding");
+        }
+        return values;
+    }
+}  // namespace ColumnFormat
+
+static_assert(sizeof(ColumnFileHeader) % ColumnFormat::COLUMN_ALIGNMENT == 0, "column header must keep alignment");
+
+#endif  // COLUMN_FORMAT_H
@@ -0,0 +1,144 @@
+/**
+ * @file JournalFormat.h
+ * @brief On-disk layout of telemetry journal segments
+ *
+ * This file defines the binary format written by the service's recorder and read
+ * back by the journal tools. A journal is a directory of segment files named
+ * "segment-NNNNNN.tlj". Each segment is preallocated, filled append-only and
+ * sealed with an index when it is full or the service stops:
+ *
+ *   [JournalSegmentHeader, padded to DATA_OFFSET]
+ *   [record][record]...                  records start 8-byte aligned
+ *   [JournalTimeIndexEntry x timeIndexCount]
+ *   [JournalUavIndexEntry x uavCount]
+ *   [uint32 record offsets per UAV]      referenced by JournalUavIndexEntry
+ *
+ * A record is a JournalRecordHeader followed by the packet exactly as the UAV
+ * sent it (PacketHeader + payload), padded to RECORD_ALIGNMENT. All integers are
+ * little-endian. A segment that was never sealed (the service crashed) has no
+ * index; its records end at the first header whose size is 0.
+ */
+
+#ifndef JOURNAL_FORMAT_H
+#define JOURNAL_FORMAT_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+// Ensure struct packing without padding so the layout matches the file byte for byte
+#pragma pack(push, 1)
+
+/**
+ * @brief Header at offset 0 of every segment file
+ *
+ * dataEnd and recordCount are rewritten after every batch, so a reader can use
+ * them on a segment that is still being written.
+ */
+struct JournalSegmentHeader {
+    char magic[8];             ///< JournalFormat::MAGIC
+    uint16_t version;          ///< JournalFormat::VERSION
+    uint16_t dataOffset;       ///< Offset of the first record (JournalFormat::DATA_OFFSET)
+    uint32_t segmentIndex;     ///< Number in the file name
+    uint32_t flags;            ///< JournalFormat::FLAG_SEALED once the index is written
+    uint32_t timeIndexCount;   ///< Number of JournalTimeIndexEntry items
+    uint64_t capacity;         ///< Preallocated file size; records never extend past it
+    uint64_t dataEnd;          ///< End of the last complete record
+    uint64_t recordCount;      ///< Number of complete records
+    uint64_t firstSequence;    ///< Sequence number of the first record (0 if empty)
+    int64_t createdNs;         ///< Segment creation time (ns since the Unix epoch)
+    int64_t firstTimestampNs;  ///< Receive time of the first record
+    int64_t lastTimestampNs;   ///< Receive time of the last record
+    uint64_t indexOffset;      ///< Offset of the time index (0 until sealed)
+    uint32_t uavCount;         ///< Number of JournalUavIndexEntry items
+    uint32_t reserved;         ///< Always 0
+};
+
+/**
+ * @brief Header in front of every journaled packet
+ */
+struct JournalRecordHeader {
+    uint32_t size;       ///< Packet bytes following this header (never 0)
+    uint16_t uavId;      ///< UAV id from service_config.json (0 if unknown)
+    uint8_t protocol;    ///< JournalProtocol the packet arrived on
+    uint8_t reserved;    ///< Always 0
+    uint64_t sequence;   ///< Service-wide receive order, starting at 1 for each service run
+    int64_t receivedNs;  ///< Receive time (ns since the Unix epoch)
+};
+
+/**
+ * @brief Sparse time index entry: one for every JournalFormat::TIME_INDEX_INTERVAL records
+ */
+struct JournalTimeIndexEntry {
+    int64_t receivedNs;  ///< Receive time of the record
+    uint64_t offset;     ///< File offset of the record
+    uint64_t sequence;   ///< Sequence number of the record
+};
+
+/**
+ * @brief Per-UAV index entry: where to find every record of one UAV in the segment
+ */
+struct JournalUavIndexEntry {
+    uint16_t uavId;          ///< UAV id
+    uint16_t reserved;       ///< Always 0
+    uint32_t recordCount;    ///< Number of records (= number of uint32 offsets)
+    uint64_t offsetsOffset;  ///< File offset of the UAV's uint32 record offsets (in receive order)
+    int64_t firstNs;         ///< Receive time of the UAV's first record
+    int64_t lastNs;          ///< Receive time of the UAV's last record
+    char name[32];           ///< UAV name, NUL-padded (truncated to 31 characters)
+};
+
+#pragma pack(pop)
+
+// Segment layout constants
+namespace JournalFormat {
+    constexpr char MAGIC[8] = {'T', 'L', 'M', 'J', 'R', 'N', 'L', '1'};
+    constexpr uint16_t VERSION = 1;
+    constexpr uint16_t DATA_OFFSET = 128;                  ///< Records start here (room to grow the header)
+    constexpr uint64_t RECORD_ALIGNMENT = 8;               ///< Records and index sections start 8-byte aligned
+    constexpr uint32_t FLAG_SEALED = 1;                    ///< Index written, segment complete
+    constexpr uint32_t TIME_INDEX_INTERVAL = 256;          ///< Records between time index entries
+    constexpr uint64_t MAX_SEGMENT_BYTES = 0xFFFFFFFFULL;  ///< Per-UAV offsets are 32-bit
+    constexpr const char* FILE_PREFIX = "segment-";
+    constexpr const char* FILE_EXTENSION = ".tlj";
+
+    /**
+     * @brief Round a size up to the record alignment
+     * @param size Size in bytes
+     * @return Aligned size
+     */
+    constexpr uint64_t align(uint64_t size) {
+        return (size + RECORD_ALIGNMENT - 1) & ~(RECORD_ALIGNMENT - 1);
+    }
+
+    /**
+     * @brief Space one packet takes in a segment
+     * @param packetSize Packet bytes
+     * @return Aligned size of header + packet
+     */
+    constexpr uint64_t recordSpan(uint64_t packetSize) {
+        return align(sizeof(JournalRecordHeader) + packetSize);
+    }
+
+    /**
+     * @brief File name of a segment
+     * @param index Segment number
+     * @return e.g. "segment-000042.tlj"
+     */
+    inline std::string segmentFileName(uint32_t index) {
+        char number[16];
+        std::snprintf(number, sizeof(number), "%06u", index);
+        return std::string(FILE_PREFIX) + number + FILE_EXTENSION;
+    }
+}  // namespace JournalFormat
+
+// Ingest protocol constants (JournalRecordHeader::protocol)
+namespace JournalProtocol {
+    constexpr uint8_t TCP = 1;
+    constexpr uint8_t UDP = 2;
+}  // namespace JournalProtocol
+
+static_assert(sizeof(JournalSegmentHeader) <= JournalFormat::DATA_OFFSET, "segment header overlaps the records");
+static_assert(sizeof(JournalRecordHeader) % JournalFormat::RECORD_ALIGNMENT == 0, "record header must keep alignment");
+
+#endif  // JOURNAL_FORMAT_H
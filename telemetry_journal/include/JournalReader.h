@@ -0,0 +1,290 @@
+/**
+ * @file JournalReader.h
+ * @brief Memory-mapped access to recorded telemetry journals
+ *
+ * This file defines the reader side of the journal written by the service's
+ * recorder. Segments are memory-mapped and queried through their indexes, so a
+ * time range or the last few packets of one UAV are found without reading the
+ * rest of the file. Returned records point straight into the mapping.
+ */
+
+#ifndef JOURNAL_READER_H
+#define JOURNAL_READER_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "JournalFormat.h"
+#include "PacketViews.h"
+
+namespace TelemetryJournal {
+
+    // Forward declaration to keep platform mapping code out of the header
+    class MappedFile;
+
+    /**
+     * @brief One journaled packet
+     *
+     * The packet view points into the memory mapping and stays valid for the
+     * lifetime of the JournalReader (or JournalSegment) it came from.
+     */
+    struct JournalRecord {
+        uint64_t sequence{0};             ///< Service-wide receive order (restarts with the service)
+        int64_t receivedNs{0};            ///< Receive time (ns since the Unix epoch)
+        uint16_t uavId{0};                ///< UAV id (0 if the service did not know the UAV)
+        uint8_t protocol{0};              ///< JournalProtocol the packet arrived on
+        uint32_t segmentIndex{0};         ///< Segment the record is stored in
+        TelemetryAPI::PacketView packet;  ///< The packet as received
+    };
+
+    /**
+     * @brief Callback for streaming queries
+     * @param record Current record
+     * @return false to stop the query early
+     */
+    using RecordCallback = std::function<bool(const JournalRecord& record)>;
+
+    /**
+     * @class JournalSegment
+     * @brief One memory-mapped segment file and its indexes
+     *
+     * A sealed segment uses the index stored in the file. For a segment that
+     * was never sealed (the service stopped abruptly) the same index is rebuilt
+     * with a single scan when the segment is opened.
+     */
+    class JournalSegment {
+       public:
+        /**
+         * @brief Map a segment file and load its index
+         * @param path Segment file path
+         * @throws std::runtime_error if the file cannot be mapped or is not a journal segment
+         */
+        explicit JournalSegment(const std::filesystem::path& path);
+
+        /**
+         * @brief Destructor - unmaps the file
+         */
+        ~JournalSegment();
+
+        // Records point into the mapping, which must not move
+        JournalSegment(const JournalSegment&) = delete;
+        JournalSegment& operator=(const JournalSegment&) = delete;
+        JournalSegment(JournalSegment&&) = delete;
+        JournalSegment& operator=(JournalSegment&&) = delete;
+
+        /**
+         * @brief Get the segment header
+         * @return Header (for an unsealed segment, counts and times are those found by the scan)
+         */
+        [[nodiscard]] const JournalSegmentHeader& header() const {
+            return header_;
+        }
+
+        /**
+         * @brief Check whether the segment was sealed by the recorder
+         */
+        [[nodiscard]] bool sealed() const {
+            return (header_.flags & JournalFormat::FLAG_SEALED) != 0;
+        }
+
+        /**
+         * @brief Get the UAVs recorded in this segment
+         * @return UAV id -> name (empty for unsealed segments, which carry no names)
+         */
+        [[nodiscard]] const std::map<uint16_t, std::string>& uavNames() const {
+            return names_;
+        }
+
+        /**
+         * @brief Visit all records with receivedNs in [fromNs, toNs], in receive order
+         * @param fromNs Start of the range (inclusive)
+         * @param toNs End of the range (inclusive)
+         * @param callback Called per record; return false to stop
+         * @return false if the callback stopped the query
+         *
+         * Starts at the closest time index entry instead of the first record.
+         */
+        bool forEachInRange(int64_t fromNs, int64_t toNs, const RecordCallback& callback) const;
+
+        /**
+         * @brief Visit the records of one UAV with receivedNs in [fromNs, toNs], in receive order
+         * @param uavId UAV id
+         * @param fromNs Start of the range (inclusive)
+         * @param toNs End of the range (inclusive)
+         * @param callback Called per record; return false to stop
+         * @return false if the callback stopped the query
+         *
+         * Binary-searches the UAV's record offsets; other UAVs' records are never touched.
+         */
+        bool forEachOfUav(uint16_t uavId, int64_t fromNs, int64_t toNs, const RecordCallback& callback) const;
+
+        /**
+         * @brief Visit records newest first
+         * @param uavId UAV id, or nothing for every UAV
+         * @param callback Called per record; return false to stop
+         * @return false if the callback stopped the query
+         */
+        bool forEachNewestFirst(std::optional<uint16_t> uavId, const RecordCallback& callback) const;
+
+       private:
+        /**
+         * @struct OffsetList
+         * @brief Record offsets of one UAV (in the file, or rebuilt in memory)
+         */
+        struct OffsetList {
+            const uint32_t* offsets{nullptr};  ///< Offsets in receive order
+            size_t count{0};                   ///< Number of offsets
+        };
+
+        /**
+         * @brief Load the index stored in a sealed segment
+         * @throws std::runtime_error if the index lies outside the file
+         */
+        void loadIndex();
+
+        /**
+         * @brief Rebuild the index of an unsealed segment with one scan
+         */
+        void rebuildIndex();
+
+        /**
+         * @brief Decode the record at a file offset
+         * @param offset File offset of a JournalRecordHeader
+         * @return The record (its packet view points into the mapping)
+         */
+        [[nodiscard]] JournalRecord recordAt(uint64_t offset) const;
+
+        std::unique_ptr<MappedFile> file_;                          ///< Memory mapping of the segment
+        JournalSegmentHeader header_{};                             ///< Copy of the header
+        const JournalTimeIndexEntry* timeIndex_{nullptr};           ///< Sparse time index
+        size_t timeIndexCount_{0};                                  ///< Entries in timeIndex_
+        std::map<uint16_t, OffsetList> uavOffsets_;                 ///< UAV id -> record offsets
+        std::map<uint16_t, std::string> names_;                     ///< UAV id -> name
+        std::vector<JournalTimeIndexEntry> rebuiltTimeIndex_;       ///< Storage for an unsealed segment
+        std::map<uint16_t, std::vector<uint32_t>> rebuiltOffsets_;  ///< Storage for an unsealed segment
+    };
+
+    /**
+     * @class JournalReader
+     * @brief Query API over all segments of a journal directory
+     *
+     * Example usage:
+     * ```cpp
+     * TelemetryJournal::JournalReader reader("telemetry_service/journal");
+     * for (const auto& record : reader.query("UAV_2", t1, t2)) {
+     *     if (auto location = record.packet.location()) {
+     *         std::cout << location->altitude << '\n';
+     *     }
+     * }
+     * ```
+     */
+    class JournalReader {
+       public:
+        /// Sentinel bounds for open-ended time ranges
+        static constexpr int64_t BEGINNING = std::numeric_limits<int64_t>::min();
+        static constexpr int64_t END = std::numeric_limits<int64_t>::max();
+
+        /**
+         * @brief Open every segment in a journal directory
+         * @param directory Journal directory
+         * @throws std::runtime_error if the directory does not exist or a segment is unreadable
+         */
+        explicit JournalReader(const std::filesystem::path& directory);
+
+        /**
+         * @brief Get the opened segments, ordered by segment number
+         */
+        [[nodiscard]] const std::vector<std::unique_ptr<JournalSegment>>& segments() const {
+            return segments_;
+        }
+
+        /**
+         * @brief Look up a UAV id by name
+         * @param name UAV name
+         * @return The id, or nothing if no sealed segment names the UAV
+         */
+        [[nodiscard]] std::optional<uint16_t> uavId(const std::string& name) const;
+
+        /**
+         * @brief Look up a UAV name by id
+         * @param id UAV id
+         * @return The name, or "#<id>" if no sealed segment names the UAV
+         */
+        [[nodiscard]] std::string uavName(uint16_t id) const;
+
+        /**
+         * @brief Get every UAV named in the journal
+         * @return UAV id -> name
+         */
+        [[nodiscard]] const std::map<uint16_t, std::string>& uavNames() const {
+            return names_;
+        }
+
+        /**
+         * @brief All packets of one UAV received in [fromNs, toNs]
+         * @param uavName UAV name (a numeric "#<id>" is accepted too)
+         * @param fromNs Start of the range (inclusive)
+         * @param toNs End of the range (inclusive)
+         * @param packetType Only packets of this type (optional)
+         * @return Records in receive order
+         * @throws std::invalid_argument if the UAV is unknown
+         */
+        [[nodiscard]] std::vector<JournalRecord> query(const std::string& uavName,
+                                                       int64_t fromNs,
+                                                       int64_t toNs,
+                                                       std::optional<uint8_t> packetType = std::nullopt) const;
+
+        /**
+         * @brief Stream all packets received in [fromNs, toNs], in receive order
+         * @param fromNs Start of the range (inclusive)
+         * @param toNs End of the range (inclusive)
+         * @param callback Called per record; return false to stop
+         *
+         * Segments entirely outside the range are skipped using their header.
+         */
+        void forEach(int64_t fromNs, int64_t toNs, const RecordCallback& callback) const;
+
+        /**
+         * @brief The last packets of one UAV (or of the whole fleet)
+         * @param count Maximum number of records
+         * @param uavName UAV name, or empty for every UAV
+         * @param packetType Only packets of this type (optional)
+         * @return Up to count records, oldest first
+         * @throws std::invalid_argument if the UAV is unknown
+         */
+        [[nodiscard]] std::vector<JournalRecord> last(size_t count,
+                                                      const std::string& uavName = "",
+                                                      std::optional<uint8_t> packetType = std::nullopt) const;
+
+       private:
+        /**
+         * @brief Resolve a UAV name given on the API
+         * @param name UAV name or "#<id>"
+         * @return The id
+         * @throws std::invalid_argument if the UAV is unknown
+         */
+        [[nodiscard]] uint16_t resolveUav(const std::string& name) const;
+
+        std::vector<std::unique_ptr<JournalSegment>> segments_;  ///< Segments ordered by number
+        std::map<uint16_t, std::string> names_;                  ///< UAV id -> name, merged from all segments
+    };
+
+    /**
+     * @brief Parse a time given on a command line
+     * @param text Unix time in seconds (fractions allowed), local time "YYYY-MM-DDTHH:MM:SS", "start" or "end"
+     * @return Nanoseconds since the Unix epoch (JournalReader::BEGINNING / END for "start" / "end")
+     * @throws std::invalid_argument if the text is none of these
+     */
+    int64_t parseTime(const std::string& text);
+
+}  // namespace TelemetryJournal
+
+#endif  // JOURNAL_READER_H
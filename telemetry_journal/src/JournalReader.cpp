@@ -0,0 +1,571 @@
+/**
+ * @file JournalReader.cpp
+ * @brief Implementation of the memory-mapped telemetry journal reader
+ */
+
+#include "JournalReader.h"
+
+#include <algorithm>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#if defined(_WIN32)
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace TelemetryJournal {
+
+    /**
+     * @class MappedFile
+     * @brief Read-only memory mapping of a whole file
+     */
+    class MappedFile {
+       public:
+        /**
+         * @brief Map a file
+         * @param path File path
+         * @throws std::runtime_error if the file cannot be opened or mapped
+         */
+        explicit MappedFile(const std::filesystem::path& path) {
+#if defined(_WIN32)
+            file_ = CreateFileW(path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr,
+                                OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+            if (file_ == INVALID_HANDLE_VALUE) {
+                throw std::runtime_error("cannot open " + path.string());
+            }
+            LARGE_INTEGER file_size{};
+            GetFileSizeEx(file_, &file_size);
+            size_ = static_cast<size_t>(file_size.QuadPart);
+            if (size_ == 0) {
+                return;
+            }
+            mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+            if (mapping_ == nullptr) {
+                CloseHandle(file_);
+                throw std::runtime_error("cannot map " + path.string());
+            }
+            data_ = static_cast<const uint8_t*>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+            if (data_ == nullptr) {
+                CloseHandle(mapping_);
+                CloseHandle(file_);
+                throw std::runtime_error("cannot map " + path.string());
+            }
+#else
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) {
+                throw std::runtime_error("cannot open " + path.string());
+            }
+            struct stat info {};
+            if (::fstat(fd, &info) != 0) {
+                ::close(fd);
+                throw std::runtime_error("cannot stat " + path.string());
+            }
+            size_ = static_cast<size_t>(info.st_size);
+            if (size_ > 0) {
+                void* address = ::mmap(nullptr, size_, PROT_READ, MAP_SHARED, fd, 0);
+                if (address == MAP_FAILED) {
+                    ::close(fd);
+                    throw std::runtime_error("cannot map " + path.string());
+                }
+                data_ = static_cast<const uint8_t*>(address);
+                // Queries jump around through the indexes rather than reading front to back
+                ::madvise(address, size_, MADV_RANDOM);
+            }
+            // The mapping keeps the file contents reachable
+            ::close(fd);
+#endif
+        }
+
+        /**
+         * @brief Destructor - unmaps the file
+         */
+        ~MappedFile() {
+#if defined(_WIN32)
+            if (data_ != nullptr) {
+                UnmapViewOfFile(data_);
+            }
+            if (mapping_ != nullptr) {
+                CloseHandle(mapping_);
+            }
+            CloseHandle(file_);
+#else
+            if (data_ != nullptr) {
+                ::munmap(const_cast<uint8_t*>(data_), size_);
+            }
+#endif
+        }
+
+        MappedFile(const MappedFile&) = delete;
+        MappedFile& operator=(const MappedFile&) = delete;
+
+        /**
+         * @brief Get the first byte of the file
+         */
+        [[nodiscard]] const uint8_t* data() const {
+            return data_;
+        }
+
+        /**
+         * @brief Get the file size in bytes
+         */
+        [[nodiscard]] size_t size() const {
+            return size_;
+        }
+
+       private:
+        const uint8_t* data_{nullptr};  ///< Start of the mapping
+        size_t size_{0};                ///< Mapped size
+#if defined(_WIN32)
+        HANDLE file_{INVALID_HANDLE_VALUE};  ///< File handle
+        HANDLE mapping_{nullptr};            ///< File mapping handle
+#endif
+    };
+
+    /**
+     * @brief Map a segment file and load its index
+     * @param path Segment file path
+     */
+    JournalSegment::JournalSegment(const std::filesystem::path& path)
+        : file_(std::make_unique<MappedFile>(path)) {
+        if (file_->size() < JournalFormat::DATA_OFFSET) {
+            throw std::runtime_error(path.string() + " is too small to be a journal segment");
+        }
+        std::memcpy(&header_, file_->data(), sizeof(header_));
+        if (std::memcmp(header_.magic, JournalFormat::MAGIC, sizeof(header_.magic)) != 0) {
+            throw std::runtime_error(path.string() + " is not a journal segment");
+        }
+        if (header_.version != JournalFormat::VERSION) {
+            throw std::runtime_error(path.string() + " has unsupported journal version " +
+                                     std::to_string(header_.version));
+        }
+
+        if (sealed()) {
+            loadIndex();
+        } else {
+            rebuildIndex();
+        }
+    }
+
+    /**
+     * @brief Destructor - unmaps the file
+     */
+    JournalSegment::~JournalSegment() = default;
+
+    /**
+     * @brief Load the index stored in a sealed segment
+     *
+     * The index sections are 8-byte aligned in the file and the mapping is page
+     * aligned, so the arrays are used in place.
+     */
+    void JournalSegment::loadIndex() {
+        const uint8_t* base = file_->data();
+        uint64_t size = file_->size();
+        uint64_t time_bytes = uint64_t{header_.timeIndexCount} * sizeof(JournalTimeIndexEntry);
+        uint64_t table_bytes = uint64_t{header_.uavCount} * sizeof(JournalUavIndexEntry);
+        if (header_.dataEnd > size || header_.indexOffset < header_.dataEnd ||
+            header_.indexOffset + time_bytes + table_bytes > size) {
+            throw std::runtime_error("journal segment " + std::to_string(header_.segmentIndex) +
+                                     " has an index outside the file");
+        }
+
+        timeIndex_ = reinterpret_cast<const JournalTimeIndexEntry*>(base + header_.indexOffset);
+        timeIndexCount_ = header_.timeIndexCount;
+
+        const auto* table = reinterpret_cast<const JournalUavIndexEntry*>(base + header_.indexOffset + time_bytes);
+        for (uint32_t i = 0; i < header_.uavCount; ++i) {
+            const JournalUavIndexEntry& entry = table[i];
+            if (entry.offsetsOffset + uint64_t{entry.recordCount} * sizeof(uint32_t) > size) {
+                throw std::runtime_error("journal segment " + std::to_string(header_.segmentIndex) +
+                                         " has a UAV index outside the file");
+            }
+            uavOffsets_[entry.uavId] = {reinterpret_cast<const uint32_t*>(base + entry.offsetsOffset),
+                                        entry.recordCount};
+            if (entry.name[0] != '\0') {
+                names_[entry.uavId] = std::string(entry.name, strnlen(entry.name, sizeof(entry.name)));
+            }
+        }
+    }
+
+    /**
+     * @brief Rebuild the index of an unsealed segment with one scan
+     *
+     * The recorder preallocates segments with zeros, so the records end at the
+     * first header with size 0 (or at a record that runs past the file). The
+     * header counters may lag behind the last write and are recomputed.
+     */
+    void JournalSegment::rebuildIndex() {
+        const uint8_t* base = file_->data();
+        uint64_t limit = std::min<uint64_t>(file_->size(), header_.capacity > 0 ? header_.capacity : file_->size());
+        uint64_t offset = header_.dataOffset;
+        header_.recordCount = 0;
+
+        while (offset + sizeof(JournalRecordHeader) <= limit) {
+            JournalRecordHeader record{};
+            std::memcpy(&record, base + offset, sizeof(record));
+            uint64_t span = JournalFormat::recordSpan(record.size);
+            if (record.size == 0 || offset + span > limit) {
+                break;
+            }
+            if (header_.recordCount % JournalFormat::TIME_INDEX_INTERVAL == 0) {
+                rebuiltTimeIndex_.push_back({record.receivedNs, offset, record.sequence});
+            }
+            if (header_.recordCount == 0) {
+                header_.firstSequence = record.sequence;
+                header_.firstTimestampNs = record.receivedNs;
+            }
+            header_.lastTimestampNs = record.receivedNs;
+            ++header_.recordCount;
+            rebuiltOffsets_[record.uavId].push_back(static_cast<uint32_t>(offset));
+            offset += span;
+        }
+
+        header_.dataEnd = offset;
+        header_.timeIndexCount = static_cast<uint32_t>(rebuiltTimeIndex_.size());
+        header_.uavCount = static_cast<uint32_t>(rebuiltOffsets_.size());
+        timeIndex_ = rebuiltTimeIndex_.data();
+        timeIndexCount_ = rebuiltTimeIndex_.size();
+        for (const auto& [uav_id, offsets] : rebuiltOffsets_) {
+            uavOffsets_[uav_id] = {offsets.data(), offsets.size()};
+        }
+    }
+
+    /**
+     * @brief Decode the record at a file offset
+     * @param offset File offset of a JournalRecordHeader
+     * @return The record (its packet view points into the mapping)
+     */
+    JournalRecord JournalSegment::recordAt(uint64_t offset) const {
+        JournalRecordHeader header{};
+        std::memcpy(&header, file_->data() + offset, sizeof(header));
+        JournalRecord record;
+        record.sequence = header.sequence;
+        record.receivedNs = header.receivedNs;
+        record.uavId = header.uavId;
+        record.protocol = header.protocol;
+        record.segmentIndex = header_.segmentIndex;
+        record.packet = TelemetryAPI::PacketView(file_->data() + offset + sizeof(header), header.size);
+        return record;
+    }
+
+    /**
+     * @brief Visit all records with receivedNs in [fromNs, toNs], in receive order
+     * @param fromNs Start of the range (inclusive)
+     * @param toNs End of the range (inclusive)
+     * @param callback Called per record; return false to stop
+     * @return false if the callback stopped the query
+     */
+    bool JournalSegment::forEachInRange(int64_t fromNs, int64_t toNs, const RecordCallback& callback) const {
+        if (header_.recordCount == 0 || header_.lastTimestampNs < fromNs || header_.firstTimestampNs > toNs) {
+            return true;
+        }
+
+        // Last index entry strictly before fromNs; every record in front of it is too old
+        uint64_t offset = header_.dataOffset;
+        const JournalTimeIndexEntry* end = timeIndex_ + timeIndexCount_;
+        const JournalTimeIndexEntry* first_not_before =
+            std::lower_bound(timeIndex_, end, fromNs, [](const JournalTimeIndexEntry& entry, int64_t time) {
+                return entry.receivedNs < time;
+            });
+        if (first_not_before != timeIndex_) {
+            offset = (first_not_before - 1)->offset;
+        }
+
+        const uint8_t* base = file_->data();
+        while (offset < header_.dataEnd) {
+            JournalRecordHeader header{};
+            std::memcpy(&header, base + offset, sizeof(header));
+            if (header.receivedNs > toNs) {
+                break;
+            }
+            if (header.receivedNs >= fromNs && !callback(recordAt(offset))) {
+                return false;
+            }
+            offset += JournalFormat::recordSpan(header.size);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Visit the records of one UAV with receivedNs in [fromNs, toNs], in receive order
+     * @param uavId UAV id
+     * @param fromNs Start of the range (inclusive)
+     * @param toNs End of the range (inclusive)
+     * @param callback Called per record; return false to stop
+     * @return false if the callback stopped the query
+     */
+    bool JournalSegment::forEachOfUav(uint16_t uavId,
+                                      int64_t fromNs,
+                                      int64_t toNs,
+                                      const RecordCallback& callback) const {
+        auto it = uavOffsets_.find(uavId);
+        if (it == uavOffsets_.end()) {
+            return true;
+        }
+        const uint32_t* begin = it->second.offsets;
+        const uint32_t* end = begin + it->second.count;
+        const uint8_t* base = file_->data();
+        auto received_at = [base](uint32_t offset) {
+            JournalRecordHeader header{};
+            std::memcpy(&header, base + offset, sizeof(header));
+            return header.receivedNs;
+        };
+
+        const uint32_t* position = std::lower_bound(
+            begin, end, fromNs, [&received_at](uint32_t offset, int64_t time) { return received_at(offset) < time; });
+        for (; position != end; ++position) {
+            JournalRecord record = recordAt(*position);
+            if (record.receivedNs > toNs) {
+                break;
+            }
+            if (!callback(record)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /**
+     * @brief Visit records newest first
+     * @param uavId UAV id, or nothing for every UAV
+     * @param callback Called per record; return false to stop
+     * @return false if the callback stopped the query
+     *
+     * Records are variable-length and only linked forwards, so for the whole
+     * segment each stretch between two time index entries is walked forwards
+     * and then replayed backwards. A single UAV walks its offset list backwards.
+     */
+    bool JournalSegment::forEachNewestFirst(std::optional<uint16_t> uavId, const RecordCallback& callback) const {
+        if (uavId) {
+            auto it = uavOffsets_.find(*uavId);
+            if (it == uavOffsets_.end()) {
+                return true;
+            }
+            for (size_t i = it->second.count; i > 0; --i) {
+                if (!callback(recordAt(it->second.offsets[i - 1]))) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        const uint8_t* base = file_->data();
+        std::vector<uint64_t> stretch;
+        uint64_t stretch_end = header_.dataEnd;
+        for (size_t i = timeIndexCount_; i > 0; --i) {
+            stretch.clear();
+            for (uint64_t offset = timeIndex_[i - 1].offset; offset < stretch_end;) {
+                stretch.push_back(offset);
+                uint32_t size = 0;
+                std::memcpy(&size, base + offset, sizeof(size));
+                offset += JournalFormat::recordSpan(size);
+            }
+            for (auto it = stretch.rbegin(); it != stretch.rend(); ++it) {
+                if (!callback(recordAt(*it))) {
+                    return false;
+                }
+            }
+            stretch_end = timeIndex_[i - 1].offset;
+        }
+        return true;
+    }
+
+    /**
+     * @brief Open every segment in a journal directory
+     * @param directory Journal directory
+     */
+    JournalReader::JournalReader(const std::filesystem::path& directory) {
+        if (!std::filesystem::is_directory(directory)) {
+            throw std::runtime_error("journal directory not found: " + directory.string());
+        }
+
+        std::vector<std::filesystem::path> paths;
+        for (const auto& entry : std::filesystem::directory_iterator(directory)) {
+            std::string name = entry.path().filename().string();
+            if (entry.is_regular_file() && name.rfind(JournalFormat::FILE_PREFIX, 0) == 0 &&
+                entry.path().extension() == JournalFormat::FILE_EXTENSION) {
+                paths.push_back(entry.path());
+            }
+        }
+        // Zero-padded numbers sort like the segment order
+        std::sort(paths.begin(), paths.end());
+
+        for (const auto& path : paths) {
+            auto segment = std::make_unique<JournalSegment>(path);
+            if (segment->header().recordCount == 0) {
+                continue;
+            }
+            for (const auto& [id, name] : segment->uavNames()) {
+                names_[id] = name;
+            }
+            segments_.push_back(std::move(segment));
+        }
+    }
+
+    /**
+     * @brief Look up a UAV id by name
+     * @param name UAV name
+     * @return The id, or nothing if no sealed segment names the UAV
+     */
+    std::optional<uint16_t> JournalReader::uavId(const std::string& name) const {
+        for (const auto& [id, uav_name] : names_) {
+            if (uav_name == name) {
+                return id;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Look up a UAV name by id
+     * @param id UAV id
+     * @return The name, or "#<id>" if no sealed segment names the UAV
+     */
+    std::string JournalReader::uavName(uint16_t id) const {
+        auto it = names_.find(id);
+        return it != names_.end() ? it->second : "#" + std::to_string(id);
+    }
+
+    /**
+     * @brief Resolve a UAV name given on the API
+     * @param name UAV name or "#<id>"
+     * @return The id
+     */
+    uint16_t JournalReader::resolveUav(const std::string& name) const {
+        if (auto id = uavId(name)) {
+            return *id;
+        }
+        if (name.size() > 1 && name[0] == '#') {
+            try {
+                unsigned long id = std::stoul(name.substr(1));
+                if (id <= std::numeric_limits<uint16_t>::max()) {
+                    return static_cast<uint16_t>(id);
+                }
+            } catch (const std::exception&) {
+                // Fall through to the error below
+            }
+        }
+        throw std::invalid_argument("UAV not found in journal: " + name);
+    }
+
+    /**
+     * @brief All packets of one UAV received in [fromNs, toNs]
+     * @param uavName UAV name (a numeric "#<id>" is accepted too)
+     * @param fromNs Start of the range (inclusive)
+     * @param toNs End of the range (inclusive)
+     * @param packetType Only packets of this type (optional)
+     * @return Records in receive order
+     */
+    std::vector<JournalRecord> JournalReader::query(const std::string& uavName,
+                                                    int64_t fromNs,
+                                                    int64_t toNs,
+                                                    std::optional<uint8_t> packetType) const {
+        uint16_t id = resolveUav(uavName);
+        std::vector<JournalRecord> records;
+        for (const auto& segment : segments_) {
+            const JournalSegmentHeader& header = segment->header();
+            if (header.lastTimestampNs < fromNs || header.firstTimestampNs > toNs) {
+                continue;
+            }
+            segment->forEachOfUav(id, fromNs, toNs, [&](const JournalRecord& record) {
+                if (!packetType || record.packet.packetType() == *packetType) {
+                    records.push_back(record);
+                }
+                return true;
+            });
+        }
+        return records;
+    }
+
+    /**
+     * @brief Stream all packets received in [fromNs, toNs], in receive order
+     * @param fromNs Start of the range (inclusive)
+     * @param toNs End of the range (inclusive)
+     * @param callback Called per record; return false to stop
+     */
+    void JournalReader::forEach(int64_t fromNs, int64_t toNs, const RecordCallback& callback) const {
+        for (const auto& segment : segments_) {
+            if (!segment->forEachInRange(fromNs, toNs, callback)) {
+                return;
+            }
+        }
+    }
+
+    /**
+     * @brief The last packets of one UAV (or of the whole fleet)
+     * @param count Maximum number of records
+     * @param uavName UAV name, or empty for every UAV
+     * @param packetType Only packets of this type (optional)
+     * @return Up to count records, oldest first
+     *
+     * Segments are visited newest first and the walk stops as soon as enough
+     * records were found, so only the tail of the journal is touched.
+     */
+    std::vector<JournalRecord> JournalReader::last(size_t count,
+                                                   const std::string& uavName,
+                                                   std::optional<uint8_t> packetType) const {
+        std::optional<uint16_t> id;
+        if (!uavName.empty()) {
+            id = resolveUav(uavName);
+        }
+
+        std::vector<JournalRecord> records;
+        if (count == 0) {
+            return records;
+        }
+        for (auto it = segments_.rbegin(); it != segments_.rend(); ++it) {
+            bool more = (*it)->forEachNewestFirst(id, [&](const JournalRecord& record) {
+                if (!packetType || record.packet.packetType() == *packetType) {
+                    records.push_back(record);
+                }
+                return records.size() < count;
+            });
+            if (!more) {
+                break;
+            }
+        }
+        std::reverse(records.begin(), records.end());
+        return records;
+    }
+
+    /**
+     * @brief Parse a time given on a command line
+     * @param text Unix time in seconds (fractions allowed), local time "YYYY-MM-DDTHH:MM:SS", "start" or "end"
+     * @return Nanoseconds since the Unix epoch (JournalReader::BEGINNING / END for "start" / "end")
+     */
+    int64_t parseTime(const std::string& text) {
+        if (text == "start") {
+            return JournalReader::BEGINNING;
+        }
+        if (text == "end") {
+            return JournalReader::END;
+        }
+
+        size_t used = 0;
+        try {
+            double seconds = std::stod(text, &used);
+            if (used == text.size()) {
+                return static_cast<int64_t>(seconds * 1e9);
+            }
+        } catch (const std::exception&) {
+            // Not a number; try the calendar format below
+        }
+
+        std::tm time_info{};
+        std::istringstream iss(text);
+        iss >> std::get_time(&time_info, "%Y-%m-%dT%H:%M:%S");
+        if (iss.fail()) {
+            throw std::invalid_argument("invalid time: " + text);
+        }
+        time_info.tm_isdst = -1;
+        return static_cast<int64_t>(std::mktime(&time_info)) * 1000000000;
+    }
+
+}  // namespace TelemetryJournal
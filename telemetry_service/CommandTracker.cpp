@@ -0,0 +1,92 @@
+/**
+ * @file CommandTracker.cpp
+ * @brief Implementation of the pending-command table
+ */
+
+#include "CommandTracker.h"
+
+/**
+ * @brief Constructor
+ * @param timeout Time a UAV has to acknowledge a command
+ */
+CommandTracker::CommandTracker(std::chrono::milliseconds timeout) : timeout_(timeout) {}
+
+/**
+ * @brief Start tracking a command
+ * @param clientId UI client that sent the command
+ * @param clientCommandId Command id chosen by the client
+ * @param uavName UAV the command is forwarded to
+ * @return Sequence number to send to the UAV
+ */
+uint32_t CommandTracker::track(const std::string& clientId, uint32_t clientCommandId, const std::string& uavName) {
+    auto now = std::chrono::steady_clock::now();
+    std::lock_guard<std::mutex> lock(mutex_);
+    uint32_t sequence = nextSequence_++;
+    if (nextSequence_ == 0) {
+        nextSequence_ = 1;  // 0 is never handed out so it can mean "no id"
+    }
+    pending_[sequence] = PendingCommand{clientId, clientCommandId, uavName, now, now + timeout_};
+    expiryOrder_.push_back(sequence);
+    return sequence;
+}
+
+/**
+ * @brief Resolve a command by its UAV acknowledgement
+ * @param uavName UAV that sent the acknowledgement
+ * @param sequence Sequence number echoed by the UAV
+ * @return The pending command, or nothing if unknown, already expired, or sent to another UAV
+ *
+ * The sequence number stays in the expiry FIFO; expire() skips entries that are
+ * no longer pending.
+ */
+std::optional<PendingCommand> CommandTracker::acknowledge(const std::string& uavName, uint32_t sequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto pending_it = pending_.find(sequence);
+    if (pending_it == pending_.end() || pending_it->second.uavName != uavName) {
+        return std::nullopt;
+    }
+    PendingCommand command = std::move(pending_it->second);
+    pending_.erase(pending_it);
+    return command;
+}
+
+/**
+ * @brief Stop tracking a command that could not be forwarded
+ * @param sequence Sequence number returned by track()
+ * @return The pending command, or nothing if unknown
+ */
+std::optional<PendingCommand> CommandTracker::cancel(uint32_t sequence) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto pending_it = pending_.find(sequence);
+    if (pending_it == pending_.end()) {
+        return std::nullopt;
+    }
+    PendingCommand command = std::move(pending_it->second);
+    pending_.erase(pending_it);
+    return command;
+}
+
+/**
+ * @brief Remove and return all commands whose deadline has passed
+ * @param now Current time
+ * @return Expired commands (usually empty)
+ *
+ * Amortized O(1) per command: every sequence number is popped from the FIFO
+ * exactly once, whether it expired or was acknowledged earlier.
+ */
+std::vector<PendingCommand> CommandTracker::expire(std::chrono::steady_clock::time_point now) {
+    std::vector<PendingCommand> expired;
+    std::lock_guard<std::mutex> lock(mutex_);
+    while (!expiryOrder_.empty()) {
+        auto pending_it = pending_.find(expiryOrder_.front());
+        if (pending_it != pending_.end()) {
+            if (pending_it->second.deadline > now) {
+                break;
+            }
+            expired.push_back(std::move(pending_it->second));
+            pending_.erase(pending_it);
+        }
+        expiryOrder_.pop_front();
+    }
+    return expired;
+}
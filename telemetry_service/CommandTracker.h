@@ -0,0 +1,90 @@
+/**
+ * @file CommandTracker.h
+ * @brief Pending-command table for acknowledged UI commands
+ *
+ * This file defines the CommandTracker class which remembers commands that a UI
+ * client asked to have acknowledged, matches UAV acknowledgements against them
+ * and expires the ones whose UAV never answered.
+ */
+
+#ifndef COMMANDTRACKER_H
+#define COMMANDTRACKER_H
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @struct PendingCommand
+ * @brief One forwarded command waiting for its UAV acknowledgement
+ */
+struct PendingCommand {
+    std::string clientId;                            ///< UI client that sent the command (reply topic suffix)
+    uint32_t clientCommandId{0};                     ///< Command id chosen by the client
+    std::string uavName;                             ///< UAV the command was forwarded to
+    std::chrono::steady_clock::time_point sentAt;    ///< When the command was handed to the UAV socket
+    std::chrono::steady_clock::time_point deadline;  ///< When the command times out
+};
+
+/**
+ * @class CommandTracker
+ * @brief Thread-safe table of commands awaiting acknowledgement
+ *
+ * Each tracked command gets a service-wide sequence number that is sent to the
+ * UAV instead of the client's id, so ids from different clients never collide.
+ * All commands share one timeout, which makes deadlines increase in insertion
+ * order: expiry only looks at the front of a FIFO and never scans the table.
+ */
+class CommandTracker {
+   public:
+    /**
+     * @brief Constructor
+     * @param timeout Time a UAV has to acknowledge a command
+     */
+    explicit CommandTracker(std::chrono::milliseconds timeout);
+
+    /**
+     * @brief Start tracking a command
+     * @param clientId UI client that sent the command
+     * @param clientCommandId Command id chosen by the client
+     * @param uavName UAV the command is forwarded to
+     * @return Sequence number to send to the UAV
+     */
+    uint32_t track(const std::string& clientId, uint32_t clientCommandId, const std::string& uavName);
+
+    /**
+     * @brief Resolve a command by its UAV acknowledgement
+     * @param uavName UAV that sent the acknowledgement
+     * @param sequence Sequence number echoed by the UAV
+     * @return The pending command, or nothing if unknown, already expired, or sent to another UAV
+     */
+    std::optional<PendingCommand> acknowledge(const std::string& uavName, uint32_t sequence);
+
+    /**
+     * @brief Stop tracking a command that could not be forwarded
+     * @param sequence Sequence number returned by track()
+     * @return The pending command, or nothing if unknown
+     */
+    std::optional<PendingCommand> cancel(uint32_t sequence);
+
+    /**
+     * @brief Remove and return all commands whose deadline has passed
+     * @param now Current time
+     * @return Expired commands (usually empty)
+     */
+    std::vector<PendingCommand> expire(std::chrono::steady_clock::time_point now);
+
+   private:
+    std::chrono::milliseconds timeout_;                     ///< Acknowledgement timeout for every command
+    std::mutex mutex_;                                      ///< Protects all members below
+    uint32_t nextSequence_{1};                              ///< Next sequence number to hand out
+    std::unordered_map<uint32_t, PendingCommand> pending_;  ///< Sequence number -> pending command
+    std::deque<uint32_t> expiryOrder_;                      ///< Sequence numbers in deadline order (may be stale)
+};
+
+#endif  // COMMANDTRACKER_H
@@ -10,6 +10,8 @@
 
 #include <fstream>
 #include <stdexcept>
+#include <unordered_map>
+#include <unordered_set>
 
 /**
  * @brief Load configuration from a JSON file
@@ -18,9 +20,17 @@
  *
  * This method:
  * 1. Opens and parses the JSON file
- * 2. Extracts UAV configurations from the "uavs" array (TCP and UDP ports required)
- * 3. Loads UI port settings from "ui_ports" object (TCP and UDP ports required)
- * 4. Sets the log file path from "log_file" field
+ * 2. Loads the optional "shared_ingest" endpoints
+ * 3. Extracts UAV configurations from the "uavs" array (dedicated TCP and UDP ports are
+ *    required unless the matching shared ingest endpoint is configured)
+ * 4. Loads the optional "groups" object (group name -> array of UAV names)
+ * 5. Loads UI port settings from "ui_ports" object (TCP and UDP ports required)
+ * 6. Sets the log file path from "log_file" field and the optional "log_level"
+ * 7. Loads the optional "recorder" section (telemetry journal)
+ * 8. Loads the optional "state_store" section (fleet state)
+ * 9. Loads the optional "geofences" array
+ * 10. Loads the optional "analytics" section (fleet health statistics)
+ * 11. Loads the optional "link_monitor" section (stale-UAV detection)
  *
  * @throws nlohmann::json::exception if JSON parsing fails
  */
@@ -36,42 +46,56 @@ bool Config::loadFromFile(const std::string& path) {
     file >> json_data;
     file.close();
 
+    // Load optional shared ingest endpoints first - they decide which UAV ports are required
+    if (json_data.contains("shared_ingest")) {
+        const auto& shared_json = json_data["shared_ingest"];
+        sharedIngest.tcp_telemetry_port = shared_json.value("tcp_telemetry_port", 0);
+        sharedIngest.tcp_command_port = shared_json.value("tcp_command_port", 0);
+        sharedIngest.udp_telemetry_port = shared_json.value("udp_telemetry_port", 0);
+
+        auto validateSharedPort = [](int port, const std::string& portName) {
+            if (port < 0 || port > 65535) {
+                throw std::runtime_error("Shared ingest port '" + portName + "' has invalid value: "
+                                         + std::to_string(port) + " (must be 1-65535, or 0 to disable)");
+            }
+        };
+        validateSharedPort(sharedIngest.tcp_telemetry_port, "tcp_telemetry_port");
+        validateSharedPort(sharedIngest.tcp_command_port, "tcp_command_port");
+        validateSharedPort(sharedIngest.udp_telemetry_port, "udp_telemetry_port");
+    }
+
+    std::unordered_set<std::string> seen_names;
+    std::unordered_set<uint16_t> seen_ids;
+
     // Process each UAV in the configuration
     for (const auto& uav_json : json_data["uavs"]) {
-        UAVConfig uav;
-
-        // Extract required UAV fields with validation
-        if (!uav_json.contains("name") || !uav_json.contains("ip")) {
-            throw std::runtime_error("UAV configuration missing required 'name' or 'ip' field");
+        // Numeric id defaults to the UAV's position in the list (1-based)
+        UAVConfig uav = parseUAV(uav_json, sharedIngest, static_cast<int>(uavs.size()) + 1);
+        if (!seen_names.insert(uav.name).second) {
+            throw std::runtime_error("Duplicate UAV name in configuration: '" + uav.name + "'");
         }
-        uav.name = uav_json["name"];
-        uav.ip = uav_json["ip"];
-
-        // Extract TCP ports configuration with validation
-        if (!uav_json.contains("tcp_telemetry_port") || !uav_json.contains("tcp_command_port")) {
-            throw std::runtime_error("UAV '" + uav.name + "' missing required TCP ports configuration");
+        if (!seen_ids.insert(uav.id).second) {
+            throw std::runtime_error("UAV '" + uav.name + "' reuses id " + std::to_string(uav.id));
         }
-        uav.tcp_telemetry_port = uav_json["tcp_telemetry_port"];
-        uav.tcp_command_port = uav_json["tcp_command_port"];
+        uavs.push_back(uav);
+    }
 
-        // Extract UDP telemetry port with validation
-        if (!uav_json.contains("udp_telemetry_port")) {
-            throw std::runtime_error("UAV '" + uav.name + "' missing required UDP telemetry port configuration");
+    // Load optional command groups. Members are not required to be in "uavs": a group may
+    // name UAVs that are registered at runtime, and absent members are simply skipped.
+    if (json_data.contains("groups")) {
+        const auto& groups_json = json_data["groups"];
+        if (!groups_json.is_object()) {
+            throw std::runtime_error("'groups' must be an object of group name -> array of UAV names");
         }
-        uav.udp_telemetry_port = uav_json["udp_telemetry_port"];
-
-        // Validate port ranges
-        auto validatePort = [&](int port, const std::string& portName) {
-            if (port < 1 || port > 65535) {
-                throw std::runtime_error("UAV '" + uav.name + "' has invalid " + portName + ": " + std::to_string(port)
-                                         + " (must be 1-65535)");
+        for (const auto& [group_name, members_json] : groups_json.items()) {
+            if (group_name.empty() || group_name.find(':') != std::string::npos) {
+                throw std::runtime_error("Invalid group name '" + group_name + "' (must be non-empty, no ':')");
             }
-        };
-        validatePort(uav.tcp_telemetry_port, "tcp_telemetry_port");
-        validatePort(uav.tcp_command_port, "tcp_command_port");
-        validatePort(uav.udp_telemetry_port, "udp_telemetry_port");
-
-        uavs.push_back(uav);
+            if (!members_json.is_array()) {
+                throw std::runtime_error("Group '" + group_name + "' must be an array of UAV names");
+            }
+            groups[group_name] = members_json.get<std::vector<std::string>>();
+        }
     }
 
     // Load UI port configuration with validation
@@ -105,5 +129,252 @@ bool Config::loadFromFile(const std::string& path) {
         logFile = json_data["log_file"];
     }
 
+    // Load optional minimum log level (can be changed at runtime by a reload)
+    if (json_data.contains("log_level")) {
+        std::string level = json_data["log_level"];
+        if (level == "debug") {
+            logLevel = LogLevel::DEBUG;
+        } else if (level == "info") {
+            logLevel = LogLevel::INFO;
+        } else if (level == "warn") {
+            logLevel = LogLevel::WARN;
+        } else if (level == "error") {
+            logLevel = LogLevel::ERROR;
+        } else {
+            throw std::runtime_error("Invalid log_level '" + level + "' (must be debug, info, warn or error)");
+        }
+    }
+
+    // Load optional telemetry journal settings; the section's presence enables recording
+    if (json_data.contains("recorder")) {
+        const auto& recorder_json = json_data["recorder"];
+        recorder.enabled = recorder_json.value("enabled", true);
+        recorder.directory = recorder_json.value("directory", recorder.directory);
+        recorder.segment_size_mb = recorder_json.value("segment_size_mb", recorder.segment_size_mb);
+        recorder.buffer_mb = recorder_json.value("buffer_mb", recorder.buffer_mb);
+        if (recorder.directory.empty()) {
+            throw std::runtime_error("Recorder 'directory' must not be empty");
+        }
+        // Segment offsets are seeked with long, which is 32-bit on Windows
+        if (recorder.segment_size_mb < 1 || recorder.segment_size_mb > 1024) {
+            throw std::runtime_error("Recorder 'segment_size_mb' has invalid value: "
+                                     + std::to_string(recorder.segment_size_mb) + " (must be 1-1024)");
+        }
+        if (recorder.buffer_mb < 1) {
+            throw std::runtime_error("Recorder 'buffer_mb' has invalid value: " + std::to_string(recorder.buffer_mb)
+                                     + " (must be at least 1)");
+        }
+    }
+
+    if (json_data.contains("state_store")) {
+        const auto& state_json = json_data["state_store"];
+        stateStore.enabled = state_json.value("enabled", true);
+        stateStore.grid_cell_deg = state_json.value("grid_cell_deg", stateStore.grid_cell_deg);
+        if (!(stateStore.grid_cell_deg >= 0.0001 && stateStore.grid_cell_deg <= 10.0)) {
+            throw std::runtime_error("State store 'grid_cell_deg' has invalid value: "
+                                     + std::to_string(stateStore.grid_cell_deg) + " (must be 0.0001-10)");
+        }
+    }
+
+    // Load optional geofences. Like groups, the UAV lists may name UAVs registered later.
+    if (json_data.contains("geofences")) {
+        std::unordered_set<std::string> fence_names;
+        for (const auto& fence_json : json_data["geofences"]) {
+            GeofenceConfig fence;
+            fence.name = fence_json.value("name", "");
+            if (fence.name.empty() || fence.name.find_first_of(".* ") != std::string::npos) {
+                throw std::runtime_error("Invalid geofence name '" + fence.name + "' (must be non-empty, no '.', '*' "
+                                         "or spaces)");
+            }
+            if (!fence_names.insert(fence.name).second) {
+                throw std::runtime_error("Duplicate geofence name '" + fence.name + "'");
+            }
+            std::string type = fence_json.value("type", "keep_in");
+            if (type != "keep_in" && type != "keep_out") {
+                throw std::runtime_error("Geofence '" + fence.name + "' has invalid type '" + type
+                                         + "' (must be keep_in or keep_out)");
+            }
+            fence.keep_in = type == "keep_in";
+            for (const auto& vertex : fence_json.at("polygon")) {
+                double latitude = vertex.at(0).get<double>();
+                double longitude = vertex.at(1).get<double>();
+                if (latitude < -90.0 || latitude > 90.0 || longitude < -180.0 || longitude > 180.0) {
+                    throw std::runtime_error("Geofence '" + fence.name + "' has a vertex outside -90..90 / -180..180");
+                }
+                fence.polygon.emplace_back(latitude, longitude);
+            }
+            if (fence.polygon.size() < 3) {
+                throw std::runtime_error("Geofence '" + fence.name + "' needs at least 3 [lat, lon] vertices");
+            }
+            fence.uavs = fence_json.value("uavs", std::vector<std::string>{});
+            geofences.push_back(std::move(fence));
+        }
+    }
+
+    if (json_data.contains("analytics")) {
+        const auto& analytics_json = json_data["analytics"];
+        analytics.enabled = analytics_json.value("enabled", true);
+        analytics.publish_interval_ms = analytics_json.value("publish_interval_ms", analytics.publish_interval_ms);
+        analytics.ewma_half_life_s = analytics_json.value("ewma_half_life_s", analytics.ewma_half_life_s);
+        analytics.window_s = analytics_json.value("window_s", analytics.window_s);
+        if (analytics.publish_interval_ms < 100 || analytics.publish_interval_ms > 60000) {
+            throw std::runtime_error("Analytics 'publish_interval_ms' has invalid value: "
+                                     + std::to_string(analytics.publish_interval_ms) + " (must be 100-60000)");
+        }
+        if (!(analytics.ewma_half_life_s >= 0.1 && analytics.ewma_half_life_s <= 3600.0)) {
+            throw std::runtime_error("Analytics 'ewma_half_life_s' has invalid value: "
+                                     + std::to_string(analytics.ewma_half_life_s) + " (must be 0.1-3600)");
+        }
+        if (analytics.window_s < 2 || analytics.window_s > 3600) {
+            throw std::runtime_error("Analytics 'window_s' has invalid value: " + std::to_string(analytics.window_s)
+                                     + " (must be 2-3600)");
+        }
+    }
+
+    if (json_data.contains("link_monitor")) {
+        const auto& link_json = json_data["link_monitor"];
+        linkMonitor.enabled = link_json.value("enabled", true);
+        linkMonitor.timeout_ms = link_json.value("timeout_ms", linkMonitor.timeout_ms);
+        if (linkMonitor.timeout_ms < 200 || linkMonitor.timeout_ms > 3600000) {
+            throw std::runtime_error("Link monitor 'timeout_ms' has invalid value: "
+                                     + std::to_string(linkMonitor.timeout_ms) + " (must be 200-3600000)");
+        }
+    }
+
     return true;
 }
+
+/**
+ * @brief Parse and validate a single UAV entry
+ * @param uav_json JSON object describing the UAV
+ * @param shared Shared ingest endpoints (decide which dedicated ports may be omitted)
+ * @param default_id Id to use when the entry has no "id" field
+ * @return The validated UAV configuration
+ *
+ * Used both for the "uavs" array at startup and for UAVs registered at runtime.
+ * Uniqueness against other UAVs is left to the caller.
+ *
+ * @throws std::runtime_error if a required field is missing or a value is out of range
+ * @throws nlohmann::json::exception if a field has the wrong JSON type
+ */
+UAVConfig Config::parseUAV(const nlohmann::json& uav_json, const SharedIngestConfig& shared, int default_id) {
+    UAVConfig uav;
+
+    // Extract required UAV fields with validation
+    if (!uav_json.is_object() || !uav_json.contains("name") || !uav_json.contains("ip")) {
+        throw std::runtime_error("UAV configuration missing required 'name' or 'ip' field");
+    }
+    uav.name = uav_json["name"];
+    uav.ip = uav_json["ip"];
+    // "ADMIN", "group" and "tag" are reserved command target prefixes; '*' addresses every UAV
+    if (uav.name.empty() || uav.name == "ADMIN" || uav.name == "group" || uav.name == "tag"
+        || uav.name.find_first_of(":.|*") != std::string::npos) {
+        throw std::runtime_error("Invalid UAV name '" + uav.name
+                                 + "' (must be non-empty, not 'ADMIN', 'group' or 'tag', no ':.|*')");
+    }
+
+    // Numeric id identifies the UAV on the shared UDP port
+    int uav_id = uav_json.value("id", default_id);
+    if (uav_id < 1 || uav_id > 65535) {
+        throw std::runtime_error("UAV '" + uav.name + "' has invalid id: " + std::to_string(uav_id)
+                                 + " (must be 1-65535)");
+    }
+    uav.id = static_cast<uint16_t>(uav_id);
+    uav.defaultId = !uav_json.contains("id");
+
+    // Extract TCP ports configuration with validation
+    // Dedicated ports may be omitted only when the matching shared ingest endpoint exists
+    if ((!uav_json.contains("tcp_telemetry_port") && shared.tcp_telemetry_port == 0)
+        || (!uav_json.contains("tcp_command_port") && shared.tcp_command_port == 0)) {
+        throw std::runtime_error("UAV '" + uav.name + "' missing required TCP ports configuration");
+    }
+    uav.tcp_telemetry_port = uav_json.value("tcp_telemetry_port", 0);
+    uav.tcp_command_port = uav_json.value("tcp_command_port", 0);
+
+    // Extract UDP telemetry port with validation
+    if (!uav_json.contains("udp_telemetry_port") && shared.udp_telemetry_port == 0) {
+        throw std::runtime_error("UAV '" + uav.name + "' missing required UDP telemetry port configuration");
+    }
+    uav.udp_telemetry_port = uav_json.value("udp_telemetry_port", 0);
+
+    // Validate port ranges (0 is only reachable for ports served by shared ingest)
+    auto validatePort = [&](int port, const std::string& portName) {
+        if (port < 0 || port > 65535 || (port == 0 && uav_json.contains(portName))) {
+            throw std::runtime_error("UAV '" + uav.name + "' has invalid " + portName + ": " + std::to_string(port)
+                                     + " (must be 1-65535)");
+        }
+    };
+    validatePort(uav.tcp_telemetry_port, "tcp_telemetry_port");
+    validatePort(uav.tcp_command_port, "tcp_command_port");
+    validatePort(uav.udp_telemetry_port, "udp_telemetry_port");
+
+    // Optional tags for "tag:<tag>" command targets
+    if (uav_json.contains("tags")) {
+        uav.tags = uav_json["tags"].get<std::vector<std::string>>();
+        for (const auto& tag : uav.tags) {
+            if (tag.empty() || tag.find(':') != std::string::npos) {
+                throw std::runtime_error("UAV '" + uav.name + "' has invalid tag '" + tag
+                                         + "' (must be non-empty, no ':')");
+            }
+        }
+    }
+
+    return uav;
+}
+
+/**
+ * @brief Compute the differences between two configuration snapshots
+ * @param before Currently applied configuration
+ * @param after Newly loaded configuration
+ * @return Description of what changed
+ *
+ * UAVs are matched by name with a hash index, so the diff is linear in the
+ * number of UAVs. Order of the "uavs" array does not matter.
+ */
+ConfigDiff diffConfigs(const Config& before, const Config& after) {
+    ConfigDiff diff;
+
+    std::unordered_map<std::string, const UAVConfig*> old_by_name;
+    old_by_name.reserve(before.getUAVs().size());
+    for (const auto& uav : before.getUAVs()) {
+        old_by_name.emplace(uav.name, &uav);
+    }
+
+    for (const auto& uav : after.getUAVs()) {
+        auto old_it = old_by_name.find(uav.name);
+        if (old_it == old_by_name.end()) {
+            diff.addedUavs.push_back(uav);
+            continue;
+        }
+        const UAVConfig& old = *old_it->second;
+        if (old != uav) {
+            bool rebind = old.tcp_telemetry_port != uav.tcp_telemetry_port
+                          || old.tcp_command_port != uav.tcp_command_port
+                          || old.udp_telemetry_port != uav.udp_telemetry_port
+                          || (old.ip != uav.ip && uav.udp_telemetry_port > 0);
+            (rebind ? diff.changedUavs : diff.updatedUavs).push_back(uav);
+            if (old.id != uav.id && uav.defaultId) {
+                diff.shiftedIds.push_back(uav.name);
+            }
+        }
+        old_by_name.erase(old_it);
+    }
+    // Whatever was not matched no longer exists
+    for (const auto& uav : before.getUAVs()) {
+        if (old_by_name.count(uav.name) != 0) {
+            diff.removedUavs.push_back(uav.name);
+        }
+    }
+
+    diff.endpointsChanged =
+        !(before.getUiPorts() == after.getUiPorts()) || !(before.getSharedIngest() == after.getSharedIngest());
+    diff.logFileChanged = before.getLogFile() != after.getLogFile();
+    diff.logLevelChanged = before.getLogLevel() != after.getLogLevel();
+    diff.groupsChanged = before.getGroups() != after.getGroups();
+    diff.recorderChanged = !(before.getRecorder() == after.getRecorder());
+    diff.stateStoreChanged = !(before.getStateStore() == after.getStateStore());
+    diff.geofencesChanged = before.getGeofences() != after.getGeofences();
+    diff.analyticsChanged = !(before.getAnalytics() == after.getAnalytics());
+    diff.linkMonitorChanged = !(before.getLinkMonitor() == after.getLinkMonitor());
+    return diff;
+}
@@ -10,25 +10,69 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include <cstdint>
+#include <map>
 #include <nlohmann/json.hpp>
 #include <string>
+#include <utility>
 #include <vector>
 
+#include "Logger.h"
+
 /**
  * @struct UAVConfig
  * @brief Configuration data for a single UAV
  *
  * Contains all the network configuration needed to communicate with one UAV,
- * including ports for different communication protocols.
+ * including ports for different communication protocols. A port left at 0 means
+ * the UAV has no dedicated endpoint for that channel and uses shared ingest.
  */
 struct UAVConfig {
-    std::string name;           ///< Unique identifier for the UAV (e.g., "UAV_1")
-    std::string ip;             ///< IP address or hostname of the UAV
-    int tcp_telemetry_port{0};  ///< TCP port for receiving telemetry data
-    int tcp_command_port{0};    ///< TCP port for sending commands to UAV
-    int udp_telemetry_port{0};  ///< UDP port for receiving telemetry data
+    std::string name;               ///< Unique identifier for the UAV (e.g., "UAV_1")
+    std::string ip;                 ///< IP address or hostname of the UAV
+    uint16_t id{0};                 ///< Numeric identifier carried in shared-ingest UDP packets
+    int tcp_telemetry_port{0};      ///< TCP port for receiving telemetry data (0 = shared ingest)
+    int tcp_command_port{0};        ///< TCP port for sending commands to UAV (0 = shared ingest)
+    int udp_telemetry_port{0};      ///< UDP port for receiving telemetry data (0 = shared ingest)
+    std::vector<std::string> tags;  ///< Free-form labels addressable with "tag:<tag>" command targets
+    bool defaultId{false};          ///< "id" was omitted and defaulted (to the position in "uavs")
+};
+
+/**
+ * @brief Compare two UAV configurations field by field (defaultId is not a setting and is ignored)
+ */
+inline bool operator==(const UAVConfig& lhs, const UAVConfig& rhs) {
+    return lhs.name == rhs.name && lhs.ip == rhs.ip && lhs.id == rhs.id
+           && lhs.tcp_telemetry_port == rhs.tcp_telemetry_port && lhs.tcp_command_port == rhs.tcp_command_port
+           && lhs.udp_telemetry_port == rhs.udp_telemetry_port && lhs.tags == rhs.tags;
+}
+
+inline bool operator!=(const UAVConfig& lhs, const UAVConfig& rhs) {
+    return !(lhs == rhs);
+}
+
+/**
+ * @struct SharedIngestConfig
+ * @brief Fleet-wide endpoints shared by all UAVs
+ *
+ * Instead of binding a socket per UAV, the service can expose one endpoint per
+ * channel. UAV identity then comes from the ZeroMQ routing ID (TCP) or from the
+ * IngestHeader prepended to each datagram (UDP). All ports are optional.
+ */
+struct SharedIngestConfig {
+    int tcp_telemetry_port{0};  ///< ROUTER port receiving telemetry from any UAV
+    int tcp_command_port{0};    ///< ROUTER port delivering commands to any UAV
+    int udp_telemetry_port{0};  ///< UDP port receiving telemetry from any UAV
 };
 
+/**
+ * @brief Compare two shared ingest configurations field by field
+ */
+inline bool operator==(const SharedIngestConfig& lhs, const SharedIngestConfig& rhs) {
+    return lhs.tcp_telemetry_port == rhs.tcp_telemetry_port && lhs.tcp_command_port == rhs.tcp_command_port
+           && lhs.udp_telemetry_port == rhs.udp_telemetry_port;
+}
+
 /**
  * @struct UIConfig
  * @brief Configuration for UI communication ports
@@ -42,12 +86,128 @@ struct UIConfig {
     int udp_publish_port{0};  ///< Port for UDP subscription management and publishing
 };
 
+/**
+ * @brief Compare two UI port configurations field by field
+ */
+inline bool operator==(const UIConfig& lhs, const UIConfig& rhs) {
+    return lhs.tcp_command_port == rhs.tcp_command_port && lhs.tcp_publish_port == rhs.tcp_publish_port
+           && lhs.udp_publish_port == rhs.udp_publish_port;
+}
+
+/**
+ * @struct RecorderConfig
+ * @brief Settings of the telemetry journal recorder
+ *
+ * When enabled, every ingested packet is appended to segment files in the
+ * journal directory (see telemetry_journal/include/JournalFormat.h).
+ */
+struct RecorderConfig {
+    bool enabled{false};               ///< Record ingested packets (true when the "recorder" section exists)
+    std::string directory{"journal"};  ///< Journal directory (relative paths are resolved like log_file)
+    int segment_size_mb{64};           ///< Preallocated size of one segment file (1-1024)
+    int buffer_mb{64};                 ///< Packets buffered for the writer thread before new ones are dropped
+};
+
+/**
+ * @brief Compare two recorder configurations field by field
+ */
+inline bool operator==(const RecorderConfig& lhs, const RecorderConfig& rhs) {
+    return lhs.enabled == rhs.enabled && lhs.directory == rhs.directory && lhs.segment_size_mb == rhs.segment_size_mb
+           && lhs.buffer_mb == rhs.buffer_mb;
+}
+
+/**
+ * @struct StateStoreConfig
+ * @brief Settings of the fleet state store
+ *
+ * When enabled, the service keeps the latest decoded location and status of
+ * every UAV in memory (see FleetState.h).
+ */
+struct StateStoreConfig {
+    bool enabled{false};         ///< Keep fleet state (true when the "state_store" section exists)
+    double grid_cell_deg{0.01};  ///< Cell size of the spatial index in degrees (0.0001-10)
+};
+
+/**
+ * @brief Compare two state store configurations field by field
+ */
+inline bool operator==(const StateStoreConfig& lhs, const StateStoreConfig& rhs) {
+    return lhs.enabled == rhs.enabled && lhs.grid_cell_deg == rhs.grid_cell_deg;
+}
+
+/**
+ * @struct AnalyticsConfig
+ * @brief Settings of the fleet health analytics stage
+ *
+ * When enabled, status packets feed rolling per-UAV and fleet-wide statistics
+ * that are published on "fleet.*" topics (see FleetAnalytics.h).
+ */
+struct AnalyticsConfig {
+    bool enabled{false};            ///< Run the stage (true when the "analytics" section exists)
+    int publish_interval_ms{1000};  ///< Report cadence (100-60000)
+    double ewma_half_life_s{10.0};  ///< Half-life of the CPU/memory moving averages (0.1-3600)
+    int window_s{60};               ///< Rolling window of the percentiles (2-3600)
+};
+
+/**
+ * @brief Compare two analytics configurations field by field
+ */
+inline bool operator==(const AnalyticsConfig& lhs, const AnalyticsConfig& rhs) {
+    return lhs.enabled == rhs.enabled && lhs.publish_interval_ms == rhs.publish_interval_ms
+           && lhs.ewma_half_life_s == rhs.ewma_half_life_s && lhs.window_s == rhs.window_s;
+}
+
+/**
+ * @struct LinkMonitorConfig
+ * @brief Settings of stale-UAV detection
+ *
+ * Unlike the other optional features this one is on by default: a UAV that
+ * stops sending is reported on "uav.<UAV>.link" unless "link_monitor" turns
+ * it off (see LinkMonitor.h).
+ */
+struct LinkMonitorConfig {
+    bool enabled{true};    ///< Report links going up and down
+    int timeout_ms{3000};  ///< Silence after which a UAV or topic is reported down (200-3600000)
+};
+
+/**
+ * @brief Compare two link monitor configurations field by field
+ */
+inline bool operator==(const LinkMonitorConfig& lhs, const LinkMonitorConfig& rhs) {
+    return lhs.enabled == rhs.enabled && lhs.timeout_ms == rhs.timeout_ms;
+}
+
+/**
+ * @struct GeofenceConfig
+ * @brief One configured geofence
+ *
+ * A keep-in fence alerts when a UAV leaves the polygon, a keep-out fence when a
+ * UAV enters it. Polygons must not cross the antimeridian.
+ */
+struct GeofenceConfig {
+    std::string name;                                ///< Fence name (used in the alert topic)
+    bool keep_in{true};                              ///< true: "keep_in", false: "keep_out"
+    std::vector<std::pair<double, double>> polygon;  ///< Vertices as (latitude, longitude), at least 3
+    std::vector<std::string> uavs;                   ///< UAV names the fence applies to (empty = every UAV)
+};
+
+/**
+ * @brief Compare two geofence configurations field by field
+ */
+inline bool operator==(const GeofenceConfig& lhs, const GeofenceConfig& rhs) {
+    return lhs.name == rhs.name && lhs.keep_in == rhs.keep_in && lhs.polygon == rhs.polygon && lhs.uavs == rhs.uavs;
+}
+
 /**
  * @class Config
  * @brief Main configuration management class
  *
  * Handles loading configuration from JSON files and provides access to
  * all configuration parameters needed by the telemetry service.
+ *
+ * A loaded Config is treated as immutable: the service publishes it through a
+ * Snapshot<Config> and a reload (SIGHUP) publishes a new object instead of
+ * modifying the current one.
  */
 class Config {
    public:
@@ -61,11 +221,30 @@ class Config {
      * {
      *   "uavs": [...],
      *   "ui_ports": {...},
-     *   "log_file": "..."
+     *   "shared_ingest": {...},   (optional)
+     *   "groups": {...},          (optional: group name -> list of UAV names)
+     *   "recorder": {...},        (optional: telemetry journal settings)
+     *   "state_store": {...},     (optional: in-memory fleet state)
+     *   "geofences": [...],       (optional: polygons checked against every location packet)
+     *   "analytics": {...},       (optional: fleet health statistics on "fleet.*" topics)
+     *   "link_monitor": {...},    (optional: stale-UAV detection, on by default)
+     *   "log_file": "...",
+     *   "log_level": "info"       (optional: debug, info, warn, error)
      * }
      */
     bool loadFromFile(const std::string& path);
 
+    /**
+     * @brief Parse and validate a single UAV entry
+     * @param uav_json JSON object in the same format as an element of "uavs"
+     * @param shared Shared ingest endpoints (decide which dedicated ports may be omitted)
+     * @param default_id Id to use when the entry has no "id" field
+     * @return The validated UAV configuration
+     *
+     * Also used for UAVs registered at runtime. Does not check uniqueness.
+     */
+    static UAVConfig parseUAV(const nlohmann::json& uav_json, const SharedIngestConfig& shared, int default_id);
+
     /**
      * @brief Get the list of configured UAVs
      * @return Reference to vector of UAV configurations
@@ -82,6 +261,62 @@ class Config {
         return uiPorts;
     }
 
+    /**
+     * @brief Get the shared ingest endpoint configuration
+     * @return Reference to shared ingest configuration (ports are 0 when unused)
+     */
+    [[nodiscard]] const SharedIngestConfig& getSharedIngest() const {
+        return sharedIngest;
+    }
+
+    /**
+     * @brief Get the named UAV groups used as "group:<name>" command targets
+     * @return Reference to map of group name -> member UAV names (may name UAVs registered later)
+     */
+    [[nodiscard]] const std::map<std::string, std::vector<std::string>>& getGroups() const {
+        return groups;
+    }
+
+    /**
+     * @brief Get the telemetry journal recorder settings
+     * @return Reference to recorder configuration (disabled unless "recorder" is present)
+     */
+    [[nodiscard]] const RecorderConfig& getRecorder() const {
+        return recorder;
+    }
+
+    /**
+     * @brief Get the fleet state store settings
+     * @return Reference to state store configuration (disabled unless "state_store" is present)
+     */
+    [[nodiscard]] const StateStoreConfig& getStateStore() const {
+        return stateStore;
+    }
+
+    /**
+     * @brief Get the configured geofences
+     * @return Reference to vector of geofences (empty unless "geofences" is present)
+     */
+    [[nodiscard]] const std::vector<GeofenceConfig>& getGeofences() const {
+        return geofences;
+    }
+
+    /**
+     * @brief Get the fleet analytics settings
+     * @return Reference to analytics configuration (disabled unless "analytics" is present)
+     */
+    [[nodiscard]] const AnalyticsConfig& getAnalytics() const {
+        return analytics;
+    }
+
+    /**
+     * @brief Get the stale-UAV detection settings
+     * @return Reference to link monitor configuration (enabled unless "link_monitor" turns it off)
+     */
+    [[nodiscard]] const LinkMonitorConfig& getLinkMonitor() const {
+        return linkMonitor;
+    }
+
     /**
      * @brief Get the log file path
      * @return Reference to log file path string
@@ -90,10 +325,71 @@ class Config {
         return logFile;
     }
 
+    /**
+     * @brief Get the minimum log level
+     * @return Log level (INFO unless "log_level" is set); can be changed by a reload
+     */
+    [[nodiscard]] LogLevel getLogLevel() const {
+        return logLevel;
+    }
+
    private:
-    std::vector<UAVConfig> uavs;  ///< List of configured UAVs
-    UIConfig uiPorts;             ///< UI communication ports
-    std::string logFile;          ///< Path to log file (required in JSON)
+    std::vector<UAVConfig> uavs;                             ///< List of configured UAVs
+    UIConfig uiPorts;                                        ///< UI communication ports
+    SharedIngestConfig sharedIngest;                         ///< Optional fleet-wide ingest endpoints
+    std::map<std::string, std::vector<std::string>> groups;  ///< Optional named UAV groups
+    RecorderConfig recorder;                                 ///< Optional telemetry journal settings
+    StateStoreConfig stateStore;                             ///< Optional fleet state store settings
+    std::vector<GeofenceConfig> geofences;                   ///< Optional geofences
+    AnalyticsConfig analytics;                               ///< Optional fleet analytics settings
+    LinkMonitorConfig linkMonitor;                           ///< Stale-UAV detection settings
+    std::string logFile;                                     ///< Path to log file (required in JSON)
+    LogLevel logLevel{LogLevel::INFO};                       ///< Minimum log level (optional in JSON)
 };
 
+/**
+ * @struct ConfigDiff
+ * @brief Differences between two configuration snapshots
+ *
+ * Produced by diffConfigs() when the configuration is reloaded. UAVs are
+ * matched by name. A UAV whose sockets must be rebound (a port changed, or the
+ * address of its dedicated UDP port) is listed in changedUavs; one where only
+ * the address, id or tags changed is listed in updatedUavs and keeps its
+ * sockets. Both lists hold the new settings.
+ */
+struct ConfigDiff {
+    std::vector<UAVConfig> addedUavs;      ///< UAVs only in the new configuration
+    std::vector<std::string> removedUavs;  ///< Names of UAVs only in the old configuration
+    std::vector<UAVConfig> changedUavs;    ///< New settings of UAVs whose sockets must be rebound
+    std::vector<UAVConfig> updatedUavs;    ///< New settings of UAVs updated in place (address, id or tags)
+    std::vector<std::string> shiftedIds;   ///< UAVs whose defaulted id changed with their list position
+    bool endpointsChanged{false};          ///< "ui_ports" or "shared_ingest" differ (requires a restart)
+    bool logFileChanged{false};            ///< "log_file" differs (requires a restart)
+    bool logLevelChanged{false};           ///< "log_level" differs
+    bool groupsChanged{false};             ///< "groups" differs
+    bool recorderChanged{false};           ///< "recorder" differs (requires a restart)
+    bool stateStoreChanged{false};         ///< "state_store" differs (requires a restart)
+    bool geofencesChanged{false};          ///< "geofences" differs
+    bool analyticsChanged{false};          ///< "analytics" differs (requires a restart)
+    bool linkMonitorChanged{false};        ///< "link_monitor" differs (requires a restart)
+
+    /**
+     * @brief Check whether the two configurations are equivalent
+     * @return true if nothing changed
+     */
+    [[nodiscard]] bool empty() const {
+        return addedUavs.empty() && removedUavs.empty() && changedUavs.empty() && updatedUavs.empty()
+               && !endpointsChanged && !logFileChanged && !logLevelChanged && !groupsChanged && !recorderChanged
+               && !stateStoreChanged && !geofencesChanged && !analyticsChanged && !linkMonitorChanged;
+    }
+};
+
+/**
+ * @brief Compute the differences between two configuration snapshots
+ * @param before Currently applied configuration
+ * @param after Newly loaded configuration
+ * @return Description of what changed
+ */
+ConfigDiff diffConfigs(const Config& before, const Config& after);
+
 #endif  // CONFIG_H
@@ -0,0 +1,232 @@
+/**
+ * @file DerivedStreams.cpp
+ * @brief Implementation of the downsampled and aggregated streams
+ */
+
+#include "DerivedStreams.h"
+
+#include <algorithm>
+#include <cmath>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+namespace {
+    constexpr double MAX_RATE_HZ = 100.0;    ///< Faster streams would hardly reduce anything
+    constexpr double MIN_WINDOW_S = 1.0;     ///< Shortest aggregate window (windows close on a 100 ms tick)
+    constexpr double MAX_WINDOW_S = 3600.0;  ///< Longest aggregate window
+    constexpr size_t MAX_STREAMS = 256;      ///< Distinct streams served at once
+
+    /**
+     * @brief Parse a positive decimal number that must make up the whole text
+     * @throws std::runtime_error if the text is not such a number
+     */
+    double parseNumber(const std::string& text, const std::string& spec) {
+        size_t used = 0;
+        double value = 0;
+        try {
+            value = std::stod(text, &used);
+        } catch (const std::exception&) {
+            used = 0;
+        }
+        if (used == 0 || used != text.size() || !std::isfinite(value) || value <= 0) {
+            throw std::runtime_error("invalid number in stream spec '" + spec + "'");
+        }
+        return value;
+    }
+}  // namespace
+
+/**
+ * @brief Register one subscriber of a stream
+ * @param channel Channel the subscriber receives the stream on
+ * @param subscription "<pattern>[?<expression>]@<spec>"
+ *
+ * Spec syntax: "<N>Hz" (0 < N <= 100) or "<W>s:<field>" (1 <= W <= 3600,
+ * field as in payload filters).
+ */
+void DerivedStreams::add(OutboundChannel channel, const std::string& subscription) {
+    auto it = streams_.find(subscription);
+    if (it == streams_.end()) {
+        if (streams_.size() >= MAX_STREAMS) {
+            throw std::runtime_error("too many derived streams");
+        }
+        Stream stream;
+        stream.input = SubscriptionFilter::parse(subscription);
+        stream.suffix = std::move(stream.input.derivedSuffix);
+        stream.input.derivedSuffix.clear();
+        std::string spec = stream.suffix.substr(1);
+        if (stream.input.pattern.empty() || spec.empty()) {
+            throw std::runtime_error("expected <pattern>@<spec>");
+        }
+
+        size_t colon = spec.find(':');
+        if (colon == std::string::npos && spec.size() > 2 && spec.compare(spec.size() - 2, 2, "Hz") == 0) {
+            double hz = parseNumber(spec.substr(0, spec.size() - 2), spec);
+            if (hz > MAX_RATE_HZ) {
+                throw std::runtime_error("stream rate above " + std::to_string(static_cast<int>(MAX_RATE_HZ)) + " Hz");
+            }
+            stream.periodMs = std::max<int64_t>(1, std::llround(1000.0 / hz));
+        } else if (colon != std::string::npos && colon > 1 && spec[colon - 1] == 's') {
+            double seconds = parseNumber(spec.substr(0, colon - 1), spec);
+            if (seconds < MIN_WINDOW_S || seconds > MAX_WINDOW_S) {
+                throw std::runtime_error("aggregate window must be 1 to 3600 s");
+            }
+            stream.field = PacketField::find(std::string_view(spec).substr(colon + 1));
+            if (!stream.field) {
+                throw std::runtime_error("unknown field '" + spec.substr(colon + 1) + "'");
+            }
+            stream.periodMs = std::llround(seconds * 1000.0);
+        } else {
+            throw std::runtime_error("expected @<N>Hz or @<W>s:<field>, got '@" + spec + "'");
+        }
+        it = streams_.emplace(subscription, std::move(stream)).first;
+    }
+    ++(channel == OutboundChannel::TCP ? it->second.tcpSubscribers : it->second.udpSubscribers);
+}
+
+/**
+ * @brief Unregister one subscriber of a stream
+ * @param channel Channel the subscriber received the stream on
+ * @param subscription Subscription string given to add()
+ */
+void DerivedStreams::remove(OutboundChannel channel, const std::string& subscription) {
+    auto it = streams_.find(subscription);
+    if (it == streams_.end()) {
+        return;
+    }
+    unsigned& subscribers = channel == OutboundChannel::TCP ? it->second.tcpSubscribers : it->second.udpSubscribers;
+    if (subscribers > 0) {
+        --subscribers;
+    }
+    if (it->second.tcpSubscribers == 0 && it->second.udpSubscribers == 0) {
+        streams_.erase(it);
+    }
+}
+
+/**
+ * @brief Feed an ingested packet to every stream whose pattern matches its topic
+ * @param uavName UAV that sent the packet
+ * @param topic Topic the packet is published on
+ * @param packet Packet as received
+ * @param nowMs Current time (milliseconds since the epoch)
+ * @param out Derived messages to publish are appended here
+ */
+void DerivedStreams::process(const std::string& uavName,
+                             const std::string& topic,
+                             const std::vector<uint8_t>& packet,
+                             int64_t nowMs,
+                             std::vector<DerivedMessage>& out) {
+    for (auto& [subscription, stream] : streams_) {
+        if (!stream.input.matches(topic, packet)) {
+            continue;
+        }
+        double value = 0;
+        if (stream.field && (!stream.field->read(packet, value) || std::isnan(value))) {
+            continue;  // Source packet of another type
+        }
+        auto source = stream.sources.find(topic);
+        if (source == stream.sources.end()) {
+            source = stream.sources.emplace(topic, SourceState{}).first;
+            source->second.uavName = uavName;
+        }
+        SourceState& state = source->second;
+
+        if (!stream.field) {
+            if (nowMs < state.nextEmitMs) {
+                continue;
+            }
+            // Keep to the slot grid while packets keep coming; restart it after a gap
+            state.nextEmitMs = state.nextEmitMs + stream.periodMs > nowMs ? state.nextEmitMs + stream.periodMs
+                                                                          : nowMs + stream.periodMs;
+            emit(subscription, stream, PriorityRouter::classify(packet), topic + stream.suffix, packet, out);
+            continue;
+        }
+
+        int64_t window_start = nowMs - (nowMs % stream.periodMs + stream.periodMs) % stream.periodMs;
+        if (state.count > 0 && window_start != state.windowStartMs) {
+            emit(subscription,
+                 stream,
+                 PriorityLane::BULK,
+                 topic + stream.suffix,
+                 summarize(stream, topic, state),
+                 out);
+            state.count = 0;
+        }
+        if (state.count == 0) {
+            state.windowStartMs = window_start;
+            state.min = state.max = value;
+            state.sum = 0;
+        }
+        ++state.count;
+        state.min = std::min(state.min, value);
+        state.max = std::max(state.max, value);
+        state.sum += value;
+    }
+}
+
+/**
+ * @brief Close the aggregate windows that have ended
+ * @param nowMs Current time (milliseconds since the epoch)
+ * @param out Derived messages to publish are appended here
+ *
+ * Also forgets rate-stream sources idle for a whole slot: their next packet
+ * passes either way.
+ */
+void DerivedStreams::flush(int64_t nowMs, std::vector<DerivedMessage>& out) {
+    for (auto& [subscription, stream] : streams_) {
+        for (auto it = stream.sources.begin(); it != stream.sources.end();) {
+            SourceState& state = it->second;
+            bool ended = stream.field ? nowMs >= state.windowStartMs + stream.periodMs
+                                      : nowMs >= state.nextEmitMs + stream.periodMs;
+            if (!ended) {
+                ++it;
+            } else if (state.count > 0) {
+                emit(subscription,
+                     stream,
+                     PriorityLane::BULK,
+                     it->first + stream.suffix,
+                     summarize(stream, it->first, state),
+                     out);
+                state.count = 0;
+                ++it;
+            } else {
+                it = stream.sources.erase(it);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Queue a derived message on every channel the stream has subscribers on
+ */
+void DerivedStreams::emit(const std::string& subscription,
+                          const Stream& stream,
+                          PriorityLane lane,
+                          const std::string& topic,
+                          const std::vector<uint8_t>& data,
+                          std::vector<DerivedMessage>& out) {
+    if (stream.tcpSubscribers > 0) {
+        out.push_back(DerivedMessage{lane, OutboundMessage{OutboundChannel::TCP, topic, data, subscription}});
+    }
+    if (stream.udpSubscribers > 0) {
+        out.push_back(DerivedMessage{lane, OutboundMessage{OutboundChannel::UDP, topic, data, subscription}});
+    }
+}
+
+/**
+ * @brief Build the JSON summary of a closed aggregate window
+ */
+std::vector<uint8_t> DerivedStreams::summarize(const Stream& stream,
+                                               const std::string& topic,
+                                               const SourceState& state) {
+    nlohmann::json summary = {{"uav", state.uavName},
+                              {"topic", topic},
+                              {"field", stream.field->name},
+                              {"window_start_ms", state.windowStartMs},
+                              {"window_ms", stream.periodMs},
+                              {"count", state.count},
+                              {"min", state.min},
+                              {"max", state.max},
+                              {"avg", state.sum / static_cast<double>(state.count)}};
+    std::string text = summary.dump();
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
@@ -0,0 +1,150 @@
+/**
+ * @file DerivedStreams.h
+ * @brief Downsampled and aggregated telemetry streams computed in the service
+ *
+ * This file defines the DerivedStreams class. A subscriber that does not need
+ * every packet asks for a derived stream by appending "@<spec>" to its
+ * subscription:
+ * - "telemetry.*.mapping.location@1Hz" - at most one packet per second per source topic
+ * - "telemetry.*.*.status@10s:cpuUsage" - min/max/avg of a field per source topic over 10 s windows
+ *
+ * The streams are computed incrementally as packets arrive, so their egress
+ * rate no longer depends on the ingest rate.
+ */
+
+#ifndef DERIVEDSTREAMS_H
+#define DERIVEDSTREAMS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "PriorityRouter.h"
+#include "SubscriptionFilter.h"
+
+/**
+ * @struct DerivedMessage
+ * @brief A derived-stream message and the lane to publish it in
+ */
+struct DerivedMessage {
+    PriorityLane lane{PriorityLane::BULK};  ///< Priority lane
+    OutboundMessage message;                ///< Channel, derived topic, payload and stream subscription
+};
+
+/**
+ * @class DerivedStreams
+ * @brief Registry and state of the derived streams requested by subscribers
+ *
+ * Each distinct subscription string is one stream, computed once however many
+ * subscribers share it and published once per channel ("<source topic>@<spec>").
+ * Every message carries its subscription string, and the managers deliver it
+ * only to subscribers of exactly that string: two streams with the same spec
+ * but different patterns or predicates share topics, not subscribers. Streams
+ * keep their state per source topic:
+ * - rate streams ("@<N>Hz") pass the first packet of every 1/N s slot through
+ *   unchanged, so a 10 Hz source at "@1Hz" yields every tenth packet;
+ * - aggregate streams ("@<W>s:<field>") keep count/min/max/sum of the field over
+ *   the current window (aligned to multiples of W since the epoch) and publish
+ *   them as JSON when the window ends.
+ * Rate streams keep the lane of the source packet; aggregates use the bulk lane.
+ *
+ * Not thread-safe; the service calls it under its processing lock.
+ */
+class DerivedStreams {
+   public:
+    /**
+     * @brief Register one subscriber of a stream
+     * @param channel Channel the subscriber receives the stream on
+     * @param subscription "<pattern>[?<expression>]@<spec>"
+     * @throws std::runtime_error if the subscription is not a valid stream
+     */
+    void add(OutboundChannel channel, const std::string& subscription);
+
+    /**
+     * @brief Unregister one subscriber of a stream (the stream is dropped with its last subscriber)
+     * @param channel Channel the subscriber received the stream on
+     * @param subscription Subscription string given to add()
+     */
+    void remove(OutboundChannel channel, const std::string& subscription);
+
+    /**
+     * @brief Check whether any stream is registered
+     */
+    [[nodiscard]] bool empty() const {
+        return streams_.empty();
+    }
+
+    /**
+     * @brief Feed an ingested packet to every stream whose pattern matches its topic
+     * @param uavName UAV that sent the packet
+     * @param topic Topic the packet is published on
+     * @param packet Packet as received
+     * @param nowMs Current time (milliseconds since the epoch)
+     * @param out Derived messages to publish are appended here
+     */
+    void process(const std::string& uavName,
+                 const std::string& topic,
+                 const std::vector<uint8_t>& packet,
+                 int64_t nowMs,
+                 std::vector<DerivedMessage>& out);
+
+    /**
+     * @brief Close the aggregate windows that have ended
+     * @param nowMs Current time (milliseconds since the epoch)
+     * @param out Derived messages to publish are appended here
+     *
+     * Called periodically, so a window is published even when its source falls
+     * silent. Source topics without data in the last window are forgotten.
+     */
+    void flush(int64_t nowMs, std::vector<DerivedMessage>& out);
+
+   private:
+    /**
+     * @struct SourceState
+     * @brief State of one stream for one source topic
+     */
+    struct SourceState {
+        std::string uavName;       ///< UAV publishing the source topic
+        int64_t nextEmitMs{0};     ///< Rate streams: start of the next slot
+        int64_t windowStartMs{0};  ///< Aggregate streams: start of the current window
+        uint64_t count{0};         ///< Aggregate streams: samples in the current window
+        double min{0};             ///< Aggregate streams: smallest sample
+        double max{0};             ///< Aggregate streams: largest sample
+        double sum{0};             ///< Aggregate streams: sum of the samples
+    };
+
+    /**
+     * @struct Stream
+     * @brief One requested stream and its per-source state
+     */
+    struct Stream {
+        SubscriptionFilter input;                              ///< Pattern and predicate selecting source packets
+        std::string suffix;                                    ///< "@<spec>" appended to the source topic
+        const PacketField* field{nullptr};                     ///< Aggregated field (null for rate streams)
+        int64_t periodMs{0};                                   ///< Slot length (rate) or window length (aggregate)
+        unsigned tcpSubscribers{0};                            ///< Subscribers on the TCP channel
+        unsigned udpSubscribers{0};                            ///< Subscribers on the UDP channel
+        std::unordered_map<std::string, SourceState> sources;  ///< Source topic -> state
+    };
+
+    /**
+     * @brief Queue a derived message on every channel the stream has subscribers on
+     */
+    static void emit(const std::string& subscription,
+                     const Stream& stream,
+                     PriorityLane lane,
+                     const std::string& topic,
+                     const std::vector<uint8_t>& data,
+                     std::vector<DerivedMessage>& out);
+
+    /**
+     * @brief Build the JSON summary of a closed aggregate window
+     */
+    static std::vector<uint8_t> summarize(const Stream& stream, const std::string& topic, const SourceState& state);
+
+    std::map<std::string, Stream> streams_;  ///< Subscription string -> stream
+};
+
+#endif  // DERIVEDSTREAMS_H
@@ -0,0 +1,341 @@
+/**
+ * @file FleetAnalytics.cpp
+ * @brief Implementation of the t-digest and the fleet analytics stage
+ */
+
+#include "FleetAnalytics.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <nlohmann/json.hpp>
+
+#include "TelemetryPackets.h"
+
+namespace {
+    constexpr double PI = 3.14159265358979323846;
+
+    /// Report names of StatusPayload::systemHealth values
+    const char* const HEALTH_NAMES[] = {"critical", "warning", "good", "excellent"};
+    /// Report names of StatusPayload::missionState values
+    const char* const MISSION_NAMES[] = {"idle", "takeoff", "mission", "landing", "emergency"};
+
+    /**
+     * @brief Name of an enumerated status value ("unknown" if out of range)
+     */
+    template <size_t N>
+    const char* nameOf(const char* const (&names)[N], uint8_t value) {
+        return value < N ? names[value] : "unknown";
+    }
+
+    /**
+     * @brief Round to two decimals for the reports (NaN becomes null)
+     */
+    nlohmann::json rounded(double value) {
+        if (std::isnan(value)) {
+            return nullptr;
+        }
+        return std::round(value * 100.0) / 100.0;
+    }
+}  // namespace
+
+/**
+ * @brief Constructor
+ * @param compression Accuracy/size trade-off
+ */
+TDigest::TDigest(double compression) : compression_(compression) {}
+
+/**
+ * @brief Add one sample
+ *
+ * Samples are merged in batches, so adding costs an append most of the time.
+ */
+void TDigest::add(double value) {
+    if (count_ == 0) {
+        min_ = max_ = value;
+    } else {
+        min_ = std::min(min_, value);
+        max_ = std::max(max_, value);
+    }
+    ++count_;
+    buffer_.push_back(Centroid{value, 1.0});
+    if (buffer_.size() >= static_cast<size_t>(compression_ * 5)) {
+        compress();
+    }
+}
+
+/**
+ * @brief Add every sample summarized by another digest
+ */
+void TDigest::merge(const TDigest& other) {
+    if (other.count_ == 0) {
+        return;
+    }
+    if (count_ == 0) {
+        min_ = other.min_;
+        max_ = other.max_;
+    } else {
+        min_ = std::min(min_, other.min_);
+        max_ = std::max(max_, other.max_);
+    }
+    count_ += other.count_;
+    buffer_.insert(buffer_.end(), other.centroids_.begin(), other.centroids_.end());
+    buffer_.insert(buffer_.end(), other.buffer_.begin(), other.buffer_.end());
+    if (buffer_.size() >= static_cast<size_t>(compression_ * 5)) {
+        compress();
+    }
+}
+
+/**
+ * @brief Estimate a quantile
+ * @param q Quantile in 0..1
+ * @return Estimated value, or NaN if the digest is empty
+ *
+ * Each centroid's mean is placed at the middle of its weight; values between
+ * two centroids, and between the outer centroids and min/max, are linearly
+ * interpolated.
+ */
+double TDigest::quantile(double q) {
+    compress();
+    if (centroids_.empty()) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+    if (q <= 0.0) {
+        return min_;
+    }
+    if (q >= 1.0) {
+        return max_;
+    }
+    if (centroids_.size() == 1) {
+        return centroids_.front().mean;
+    }
+
+    double target = q * static_cast<double>(count_);
+    const Centroid& first = centroids_.front();
+    if (target < first.weight / 2) {
+        return min_ + (first.mean - min_) * target / (first.weight / 2);
+    }
+    double cumulative = 0;
+    for (size_t i = 0; i + 1 < centroids_.size(); ++i) {
+        const Centroid& left = centroids_[i];
+        const Centroid& right = centroids_[i + 1];
+        double left_center = cumulative + left.weight / 2;
+        double right_center = cumulative + left.weight + right.weight / 2;
+        if (target <= right_center) {
+            double t = (target - left_center) / (right_center - left_center);
+            return left.mean + t * (right.mean - left.mean);
+        }
+        cumulative += left.weight;
+    }
+    const Centroid& last = centroids_.back();
+    double last_center = static_cast<double>(count_) - last.weight / 2;
+    return last.mean + (max_ - last.mean) * std::min(1.0, (target - last_center) / (last.weight / 2));
+}
+
+/**
+ * @brief Forget every sample
+ */
+void TDigest::clear() {
+    centroids_.clear();
+    buffer_.clear();
+    count_ = 0;
+}
+
+/**
+ * @brief Merge the buffered samples into the centroids
+ *
+ * Uses the k1 scale function k(q) = compression / (2 pi) * asin(2q - 1): a
+ * centroid may grow while it spans at most one unit of k, which keeps
+ * centroids near q = 0 and q = 1 small.
+ */
+void TDigest::compress() {
+    if (buffer_.empty()) {
+        return;
+    }
+    buffer_.insert(buffer_.end(), centroids_.begin(), centroids_.end());
+    std::sort(buffer_.begin(), buffer_.end(), [](const Centroid& a, const Centroid& b) { return a.mean < b.mean; });
+
+    auto q_limit = [this](double q) {
+        double k = compression_ / (2 * PI) * std::asin(2 * q - 1) + 1;
+        if (k >= compression_ / 4) {
+            return 1.0;
+        }
+        return (std::sin(k * 2 * PI / compression_) + 1) / 2;
+    };
+
+    double total = static_cast<double>(count_);
+    double so_far = 0;
+    double limit = total * q_limit(0);
+    centroids_.clear();
+    Centroid current = buffer_.front();
+    for (size_t i = 1; i < buffer_.size(); ++i) {
+        const Centroid& next = buffer_[i];
+        if (so_far + current.weight + next.weight <= limit) {
+            current.weight += next.weight;
+            current.mean += (next.mean - current.mean) * next.weight / current.weight;
+        } else {
+            so_far += current.weight;
+            centroids_.push_back(current);
+            limit = total * q_limit(so_far / total);
+            current = next;
+        }
+    }
+    centroids_.push_back(current);
+    buffer_.clear();
+}
+
+/**
+ * @brief Constructor
+ * @param config Analytics settings
+ */
+FleetAnalytics::FleetAnalytics(const AnalyticsConfig& config)
+    : publishIntervalMs_(config.publish_interval_ms),
+      halfWindowMs_(static_cast<int64_t>(config.window_s) * 500),
+      windowMs_(static_cast<int64_t>(config.window_s) * 1000),
+      ewmaTauMs_(config.ewma_half_life_s * 1000.0 / std::log(2.0)) {}
+
+/**
+ * @brief Feed a packet (non-status packets are ignored)
+ * @param uavName UAV that sent the packet
+ * @param packet Packet as received (PacketHeader + payload)
+ * @param nowMs Current time (milliseconds since the epoch)
+ *
+ * The EWMA weight depends on the time since the UAV's previous status, so UAVs
+ * reporting at different rates average over the same time span.
+ */
+void FleetAnalytics::update(const std::string& uavName, const std::vector<uint8_t>& packet, int64_t nowMs) {
+    if (packet.size() < sizeof(PacketHeader) + sizeof(StatusPayload)
+        || packet[offsetof(PacketHeader, packetType)] != PacketTypes::STATUS) {
+        return;
+    }
+    StatusPayload status{};
+    std::memcpy(&status, packet.data() + sizeof(PacketHeader), sizeof(status));
+    if (std::isnan(status.cpuUsage) || std::isnan(status.memoryUsage)) {
+        return;
+    }
+    rotateUntil(nowMs);
+
+    auto [it, first] = uavs_.try_emplace(uavName);
+    UavStats& stats = it->second;
+    if (first) {
+        stats.cpuEwma = status.cpuUsage;
+        stats.memoryEwma = status.memoryUsage;
+    } else {
+        double elapsed = static_cast<double>(std::max<int64_t>(nowMs - stats.lastSeenMs, 1));
+        double alpha = 1.0 - std::exp(-elapsed / ewmaTauMs_);
+        stats.cpuEwma += alpha * (status.cpuUsage - stats.cpuEwma);
+        stats.memoryEwma += alpha * (status.memoryUsage - stats.memoryEwma);
+    }
+    stats.systemHealth = status.systemHealth;
+    stats.missionState = status.missionState;
+    stats.lastSeenMs = nowMs;
+    ++stats.packets;
+    stats.cpu[current_].add(status.cpuUsage);
+    stats.memory[current_].add(status.memoryUsage);
+}
+
+/**
+ * @brief Build the report and schedule the next one
+ * @param nowMs Current time (milliseconds since the epoch)
+ * @return (topic, JSON text) pairs
+ */
+std::vector<std::pair<std::string, std::string>> FleetAnalytics::publish(int64_t nowMs) {
+    nextPublishMs_ = nextPublishMs_ != 0 && nextPublishMs_ + publishIntervalMs_ > nowMs
+                         ? nextPublishMs_ + publishIntervalMs_
+                         : nowMs + publishIntervalMs_;
+    rotateUntil(nowMs);
+
+    std::vector<std::pair<std::string, std::string>> messages;
+    std::map<std::string, int> health_counts;
+    std::map<std::string, int> mission_counts;
+    for (const char* name : HEALTH_NAMES) {
+        health_counts[name] = 0;
+    }
+    for (const char* name : MISSION_NAMES) {
+        mission_counts[name] = 0;
+    }
+    TDigest fleet_cpu;
+    TDigest fleet_memory;
+    double cpu_ewma_sum = 0;
+    double memory_ewma_sum = 0;
+
+    for (auto it = uavs_.begin(); it != uavs_.end();) {
+        UavStats& stats = it->second;
+        if (nowMs - stats.lastSeenMs > windowMs_) {
+            it = uavs_.erase(it);
+            continue;
+        }
+        TDigest cpu = stats.cpu[current_];
+        cpu.merge(stats.cpu[1 - current_]);
+        TDigest memory = stats.memory[current_];
+        memory.merge(stats.memory[1 - current_]);
+        fleet_cpu.merge(cpu);
+        fleet_memory.merge(memory);
+        cpu_ewma_sum += stats.cpuEwma;
+        memory_ewma_sum += stats.memoryEwma;
+        ++health_counts[nameOf(HEALTH_NAMES, stats.systemHealth)];
+        ++mission_counts[nameOf(MISSION_NAMES, stats.missionState)];
+
+        nlohmann::json report = {{"uav", it->first},
+                                 {"system_health", nameOf(HEALTH_NAMES, stats.systemHealth)},
+                                 {"mission_state", nameOf(MISSION_NAMES, stats.missionState)},
+                                 {"cpu_ewma", rounded(stats.cpuEwma)},
+                                 {"memory_ewma", rounded(stats.memoryEwma)},
+                                 {"cpu_p50", rounded(cpu.quantile(0.5))},
+                                 {"cpu_p95", rounded(cpu.quantile(0.95))},
+                                 {"memory_p50", rounded(memory.quantile(0.5))},
+                                 {"memory_p95", rounded(memory.quantile(0.95))},
+                                 {"window_samples", cpu.count()},
+                                 {"packets", stats.packets},
+                                 {"last_seen_ms", stats.lastSeenMs}};
+        stats.packets = 0;
+        messages.emplace_back("fleet." + it->first + ".stats", report.dump());
+        ++it;
+    }
+
+    double uav_count = static_cast<double>(uavs_.size());
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    nlohmann::json summary = {
+        {"uavs", uavs_.size()},
+        {"health", health_counts},
+        {"mission", mission_counts},
+        {"cpu",
+         {{"ewma_mean", rounded(uavs_.empty() ? nan : cpu_ewma_sum / uav_count)},
+          {"p50", rounded(fleet_cpu.quantile(0.5))},
+          {"p95", rounded(fleet_cpu.quantile(0.95))},
+          {"p99", rounded(fleet_cpu.quantile(0.99))}}},
+        {"memory",
+         {{"ewma_mean", rounded(uavs_.empty() ? nan : memory_ewma_sum / uav_count)},
+          {"p50", rounded(fleet_memory.quantile(0.5))},
+          {"p95", rounded(fleet_memory.quantile(0.95))},
+          {"p99", rounded(fleet_memory.quantile(0.99))}}},
+        {"window_ms", windowMs_},
+        {"time_ms", nowMs}};
+    messages.emplace_back("fleet.summary", summary.dump());
+    return messages;
+}
+
+/**
+ * @brief Rotate the half-window digests up to the current time
+ * @param nowMs Current time (milliseconds since the epoch)
+ *
+ * After a gap of a whole window both digests are cleared.
+ */
+void FleetAnalytics::rotateUntil(int64_t nowMs) {
+    if (nextRotateMs_ == 0) {
+        nextRotateMs_ = nowMs + halfWindowMs_;
+        return;
+    }
+    for (int i = 0; i < 2 && nowMs >= nextRotateMs_; ++i) {
+        current_ = 1 - current_;
+        for (auto& [name, stats] : uavs_) {
+            stats.cpu[current_].clear();
+            stats.memory[current_].clear();
+        }
+        nextRotateMs_ += halfWindowMs_;
+    }
+    if (nowMs >= nextRotateMs_) {
+        nextRotateMs_ = nowMs + halfWindowMs_;
+    }
+}
@@ -0,0 +1,179 @@
+/**
+ * @file FleetAnalytics.h
+ * @brief Rolling health statistics per UAV and for the whole fleet
+ *
+ * This file defines the TDigest class, a compact quantile sketch, and the
+ * FleetAnalytics stage that the routing stage feeds with every status packet.
+ * At a fixed cadence the stage publishes one "fleet.<UAV>.stats" message per
+ * UAV and a "fleet.summary" message, so UIs get fleet health without
+ * processing every status packet themselves.
+ */
+
+#ifndef FLEETANALYTICS_H
+#define FLEETANALYTICS_H
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Config.h"
+
+/**
+ * @class TDigest
+ * @brief Merging t-digest: approximate quantiles of a stream in bounded memory
+ *
+ * Samples are buffered and periodically merged into at most about
+ * "compression" centroids. Centroids near the tails are kept small, so extreme
+ * quantiles (p95, p99) stay accurate while the median uses coarse centroids.
+ */
+class TDigest {
+   public:
+    /**
+     * @brief Constructor
+     * @param compression Accuracy/size trade-off (about this many centroids are kept)
+     */
+    explicit TDigest(double compression = 100.0);
+
+    /**
+     * @brief Add one sample
+     */
+    void add(double value);
+
+    /**
+     * @brief Add every sample summarized by another digest
+     */
+    void merge(const TDigest& other);
+
+    /**
+     * @brief Estimate a quantile
+     * @param q Quantile in 0..1 (0.5 = median)
+     * @return Estimated value, or NaN if the digest is empty
+     */
+    [[nodiscard]] double quantile(double q);
+
+    /**
+     * @brief Get the number of samples added
+     */
+    [[nodiscard]] uint64_t count() const {
+        return count_;
+    }
+
+    /**
+     * @brief Forget every sample (keeps the allocated memory)
+     */
+    void clear();
+
+   private:
+    /**
+     * @struct Centroid
+     * @brief Mean of a group of neighbouring samples and their number
+     */
+    struct Centroid {
+        double mean;    ///< Mean of the samples
+        double weight;  ///< Number of samples
+    };
+
+    /**
+     * @brief Merge the buffered samples into the centroids
+     */
+    void compress();
+
+    double compression_;               ///< Scale of the size limit per centroid
+    std::vector<Centroid> centroids_;  ///< Merged centroids, sorted by mean
+    std::vector<Centroid> buffer_;     ///< Samples not yet merged
+    uint64_t count_{0};                ///< Samples added
+    double min_{0};                    ///< Smallest sample
+    double max_{0};                    ///< Largest sample
+};
+
+/**
+ * @class FleetAnalytics
+ * @brief Incremental per-UAV and fleet-wide statistics of status packets
+ *
+ * Each status packet updates its UAV's latest health and mission state, an
+ * exponentially weighted moving average (EWMA) of CPU and memory usage, and
+ * t-digests of both for the rolling window. The window is two digests that take
+ * turns: every half window the older one is cleared and becomes the current
+ * one, so the percentiles cover between half and all of the last window.
+ *
+ * publish() reports every UAV with a status in the window plus a fleet summary
+ * (counts by health and mission state, mean of the EWMAs, fleet percentiles
+ * from the merged digests). UAVs silent for a whole window are dropped. Not
+ * thread-safe; the service calls it under its processing lock.
+ */
+class FleetAnalytics {
+   public:
+    /**
+     * @brief Constructor
+     * @param config Analytics settings (validated by Config)
+     */
+    explicit FleetAnalytics(const AnalyticsConfig& config);
+
+    /**
+     * @brief Feed a packet (non-status packets are ignored)
+     * @param uavName UAV that sent the packet
+     * @param packet Packet as received (PacketHeader + payload)
+     * @param nowMs Current time (milliseconds since the epoch)
+     */
+    void update(const std::string& uavName, const std::vector<uint8_t>& packet, int64_t nowMs);
+
+    /**
+     * @brief Check whether the next report is due
+     * @param nowMs Current time (milliseconds since the epoch)
+     */
+    [[nodiscard]] bool due(int64_t nowMs) const {
+        return nowMs >= nextPublishMs_;
+    }
+
+    /**
+     * @brief Build the report and schedule the next one
+     * @param nowMs Current time (milliseconds since the epoch)
+     * @return (topic, JSON text) pairs: "fleet.<UAV>.stats" per UAV, then "fleet.summary"
+     */
+    std::vector<std::pair<std::string, std::string>> publish(int64_t nowMs);
+
+    /**
+     * @brief Drop a UAV's statistics (it is left out of the next report)
+     * @param uavName UAV name
+     */
+    void removeUav(const std::string& uavName) {
+        uavs_.erase(uavName);
+    }
+
+   private:
+    /**
+     * @struct UavStats
+     * @brief Rolling statistics of one UAV
+     */
+    struct UavStats {
+        uint8_t systemHealth{0};  ///< Latest system health
+        uint8_t missionState{0};  ///< Latest mission state
+        double cpuEwma{0};        ///< EWMA of CPU usage (percent)
+        double memoryEwma{0};     ///< EWMA of memory usage (percent)
+        int64_t lastSeenMs{0};    ///< Time of the latest status packet
+        uint64_t packets{0};      ///< Status packets since the previous report
+        TDigest cpu[2];           ///< CPU usage in the current and the previous half window
+        TDigest memory[2];        ///< Memory usage in the current and the previous half window
+    };
+
+    /**
+     * @brief Rotate the half-window digests up to the current time
+     * @param nowMs Current time (milliseconds since the epoch)
+     *
+     * Every half window the older digests are cleared and become the current ones.
+     */
+    void rotateUntil(int64_t nowMs);
+
+    int64_t publishIntervalMs_;             ///< Report cadence
+    int64_t halfWindowMs_;                  ///< Digest rotation period
+    int64_t windowMs_;                      ///< Rolling window length
+    double ewmaTauMs_;                      ///< EWMA time constant (half-life / ln 2)
+    int64_t nextPublishMs_{0};              ///< Time of the next report (0 = none published yet)
+    int64_t nextRotateMs_{0};               ///< Time of the next digest rotation
+    int current_{0};                        ///< Index of the current digest in UavStats
+    std::map<std::string, UavStats> uavs_;  ///< UAV name -> statistics (sorted for stable reports)
+};
+
+#endif  // FLEETANALYTICS_H
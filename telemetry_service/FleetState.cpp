@@ -0,0 +1,294 @@
+/**
+ * @file FleetState.cpp
+ * @brief Implementation of the fleet state store
+ */
+
+#include "FleetState.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+
+#include "TelemetryPackets.h"
+
+/**
+ * @brief Grow every array to the same number of rows
+ * @param rows New number of rows
+ */
+void FleetColumns::resize(size_t rows) {
+    registered.resize(rows);
+    names.resize(rows);
+    locationNs.resize(rows);
+    latitude.resize(rows);
+    longitude.resize(rows);
+    altitude.resize(rows);
+    heading.resize(rows);
+    speed.resize(rows);
+    statusNs.resize(rows);
+    systemHealth.resize(rows);
+    missionState.resize(rows);
+    flightTime.resize(rows);
+    cpuUsage.resize(rows);
+    memoryUsage.resize(rows);
+}
+
+/**
+ * @brief Reset one row to "no data"
+ * @param row Row to reset
+ */
+void FleetColumns::clearRow(size_t row) {
+    registered[row] = 0;
+    names[row].clear();
+    locationNs[row] = 0;
+    latitude[row] = 0;
+    longitude[row] = 0;
+    altitude[row] = 0;
+    heading[row] = 0;
+    speed[row] = 0;
+    statusNs[row] = 0;
+    systemHealth[row] = 0;
+    missionState[row] = 0;
+    flightTime[row] = 0;
+    cpuUsage[row] = 0;
+    memoryUsage[row] = 0;
+}
+
+namespace {
+    constexpr double EARTH_RADIUS_M = 6371008.8;                           ///< Mean earth radius
+    constexpr double RADIANS_PER_DEGREE = 3.14159265358979323846 / 180.0;  ///< M_PI is not standard C++
+    constexpr double METERS_PER_DEGREE = EARTH_RADIUS_M * RADIANS_PER_DEGREE;
+
+    /**
+     * @brief Great-circle distance between two points (haversine formula)
+     * @return Distance in meters
+     */
+    double distanceMeters(double lat1, double lon1, double lat2, double lon2) {
+        double d_lat = (lat2 - lat1) * RADIANS_PER_DEGREE;
+        double d_lon = (lon2 - lon1) * RADIANS_PER_DEGREE;
+        double a = std::sin(d_lat / 2) * std::sin(d_lat / 2)
+                   + std::cos(lat1 * RADIANS_PER_DEGREE) * std::cos(lat2 * RADIANS_PER_DEGREE) * std::sin(d_lon / 2)
+                         * std::sin(d_lon / 2);
+        return 2 * EARTH_RADIUS_M * std::asin(std::min(1.0, std::sqrt(a)));
+    }
+}  // namespace
+
+/**
+ * @brief Constructor
+ * @param gridCellDegrees Cell size of the spatial index in degrees
+ */
+FleetState::FleetState(double gridCellDegrees) : grid_(gridCellDegrees) {}
+
+/**
+ * @brief Register a UAV, or change the id of a registered one
+ * @param name UAV name
+ * @param id UAV id from the configuration
+ */
+void FleetState::setUav(const std::string& name, uint16_t id) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it != ids_.end()) {
+        columns_.clearRow(it->second);
+        grid_.remove(it->second);
+    }
+    if (id >= columns_.size()) {
+        columns_.resize(static_cast<size_t>(id) + 1);
+    }
+    columns_.clearRow(id);
+    columns_.registered[id] = 1;
+    columns_.names[id] = name;
+    ids_[name] = id;
+}
+
+/**
+ * @brief Forget a UAV and its state
+ * @param name UAV name
+ */
+void FleetState::removeUav(const std::string& name) {
+    std::unique_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
+        return;
+    }
+    columns_.clearRow(it->second);
+    grid_.remove(it->second);
+    ids_.erase(it);
+}
+
+/**
+ * @brief Store the contents of a LOCATION or STATUS packet
+ * @param uavName UAV that sent the packet
+ * @param packet Packet as received (PacketHeader + payload)
+ * @return true if the packet updated the state
+ *
+ * The payload is decoded before the lock is taken, so the exclusive section
+ * only writes one row.
+ */
+bool FleetState::update(const std::string& uavName, const std::vector<uint8_t>& packet) {
+    if (packet.size() < sizeof(PacketHeader)) {
+        return false;
+    }
+    PacketHeader header{};
+    std::memcpy(&header, packet.data(), sizeof(header));
+    const uint8_t* payload = packet.data() + sizeof(PacketHeader);
+    size_t payload_size = packet.size() - sizeof(PacketHeader);
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+
+    if (header.packetType == PacketTypes::LOCATION && payload_size >= sizeof(LocationPayload)) {
+        LocationPayload location{};
+        std::memcpy(&location, payload, sizeof(location));
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(uavName);
+        if (it == ids_.end()) {
+            return false;
+        }
+        uint16_t row = it->second;
+        columns_.locationNs[row] = now_ns;
+        columns_.latitude[row] = location.latitude;
+        columns_.longitude[row] = location.longitude;
+        columns_.altitude[row] = location.altitude;
+        columns_.heading[row] = location.heading;
+        columns_.speed[row] = location.speed;
+        grid_.move(row, location.latitude, location.longitude);
+        return true;
+    }
+
+    if (header.packetType == PacketTypes::STATUS && payload_size >= sizeof(StatusPayload)) {
+        StatusPayload status{};
+        std::memcpy(&status, payload, sizeof(status));
+
+        std::unique_lock<std::shared_mutex> lock(mutex_);
+        auto it = ids_.find(uavName);
+        if (it == ids_.end()) {
+            return false;
+        }
+        uint16_t row = it->second;
+        columns_.statusNs[row] = now_ns;
+        columns_.systemHealth[row] = status.systemHealth;
+        columns_.missionState[row] = status.missionState;
+        columns_.flightTime[row] = status.flightTime;
+        columns_.cpuUsage[row] = status.cpuUsage;
+        columns_.memoryUsage[row] = status.memoryUsage;
+        return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Copy one UAV's state
+ * @param name UAV name
+ * @return The UAV's state, or nothing if the UAV is not registered
+ */
+std::optional<UavState> FleetState::get(const std::string& name) const {
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = ids_.find(name);
+    if (it == ids_.end()) {
+        return std::nullopt;
+    }
+    return rowState(it->second);
+}
+
+/**
+ * @brief Find the UAVs whose latest position is within a distance of a point
+ * @param latitude Latitude of the center in decimal degrees
+ * @param longitude Longitude of the center in decimal degrees
+ * @param meters Radius in meters
+ * @return States of the matching UAVs, nearest first
+ *
+ * The circle's bounding box selects grid cells; the exact distance check runs
+ * only on the UAVs in those cells. Near the poles, or for radii spanning more
+ * than half the globe, the box covers every longitude.
+ */
+std::vector<UavState> FleetState::withinRadius(double latitude, double longitude, double meters) const {
+    double lat_span = meters / METERS_PER_DEGREE;
+    double min_latitude = latitude - lat_span;
+    double max_latitude = latitude + lat_span;
+    double min_longitude = -180.0;
+    double max_longitude = 180.0;
+    if (min_latitude > -90.0 && max_latitude < 90.0) {
+        double widest = std::max(std::abs(min_latitude), std::abs(max_latitude));
+        double lon_span = lat_span / std::cos(widest * RADIANS_PER_DEGREE);
+        if (lon_span < 180.0) {
+            // Wrapped edges give a box across the antimeridian (min > max)
+            min_longitude = std::remainder(longitude - lon_span, 360.0);
+            max_longitude = std::remainder(longitude + lon_span, 360.0);
+        }
+    }
+
+    std::vector<std::pair<double, UavState>> found;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        for (uint16_t row : grid_.candidates(min_latitude, min_longitude, max_latitude, max_longitude)) {
+            double distance = distanceMeters(latitude, longitude, columns_.latitude[row], columns_.longitude[row]);
+            if (distance <= meters) {
+                found.emplace_back(distance, rowState(row));
+            }
+        }
+    }
+    std::sort(found.begin(), found.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+    std::vector<UavState> states;
+    states.reserve(found.size());
+    for (auto& entry : found) {
+        states.push_back(std::move(entry.second));
+    }
+    return states;
+}
+
+/**
+ * @brief Find the UAVs whose latest position is inside a latitude/longitude box
+ * @param minLatitude Southern edge
+ * @param minLongitude Western edge
+ * @param maxLatitude Northern edge
+ * @param maxLongitude Eastern edge (less than minLongitude for a box across the antimeridian)
+ * @return States of the matching UAVs, in id order
+ */
+std::vector<UavState> FleetState::withinBox(double minLatitude,
+                                            double minLongitude,
+                                            double maxLatitude,
+                                            double maxLongitude) const {
+    bool wraps = minLongitude > maxLongitude;
+    std::vector<UavState> states;
+    {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        std::vector<uint16_t> rows = grid_.candidates(minLatitude, minLongitude, maxLatitude, maxLongitude);
+        std::sort(rows.begin(), rows.end());
+        for (uint16_t row : rows) {
+            double latitude = columns_.latitude[row];
+            double longitude = columns_.longitude[row];
+            bool in_longitude = wraps ? (longitude >= minLongitude || longitude <= maxLongitude)
+                                      : (longitude >= minLongitude && longitude <= maxLongitude);
+            if (latitude >= minLatitude && latitude <= maxLatitude && in_longitude) {
+                states.push_back(rowState(row));
+            }
+        }
+    }
+    return states;
+}
+
+/**
+ * @brief Copy one row (caller holds the lock)
+ * @param row UAV id
+ */
+UavState FleetState::rowState(uint16_t row) const {
+    UavState state;
+    state.name = columns_.names[row];
+    state.id = row;
+    state.locationNs = columns_.locationNs[row];
+    state.latitude = columns_.latitude[row];
+    state.longitude = columns_.longitude[row];
+    state.altitude = columns_.altitude[row];
+    state.heading = columns_.heading[row];
+    state.speed = columns_.speed[row];
+    state.statusNs = columns_.statusNs[row];
+    state.systemHealth = columns_.systemHealth[row];
+    state.missionState = columns_.missionState[row];
+    state.flightTime = columns_.flightTime[row];
+    state.cpuUsage = columns_.cpuUsage[row];
+    state.memoryUsage = columns_.memoryUsage[row];
+    return state;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file FleetState.h
+ * @brief Latest decoded location and status of every UAV
+ *
+ * This file defines the FleetState class, an optional in-memory store that the
+ * routing stage updates with every location and status packet. The values are
+ * kept as one array per field, indexed by UAV id, so whole-fleet questions
+ * ("which UAVs are below 50 m", "all positions") are linear scans over
+ * contiguous memory instead of a walk over per-UAV objects.
+ */
+
+#ifndef FLEETSTATE_H
+#define FLEETSTATE_H
+
+#include <cstdint>
+#include <mutex>
+#include <optional>
+#include <shared_mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "SpatialGrid.h"
+
+/**
+ * @struct FleetColumns
+ * @brief Fleet state as one array per field
+ *
+ * Row i of every array belongs to the UAV with id i; rows of ids that are not
+ * registered have registered[i] == 0. A timestamp of 0 means no packet of that
+ * type has arrived yet and the matching fields are meaningless.
+ */
+struct FleetColumns {
+    std::vector<uint8_t> registered;  ///< 1 if a UAV with this id is registered
+    std::vector<std::string> names;   ///< UAV name ("" for unregistered ids)
+
+    // Latest LOCATION packet
+    std::vector<int64_t> locationNs;  ///< Receive time in ns since the Unix epoch (0 = none yet)
+    std::vector<double> latitude;     ///< Latitude in decimal degrees
+    std::vector<double> longitude;    ///< Longitude in decimal degrees
+    std::vector<float> altitude;      ///< Altitude in meters above sea level
+    std::vector<float> heading;       ///< Heading in degrees (0-359)
+    std::vector<float> speed;         ///< Ground speed in m/s
+
+    // Latest STATUS packet
+    std::vector<int64_t> statusNs;      ///< Receive time in ns since the Unix epoch (0 = none yet)
+    std::vector<uint8_t> systemHealth;  ///< System health (0: Critical, 1: Warning, 2: Good, 3: Excellent)
+    std::vector<uint8_t> missionState;  ///< Mission state (0: Idle, 1: Takeoff, 2: Mission, 3: Landing, 4: Emergency)
+    std::vector<uint16_t> flightTime;   ///< Flight time in seconds
+    std::vector<float> cpuUsage;        ///< CPU usage percentage (0.0-100.0)
+    std::vector<float> memoryUsage;     ///< Memory usage percentage (0.0-100.0)
+
+    /**
+     * @brief Get the number of rows (highest registered id + 1)
+     */
+    [[nodiscard]] size_t size() const {
+        return registered.size();
+    }
+
+    /**
+     * @brief Grow every array to the same number of rows
+     * @param rows New number of rows
+     */
+    void resize(size_t rows);
+
+    /**
+     * @brief Reset one row to "no data"
+     * @param row Row to reset
+     */
+    void clearRow(size_t row);
+};
+
+/**
+ * @struct UavState
+ * @brief Copy of one UAV's row of the fleet state
+ */
+struct UavState {
+    std::string name;         ///< UAV name
+    uint16_t id{0};           ///< UAV id
+    int64_t locationNs{0};    ///< Receive time of the latest location (0 = none yet)
+    double latitude{0};       ///< Latitude in decimal degrees
+    double longitude{0};      ///< Longitude in decimal degrees
+    float altitude{0};        ///< Altitude in meters above sea level
+    float heading{0};         ///< Heading in degrees
+    float speed{0};           ///< Ground speed in m/s
+    int64_t statusNs{0};      ///< Receive time of the latest status (0 = none yet)
+    uint8_t systemHealth{0};  ///< System health
+    uint8_t missionState{0};  ///< Mission state
+    uint16_t flightTime{0};   ///< Flight time in seconds
+    float cpuUsage{0};        ///< CPU usage percentage
+    float memoryUsage{0};     ///< Memory usage percentage
+};
+
+/**
+ * @class FleetState
+ * @brief Thread-safe store of the latest location and status per UAV
+ *
+ * The routing stage is the only writer; any number of readers can scan the
+ * columns at the same time under a shared lock. An update costs one hash
+ * lookup of the UAV name and a short exclusive lock to write one row.
+ *
+ * Latest positions are also kept in a SpatialGrid, so area queries
+ * (withinRadius(), withinBox()) only look at UAVs near the area.
+ */
+class FleetState {
+   public:
+    /**
+     * @brief Constructor
+     * @param gridCellDegrees Cell size of the spatial index in degrees
+     */
+    explicit FleetState(double gridCellDegrees = 0.01);
+
+    /**
+     * @brief Register a UAV, or change the id of a registered one
+     * @param name UAV name
+     * @param id UAV id from the configuration (row in the columns)
+     *
+     * The row starts out empty.
+     */
+    void setUav(const std::string& name, uint16_t id);
+
+    /**
+     * @brief Forget a UAV and its state
+     * @param name UAV name
+     */
+    void removeUav(const std::string& name);
+
+    /**
+     * @brief Store the contents of a LOCATION or STATUS packet
+     * @param uavName UAV that sent the packet
+     * @param packet Packet as received (PacketHeader + payload)
+     * @return true if the packet updated the state (false for other types, short packets or unknown UAVs)
+     *
+     * The receive time is taken here.
+     */
+    bool update(const std::string& uavName, const std::vector<uint8_t>& packet);
+
+    /**
+     * @brief Run a function over the whole fleet state
+     * @param visitor Called once with a const FleetColumns&
+     *
+     * The state cannot change while the visitor runs, so keep it short:
+     * updates from the routing stage wait for it.
+     */
+    template <typename Visitor>
+    void read(Visitor&& visitor) const {
+        std::shared_lock<std::shared_mutex> lock(mutex_);
+        visitor(static_cast<const FleetColumns&>(columns_));
+    }
+
+    /**
+     * @brief Copy one UAV's state
+     * @param name UAV name
+     * @return The UAV's state, or nothing if the UAV is not registered
+     */
+    [[nodiscard]] std::optional<UavState> get(const std::string& name) const;
+
+    /**
+     * @brief Find the UAVs whose latest position is within a distance of a point
+     * @param latitude Latitude of the center in decimal degrees
+     * @param longitude Longitude of the center in decimal degrees
+     * @param meters Radius in meters (great-circle distance)
+     * @return States of the matching UAVs, nearest first
+     */
+    [[nodiscard]] std::vector<UavState> withinRadius(double latitude, double longitude, double meters) const;
+
+    /**
+     * @brief Find the UAVs whose latest position is inside a latitude/longitude box
+     * @param minLatitude Southern edge
+     * @param minLongitude Western edge
+     * @param maxLatitude Northern edge
+     * @param maxLongitude Eastern edge (less than minLongitude for a box across the antimeridian)
+     * @return States of the matching UAVs, in id order
+     */
+    [[nodiscard]] std::vector<UavState> withinBox(double minLatitude,
+                                                  double minLongitude,
+                                                  double maxLatitude,
+                                                  double maxLongitude) const;
+
+   private:
+    /**
+     * @brief Copy one row (caller holds the lock)
+     * @param row UAV id
+     */
+    [[nodiscard]] UavState rowState(uint16_t row) const;
+
+    mutable std::shared_mutex mutex_;                ///< Readers share, the routing stage writes exclusively
+    FleetColumns columns_;                           ///< State indexed by UAV id
+    SpatialGrid grid_;                               ///< Latest positions by grid cell
+    std::unordered_map<std::string, uint16_t> ids_;  ///< UAV name -> id
+};
+
+#endif  // FLEETSTATE_H
@@ -0,0 +1,262 @@
+/**
+ * @file Geofence.cpp
+ * @brief Implementation of the geofence grid and engine
+ */
+
+#include "Geofence.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#include "TelemetryPackets.h"
+
+namespace {
+    constexpr int MIN_GRID_SIDE = 16;   ///< Smallest grid, even for triangles
+    constexpr int MAX_GRID_SIDE = 128;  ///< Largest grid (16384 cells)
+
+    /**
+     * @brief Twice the signed area of the triangle (a, b, c); positive if c is left of a->b
+     */
+    template <typename P>
+    double orientation(const P& a, const P& b, double cx, double cy) {
+        return (b.x - a.x) * (cy - a.y) - (b.y - a.y) * (cx - a.x);
+    }
+}  // namespace
+
+/**
+ * @brief Constructor
+ * @param config Fence definition
+ *
+ * The grid has about 2 * sqrt(vertices) cells per side, so the edges per
+ * boundary cell stay small as polygons grow. Building costs one exact test per
+ * cell plus one clip test per edge and covered cell.
+ */
+Geofence::Geofence(const GeofenceConfig& config)
+    : name_(config.name), keepIn_(config.keep_in), uavs_(config.uavs.begin(), config.uavs.end()) {
+    vertices_.reserve(config.polygon.size());
+    for (const auto& [latitude, longitude] : config.polygon) {
+        vertices_.push_back(Point{longitude, latitude});
+    }
+    minX_ = maxX_ = vertices_.front().x;
+    minY_ = maxY_ = vertices_.front().y;
+    for (const auto& vertex : vertices_) {
+        minX_ = std::min(minX_, vertex.x);
+        maxX_ = std::max(maxX_, vertex.x);
+        minY_ = std::min(minY_, vertex.y);
+        maxY_ = std::max(maxY_, vertex.y);
+    }
+
+    side_ = std::clamp(static_cast<int>(std::ceil(2.0 * std::sqrt(static_cast<double>(vertices_.size())))),
+                       MIN_GRID_SIDE,
+                       MAX_GRID_SIDE);
+    // A degenerate (zero-area) polygon still gets a valid grid; every cell ends up outside
+    cellWidth_ = maxX_ > minX_ ? (maxX_ - minX_) / side_ : 1.0;
+    cellHeight_ = maxY_ > minY_ ? (maxY_ - minY_) / side_ : 1.0;
+
+    size_t cells = static_cast<size_t>(side_) * static_cast<size_t>(side_);
+    std::vector<std::vector<uint32_t>> edges_per_cell(cells);
+    for (size_t edge = 0; edge < vertices_.size(); ++edge) {
+        const Point& a = vertices_[edge];
+        const Point& b = vertices_[(edge + 1) % vertices_.size()];
+        // Only the cells under the edge's bounding box can touch it
+        int first_column = std::clamp(static_cast<int>((std::min(a.x, b.x) - minX_) / cellWidth_), 0, side_ - 1);
+        int last_column = std::clamp(static_cast<int>((std::max(a.x, b.x) - minX_) / cellWidth_), 0, side_ - 1);
+        int first_row = std::clamp(static_cast<int>((std::min(a.y, b.y) - minY_) / cellHeight_), 0, side_ - 1);
+        int last_row = std::clamp(static_cast<int>((std::max(a.y, b.y) - minY_) / cellHeight_), 0, side_ - 1);
+        for (int row = first_row; row <= last_row; ++row) {
+            for (int column = first_column; column <= last_column; ++column) {
+                if (edgeTouchesCell(a, b, row, column)) {
+                    edges_per_cell[static_cast<size_t>(row) * side_ + column].push_back(static_cast<uint32_t>(edge));
+                }
+            }
+        }
+    }
+
+    cellState_.resize(cells);
+    centerInside_.resize(cells);
+    cellEdgeStart_.reserve(cells + 1);
+    for (size_t cell = 0; cell < cells; ++cell) {
+        Point center = cellCenter(static_cast<int>(cell / side_), static_cast<int>(cell % side_));
+        bool inside = containsExact(center.x, center.y);
+        centerInside_[cell] = inside ? 1 : 0;
+        cellState_[cell] = !edges_per_cell[cell].empty() ? BOUNDARY : (inside ? INSIDE : OUTSIDE);
+        cellEdgeStart_.push_back(static_cast<uint32_t>(cellEdges_.size()));
+        cellEdges_.insert(cellEdges_.end(), edges_per_cell[cell].begin(), edges_per_cell[cell].end());
+    }
+    cellEdgeStart_.push_back(static_cast<uint32_t>(cellEdges_.size()));
+}
+
+/**
+ * @brief Test whether a point is inside the polygon
+ * @param latitude Latitude in decimal degrees
+ * @param longitude Longitude in decimal degrees
+ * @return true if the point is inside
+ *
+ * In a boundary cell, the segment from the cell center to the point stays in
+ * the cell, so only the cell's edges can cross it: each crossing flips the
+ * center's inside/outside state. Vertices are assigned to one side of the
+ * segment (half-open rule), so a segment through a vertex counts once.
+ */
+bool Geofence::contains(double latitude, double longitude) const {
+    double x = longitude;
+    double y = latitude;
+    if (!(x >= minX_ && x <= maxX_ && y >= minY_ && y <= maxY_)) {
+        return false;  // Also rejects NaN
+    }
+    int column = std::min(static_cast<int>((x - minX_) / cellWidth_), side_ - 1);
+    int row = std::min(static_cast<int>((y - minY_) / cellHeight_), side_ - 1);
+    size_t cell = static_cast<size_t>(row) * side_ + column;
+    if (cellState_[cell] != BOUNDARY) {
+        return cellState_[cell] == INSIDE;
+    }
+
+    Point center = cellCenter(row, column);
+    bool inside = centerInside_[cell] != 0;
+    for (uint32_t i = cellEdgeStart_[cell]; i < cellEdgeStart_[cell + 1]; ++i) {
+        uint32_t edge = cellEdges_[i];
+        const Point& a = vertices_[edge];
+        const Point& b = vertices_[(edge + 1) % vertices_.size()];
+        bool a_left = orientation(center, Point{x, y}, a.x, a.y) > 0;
+        bool b_left = orientation(center, Point{x, y}, b.x, b.y) > 0;
+        if (a_left == b_left) {
+            continue;
+        }
+        bool center_left = orientation(a, b, center.x, center.y) > 0;
+        bool point_left = orientation(a, b, x, y) > 0;
+        if (center_left != point_left) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/**
+ * @brief Test a point against every edge (ray casting)
+ */
+bool Geofence::containsExact(double x, double y) const {
+    bool inside = false;
+    for (size_t i = 0, j = vertices_.size() - 1; i < vertices_.size(); j = i++) {
+        const Point& a = vertices_[i];
+        const Point& b = vertices_[j];
+        if ((a.y > y) != (b.y > y) && x < (b.x - a.x) * (y - a.y) / (b.y - a.y) + a.x) {
+            inside = !inside;
+        }
+    }
+    return inside;
+}
+
+/**
+ * @brief Test whether an edge passes through a cell (Liang-Barsky clip)
+ *
+ * The cell is widened by a small margin so that edges running along a cell
+ * border are listed in both neighbours; listing an extra edge never changes
+ * the crossing count.
+ */
+bool Geofence::edgeTouchesCell(const Point& a, const Point& b, int row, int column) const {
+    double margin_x = cellWidth_ * 1e-9;
+    double margin_y = cellHeight_ * 1e-9;
+    double left = minX_ + column * cellWidth_ - margin_x;
+    double right = minX_ + (column + 1) * cellWidth_ + margin_x;
+    double bottom = minY_ + row * cellHeight_ - margin_y;
+    double top = minY_ + (row + 1) * cellHeight_ + margin_y;
+
+    double dx = b.x - a.x;
+    double dy = b.y - a.y;
+    double t_enter = 0.0;
+    double t_exit = 1.0;
+    const double p[4] = {-dx, dx, -dy, dy};
+    const double q[4] = {a.x - left, right - a.x, a.y - bottom, top - a.y};
+    for (int i = 0; i < 4; ++i) {
+        if (p[i] == 0.0) {
+            if (q[i] < 0.0) {
+                return false;  // Parallel to this border and outside it
+            }
+            continue;
+        }
+        double t = q[i] / p[i];
+        if (p[i] < 0.0) {
+            t_enter = std::max(t_enter, t);
+        } else {
+            t_exit = std::min(t_exit, t);
+        }
+        if (t_enter > t_exit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Get the center of a cell
+ */
+Geofence::Point Geofence::cellCenter(int row, int column) const {
+    return Point{minX_ + (column + 0.5) * cellWidth_, minY_ + (row + 0.5) * cellHeight_};
+}
+
+/**
+ * @brief Constructor
+ * @param fences Fence definitions from the configuration
+ */
+GeofenceEngine::GeofenceEngine(const std::vector<GeofenceConfig>& fences) {
+    fences_.reserve(fences.size());
+    for (const auto& fence : fences) {
+        fences_.emplace_back(fence);
+    }
+}
+
+/**
+ * @brief Check a packet against the fences that apply to its UAV
+ * @param uavName UAV that sent the packet
+ * @param packet Packet as received (PacketHeader + payload)
+ * @return Alerts for every fence whose state changed
+ */
+std::vector<GeofenceAlert> GeofenceEngine::evaluate(const std::string& uavName, const std::vector<uint8_t>& packet) {
+    std::vector<GeofenceAlert> alerts;
+    if (fences_.empty() || packet.size() < sizeof(PacketHeader) + sizeof(LocationPayload)) {
+        return alerts;
+    }
+    PacketHeader header{};
+    std::memcpy(&header, packet.data(), sizeof(header));
+    if (header.packetType != PacketTypes::LOCATION) {
+        return alerts;
+    }
+    LocationPayload location{};
+    std::memcpy(&location, packet.data() + sizeof(PacketHeader), sizeof(location));
+    if (std::isnan(location.latitude) || std::isnan(location.longitude)) {
+        return alerts;
+    }
+
+    auto it = uavs_.find(uavName);
+    if (it == uavs_.end()) {
+        UavFences entry;
+        for (size_t i = 0; i < fences_.size(); ++i) {
+            if (fences_[i].appliesTo(uavName)) {
+                entry.fences.push_back(i);
+            }
+        }
+        entry.states.assign(entry.fences.size(), UNKNOWN);
+        it = uavs_.emplace(uavName, std::move(entry)).first;
+    }
+
+    UavFences& entry = it->second;
+    for (size_t i = 0; i < entry.fences.size(); ++i) {
+        const Geofence& fence = fences_[entry.fences[i]];
+        bool violating = fence.contains(location.latitude, location.longitude) != fence.keepIn();
+        uint8_t state = violating ? VIOLATING : CLEAR;
+        uint8_t previous = entry.states[i];
+        entry.states[i] = state;
+        if (state == previous || (previous == UNKNOWN && !violating)) {
+            continue;
+        }
+        GeofenceAlert alert;
+        alert.fence = fence.name();
+        alert.keepIn = fence.keepIn();
+        alert.violation = violating;
+        alert.latitude = location.latitude;
+        alert.longitude = location.longitude;
+        alert.altitude = location.altitude;
+        alerts.push_back(std::move(alert));
+    }
+    return alerts;
+}
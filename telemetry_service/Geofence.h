@@ -0,0 +1,190 @@
+/**
+ * @file Geofence.h
+ * @brief Geofence polygons and the engine that checks location packets against them
+ *
+ * This file defines the Geofence class, a polygon with a precomputed grid for
+ * fast point-in-polygon tests, and the GeofenceEngine that the routing stage
+ * runs on every location packet. The engine remembers which side of each fence
+ * every UAV was on and reports only the transitions, which the service
+ * publishes as "alert.<UAV>.geofence.<fence>" messages.
+ */
+
+#ifndef GEOFENCE_H
+#define GEOFENCE_H
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "Config.h"
+
+/**
+ * @class Geofence
+ * @brief Polygon with a uniform grid over its bounding box
+ *
+ * The bounding box is divided into cells once, at construction. A cell that no
+ * polygon edge passes through is entirely inside or entirely outside, so a
+ * point in it is answered by a table lookup. For the few cells an edge does
+ * pass through, the cell stores those edges and whether its center is inside;
+ * a point there is answered by counting the edges crossed between the center
+ * and the point. Either way a test touches a handful of edges instead of all
+ * of them.
+ *
+ * Edges are straight lines in latitude/longitude, which is accurate for fences
+ * up to a few tens of kilometers. Polygons crossing the antimeridian are not
+ * supported. Immutable after construction, so it can be shared between threads.
+ */
+class Geofence {
+   public:
+    /**
+     * @brief Constructor
+     * @param config Fence definition (validated by Config)
+     */
+    explicit Geofence(const GeofenceConfig& config);
+
+    /**
+     * @brief Test whether a point is inside the polygon
+     * @param latitude Latitude in decimal degrees
+     * @param longitude Longitude in decimal degrees
+     * @return true if the point is inside (points exactly on an edge may go either way)
+     */
+    [[nodiscard]] bool contains(double latitude, double longitude) const;
+
+    /**
+     * @brief Test whether the fence applies to a UAV
+     * @param uavName UAV name
+     */
+    [[nodiscard]] bool appliesTo(const std::string& uavName) const {
+        return uavs_.empty() || uavs_.count(uavName) != 0;
+    }
+
+    /**
+     * @brief Get the fence name
+     */
+    [[nodiscard]] const std::string& name() const {
+        return name_;
+    }
+
+    /**
+     * @brief Check whether this is a keep-in fence (false: keep-out)
+     */
+    [[nodiscard]] bool keepIn() const {
+        return keepIn_;
+    }
+
+   private:
+    /**
+     * @struct Point
+     * @brief Polygon vertex in grid coordinates (x = longitude, y = latitude)
+     */
+    struct Point {
+        double x;  ///< Longitude
+        double y;  ///< Latitude
+    };
+
+    /// Cell classification
+    enum CellState : uint8_t { OUTSIDE = 0, INSIDE = 1, BOUNDARY = 2 };
+
+    /**
+     * @brief Test a point against every edge (ray casting, used while building the grid)
+     */
+    [[nodiscard]] bool containsExact(double x, double y) const;
+
+    /**
+     * @brief Test whether an edge passes through a cell (segment/rectangle clip)
+     */
+    [[nodiscard]] bool edgeTouchesCell(const Point& a, const Point& b, int row, int column) const;
+
+    /**
+     * @brief Get the center of a cell
+     */
+    [[nodiscard]] Point cellCenter(int row, int column) const;
+
+    std::string name_;                      ///< Fence name
+    bool keepIn_;                           ///< Keep-in (true) or keep-out (false)
+    std::unordered_set<std::string> uavs_;  ///< UAVs the fence applies to (empty = all)
+    std::vector<Point> vertices_;           ///< Polygon vertices; edge i runs from vertex i to i + 1
+    double minX_, minY_, maxX_, maxY_;      ///< Bounding box
+    int side_;                              ///< Grid cells per side
+    double cellWidth_, cellHeight_;         ///< Cell size in degrees
+    std::vector<uint8_t> cellState_;        ///< CellState per cell, row-major
+    std::vector<uint8_t> centerInside_;     ///< Whether each BOUNDARY cell's center is inside
+    std::vector<uint32_t> cellEdgeStart_;   ///< Offset of each cell's edges in cellEdges_ (cells + 1 entries)
+    std::vector<uint32_t> cellEdges_;       ///< Edge indices of the BOUNDARY cells, grouped by cell
+};
+
+/**
+ * @struct GeofenceAlert
+ * @brief A UAV crossed a fence into or out of violation
+ */
+struct GeofenceAlert {
+    std::string fence;     ///< Fence name
+    bool keepIn{true};     ///< Fence type
+    bool violation{true};  ///< true: UAV is now violating the fence, false: violation cleared
+    double latitude{0};    ///< Position that caused the change
+    double longitude{0};   ///< Position that caused the change
+    float altitude{0};     ///< Altitude in meters
+};
+
+/**
+ * @class GeofenceEngine
+ * @brief Checks LOCATION packets against every configured fence
+ *
+ * Alerts are raised on transitions only: a UAV that keeps flying outside its
+ * keep-in area produces one "violation" alert, and one "cleared" alert when it
+ * returns. The first position seen for a UAV raises an alert only if it is
+ * already in violation. Not thread-safe; the service calls it from the routing
+ * stage under its processing lock, and a config reload replaces the engine
+ * (which restarts the transition tracking).
+ */
+class GeofenceEngine {
+   public:
+    /**
+     * @brief Constructor
+     * @param fences Fence definitions from the configuration
+     */
+    explicit GeofenceEngine(const std::vector<GeofenceConfig>& fences);
+
+    /**
+     * @brief Check a packet against the fences that apply to its UAV
+     * @param uavName UAV that sent the packet
+     * @param packet Packet as received (PacketHeader + payload)
+     * @return Alerts for every fence whose state changed (empty for non-location packets)
+     */
+    std::vector<GeofenceAlert> evaluate(const std::string& uavName, const std::vector<uint8_t>& packet);
+
+    /**
+     * @brief Get the number of configured fences
+     */
+    [[nodiscard]] size_t size() const {
+        return fences_.size();
+    }
+
+    /**
+     * @brief Forget a UAV's fence states (a later first position starts fresh)
+     * @param uavName UAV name
+     */
+    void removeUav(const std::string& uavName) {
+        uavs_.erase(uavName);
+    }
+
+   private:
+    /// Per-fence state of one UAV
+    enum FenceState : uint8_t { UNKNOWN = 0, CLEAR = 1, VIOLATING = 2 };
+
+    /**
+     * @struct UavFences
+     * @brief Fences that apply to one UAV and the UAV's state for each
+     */
+    struct UavFences {
+        std::vector<size_t> fences;   ///< Indices into fences_
+        std::vector<uint8_t> states;  ///< FenceState per entry of fences
+    };
+
+    std::vector<Geofence> fences_;                     ///< Configured fences
+    std::unordered_map<std::string, UavFences> uavs_;  ///< UAV name -> applicable fences (built on first packet)
+};
+
+#endif  // GEOFENCE_H
@@ -0,0 +1,434 @@
+/**
+ * @file JournalRecorder.cpp
+ * @brief Implementation of the telemetry journal recorder
+ */
+
+#include "JournalRecorder.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+#include <system_error>
+
+#include "Logger.h"
+
+#if defined(__linux__)
+#include <fcntl.h>
+#endif
+
+namespace {
+    // The writer wakes up when this much is buffered, or after the flush interval at the latest
+    constexpr size_t flush_threshold_bytes = 1 << 20;
+    constexpr std::chrono::milliseconds flush_interval{100};
+    constexpr std::chrono::seconds drop_report_interval{5};
+}  // namespace
+
+/**
+ * @brief Constructor
+ * @param directory Journal directory (created on start())
+ * @param segmentBytes Preallocated size of one segment file
+ * @param maxBufferedBytes Limit on records waiting for the writer thread
+ */
+JournalRecorder::JournalRecorder(std::filesystem::path directory, uint64_t segmentBytes, size_t maxBufferedBytes)
+    : directory_(std::move(directory)),
+      segmentBytes_(std::min(segmentBytes, JournalFormat::MAX_SEGMENT_BYTES)),
+      maxBufferedBytes_(maxBufferedBytes) {}
+
+/**
+ * @brief Destructor - flushes buffered records and seals the open segment
+ */
+JournalRecorder::~JournalRecorder() {
+    stop();
+    join();
+}
+
+/**
+ * @brief Create the journal directory and start the writer thread
+ */
+void JournalRecorder::start() {
+    std::filesystem::create_directories(directory_);
+    nextSegmentIndex_ = findNextSegmentIndex();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pending_.reserve(flush_threshold_bytes * 2);
+        running_ = true;
+    }
+    writerThread_ = std::thread(&JournalRecorder::writerLoop, this);
+    Logger::statusWithDetails("JOURNAL",
+                              StatusMessage("Recorder started"),
+                              DetailMessage(directory_.string() + ", first segment "
+                                            + JournalFormat::segmentFileName(nextSegmentIndex_)));
+}
+
+/**
+ * @brief Stop accepting packets; the writer thread flushes what is buffered and seals the segment
+ */
+void JournalRecorder::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+}
+
+/**
+ * @brief Wait for the writer thread to finish
+ */
+void JournalRecorder::join() {
+    if (writerThread_.joinable())
+        writerThread_.join();
+}
+
+/**
+ * @brief Map a UAV name to the id stored in its records
+ * @param name UAV name
+ * @param id UAV id from the configuration
+ */
+void JournalRecorder::setUavId(const std::string& name, uint16_t id) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    uavIds_[name] = id;
+    uavNames_[id] = name;
+    removedIds_.erase(std::remove(removedIds_.begin(), removedIds_.end(), id), removedIds_.end());
+}
+
+/**
+ * @brief Forget a UAV's name mapping
+ * @param name UAV name
+ */
+void JournalRecorder::removeUav(const std::string& name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto id_it = uavIds_.find(name);
+    if (id_it == uavIds_.end()) {
+        return;
+    }
+    removedIds_.push_back(id_it->second);
+    uavIds_.erase(id_it);
+}
+
+/**
+ * @brief Append one packet to the journal
+ * @param uavName UAV that sent the packet
+ * @param protocol JournalProtocol the packet arrived on
+ * @param packet Packet as received (PacketHeader + payload)
+ * @return false if the packet was not recorded (stopped, or the buffer is full)
+ *
+ * The record is laid out in the buffer exactly as it will appear in the file,
+ * so the writer thread can hand whole runs of the buffer to the disk.
+ */
+bool JournalRecorder::record(const std::string& uavName, uint8_t protocol, const std::vector<uint8_t>& packet) {
+    auto received = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::system_clock::now().time_since_epoch());
+    uint64_t span = JournalFormat::recordSpan(packet.size());
+    if (packet.empty() || span > segmentBytes_ - JournalFormat::DATA_OFFSET) {
+        return false;
+    }
+
+    bool wake_writer = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return false;
+        }
+        if (pending_.size() + span > maxBufferedBytes_) {
+            ++dropped_;
+            return false;
+        }
+
+        JournalRecordHeader header{};
+        header.size = static_cast<uint32_t>(packet.size());
+        auto id_it = uavIds_.find(uavName);
+        header.uavId = id_it == uavIds_.end() ? 0 : id_it->second;
+        header.protocol = protocol;
+        header.sequence = nextSequence_++;
+        header.receivedNs = received.count();
+
+        size_t offset = pending_.size();
+        pending_.resize(offset + span);  // Zero-fills the alignment padding
+        std::memcpy(pending_.data() + offset, &header, sizeof(header));
+        std::memcpy(pending_.data() + offset + sizeof(header), packet.data(), packet.size());
+        wake_writer = pending_.size() >= flush_threshold_bytes && pending_.size() - span < flush_threshold_bytes;
+    }
+    if (wake_writer) {
+        wake_.notify_one();
+    }
+    return true;
+}
+
+/**
+ * @brief Main loop for the writer thread
+ *
+ * Swaps the shared buffer for an empty one and writes it outside the lock, so
+ * ingest threads keep appending while the disk is busy. After stop() the
+ * remaining buffer is written and the open segment sealed.
+ */
+void JournalRecorder::writerLoop() {
+    std::vector<uint8_t> batch;
+    batch.reserve(flush_threshold_bytes * 2);
+    auto last_drop_report = std::chrono::steady_clock::time_point{};
+    uint64_t unreported_drops = 0;
+
+    try {
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            wake_.wait_for(
+                lock, flush_interval, [this] { return !running_ || pending_.size() >= flush_threshold_bytes; });
+            bool stopping = !running_;
+            batch.swap(pending_);
+            unreported_drops += dropped_;
+            dropped_ = 0;
+            lock.unlock();
+
+            if (!batch.empty()) {
+                writeBatch(batch);
+                batch.clear();
+            }
+            auto now = std::chrono::steady_clock::now();
+            if (unreported_drops > 0 && (stopping || now - last_drop_report >= drop_report_interval)) {
+                Logger::warn("Journal buffer full, " + std::to_string(unreported_drops) + " packets not recorded");
+                unreported_drops = 0;
+                last_drop_report = now;
+            }
+
+            lock.lock();
+            if (stopping && pending_.empty()) {
+                break;
+            }
+        }
+        lock.unlock();
+        sealSegment();
+    } catch (const std::exception& e) {
+        Logger::error("Journal writer error, recording stopped: " + std::string(e.what()));
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            running_ = false;
+            pending_.clear();
+        }
+        if (segment_ && segment_->file != nullptr) {
+            std::fclose(segment_->file);
+        }
+        segment_.reset();
+    }
+    Logger::status("JOURNAL", "Writer thread stopped");
+}
+
+/**
+ * @brief Write a batch of records, opening and sealing segments as they fill up
+ * @param batch Consecutive records (JournalRecordHeader + packet + padding)
+ *
+ * Records are indexed as they are walked, and every run of records that fits in
+ * the current segment goes to the file in a single write. The header is
+ * rewritten once per batch so readers see the new end of data.
+ */
+void JournalRecorder::writeBatch(const std::vector<uint8_t>& batch) {
+    size_t position = 0;
+    while (position < batch.size()) {
+        if (!segment_) {
+            openSegment();
+        }
+        JournalSegmentHeader& header = segment_->header;
+        size_t run_start = position;
+        uint64_t file_offset = header.dataEnd;
+
+        while (position < batch.size()) {
+            JournalRecordHeader record{};
+            std::memcpy(&record, batch.data() + position, sizeof(record));
+            uint64_t span = JournalFormat::recordSpan(record.size);
+            if (file_offset + span > header.capacity) {
+                break;
+            }
+
+            if (header.recordCount % JournalFormat::TIME_INDEX_INTERVAL == 0) {
+                segment_->timeIndex.push_back({record.receivedNs, file_offset, record.sequence});
+            }
+            if (header.recordCount == 0) {
+                header.firstSequence = record.sequence;
+                header.firstTimestampNs = record.receivedNs;
+            }
+            header.lastTimestampNs = record.receivedNs;
+            ++header.recordCount;
+
+            UavRecords& uav = segment_->uavs[record.uavId];
+            if (uav.offsets.empty()) {
+                uav.firstNs = record.receivedNs;
+            }
+            uav.lastNs = record.receivedNs;
+            uav.offsets.push_back(static_cast<uint32_t>(file_offset));
+
+            file_offset += span;
+            position += static_cast<size_t>(span);
+        }
+
+        if (position > run_start) {
+            writeAt(header.dataEnd, batch.data() + run_start, position - run_start);
+            header.dataEnd = file_offset;
+        }
+        if (position < batch.size()) {
+            sealSegment();
+        }
+    }
+    if (segment_) {
+        writeAt(0, &segment_->header, sizeof(JournalSegmentHeader));
+    }
+}
+
+/**
+ * @brief Create and preallocate the next segment file
+ *
+ * The whole segment is allocated up front so appends never have to extend the
+ * file (and on Linux never have to allocate blocks).
+ */
+void JournalRecorder::openSegment() {
+    auto segment = std::make_unique<OpenSegment>();
+    uint32_t index = nextSegmentIndex_++;
+    segment->path = directory_ / JournalFormat::segmentFileName(index);
+    segment->file = std::fopen(segment->path.string().c_str(), "w+b");
+    if (segment->file == nullptr) {
+        throw std::runtime_error("cannot create " + segment->path.string());
+    }
+    // Writes are already batched; stdio buffering would only add a copy
+    std::setvbuf(segment->file, nullptr, _IONBF, 0);
+
+#if defined(__linux__)
+    if (posix_fallocate(fileno(segment->file), 0, static_cast<off_t>(segmentBytes_)) != 0) {
+        std::filesystem::resize_file(segment->path, segmentBytes_);
+    }
+#else
+    std::filesystem::resize_file(segment->path, segmentBytes_);
+#endif
+
+    JournalSegmentHeader& header = segment->header;
+    std::memcpy(header.magic, JournalFormat::MAGIC, sizeof(header.magic));
+    header.version = JournalFormat::VERSION;
+    header.dataOffset = JournalFormat::DATA_OFFSET;
+    header.segmentIndex = index;
+    header.capacity = segmentBytes_;
+    header.dataEnd = JournalFormat::DATA_OFFSET;
+    header.createdNs =
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    segment_ = std::move(segment);
+    writeAt(0, &header, sizeof(header));
+    Logger::debug("Journal segment opened: " + segment_->path.string());
+}
+
+/**
+ * @brief Write the index, mark the segment sealed and trim the unused preallocation
+ *
+ * Index layout (see JournalFormat.h): time index, UAV table, then the record
+ * offsets of each UAV in table order. It is assembled in memory and written
+ * with one call.
+ */
+void JournalRecorder::sealSegment() {
+    if (!segment_) {
+        return;
+    }
+    JournalSegmentHeader& header = segment_->header;
+    if (header.recordCount == 0) {
+        std::fclose(segment_->file);
+        std::error_code error_code;
+        std::filesystem::remove(segment_->path, error_code);
+        segment_.reset();
+        return;
+    }
+
+    // Names are owned by the ingest side; take a copy for the UAVs in this segment
+    std::vector<JournalUavIndexEntry> uav_entries;
+    uav_entries.reserve(segment_->uavs.size());
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [uav_id, records] : segment_->uavs) {
+            JournalUavIndexEntry entry{};
+            entry.uavId = uav_id;
+            entry.recordCount = static_cast<uint32_t>(records.offsets.size());
+            entry.firstNs = records.firstNs;
+            entry.lastNs = records.lastNs;
+            auto name_it = uavNames_.find(uav_id);
+            if (name_it != uavNames_.end()) {
+                std::strncpy(entry.name, name_it->second.c_str(), sizeof(entry.name) - 1);
+            }
+            uav_entries.push_back(entry);
+        }
+        // Removed UAVs have no records in later segments
+        for (uint16_t uav_id : removedIds_) {
+            uavNames_.erase(uav_id);
+        }
+        removedIds_.clear();
+    }
+
+    uint64_t index_offset = JournalFormat::align(header.dataEnd);
+    size_t time_bytes = segment_->timeIndex.size() * sizeof(JournalTimeIndexEntry);
+    size_t table_bytes = uav_entries.size() * sizeof(JournalUavIndexEntry);
+    uint64_t offsets_position = index_offset + time_bytes + table_bytes;
+    size_t entry_number = 0;
+    for (const auto& [uav_id, records] : segment_->uavs) {
+        uav_entries[entry_number++].offsetsOffset = offsets_position;
+        offsets_position += records.offsets.size() * sizeof(uint32_t);
+    }
+
+    std::vector<uint8_t> index(static_cast<size_t>(offsets_position - index_offset));
+    uint8_t* cursor = index.data();
+    std::memcpy(cursor, segment_->timeIndex.data(), time_bytes);
+    cursor += time_bytes;
+    std::memcpy(cursor, uav_entries.data(), table_bytes);
+    cursor += table_bytes;
+    for (const auto& [uav_id, records] : segment_->uavs) {
+        std::memcpy(cursor, records.offsets.data(), records.offsets.size() * sizeof(uint32_t));
+        cursor += records.offsets.size() * sizeof(uint32_t);
+    }
+    writeAt(index_offset, index.data(), index.size());
+
+    header.indexOffset = index_offset;
+    header.timeIndexCount = static_cast<uint32_t>(segment_->timeIndex.size());
+    header.uavCount = static_cast<uint32_t>(uav_entries.size());
+    header.flags |= JournalFormat::FLAG_SEALED;
+    writeAt(0, &header, sizeof(header));
+    std::fclose(segment_->file);
+
+    // Give back the preallocated space the records did not use
+    std::error_code error_code;
+    std::filesystem::resize_file(segment_->path, offsets_position, error_code);
+
+    Logger::statusWithDetails("JOURNAL",
+                              StatusMessage("Segment sealed"),
+                              DetailMessage(segment_->path.filename().string() + ": "
+                                            + std::to_string(header.recordCount) + " records, "
+                                            + std::to_string(uav_entries.size()) + " UAVs"));
+    segment_.reset();
+}
+
+/**
+ * @brief Write bytes at a file offset of the open segment
+ * @param offset File offset
+ * @param data Bytes to write
+ * @param size Number of bytes
+ */
+void JournalRecorder::writeAt(uint64_t offset, const void* data, size_t size) {
+    if (std::fseek(segment_->file, static_cast<long>(offset), SEEK_SET) != 0
+        || std::fwrite(data, 1, size, segment_->file) != size) {
+        throw std::runtime_error("write to " + segment_->path.string() + " failed");
+    }
+}
+
+/**
+ * @brief Find the number to give the first new segment
+ * @return One more than the highest segment number in the directory (1 if none)
+ *
+ * Segments are never reopened: a restarted service continues with a new file
+ * rather than appending to one that may not have been sealed.
+ */
+uint32_t JournalRecorder::findNextSegmentIndex() const {
+    uint32_t highest = 0;
+    const std::string prefix = JournalFormat::FILE_PREFIX;
+    for (const auto& entry : std::filesystem::directory_iterator(directory_)) {
+        std::string name = entry.path().filename().string();
+        if (name.rfind(prefix, 0) != 0 || entry.path().extension() != JournalFormat::FILE_EXTENSION) {
+            continue;
+        }
+        try {
+            highest = std::max(highest, static_cast<uint32_t>(std::stoul(name.substr(prefix.size()))));
+        } catch (const std::exception&) {
+            // Not one of ours
+        }
+    }
+    return highest + 1;
+}
@@ -0,0 +1,192 @@
+/**
+ * @file JournalRecorder.h
+ * @brief Append-only binary journal of every ingested telemetry packet
+ *
+ * This file defines the JournalRecorder class which records packets into the
+ * segment files described in JournalFormat.h. Ingest threads only copy the
+ * packet into a memory buffer; a dedicated writer thread turns the buffer into
+ * large sequential writes, so recording does not add disk latency to routing.
+ */
+
+#ifndef JOURNALRECORDER_H
+#define JOURNALRECORDER_H
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "JournalFormat.h"
+
+/**
+ * @class JournalRecorder
+ * @brief Buffers ingested packets and writes them to segmented journal files
+ *
+ * Each packet becomes one record with its receive timestamp, UAV id, ingest
+ * protocol and a service-wide sequence number. Segments are preallocated to
+ * their full size, filled append-only and sealed with a time index and a
+ * per-UAV index when full (or when the recorder stops).
+ *
+ * When the disk cannot keep up and the buffer limit is reached, new packets are
+ * dropped from the journal (routing is never held up) and the loss is logged.
+ */
+class JournalRecorder {
+   public:
+    /**
+     * @brief Constructor
+     * @param directory Journal directory (created on start())
+     * @param segmentBytes Preallocated size of one segment file
+     * @param maxBufferedBytes Limit on records waiting for the writer thread
+     */
+    JournalRecorder(std::filesystem::path directory, uint64_t segmentBytes, size_t maxBufferedBytes);
+
+    /**
+     * @brief Destructor - flushes buffered records and seals the open segment
+     */
+    ~JournalRecorder();
+
+    // Owns a thread that refers back to this object
+    JournalRecorder(const JournalRecorder&) = delete;
+    JournalRecorder& operator=(const JournalRecorder&) = delete;
+    JournalRecorder(JournalRecorder&&) = delete;
+    JournalRecorder& operator=(JournalRecorder&&) = delete;
+
+    /**
+     * @brief Create the journal directory and start the writer thread
+     * @throws std::filesystem::filesystem_error if the directory cannot be created
+     *
+     * New segments are numbered after the highest segment already in the directory.
+     */
+    void start();
+
+    /**
+     * @brief Stop accepting packets; the writer thread flushes what is buffered and seals the segment
+     */
+    void stop();
+
+    /**
+     * @brief Wait for the writer thread to finish
+     */
+    void join();
+
+    /**
+     * @brief Map a UAV name to the id stored in its records
+     * @param name UAV name
+     * @param id UAV id from the configuration
+     */
+    void setUavId(const std::string& name, uint16_t id);
+
+    /**
+     * @brief Forget a UAV's name mapping
+     * @param name UAV name
+     *
+     * The id keeps its name until the open segment is sealed, so the records
+     * already written are still indexed under the UAV's name.
+     */
+    void removeUav(const std::string& name);
+
+    /**
+     * @brief Append one packet to the journal
+     * @param uavName UAV that sent the packet
+     * @param protocol JournalProtocol the packet arrived on
+     * @param packet Packet as received (PacketHeader + payload)
+     * @return false if the packet was not recorded (stopped, or the buffer is full)
+     *
+     * Thread-safe. Costs one timestamp, a short lock and a copy of the packet.
+     */
+    bool record(const std::string& uavName, uint8_t protocol, const std::vector<uint8_t>& packet);
+
+   private:
+    /**
+     * @struct UavRecords
+     * @brief Per-UAV index data collected while a segment is open
+     */
+    struct UavRecords {
+        std::vector<uint32_t> offsets;  ///< File offsets of the UAV's records
+        int64_t firstNs{0};             ///< Receive time of the first record
+        int64_t lastNs{0};              ///< Receive time of the last record
+    };
+
+    /**
+     * @struct OpenSegment
+     * @brief Segment file currently being written
+     */
+    struct OpenSegment {
+        std::filesystem::path path;                    ///< File path
+        std::FILE* file{nullptr};                      ///< Open file (unbuffered; writes are batched)
+        JournalSegmentHeader header{};                 ///< Header as it will be written
+        std::vector<JournalTimeIndexEntry> timeIndex;  ///< Sparse time index
+        std::map<uint16_t, UavRecords> uavs;           ///< Per-UAV record offsets
+    };
+
+    /**
+     * @brief Main loop for the writer thread
+     */
+    void writerLoop();
+
+    /**
+     * @brief Write a batch of records, opening and sealing segments as they fill up
+     * @param batch Consecutive records (JournalRecordHeader + packet + padding)
+     * @throws std::runtime_error on I/O errors
+     */
+    void writeBatch(const std::vector<uint8_t>& batch);
+
+    /**
+     * @brief Create and preallocate the next segment file
+     * @throws std::runtime_error on I/O errors
+     */
+    void openSegment();
+
+    /**
+     * @brief Write the index, mark the segment sealed and trim the unused preallocation
+     * @throws std::runtime_error on I/O errors
+     *
+     * An empty segment is deleted instead.
+     */
+    void sealSegment();
+
+    /**
+     * @brief Write bytes at a file offset of the open segment
+     * @param offset File offset
+     * @param data Bytes to write
+     * @param size Number of bytes
+     * @throws std::runtime_error on I/O errors
+     */
+    void writeAt(uint64_t offset, const void* data, size_t size);
+
+    /**
+     * @brief Find the number to give the first new segment
+     * @return One more than the highest segment number in the directory (1 if none)
+     */
+    uint32_t findNextSegmentIndex() const;
+
+    std::filesystem::path directory_;  ///< Journal directory
+    uint64_t segmentBytes_;            ///< Preallocated segment size
+    size_t maxBufferedBytes_;          ///< Buffer limit for pending records
+
+    // Shared with the ingest threads (protected by mutex_)
+    std::mutex mutex_;                                    ///< Protects the members below
+    std::condition_variable wake_;                        ///< Signals a full buffer or shutdown
+    std::vector<uint8_t> pending_;                        ///< Records waiting for the writer thread
+    std::unordered_map<std::string, uint16_t> uavIds_;    ///< UAV name -> id
+    std::unordered_map<uint16_t, std::string> uavNames_;  ///< UAV id -> name (for the segment index)
+    std::vector<uint16_t> removedIds_;                    ///< Ids to drop from uavNames_ at the next seal
+    uint64_t nextSequence_{1};                            ///< Sequence number of the next record
+    uint64_t dropped_{0};                                 ///< Records dropped since the last report
+    bool running_{false};                                 ///< Accepting packets
+
+    // Writer thread only
+    std::unique_ptr<OpenSegment> segment_;  ///< Segment being written (null between segments)
+    uint32_t nextSegmentIndex_{1};          ///< Number of the next segment file
+    std::thread writerThread_;              ///< Writer thread
+};
+
+#endif  // JOURNALRECORDER_H
@@ -0,0 +1,237 @@
+/**
+ * @file LinkMonitor.cpp
+ * @brief Implementation of the timing wheel and the link monitor
+ */
+
+#include "LinkMonitor.h"
+
+#include <algorithm>
+
+/**
+ * @brief Constructor
+ * @param tickMs Tick length in milliseconds
+ * @param nowMs Current time in milliseconds
+ */
+TimerWheel::TimerWheel(int64_t tickMs, int64_t nowMs)
+    : tickMs_(tickMs), currentTick_(static_cast<uint64_t>(nowMs / tickMs)) {
+    heads_.fill(NONE);
+}
+
+/**
+ * @brief Schedule (or reschedule) a timer
+ * @param id Timer id
+ * @param deadlineMs Time the timer is due, in milliseconds
+ *
+ * The deadline is rounded up to a whole tick, so a timer never fires early
+ * (unless it lies beyond the wheel's range).
+ */
+void TimerWheel::schedule(uint32_t id, int64_t deadlineMs) {
+    if (id >= nodes_.size()) {
+        nodes_.resize(static_cast<size_t>(id) + 1);
+    }
+    if (nodes_[id].slot != NONE) {
+        unlink(id);
+    }
+    constexpr uint64_t RANGE = uint64_t{1} << (SLOT_BITS * (LEVELS - 1));
+    uint64_t deadline = static_cast<uint64_t>(std::max<int64_t>((deadlineMs + tickMs_ - 1) / tickMs_, 0));
+    nodes_[id].deadline = std::clamp(deadline, currentTick_ + 1, currentTick_ + RANGE);
+    insert(id);
+}
+
+/**
+ * @brief Advance to the current time
+ * @param nowMs Current time in milliseconds
+ * @param expired Ids of the timers that came due are appended here
+ *
+ * At every tick whose lower bits roll over, the matching slots of the higher
+ * levels are cascaded first (top down, so a timer can drop several levels at
+ * once), then the level-0 slot of the tick is emptied.
+ */
+void TimerWheel::advance(int64_t nowMs, std::vector<uint32_t>& expired) {
+    uint64_t target = static_cast<uint64_t>(nowMs / tickMs_);
+    while (currentTick_ < target) {
+        ++currentTick_;
+        for (int level = LEVELS - 1; level > 0; --level) {
+            uint64_t lower_mask = (uint64_t{1} << (SLOT_BITS * level)) - 1;
+            if ((currentTick_ & lower_mask) != 0) {
+                continue;
+            }
+            uint32_t slot = level * SLOTS + ((currentTick_ >> (SLOT_BITS * level)) & (SLOTS - 1));
+            uint32_t id = heads_[slot];
+            heads_[slot] = NONE;
+            while (id != NONE) {
+                uint32_t next = nodes_[id].next;
+                insert(id);
+                id = next;
+            }
+        }
+        uint32_t slot = static_cast<uint32_t>(currentTick_ & (SLOTS - 1));
+        uint32_t id = heads_[slot];
+        heads_[slot] = NONE;
+        while (id != NONE) {
+            uint32_t next = nodes_[id].next;
+            nodes_[id].slot = NONE;
+            expired.push_back(id);
+            id = next;
+        }
+    }
+}
+
+/**
+ * @brief Cancel a timer (no effect if it is not scheduled)
+ * @param id Timer id
+ */
+void TimerWheel::cancel(uint32_t id) {
+    if (id < nodes_.size() && nodes_[id].slot != NONE) {
+        unlink(id);
+    }
+}
+
+/**
+ * @brief Put a timer into the slot for its deadline, relative to the current tick
+ *
+ * The level is the highest 6-bit digit in which the deadline differs from the
+ * current tick, so the timer sits in a slot the wheel has not reached yet at
+ * that level. Deadlines equal to the current tick (during a cascade) go to the
+ * level-0 slot being emptied.
+ */
+void TimerWheel::insert(uint32_t id) {
+    Node& node = nodes_[id];
+    uint64_t differing = node.deadline ^ currentTick_;
+    int level = 0;
+    while (level < LEVELS - 1 && (differing >> (SLOT_BITS * (level + 1))) != 0) {
+        ++level;
+    }
+    uint32_t slot = level * SLOTS + ((node.deadline >> (SLOT_BITS * level)) & (SLOTS - 1));
+    node.slot = slot;
+    node.prev = NONE;
+    node.next = heads_[slot];
+    if (node.next != NONE) {
+        nodes_[node.next].prev = id;
+    }
+    heads_[slot] = id;
+}
+
+/**
+ * @brief Take a timer out of its slot
+ */
+void TimerWheel::unlink(uint32_t id) {
+    Node& node = nodes_[id];
+    if (node.prev != NONE) {
+        nodes_[node.prev].next = node.next;
+    } else {
+        heads_[node.slot] = node.next;
+    }
+    if (node.next != NONE) {
+        nodes_[node.next].prev = node.prev;
+    }
+    node.prev = node.next = node.slot = NONE;
+}
+
+namespace {
+    constexpr int64_t TICK_MS = 100;  ///< Timer resolution (the service checks every 100 ms)
+}  // namespace
+
+/**
+ * @brief Constructor
+ * @param timeoutMs Silence after which a link is reported down
+ * @param nowMs Current time (monotonic milliseconds)
+ */
+LinkMonitor::LinkMonitor(int64_t timeoutMs, int64_t nowMs) : timeoutMs_(timeoutMs), wheel_(TICK_MS, nowMs) {}
+
+/**
+ * @brief Record a packet
+ * @param uavName UAV that sent the packet
+ * @param topic Topic the packet is published on
+ * @param nowMs Current time (monotonic milliseconds)
+ * @param events "Up" events are appended here
+ */
+void LinkMonitor::seen(const std::string& uavName,
+                       const std::string& topic,
+                       int64_t nowMs,
+                       std::vector<LinkEvent>& events) {
+    touch(uavLinks_, uavName, uavName, std::string(), nowMs, events);
+    touch(topicLinks_, topic, uavName, topic, nowMs, events);
+}
+
+/**
+ * @brief Check the timers that came due
+ * @param nowMs Current time (monotonic milliseconds)
+ * @param events "Down" events are appended here
+ */
+void LinkMonitor::advance(int64_t nowMs, std::vector<LinkEvent>& events) {
+    expired_.clear();
+    wheel_.advance(nowMs, expired_);
+    for (uint32_t id : expired_) {
+        Link& link = links_[id];
+        int64_t silent_ms = nowMs - link.lastSeenMs;
+        if (silent_ms < timeoutMs_) {
+            // Heard from since the timer was set: wait for the timeout after the latest packet
+            wheel_.schedule(id, link.lastSeenMs + timeoutMs_);
+        } else if (link.up) {
+            link.up = false;
+            events.push_back(LinkEvent{link.uav, link.topic, false, silent_ms});
+        }
+    }
+}
+
+/**
+ * @brief Forget a UAV and its topics without reporting them down
+ * @param uavName UAV name
+ *
+ * Visits every topic link once; removal is rare compared with packets.
+ */
+void LinkMonitor::removeUav(const std::string& uavName) {
+    auto release = [this](uint32_t id) {
+        wheel_.cancel(id);
+        links_[id] = Link{std::string(), std::string(), 0, false};
+        freeLinks_.push_back(id);
+    };
+    auto uav_it = uavLinks_.find(uavName);
+    if (uav_it != uavLinks_.end()) {
+        release(uav_it->second);
+        uavLinks_.erase(uav_it);
+    }
+    for (auto it = topicLinks_.begin(); it != topicLinks_.end();) {
+        if (links_[it->second].uav == uavName) {
+            release(it->second);
+            it = topicLinks_.erase(it);
+        } else {
+            ++it;
+        }
+    }
+}
+
+/**
+ * @brief Record a packet on one link (created on first use)
+ */
+void LinkMonitor::touch(std::unordered_map<std::string, uint32_t>& index,
+                        const std::string& key,
+                        const std::string& uavName,
+                        const std::string& topic,
+                        int64_t nowMs,
+                        std::vector<LinkEvent>& events) {
+    auto it = index.find(key);
+    if (it == index.end()) {
+        uint32_t id;
+        if (freeLinks_.empty()) {
+            id = static_cast<uint32_t>(links_.size());
+            links_.push_back(Link{uavName, topic, nowMs, true});
+        } else {
+            id = freeLinks_.back();
+            freeLinks_.pop_back();
+            links_[id] = Link{uavName, topic, nowMs, true};
+        }
+        index.emplace(key, id);
+        wheel_.schedule(id, nowMs + timeoutMs_);
+        events.push_back(LinkEvent{uavName, topic, true, 0});
+        return;
+    }
+    Link& link = links_[it->second];
+    if (!link.up) {
+        link.up = true;
+        events.push_back(LinkEvent{uavName, topic, true, nowMs - link.lastSeenMs});
+        wheel_.schedule(it->second, nowMs + timeoutMs_);
+    }
+    link.lastSeenMs = nowMs;
+}
@@ -0,0 +1,188 @@
+/**
+ * @file LinkMonitor.h
+ * @brief Stale-link detection for UAVs and their telemetry topics
+ *
+ * This file defines the TimerWheel class, a hierarchical timing wheel, and the
+ * LinkMonitor that the routing stage notifies of every packet. The monitor
+ * reports when a UAV (or one of its topics) goes silent for longer than the
+ * configured timeout and when it is heard again; the service publishes these
+ * transitions as "uav.<UAV>.link" events.
+ */
+
+#ifndef LINKMONITOR_H
+#define LINKMONITOR_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class TimerWheel
+ * @brief Hierarchical timing wheel with O(1) scheduling
+ *
+ * Four levels of 64 slots. Level 0 holds timers due within the current run of
+ * 64 ticks, one slot per tick; each higher level covers 64 slots of the level
+ * below. When the tick counter enters a new higher-level slot, the timers in it
+ * are cascaded down, so every timer is moved at most three times before it
+ * fires. Advancing one tick touches one slot, whatever the number of timers.
+ *
+ * Timers are identified by small integers chosen by the caller (indices into
+ * its own table). Timers never fire before their deadline; deadlines more
+ * than 64^3 ticks ahead are clamped to that range and fire early, so callers
+ * must check whether the event is really due.
+ */
+class TimerWheel {
+   public:
+    /**
+     * @brief Constructor
+     * @param tickMs Tick length in milliseconds (timer resolution)
+     * @param nowMs Current time in milliseconds
+     */
+    TimerWheel(int64_t tickMs, int64_t nowMs);
+
+    /**
+     * @brief Schedule (or reschedule) a timer
+     * @param id Timer id (the wheel grows its table to hold it)
+     * @param deadlineMs Time the timer is due, in milliseconds
+     */
+    void schedule(uint32_t id, int64_t deadlineMs);
+
+    /**
+     * @brief Advance to the current time
+     * @param nowMs Current time in milliseconds
+     * @param expired Ids of the timers that came due are appended here
+     */
+    void advance(int64_t nowMs, std::vector<uint32_t>& expired);
+
+    /**
+     * @brief Cancel a timer (no effect if it is not scheduled)
+     * @param id Timer id
+     */
+    void cancel(uint32_t id);
+
+   private:
+    static constexpr int LEVELS = 4;                    ///< Wheel levels
+    static constexpr int SLOT_BITS = 6;                 ///< log2 of the slots per level
+    static constexpr uint32_t SLOTS = 1u << SLOT_BITS;  ///< Slots per level
+    static constexpr uint32_t NONE = UINT32_MAX;        ///< "No node" link value
+
+    /**
+     * @struct Node
+     * @brief Wheel linkage of one timer (intrusive doubly linked slot lists)
+     */
+    struct Node {
+        uint32_t prev{NONE};   ///< Previous timer in the slot
+        uint32_t next{NONE};   ///< Next timer in the slot
+        uint32_t slot{NONE};   ///< Slot index (level * SLOTS + slot), NONE when not scheduled
+        uint64_t deadline{0};  ///< Due tick
+    };
+
+    /**
+     * @brief Put a timer into the slot for its deadline, relative to the current tick
+     */
+    void insert(uint32_t id);
+
+    /**
+     * @brief Take a timer out of its slot
+     */
+    void unlink(uint32_t id);
+
+    int64_t tickMs_;                              ///< Tick length in milliseconds
+    uint64_t currentTick_;                        ///< Last tick processed
+    std::vector<Node> nodes_;                     ///< Timer id -> linkage
+    std::array<uint32_t, LEVELS * SLOTS> heads_;  ///< First timer of every slot
+};
+
+/**
+ * @struct LinkEvent
+ * @brief A UAV or one of its topics went silent or was heard again
+ */
+struct LinkEvent {
+    std::string uav;      ///< UAV name
+    std::string topic;    ///< Telemetry topic ("" for the UAV as a whole)
+    bool up{true};        ///< true: traffic resumed (or first seen), false: silent for the timeout
+    int64_t silentMs{0};  ///< Time since the previous packet (0 for the first packet)
+};
+
+/**
+ * @class LinkMonitor
+ * @brief Tracks the last packet per UAV and per topic and reports links going up and down
+ *
+ * A packet costs two hash lookups and a timestamp store: while a link is up
+ * its timer stays where it is. When the timer fires, the link is reported
+ * down if it really has been silent for the timeout; otherwise the timer is
+ * moved to the last packet plus the timeout. So each link is touched at most
+ * once per timeout period, and the periodic check only visits due timers
+ * instead of scanning every UAV.
+ *
+ * Not thread-safe; the service calls it under its processing lock. Times are
+ * from a monotonic clock.
+ */
+class LinkMonitor {
+   public:
+    /**
+     * @brief Constructor
+     * @param timeoutMs Silence after which a link is reported down
+     * @param nowMs Current time (monotonic milliseconds)
+     */
+    LinkMonitor(int64_t timeoutMs, int64_t nowMs);
+
+    /**
+     * @brief Record a packet
+     * @param uavName UAV that sent the packet
+     * @param topic Topic the packet is published on
+     * @param nowMs Current time (monotonic milliseconds)
+     * @param events "Up" events for links that were down or new are appended here
+     */
+    void seen(const std::string& uavName, const std::string& topic, int64_t nowMs, std::vector<LinkEvent>& events);
+
+    /**
+     * @brief Check the timers that came due
+     * @param nowMs Current time (monotonic milliseconds)
+     * @param events "Down" events are appended here
+     */
+    void advance(int64_t nowMs, std::vector<LinkEvent>& events);
+
+    /**
+     * @brief Forget a UAV and its topics without reporting them down
+     * @param uavName UAV name
+     *
+     * Used when a UAV is unregistered on purpose. The link ids are reused by
+     * the next new links.
+     */
+    void removeUav(const std::string& uavName);
+
+   private:
+    /**
+     * @struct Link
+     * @brief Last-seen state of a UAV or of one of its topics
+     */
+    struct Link {
+        std::string uav;     ///< UAV name
+        std::string topic;   ///< Topic ("" for the UAV as a whole)
+        int64_t lastSeenMs;  ///< Time of the latest packet
+        bool up;             ///< Current state
+    };
+
+    /**
+     * @brief Record a packet on one link (created on first use)
+     */
+    void touch(std::unordered_map<std::string, uint32_t>& index,
+               const std::string& key,
+               const std::string& uavName,
+               const std::string& topic,
+               int64_t nowMs,
+               std::vector<LinkEvent>& events);
+
+    int64_t timeoutMs_;                                     ///< Silence before a link is down
+    TimerWheel wheel_;                                      ///< One timer per link (id = index in links_)
+    std::vector<Link> links_;                               ///< Link id -> state
+    std::unordered_map<std::string, uint32_t> uavLinks_;    ///< UAV name -> link id
+    std::unordered_map<std::string, uint32_t> topicLinks_;  ///< Topic -> link id
+    std::vector<uint32_t> freeLinks_;                       ///< Ids of removed links, reused first
+    std::vector<uint32_t> expired_;                         ///< Scratch list for advance()
+};
+
+#endif  // LINKMONITOR_H
@@ -16,7 +16,7 @@
 // Static member definitions
 std::unique_ptr<std::ofstream> Logger::log_file = nullptr;
 std::mutex Logger::mtx;
-LogLevel Logger::current_level = LogLevel::INFO;
+std::atomic<LogLevel> Logger::current_level{LogLevel::INFO};
 
 /**
  * @brief Initialize the logging system
@@ -112,8 +112,16 @@ void Logger::error(const std::string& msg) {
  * @param level New minimum log level
  */
 void Logger::setLevel(LogLevel level) {
-    std::lock_guard<std::mutex> lock(mtx);
-    current_level = level;
+    current_level.store(level, std::memory_order_relaxed);
+}
+
+/**
+ * @brief Check whether messages of a level would be written
+ * @param level Log level to check
+ * @return true if level is at or above the current minimum level
+ */
+bool Logger::isEnabled(LogLevel level) {
+    return level >= current_level.load(std::memory_order_relaxed);
 }
 
 /**
@@ -123,13 +131,13 @@ void Logger::setLevel(LogLevel level) {
  * @param useStderr Whether to use stderr instead of stdout
  */
 void Logger::log(LogLevel level, const std::string& msg, bool useStderr) {
-    std::lock_guard<std::mutex> lock(mtx);
-
-    // Check if this message should be logged based on current level
-    if (level < current_level) {
+    // Check if this message should be logged based on current level (before taking the lock)
+    if (!isEnabled(level)) {
         return;
     }
 
+    std::lock_guard<std::mutex> lock(mtx);
+
     std::string level_str = levelToString(level);
     std::string log_msg = "[" + getTimestamp() + "] " + level_str + ": " + msg;
 
@@ -10,6 +10,7 @@
 #ifndef LOGGER_H
 #define LOGGER_H
 
+#include <atomic>
 #include <fstream>
 #include <memory>
 #include <mutex>
@@ -71,6 +72,15 @@ class Logger {
      */
     static void setLevel(LogLevel level);
 
+    /**
+     * @brief Check whether messages of a level would be written
+     * @param level Log level to check
+     * @return true if level is at or above the current minimum level
+     *
+     * Lock-free; lets hot paths skip building messages that would be dropped.
+     */
+    static bool isEnabled(LogLevel level);
+
     /**
      * @brief Log a debug message
      * @param msg The debug message to log
@@ -153,7 +163,7 @@ class Logger {
    private:
     static std::unique_ptr<std::ofstream> log_file;  ///< Log file output stream
     static std::mutex mtx;                           ///< Mutex for thread-safe access
-    static LogLevel current_level;                   ///< Current minimum log level
+    static std::atomic<LogLevel> current_level;      ///< Current minimum log level
 
     /**
      * @brief Generate a timestamp string for log entries
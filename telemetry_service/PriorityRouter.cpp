@@ -0,0 +1,200 @@
+/**
+ * @file PriorityRouter.cpp
+ * @brief Implementation of the outbound priority lanes
+ */
+
+#include "PriorityRouter.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+#include "Logger.h"
+#include "TelemetryPackets.h"
+
+/**
+ * @brief Constructor
+ * @param dispatch Function that publishes one message
+ * @param settings Weight and capacity per lane, indexed by PriorityLane
+ */
+PriorityRouter::PriorityRouter(OutboundDispatch dispatch, const std::array<LaneSettings, 3>& settings)
+    : dispatch_(std::move(dispatch)) {
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        lanes_[i].settings = settings[i];
+        // A zero weight would starve the lane forever, a zero capacity would drop everything
+        lanes_[i].settings.weight = std::max(1U, lanes_[i].settings.weight);
+        lanes_[i].settings.capacity = std::max<size_t>(1, lanes_[i].settings.capacity);
+    }
+    credit_ = lanes_[0].settings.weight;
+}
+
+/**
+ * @brief Destructor - stops the dispatcher thread
+ */
+PriorityRouter::~PriorityRouter() {
+    stop();
+    join();
+}
+
+/**
+ * @brief Default lane settings
+ * @return Settings indexed by PriorityLane
+ *
+ * Commands and critical status are rare, so their generous weights cost bulk
+ * traffic almost nothing; bulk gets the deepest queue to absorb bursts.
+ */
+std::array<LaneSettings, 3> PriorityRouter::defaultSettings() {
+    return {LaneSettings{8, 1024}, LaneSettings{4, 1024}, LaneSettings{1, 4096}};
+}
+
+/**
+ * @brief Start the dispatcher thread
+ */
+void PriorityRouter::start() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = true;
+    }
+    dispatcherThread_ = std::thread(&PriorityRouter::dispatchLoop, this);
+}
+
+/**
+ * @brief Stop the dispatcher thread; queued messages are discarded
+ */
+void PriorityRouter::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        running_ = false;
+    }
+    wake_.notify_all();
+}
+
+/**
+ * @brief Wait for the dispatcher thread to finish
+ */
+void PriorityRouter::join() {
+    if (dispatcherThread_.joinable())
+        dispatcherThread_.join();
+}
+
+/**
+ * @brief Queue a message for publishing
+ * @param lane Priority class of the message
+ * @param message Message to publish
+ * @return false if the router is not running (the message is discarded)
+ */
+bool PriorityRouter::enqueue(PriorityLane lane, OutboundMessage message) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_) {
+            return false;
+        }
+        Lane& target = lanes_[static_cast<size_t>(lane)];
+        if (target.queue.size() >= target.settings.capacity) {
+            target.queue.pop_front();
+            ++target.dropped;
+        }
+        target.queue.push_back(std::move(message));
+    }
+    wake_.notify_one();
+    return true;
+}
+
+/**
+ * @brief Determine the priority class of a telemetry packet
+ * @param packet Raw packet (PacketHeader + payload)
+ * @return CRITICAL for status packets with mission state Emergency or health Critical, BULK otherwise
+ *
+ * Only the two status bytes are inspected; everything else about the payload
+ * stays opaque to the service.
+ */
+PriorityLane PriorityRouter::classify(const std::vector<uint8_t>& packet) {
+    // Health and mission state are the first two bytes; the rest of the payload is not needed
+    constexpr size_t classified_bytes = offsetof(StatusPayload, flightTime);
+    if (packet.size() < sizeof(PacketHeader) + classified_bytes) {
+        return PriorityLane::BULK;
+    }
+    const auto* header = reinterpret_cast<const PacketHeader*>(packet.data());
+    if (header->packetType != PacketTypes::STATUS) {
+        return PriorityLane::BULK;
+    }
+    StatusPayload status{};
+    std::memcpy(&status, packet.data() + sizeof(PacketHeader), classified_bytes);
+    if (status.missionState == MissionState::EMERGENCY || status.systemHealth == SystemHealth::CRITICAL) {
+        return PriorityLane::CRITICAL;
+    }
+    return PriorityLane::BULK;
+}
+
+/**
+ * @brief Main loop for the dispatcher thread
+ *
+ * Sleeps until a message arrives, then publishes one message at a time in
+ * schedule order. The lock is released while publishing, so producers are
+ * never blocked by a slow socket.
+ */
+void PriorityRouter::dispatchLoop() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        PriorityLane lane = PriorityLane::BULK;
+        OutboundMessage message;
+        if (!takeNext(lane, message)) {
+            wake_.wait(lock);
+            continue;
+        }
+        reportDrops();
+
+        lock.unlock();
+        try {
+            dispatch_(lane, message);
+        } catch (const std::exception& e) {
+            Logger::error("Failed to publish " + message.topic + ": " + std::string(e.what()));
+        }
+        lock.lock();
+    }
+    Logger::status("SERVICE", "Priority dispatcher stopped");
+}
+
+/**
+ * @brief Take the next message according to the weighted round-robin schedule
+ * @param lane Set to the lane the message came from
+ * @param message Set to the message
+ * @return false if every lane is empty
+ *
+ * The scheduler stays on a lane until it has used up the lane's weight or the
+ * lane runs empty, then moves on in COMMAND, CRITICAL, BULK order.
+ */
+bool PriorityRouter::takeNext(PriorityLane& lane, OutboundMessage& message) {
+    for (size_t visited = 0; visited <= lanes_.size(); ++visited) {
+        Lane& current = lanes_[currentLane_];
+        if (credit_ > 0 && !current.queue.empty()) {
+            --credit_;
+            lane = static_cast<PriorityLane>(currentLane_);
+            message = std::move(current.queue.front());
+            current.queue.pop_front();
+            return true;
+        }
+        currentLane_ = (currentLane_ + 1) % lanes_.size();
+        credit_ = lanes_[currentLane_].settings.weight;
+    }
+    return false;
+}
+
+/**
+ * @brief Log dropped-message counters (at most every few seconds)
+ */
+void PriorityRouter::reportDrops() {
+    static constexpr const char* lane_names[] = {"command", "critical", "bulk"};
+    auto now = std::chrono::steady_clock::now();
+    if (now - lastDropReport_ < std::chrono::seconds(5)) {
+        return;
+    }
+    for (size_t i = 0; i < lanes_.size(); ++i) {
+        if (lanes_[i].dropped > 0) {
+            Logger::warn(std::string("Priority lane '") + lane_names[i] + "' full, dropped "
+                         + std::to_string(lanes_[i].dropped) + " oldest messages");
+            lanes_[i].dropped = 0;
+            lastDropReport_ = now;
+        }
+    }
+}
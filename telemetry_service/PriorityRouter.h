@@ -0,0 +1,178 @@
+/**
+ * @file PriorityRouter.h
+ * @brief Priority lanes for outbound messages to UI components
+ *
+ * This file defines the PriorityRouter class which decouples the ingest threads
+ * from publishing. Outbound messages are sorted into lanes by priority class and
+ * a single dispatcher thread drains the lanes with weighted round-robin, so
+ * command replies and critical status packets never wait behind a backlog of
+ * bulk location updates.
+ */
+
+#ifndef PRIORITYROUTER_H
+#define PRIORITYROUTER_H
+
+#include <array>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Priority class of an outbound message (also the lane index)
+ */
+enum class PriorityLane : uint8_t {
+    COMMAND = 0,   ///< Command acknowledgements and admin replies
+    CRITICAL = 1,  ///< Status packets reporting an emergency or critical health
+    BULK = 2       ///< All other telemetry
+};
+
+/**
+ * @brief Publishing channel an outbound message is sent on
+ */
+enum class OutboundChannel : uint8_t {
+    TCP,  ///< ZeroMQ PUB socket
+    UDP   ///< UDP subscribers
+};
+
+/**
+ * @struct OutboundMessage
+ * @brief One message waiting to be published to UI components
+ */
+struct OutboundMessage {
+    OutboundChannel channel{OutboundChannel::TCP};  ///< Channel to publish on
+    std::string topic;                              ///< Topic (e.g., "telemetry.UAV_1.camera.status")
+    std::vector<uint8_t> data;                      ///< Binary payload
+    std::string stream{};                           ///< Derived-stream subscription it belongs to ("" if none)
+};
+
+/**
+ * @struct LaneSettings
+ * @brief Scheduling weight and queue bound of one lane
+ */
+struct LaneSettings {
+    unsigned weight{1};  ///< Messages dispatched per round-robin visit
+    size_t capacity{1};  ///< Queue bound; the oldest message is dropped when it is exceeded
+};
+
+// Callback that actually publishes a message; called on the dispatcher thread only
+using OutboundDispatch = std::function<void(PriorityLane, const OutboundMessage&)>;
+
+/**
+ * @class PriorityRouter
+ * @brief Per-class outbound queues drained by one weighted round-robin dispatcher
+ *
+ * Each lane has its own queue. The dispatcher visits the lanes in priority order
+ * and sends up to the lane's weight from each non-empty one, so a critical
+ * message waits for at most one bulk visit however deep the bulk queue is, while
+ * bulk traffic still gets its share. When a queue is full the oldest message is
+ * dropped: a stale position update is worth less than the current one.
+ */
+class PriorityRouter {
+   public:
+    /**
+     * @brief Constructor
+     * @param dispatch Function that publishes one message
+     * @param settings Weight and capacity per lane, indexed by PriorityLane
+     */
+    explicit PriorityRouter(OutboundDispatch dispatch, const std::array<LaneSettings, 3>& settings = defaultSettings());
+
+    /**
+     * @brief Destructor - stops the dispatcher thread
+     */
+    ~PriorityRouter();
+
+    // Owns a thread that refers back to this object
+    PriorityRouter(const PriorityRouter&) = delete;
+    PriorityRouter& operator=(const PriorityRouter&) = delete;
+    PriorityRouter(PriorityRouter&&) = delete;
+    PriorityRouter& operator=(PriorityRouter&&) = delete;
+
+    /**
+     * @brief Default lane settings: COMMAND 8/1024, CRITICAL 4/1024, BULK 1/4096 (weight/capacity)
+     * @return Settings indexed by PriorityLane
+     */
+    static std::array<LaneSettings, 3> defaultSettings();
+
+    /**
+     * @brief Start the dispatcher thread
+     */
+    void start();
+
+    /**
+     * @brief Stop the dispatcher thread; queued messages are discarded
+     */
+    void stop();
+
+    /**
+     * @brief Wait for the dispatcher thread to finish
+     */
+    void join();
+
+    /**
+     * @brief Queue a message for publishing
+     * @param lane Priority class of the message
+     * @param message Message to publish
+     * @return false if the router is not running (the message is discarded)
+     *
+     * Thread-safe and non-blocking apart from a short queue lock.
+     */
+    bool enqueue(PriorityLane lane, OutboundMessage message);
+
+    /**
+     * @brief Determine the priority class of a telemetry packet
+     * @param packet Raw packet (PacketHeader + payload)
+     * @return CRITICAL for status packets with mission state Emergency or health Critical, BULK otherwise
+     */
+    static PriorityLane classify(const std::vector<uint8_t>& packet);
+
+   private:
+    /**
+     * @struct Lane
+     * @brief Queue and counters of one priority class
+     */
+    struct Lane {
+        LaneSettings settings;              ///< Weight and capacity
+        std::deque<OutboundMessage> queue;  ///< Messages waiting for dispatch
+        uint64_t dropped{0};                ///< Messages dropped since the last report
+    };
+
+    /**
+     * @brief Main loop for the dispatcher thread
+     */
+    void dispatchLoop();
+
+    /**
+     * @brief Take the next message according to the weighted round-robin schedule
+     * @param lane Set to the lane the message came from
+     * @param message Set to the message
+     * @return false if every lane is empty
+     *
+     * Must be called with mutex_ held.
+     */
+    bool takeNext(PriorityLane& lane, OutboundMessage& message);
+
+    /**
+     * @brief Log dropped-message counters (at most every few seconds)
+     *
+     * Must be called with mutex_ held.
+     */
+    void reportDrops();
+
+    OutboundDispatch dispatch_;                               ///< Publishes one message
+    std::array<Lane, 3> lanes_;                               ///< Lanes indexed by PriorityLane
+    size_t currentLane_{0};                                   ///< Lane being visited by the scheduler
+    unsigned credit_{0};                                      ///< Messages left in the current visit
+    std::chrono::steady_clock::time_point lastDropReport_{};  ///< When drops were last logged
+    std::mutex mutex_;                                        ///< Protects lanes and scheduler state
+    std::condition_variable wake_;                            ///< Signals new messages or shutdown
+    bool running_{false};                                     ///< Dispatcher should keep running
+    std::thread dispatcherThread_;                            ///< Dispatcher thread
+};
+
+#endif  // PRIORITYROUTER_H
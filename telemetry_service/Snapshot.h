@@ -0,0 +1,130 @@
+/**
+ * @file Snapshot.h
+ * @brief Read-copy-update holder for immutable shared state
+ *
+ * Readers take a reference-counted snapshot and keep using it for as long as
+ * they need; writers build a new immutable value and swap it in atomically.
+ * Old values are released when the last reader drops its snapshot, so readers
+ * are never blocked by updates. Hot paths use SnapshotReader, which only touches
+ * the shared pointer when the version counter says the value changed.
+ */
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+/**
+ * @class Snapshot
+ * @brief Atomically swappable pointer to an immutable value
+ * @tparam T Type of the shared value
+ *
+ * load() and store() are safe to call concurrently from any thread. Writers
+ * doing read-modify-write (copy the current value, change it, store it) must
+ * serialize among themselves with their own mutex.
+ */
+template <typename T>
+class Snapshot {
+   public:
+    /**
+     * @brief Constructor
+     * @param initial Initial value (defaults to a value-initialized T)
+     */
+    explicit Snapshot(std::shared_ptr<const T> initial = std::make_shared<const T>()) : current_(std::move(initial)) {}
+
+    // The held pointer is shared state; copying the holder would silently fork it
+    Snapshot(const Snapshot&) = delete;
+    Snapshot& operator=(const Snapshot&) = delete;
+    Snapshot(Snapshot&&) = delete;
+    Snapshot& operator=(Snapshot&&) = delete;
+
+    /**
+     * @brief Get the current value
+     * @return Reference-counted pointer that stays valid after later store() calls
+     */
+    [[nodiscard]] std::shared_ptr<const T> load() const {
+        return std::atomic_load_explicit(&current_, std::memory_order_acquire);
+    }
+
+    /**
+     * @brief Publish a new value
+     * @param next The new immutable value
+     */
+    void store(std::shared_ptr<const T> next) {
+        std::atomic_store_explicit(&current_, std::move(next), std::memory_order_release);
+        version_.fetch_add(1, std::memory_order_release);  // Bumped after the pointer so readers never miss it
+    }
+
+    /**
+     * @brief Get the number of store() calls so far
+     * @return Version counter (a plain atomic integer read)
+     */
+    [[nodiscard]] uint64_t version() const {
+        return version_.load(std::memory_order_acquire);
+    }
+
+   private:
+    std::shared_ptr<const T> current_;  ///< Current value (accessed only through atomic free functions)
+    std::atomic<uint64_t> version_{0};  ///< Incremented by every store()
+};
+
+/**
+ * @class SnapshotReader
+ * @brief Single-thread cache of a Snapshot for hot paths
+ * @tparam T Type of the shared value
+ *
+ * std::atomic_load on a shared_ptr may take an internal lock, so a thread that
+ * reads the value per message keeps its own reference and only reloads it when
+ * the snapshot version has moved. Not thread-safe: use one reader per thread.
+ */
+template <typename T>
+class SnapshotReader {
+   public:
+    /**
+     * @brief Constructor
+     * @param source Snapshot to read from (must outlive the reader)
+     */
+    explicit SnapshotReader(const Snapshot<T>& source) : source_(source) {}
+
+    /**
+     * @brief Get the current value, refreshing the cached reference if needed
+     * @return Reference valid until the next call to get() or refresh() on this reader
+     */
+    const T& get() {
+        refresh();
+        return *value_;
+    }
+
+    /**
+     * @brief Refresh the cached reference if the snapshot changed
+     * @return true if a new value was picked up
+     */
+    bool refresh() {
+        uint64_t version = source_.version();
+        if (value_ && version == version_) {
+            return false;
+        }
+        // The loaded pointer is at least as new as 'version' because store() bumps the version last
+        value_ = source_.load();
+        version_ = version;
+        return true;
+    }
+
+    /**
+     * @brief Get the cached value without checking for updates
+     * @return Shared pointer to the cached value (null before the first refresh)
+     */
+    [[nodiscard]] const std::shared_ptr<const T>& cached() const {
+        return value_;
+    }
+
+   private:
+    const Snapshot<T>& source_;       ///< Snapshot being cached
+    std::shared_ptr<const T> value_;  ///< Cached value
+    uint64_t version_{0};             ///< Version the cached value was read at
+};
+
+#endif  // SNAPSHOT_H
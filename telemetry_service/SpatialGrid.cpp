@@ -0,0 +1,137 @@
+/**
+ * @file SpatialGrid.cpp
+ * @brief Implementation of the latitude/longitude grid index
+ */
+
+#include "SpatialGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief Constructor
+ * @param cellDegrees Edge length of one cell in degrees
+ */
+SpatialGrid::SpatialGrid(double cellDegrees)
+    : cellDegrees_(cellDegrees),
+      rows_(static_cast<int64_t>(std::ceil(180.0 / cellDegrees))),
+      columns_(static_cast<int64_t>(std::ceil(360.0 / cellDegrees))) {}
+
+/**
+ * @brief Get the grid row of a latitude (clamped to the grid)
+ */
+int64_t SpatialGrid::rowOf(double latitude) const {
+    auto row = static_cast<int64_t>(std::floor((std::clamp(latitude, -90.0, 90.0) + 90.0) / cellDegrees_));
+    return std::min(row, rows_ - 1);
+}
+
+/**
+ * @brief Get the grid column of a longitude (clamped to the grid)
+ */
+int64_t SpatialGrid::columnOf(double longitude) const {
+    auto column = static_cast<int64_t>(std::floor((std::clamp(longitude, -180.0, 180.0) + 180.0) / cellDegrees_));
+    return std::min(column, columns_ - 1);
+}
+
+/**
+ * @brief Insert a UAV or move it to a new position
+ * @param id UAV id
+ * @param latitude Latitude in decimal degrees
+ * @param longitude Longitude in decimal degrees
+ */
+void SpatialGrid::move(uint16_t id, double latitude, double longitude) {
+    if (std::isnan(latitude) || std::isnan(longitude)) {
+        remove(id);
+        return;
+    }
+    int64_t key = keyOf(rowOf(latitude), columnOf(longitude));
+    if (id >= cellOf_.size()) {
+        cellOf_.resize(static_cast<size_t>(id) + 1, NO_CELL);
+    }
+    if (cellOf_[id] == key) {
+        return;
+    }
+    remove(id);
+    cells_[key].push_back(id);
+    cellOf_[id] = key;
+}
+
+/**
+ * @brief Remove a UAV from the grid
+ * @param id UAV id
+ *
+ * Cells hold few UAVs, so the id is found by a linear search and replaced by the
+ * cell's last entry. Emptied cells are dropped to keep the map small.
+ */
+void SpatialGrid::remove(uint16_t id) {
+    if (id >= cellOf_.size() || cellOf_[id] == NO_CELL) {
+        return;
+    }
+    auto cell_it = cells_.find(cellOf_[id]);
+    if (cell_it != cells_.end()) {
+        auto& ids = cell_it->second;
+        auto id_it = std::find(ids.begin(), ids.end(), id);
+        if (id_it != ids.end()) {
+            *id_it = ids.back();
+            ids.pop_back();
+        }
+        if (ids.empty()) {
+            cells_.erase(cell_it);
+        }
+    }
+    cellOf_[id] = NO_CELL;
+}
+
+/**
+ * @brief Collect the UAVs in every cell overlapping a latitude/longitude box
+ * @param minLatitude Southern edge
+ * @param minLongitude Western edge
+ * @param maxLatitude Northern edge
+ * @param maxLongitude Eastern edge (less than minLongitude for a box across the antimeridian)
+ * @return UAV ids in the overlapping cells
+ *
+ * Small boxes look up each covered cell. A box covering more cells than are
+ * occupied walks the occupied cells instead, so a query never costs more than
+ * one pass over the fleet.
+ */
+std::vector<uint16_t> SpatialGrid::candidates(double minLatitude,
+                                              double minLongitude,
+                                              double maxLatitude,
+                                              double maxLongitude) const {
+    std::vector<uint16_t> ids;
+    if (cells_.empty() || minLatitude > maxLatitude) {
+        return ids;
+    }
+    int64_t first_row = rowOf(minLatitude);
+    int64_t last_row = rowOf(maxLatitude);
+    int64_t first_column = columnOf(minLongitude);
+    int64_t last_column = columnOf(maxLongitude);
+    bool wraps = minLongitude > maxLongitude;
+    int64_t column_count = wraps ? (columns_ - first_column) + (last_column + 1) : (last_column - first_column + 1);
+    auto in_columns = [&](int64_t column) {
+        return wraps ? (column >= first_column || column <= last_column)
+                     : (column >= first_column && column <= last_column);
+    };
+
+    if (static_cast<double>(last_row - first_row + 1) * static_cast<double>(column_count)
+        > static_cast<double>(cells_.size())) {
+        for (const auto& [key, cell_ids] : cells_) {
+            int64_t row = key / columns_;
+            if (row >= first_row && row <= last_row && in_columns(key % columns_)) {
+                ids.insert(ids.end(), cell_ids.begin(), cell_ids.end());
+            }
+        }
+        return ids;
+    }
+
+    for (int64_t row = first_row; row <= last_row; ++row) {
+        for (int64_t step = 0; step < column_count; ++step) {
+            int64_t column = (first_column + step) % columns_;
+            auto cell_it = cells_.find(keyOf(row, column));
+            if (cell_it != cells_.end()) {
+                ids.insert(ids.end(), cell_it->second.begin(), cell_it->second.end());
+            }
+        }
+    }
+    return ids;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file SpatialGrid.h
+ * @brief Uniform latitude/longitude grid over the latest UAV positions
+ *
+ * This file defines the SpatialGrid class used by the fleet state store to
+ * answer area queries. The globe is divided into square cells of a configured
+ * size in degrees; each occupied cell lists the UAV ids positioned in it. A
+ * query only visits the cells overlapping its area, so its cost grows with the
+ * area and the number of UAVs found, not with the fleet size.
+ */
+
+#ifndef SPATIALGRID_H
+#define SPATIALGRID_H
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @class SpatialGrid
+ * @brief Incrementally updated grid index of UAV ids by position
+ *
+ * Not thread-safe; FleetState guards it with its own lock.
+ */
+class SpatialGrid {
+   public:
+    /**
+     * @brief Constructor
+     * @param cellDegrees Edge length of one cell in degrees (e.g. 0.01, about 1.1 km north-south)
+     */
+    explicit SpatialGrid(double cellDegrees);
+
+    /**
+     * @brief Insert a UAV or move it to a new position
+     * @param id UAV id
+     * @param latitude Latitude in decimal degrees
+     * @param longitude Longitude in decimal degrees
+     *
+     * Costs nothing beyond the cell computation while the UAV stays in its cell.
+     */
+    void move(uint16_t id, double latitude, double longitude);
+
+    /**
+     * @brief Remove a UAV from the grid
+     * @param id UAV id (ignored if not in the grid)
+     */
+    void remove(uint16_t id);
+
+    /**
+     * @brief Collect the UAVs in every cell overlapping a latitude/longitude box
+     * @param minLatitude Southern edge
+     * @param minLongitude Western edge
+     * @param maxLatitude Northern edge
+     * @param maxLongitude Eastern edge (less than minLongitude for a box across the antimeridian)
+     * @return UAV ids; a superset of the UAVs inside the box, to be filtered exactly by the caller
+     */
+    [[nodiscard]] std::vector<uint16_t> candidates(double minLatitude,
+                                                   double minLongitude,
+                                                   double maxLatitude,
+                                                   double maxLongitude) const;
+
+   private:
+    /**
+     * @brief Get the grid row of a latitude (clamped to the grid)
+     */
+    [[nodiscard]] int64_t rowOf(double latitude) const;
+
+    /**
+     * @brief Get the grid column of a longitude (clamped to the grid)
+     */
+    [[nodiscard]] int64_t columnOf(double longitude) const;
+
+    /**
+     * @brief Combine a row and a column into a cell key
+     */
+    [[nodiscard]] int64_t keyOf(int64_t row, int64_t column) const {
+        return row * columns_ + column;
+    }
+
+    static constexpr int64_t NO_CELL = -1;  ///< cellOf_ value of ids not in the grid
+
+    double cellDegrees_;                                        ///< Cell edge length in degrees
+    int64_t rows_;                                              ///< Cells from the south to the north pole
+    int64_t columns_;                                           ///< Cells around the globe
+    std::unordered_map<int64_t, std::vector<uint16_t>> cells_;  ///< Occupied cell key -> UAV ids in the cell
+    std::vector<int64_t> cellOf_;                               ///< UAV id -> cell key (NO_CELL if absent)
+};
+
+#endif  // SPATIALGRID_H
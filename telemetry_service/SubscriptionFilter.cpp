@@ -0,0 +1,468 @@
+/**
+ * @file SubscriptionFilter.cpp
+ * @brief Implementation of the subscription predicate compiler and evaluator
+ */
+
+#include "SubscriptionFilter.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstddef>
+#include <cstring>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+
+#include "TelemetryPackets.h"
+
+namespace {
+    constexpr uint16_t PAYLOAD = sizeof(PacketHeader);
+
+    // offsetof on the packed payload structs; the payload follows the 2-byte header
+    const PacketField FIELDS[] = {
+        {"latitude", PacketTypes::LOCATION, PAYLOAD + offsetof(LocationPayload, latitude), 8, true},
+        {"longitude", PacketTypes::LOCATION, PAYLOAD + offsetof(LocationPayload, longitude), 8, true},
+        {"altitude", PacketTypes::LOCATION, PAYLOAD + offsetof(LocationPayload, altitude), 4, true},
+        {"heading", PacketTypes::LOCATION, PAYLOAD + offsetof(LocationPayload, heading), 4, true},
+        {"speed", PacketTypes::LOCATION, PAYLOAD + offsetof(LocationPayload, speed), 4, true},
+        {"systemHealth", PacketTypes::STATUS, PAYLOAD + offsetof(StatusPayload, systemHealth), 1, false},
+        {"missionState", PacketTypes::STATUS, PAYLOAD + offsetof(StatusPayload, missionState), 1, false},
+        {"flightTime", PacketTypes::STATUS, PAYLOAD + offsetof(StatusPayload, flightTime), 2, false},
+        {"cpuUsage", PacketTypes::STATUS, PAYLOAD + offsetof(StatusPayload, cpuUsage), 4, true},
+        {"memoryUsage", PacketTypes::STATUS, PAYLOAD + offsetof(StatusPayload, memoryUsage), 4, true},
+    };
+
+    constexpr size_t MAX_EXPRESSION_LENGTH = 512;  ///< Longer expressions are rejected
+}  // namespace
+
+/**
+ * @brief Look up a field by name
+ * @param name Field name
+ * @return The field, or nullptr if there is no such field
+ */
+const PacketField* PacketField::find(std::string_view name) {
+    for (const auto& field : FIELDS) {
+        if (name == field.name) {
+            return &field;
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Read the field from a packet
+ * @param packet Packet as received (PacketHeader + payload)
+ * @param value Set to the field's value
+ * @return false if the packet is of another type or too short
+ */
+bool PacketField::read(const std::vector<uint8_t>& packet, double& value) const {
+    if (packet.size() < static_cast<size_t>(offset) + size
+        || packet[offsetof(PacketHeader, packetType)] != packetType) {
+        return false;
+    }
+    const uint8_t* bytes = packet.data() + offset;
+    if (floating && size == 8) {
+        double raw;
+        std::memcpy(&raw, bytes, sizeof(raw));
+        value = raw;
+    } else if (floating) {
+        float raw;
+        std::memcpy(&raw, bytes, sizeof(raw));
+        value = raw;
+    } else if (size == 2) {
+        uint16_t raw;
+        std::memcpy(&raw, bytes, sizeof(raw));
+        value = raw;
+    } else {
+        value = bytes[0];
+    }
+    return true;
+}
+
+/**
+ * @class PredicateCompiler
+ * @brief Recursive-descent parser emitting PacketPredicate instructions
+ */
+class PredicateCompiler {
+   public:
+    /**
+     * @brief Constructor
+     * @param predicate Predicate to fill in (its text_ holds the expression)
+     */
+    explicit PredicateCompiler(PacketPredicate& predicate) : predicate_(predicate), text_(predicate.text_) {}
+
+    /**
+     * @brief Compile the whole expression
+     * @throws std::runtime_error on syntax errors
+     */
+    void run() {
+        parseOr();
+        skipSpaces();
+        if (pos_ != text_.size()) {
+            fail("unexpected '" + std::string(1, text_[pos_]) + "'");
+        }
+        predicate_.stackDepth_ = maxDepth_;
+    }
+
+   private:
+    using Op = PacketPredicate::Op;
+
+    /**
+     * @brief expr := term ("or" term)*
+     */
+    void parseOr() {
+        parseAnd();
+        while (acceptKeyword("or")) {
+            parseAnd();
+            emit(Op::OR);
+        }
+    }
+
+    /**
+     * @brief term := factor ("and" factor)*
+     */
+    void parseAnd() {
+        parseFactor();
+        while (acceptKeyword("and")) {
+            parseFactor();
+            emit(Op::AND);
+        }
+    }
+
+    /**
+     * @brief factor := "not" factor | "(" expr ")" | comparison
+     */
+    void parseFactor() {
+        if (++nesting_ > 32) {
+            fail("expression nested too deeply");
+        }
+        skipSpaces();
+        if (acceptKeyword("not")) {
+            parseFactor();
+            emit(Op::NOT);
+        } else if (accept("(")) {
+            parseOr();
+            if (!accept(")")) {
+                fail("expected ')'");
+            }
+        } else {
+            parseOperand();
+            Op comparison = parseComparisonOperator();
+            parseOperand();
+            emit(comparison);
+        }
+        --nesting_;
+    }
+
+    /**
+     * @brief comparison operator
+     */
+    Op parseComparisonOperator() {
+        skipSpaces();
+        // Two-character operators first, so "<=" is not read as "<"
+        static const std::pair<std::string_view, Op> operators[] = {
+            {"<=", Op::LE}, {">=", Op::GE}, {"==", Op::EQ}, {"!=", Op::NE}, {"<", Op::LT}, {">", Op::GT}};
+        for (const auto& [symbol, op] : operators) {
+            if (accept(symbol)) {
+                return op;
+            }
+        }
+        fail("expected a comparison (<, <=, >, >=, ==, !=)");
+    }
+
+    /**
+     * @brief operand := field | number
+     */
+    void parseOperand() {
+        skipSpaces();
+        size_t start = pos_;
+        if (pos_ < text_.size() && (std::isalpha(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_')) {
+            while (pos_ < text_.size()
+                   && (std::isalnum(static_cast<unsigned char>(text_[pos_])) || text_[pos_] == '_')) {
+                ++pos_;
+            }
+            emitField(text_.substr(start, pos_ - start), start);
+            return;
+        }
+
+        size_t used = 0;
+        double value = 0;
+        try {
+            value = std::stod(text_.substr(pos_), &used);
+        } catch (const std::exception&) {
+            fail("expected a field name or a number");
+        }
+        pos_ += used;
+        PacketPredicate::Instruction instruction{Op::CONSTANT, 0, value};
+        push(instruction, 1);
+    }
+
+    /**
+     * @brief Emit the load instruction of a named field
+     */
+    void emitField(const std::string& name, size_t at) {
+        const PacketField* field = PacketField::find(name);
+        if (!field) {
+            pos_ = at;
+            fail("unknown field '" + name + "'");
+        }
+        if (predicate_.packetType_ != 0 && predicate_.packetType_ != field->packetType) {
+            pos_ = at;
+            fail("'" + name + "' belongs to another packet type than the fields before it");
+        }
+        predicate_.packetType_ = field->packetType;
+        predicate_.minSize_ = std::max(predicate_.minSize_, static_cast<size_t>(field->offset + field->size));
+        Op op = field->floating ? (field->size == 8 ? Op::LOAD_F64 : Op::LOAD_F32)
+                                : (field->size == 2 ? Op::LOAD_U16 : Op::LOAD_U8);
+        push(PacketPredicate::Instruction{op, field->offset, 0}, 1);
+    }
+
+    /**
+     * @brief Emit an operator instruction (binary operators pop two values and push one)
+     */
+    void emit(Op op) {
+        push(PacketPredicate::Instruction{op, 0, 0}, op == Op::NOT ? 0 : -1);
+    }
+
+    /**
+     * @brief Append an instruction and track the stack depth
+     */
+    void push(const PacketPredicate::Instruction& instruction, int depthChange) {
+        predicate_.program_.push_back(instruction);
+        depth_ += depthChange;
+        maxDepth_ = std::max(maxDepth_, static_cast<size_t>(depth_));
+    }
+
+    /**
+     * @brief Consume a symbol if it comes next
+     */
+    bool accept(std::string_view symbol) {
+        skipSpaces();
+        if (text_.compare(pos_, symbol.size(), symbol) == 0) {
+            pos_ += symbol.size();
+            return true;
+        }
+        return false;
+    }
+
+    /**
+     * @brief Consume a keyword if it comes next as a whole word
+     */
+    bool acceptKeyword(std::string_view keyword) {
+        skipSpaces();
+        size_t end = pos_ + keyword.size();
+        if (text_.compare(pos_, keyword.size(), keyword) != 0
+            || (end < text_.size() && (std::isalnum(static_cast<unsigned char>(text_[end])) || text_[end] == '_'))) {
+            return false;
+        }
+        pos_ = end;
+        return true;
+    }
+
+    /**
+     * @brief Skip whitespace
+     */
+    void skipSpaces() {
+        while (pos_ < text_.size() && std::isspace(static_cast<unsigned char>(text_[pos_]))) {
+            ++pos_;
+        }
+    }
+
+    /**
+     * @brief Throw a syntax error pointing at the current position
+     */
+    [[noreturn]] void fail(const std::string& what) const {
+        throw std::runtime_error("Invalid filter at position " + std::to_string(pos_) + ": " + what);
+    }
+
+    PacketPredicate& predicate_;  ///< Predicate being compiled
+    const std::string& text_;     ///< Expression text
+    size_t pos_{0};               ///< Parse position
+    int depth_{0};                ///< Stack depth after the instructions emitted so far
+    size_t maxDepth_{0};          ///< Deepest stack reached
+    int nesting_{0};              ///< Current factor nesting
+};
+
+/**
+ * @brief Compile an expression
+ * @param expression Expression text
+ * @return Compiled predicate
+ * @throws std::runtime_error if the expression is invalid
+ */
+PacketPredicate PacketPredicate::compile(const std::string& expression) {
+    if (expression.size() > MAX_EXPRESSION_LENGTH) {
+        throw std::runtime_error("Invalid filter: longer than " + std::to_string(MAX_EXPRESSION_LENGTH)
+                                 + " characters");
+    }
+    PacketPredicate predicate;
+    predicate.text_ = expression;
+    PredicateCompiler(predicate).run();
+    return predicate;
+}
+
+/**
+ * @brief Evaluate the predicate on a packet
+ * @param packet Packet as received (PacketHeader + payload)
+ * @return true if the packet matches
+ *
+ * Values are widened to double on load, which is exact for every field type.
+ * Comparisons push 1 or 0; "and", "or" and "not" combine those.
+ */
+bool PacketPredicate::matches(const std::vector<uint8_t>& packet) const {
+    if (program_.empty()) {
+        return true;
+    }
+    if (packet.size() < minSize_ || packet.size() < sizeof(PacketHeader)
+        || (packetType_ != 0 && packet[offsetof(PacketHeader, packetType)] != packetType_)) {
+        return false;
+    }
+
+    constexpr size_t INLINE_STACK = 16;
+    double inline_stack[INLINE_STACK];
+    std::vector<double> heap_stack;
+    double* stack = inline_stack;
+    if (stackDepth_ > INLINE_STACK) {
+        heap_stack.resize(stackDepth_);
+        stack = heap_stack.data();
+    }
+
+    const uint8_t* bytes = packet.data();
+    size_t top = 0;  // Number of values on the stack
+    for (const Instruction& instruction : program_) {
+        switch (instruction.op) {
+            case Op::LOAD_U8:
+                stack[top++] = bytes[instruction.offset];
+                break;
+            case Op::LOAD_U16: {
+                uint16_t value;
+                std::memcpy(&value, bytes + instruction.offset, sizeof(value));
+                stack[top++] = value;
+                break;
+            }
+            case Op::LOAD_F32: {
+                float value;
+                std::memcpy(&value, bytes + instruction.offset, sizeof(value));
+                stack[top++] = value;
+                break;
+            }
+            case Op::LOAD_F64: {
+                double value;
+                std::memcpy(&value, bytes + instruction.offset, sizeof(value));
+                stack[top++] = value;
+                break;
+            }
+            case Op::CONSTANT:
+                stack[top++] = instruction.constant;
+                break;
+            case Op::LT:
+                --top;
+                stack[top - 1] = stack[top - 1] < stack[top] ? 1.0 : 0.0;
+                break;
+            case Op::LE:
+                --top;
+                stack[top - 1] = stack[top - 1] <= stack[top] ? 1.0 : 0.0;
+                break;
+            case Op::GT:
+                --top;
+                stack[top - 1] = stack[top - 1] > stack[top] ? 1.0 : 0.0;
+                break;
+            case Op::GE:
+                --top;
+                stack[top - 1] = stack[top - 1] >= stack[top] ? 1.0 : 0.0;
+                break;
+            case Op::EQ:
+                --top;
+                stack[top - 1] = stack[top - 1] == stack[top] ? 1.0 : 0.0;
+                break;
+            case Op::NE:
+                --top;
+                stack[top - 1] = stack[top - 1] != stack[top] ? 1.0 : 0.0;
+                break;
+            case Op::AND:
+                --top;
+                stack[top - 1] = (stack[top - 1] != 0.0 && stack[top] != 0.0) ? 1.0 : 0.0;
+                break;
+            case Op::OR:
+                --top;
+                stack[top - 1] = (stack[top - 1] != 0.0 || stack[top] != 0.0) ? 1.0 : 0.0;
+                break;
+            case Op::NOT:
+                stack[top - 1] = stack[top - 1] == 0.0 ? 1.0 : 0.0;
+                break;
+        }
+    }
+    return stack[0] != 0.0;
+}
+
+/**
+ * @brief Split and compile a subscription string
+ * @param subscription "<pattern>" or "<pattern>?<expression>"
+ * @return Parsed filter
+ * @throws std::runtime_error if the expression is invalid
+ */
+SubscriptionFilter SubscriptionFilter::parse(const std::string& subscription) {
+    SubscriptionFilter filter;
+    std::string rest = subscription;
+    size_t at = rest.rfind('@');
+    if (at != std::string::npos) {
+        filter.derivedSuffix = rest.substr(at);
+        rest.resize(at);
+    }
+    size_t question = rest.find('?');
+    if (question == std::string::npos) {
+        filter.pattern = rest;
+        return filter;
+    }
+    filter.pattern = rest.substr(0, question);
+    filter.predicate = PacketPredicate::compile(rest.substr(question + 1));
+    return filter;
+}
+
+/**
+ * @brief Test a published packet against the filter
+ * @param topic Topic the packet is published on
+ * @param packet Packet as published
+ */
+bool SubscriptionFilter::matches(const std::string& topic, const std::vector<uint8_t>& packet) const {
+    return derivedSuffix.empty() && topic.find('@') == std::string::npos && topicMatchesPattern(pattern, topic)
+           && predicate.matches(packet);
+}
+
+/**
+ * @brief Match a topic against a subscription pattern
+ * @param pattern Subscription pattern
+ * @param topic Published topic
+ * @return true if the topic matches
+ *
+ * Compares segment by segment in place, without splitting either string.
+ */
+bool topicMatchesPattern(const std::string& pattern, const std::string& topic) {
+    if (pattern == topic) {
+        return true;
+    }
+    // "telemetry.*" is a prefix match, as used by --all-targets
+    if (pattern == "telemetry.*") {
+        return topic.rfind("telemetry.", 0) == 0;
+    }
+    if (pattern.find('*') == std::string::npos) {
+        return false;
+    }
+
+    std::string_view pattern_rest(pattern);
+    std::string_view topic_rest(topic);
+    while (true) {
+        size_t pattern_dot = pattern_rest.find('.');
+        size_t topic_dot = topic_rest.find('.');
+        std::string_view pattern_part = pattern_rest.substr(0, pattern_dot);
+        std::string_view topic_part = topic_rest.substr(0, topic_dot);
+        if (pattern_part != "*" && pattern_part != topic_part) {
+            return false;
+        }
+        // Both must run out of segments together
+        if (pattern_dot == std::string_view::npos || topic_dot == std::string_view::npos) {
+            return pattern_dot == topic_dot;
+        }
+        pattern_rest.remove_prefix(pattern_dot + 1);
+        topic_rest.remove_prefix(topic_dot + 1);
+    }
+}
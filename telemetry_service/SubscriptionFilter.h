@@ -0,0 +1,163 @@
+/**
+ * @file SubscriptionFilter.h
+ * @brief Content-based subscription filters ("<pattern>?<expression>")
+ *
+ * This file defines the PacketPredicate class, a small boolean expression over
+ * the typed fields of location and status payloads, compiled once into a
+ * bytecode program; and SubscriptionFilter, which pairs a predicate with a
+ * topic pattern. The publishing paths evaluate the filters, so only packets a
+ * subscriber asked for are sent to it.
+ */
+
+#ifndef SUBSCRIPTIONFILTER_H
+#define SUBSCRIPTIONFILTER_H
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/**
+ * @struct PacketField
+ * @brief Named numeric field of a location or status payload
+ */
+struct PacketField {
+    const char* name;    ///< Field name in expressions and stream specs
+    uint8_t packetType;  ///< Packet type carrying the field
+    uint16_t offset;     ///< Byte offset from the start of the packet
+    uint8_t size;        ///< Field size in bytes
+    bool floating;       ///< Float/double (true) or unsigned integer (false)
+
+    /**
+     * @brief Look up a field by name
+     * @param name Field name (e.g. "cpuUsage")
+     * @return The field, or nullptr if there is no such field
+     */
+    static const PacketField* find(std::string_view name);
+
+    /**
+     * @brief Read the field from a packet
+     * @param packet Packet as received (PacketHeader + payload)
+     * @param value Set to the field's value
+     * @return false if the packet is of another type or too short
+     */
+    bool read(const std::vector<uint8_t>& packet, double& value) const;
+};
+
+/**
+ * @class PacketPredicate
+ * @brief Compiled boolean expression over one packet's payload fields
+ *
+ * Grammar (keywords are case-sensitive):
+ * @code
+ *   expr       := term ("or" term)*
+ *   term       := factor ("and" factor)*
+ *   factor     := "not" factor | "(" expr ")" | comparison
+ *   comparison := operand ("<" | "<=" | ">" | ">=" | "==" | "!=") operand
+ *   operand    := field | number
+ * @endcode
+ * Fields are the members of LocationPayload (latitude, longitude, altitude,
+ * heading, speed) or of StatusPayload (systemHealth, missionState, flightTime,
+ * cpuUsage, memoryUsage); one expression may not mix the two. A packet of the
+ * other type, or too short, never matches.
+ *
+ * The expression is compiled to postfix instructions that read fields at
+ * fixed offsets, so evaluation is a short loop without allocation or string
+ * handling. Immutable after compilation.
+ */
+class PacketPredicate {
+   public:
+    /**
+     * @brief Constructor - the empty predicate, which matches every packet
+     */
+    PacketPredicate() = default;
+
+    /**
+     * @brief Compile an expression
+     * @param expression Expression text, e.g. "systemHealth <= 1 or cpuUsage > 90"
+     * @return Compiled predicate
+     * @throws std::runtime_error with the position of the problem if the expression is invalid
+     */
+    static PacketPredicate compile(const std::string& expression);
+
+    /**
+     * @brief Evaluate the predicate on a packet
+     * @param packet Packet as received (PacketHeader + payload)
+     * @return true if the packet matches
+     */
+    [[nodiscard]] bool matches(const std::vector<uint8_t>& packet) const;
+
+    /**
+     * @brief Get the expression the predicate was compiled from ("" for the empty predicate)
+     */
+    [[nodiscard]] const std::string& text() const {
+        return text_;
+    }
+
+   private:
+    /// Instruction opcodes
+    enum class Op : uint8_t { LOAD_U8, LOAD_U16, LOAD_F32, LOAD_F64, CONSTANT, LT, LE, GT, GE, EQ, NE, AND, OR, NOT };
+
+    /**
+     * @struct Instruction
+     * @brief One postfix instruction
+     */
+    struct Instruction {
+        Op op;            ///< Operation
+        uint16_t offset;  ///< Byte offset into the packet (LOAD_*)
+        double constant;  ///< Value (CONSTANT)
+    };
+
+    friend class PredicateCompiler;
+
+    std::string text_;                  ///< Source expression
+    std::vector<Instruction> program_;  ///< Postfix program (empty = always true)
+    uint8_t packetType_{0};             ///< Packet type the fields belong to (0 = any)
+    size_t minSize_{0};                 ///< Smallest packet holding every field read
+    size_t stackDepth_{0};              ///< Evaluation stack size the program needs
+};
+
+/**
+ * @struct SubscriptionFilter
+ * @brief Topic pattern with an optional payload predicate and derived-stream suffix
+ *
+ * A subscription ending in "@<spec>" (e.g. "@1Hz") asks for a stream the
+ * service derives from the matching packets (see DerivedStreams). Derived
+ * packets are published on "<source topic>@<spec>" and delivered by their
+ * subscription string, not by matches(): a derived filter never matches a
+ * published packet, and a plain filter never matches a derived topic.
+ */
+struct SubscriptionFilter {
+    std::string pattern;        ///< Topic pattern (wildcard syntax of the subscriptions)
+    PacketPredicate predicate;  ///< Payload predicate (empty: topic match only)
+    std::string derivedSuffix;  ///< "@<spec>" of a derived stream ("" for plain subscriptions)
+
+    /**
+     * @brief Split and compile a subscription string
+     * @param subscription "<pattern>[?<expression>][@<spec>]"
+     * @return Parsed filter (the stream spec itself is validated by DerivedStreams)
+     * @throws std::runtime_error if the expression is invalid
+     */
+    static SubscriptionFilter parse(const std::string& subscription);
+
+    /**
+     * @brief Test a published packet against the filter
+     * @param topic Topic the packet is published on
+     * @param packet Packet as published
+     *
+     * Always false for derived streams, whose messages go to the subscribers
+     * of their stream only.
+     */
+    [[nodiscard]] bool matches(const std::string& topic, const std::vector<uint8_t>& packet) const;
+};
+
+/**
+ * @brief Match a topic against a subscription pattern
+ * @param pattern Exact topic, "telemetry.*" (any telemetry topic) or a dotted pattern where
+ *                "*" matches one whole segment
+ * @param topic Published topic
+ * @return true if the topic matches
+ */
+bool topicMatchesPattern(const std::string& pattern, const std::string& topic);
+
+#endif  // SUBSCRIPTIONFILTER_H
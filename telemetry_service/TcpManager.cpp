@@ -9,19 +9,35 @@
 
 #include "TcpManager.h"
 
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
 #include <vector>
 
 #include "Logger.h"
 #include "TelemetryPackets.h"
 
+namespace {
+    // Time a UAV has to acknowledge a tracked command before the client is told TIMEOUT
+    constexpr std::chrono::milliseconds command_ack_timeout{2000};
+}  // namespace
+
 /**
  * @brief Constructor - initializes TCP manager with configuration and callback
  * @param ctx ZeroMQ context for socket creation
- * @param cfg Configuration containing UAV and port settings
+ * @param cfg Configuration snapshot containing UAV and port settings
  * @param callback Function to call when telemetry messages are received
+ * @param adminCallback Function to call for "ADMIN:" commands (may be empty)
  */
-TcpManager::TcpManager(zmq::context_t& ctx, const Config& cfg, TcpMessageCallback callback)
-    : context(ctx), config(cfg), messageCallback_(std::move(callback)) {}
+TcpManager::TcpManager(zmq::context_t& ctx,
+                       const Snapshot<Config>& cfg,
+                       TcpMessageCallback callback,
+                       TcpAdminCallback adminCallback)
+    : context(ctx),
+      config(cfg),
+      messageCallback_(std::move(callback)),
+      adminCallback_(std::move(adminCallback)),
+      commandTracker_(command_ack_timeout) {}
 
 /**
  * @brief Destructor - ensures clean shutdown
@@ -31,11 +47,12 @@ TcpManager::~TcpManager() {
     join();
 
     // Explicit socket cleanup for ZMQ
-    std::lock_guard<std::mutex> lock(socketMutex);
+    std::scoped_lock lock(socketMutex, publishMutex, commandMutex);
     pubToUi.reset();
     pullFromUi.reset();
-    uavTelemetrySockets.clear();
-    uavCommandSockets.clear();
+    routingTable.store(std::make_shared<const RoutingTable>());
+    sharedTelemetrySocket.reset();
+    sharedCommandSocket.reset();
 }
 
 /**
@@ -44,52 +61,57 @@ TcpManager::~TcpManager() {
  * This method:
  * 1. Creates and binds all necessary ZMQ sockets
  * 2. Sets up UI communication (PUB/PULL sockets)
- * 3. Sets up UAV communication (PULL/PUSH sockets for each UAV)
- * 4. Starts background threads for message processing
+ * 3. Sets up shared ingest ROUTER sockets if configured
+ * 4. Sets up UAV communication (PULL/PUSH sockets for each UAV with dedicated ports)
+ * 5. Starts background threads for message processing
  */
 void TcpManager::start() {
     running = true;
 
     try {
-        std::lock_guard<std::mutex> lock(socketMutex);
+        std::scoped_lock lock(socketMutex, publishMutex, commandMutex);
+        auto cfg = config.load();
 
         // Set up UI communication sockets
         // PUB socket for publishing telemetry data to UI subscribers
         pubToUi = std::make_unique<zmq::socket_t>(context, zmq::socket_type::pub);
-        std::string ui_pub_addr = "tcp://*:" + std::to_string(config.getUiPorts().tcp_publish_port);
+        std::string ui_pub_addr = "tcp://*:" + std::to_string(cfg->getUiPorts().tcp_publish_port);
         pubToUi->bind(ui_pub_addr);
         Logger::statusWithDetails("TCP", StatusMessage("UI Publisher bound"), DetailMessage(ui_pub_addr));
 
         // PULL socket for receiving commands from UI components
         pullFromUi = std::make_unique<zmq::socket_t>(context, zmq::socket_type::pull);
-        std::string ui_cmd_addr = "tcp://*:" + std::to_string(config.getUiPorts().tcp_command_port);
+        std::string ui_cmd_addr = "tcp://*:" + std::to_string(cfg->getUiPorts().tcp_command_port);
         pullFromUi->bind(ui_cmd_addr);
         Logger::statusWithDetails("TCP", StatusMessage("UI Command receiver bound"), DetailMessage(ui_cmd_addr));
 
+        // Set up shared ingest endpoints (one ROUTER per channel serves the whole fleet)
+        const auto& shared = cfg->getSharedIngest();
+        if (shared.tcp_telemetry_port > 0) {
+            sharedTelemetrySocket = std::make_unique<zmq::socket_t>(context, zmq::socket_type::router);
+            sharedTelemetrySocket->set(zmq::sockopt::router_handover, 1);  // Reconnecting UAV replaces stale peer
+            std::string shared_telemetry_addr = "tcp://*:" + std::to_string(shared.tcp_telemetry_port);
+            sharedTelemetrySocket->bind(shared_telemetry_addr);
+            Logger::statusWithDetails(
+                "TCP", StatusMessage("Shared telemetry ROUTER bound"), DetailMessage(shared_telemetry_addr));
+        }
+        if (shared.tcp_command_port > 0) {
+            sharedCommandSocket = std::make_unique<zmq::socket_t>(context, zmq::socket_type::router);
+            sharedCommandSocket->set(zmq::sockopt::router_handover, 1);
+            sharedCommandSocket->set(zmq::sockopt::router_mandatory, 1);  // Report unknown UAVs instead of dropping
+            std::string shared_command_addr = "tcp://*:" + std::to_string(shared.tcp_command_port);
+            sharedCommandSocket->bind(shared_command_addr);
+            Logger::statusWithDetails(
+                "TCP", StatusMessage("Shared command ROUTER bound"), DetailMessage(shared_command_addr));
+        }
+
         // Set up UAV communication sockets for each configured UAV
-        for (const auto& uav : config.getUAVs()) {
-            // PULL socket for receiving telemetry data from UAV
-            auto pull_socket = std::make_unique<zmq::socket_t>(context, zmq::socket_type::pull);
-            std::string telemetry_addr = "tcp://*:" + std::to_string(uav.tcp_telemetry_port);
-            pull_socket->bind(telemetry_addr);
-            uavTelemetrySockets.push_back(std::move(pull_socket));
-
-            // PUSH socket for sending commands to UAV
-            auto push_socket = std::make_unique<zmq::socket_t>(context, zmq::socket_type::push);
-            std::string command_addr = "tcp://*:" + std::to_string(uav.tcp_command_port);
-            push_socket->bind(command_addr);
-            uavCommandSockets.push_back(std::move(push_socket));
-
-            std::string config_msg;
-            config_msg.reserve(50 + telemetry_addr.size() + command_addr.size());
-            config_msg += "Telemetry: ";
-            config_msg += telemetry_addr;
-            config_msg += ", Commands: ";
-            config_msg += command_addr;
-
-            std::string uav_msg = "UAV " + uav.name + " configured";
-            Logger::statusWithDetails("TCP", StatusMessage(uav_msg), DetailMessage(config_msg));
+        std::vector<std::shared_ptr<const UavRoute>> routes;
+        routes.reserve(cfg->getUAVs().size());
+        for (const auto& uav : cfg->getUAVs()) {
+            routes.push_back(createRoute(uav));
         }
+        routingTable.store(buildRoutingTable(std::move(routes), cfg->getGroups()));
     } catch (const zmq::error_t& e) {
         Logger::error("TCP socket setup failed: " + std::string(e.what()));
         running = false;
@@ -127,23 +149,212 @@ void TcpManager::join() {
         forwarderThread.join();
 }
 
+/**
+ * @brief Helper to create the dedicated sockets for one UAV
+ * @param uav UAV configuration
+ * @return New route (sockets are null for channels served by shared ingest)
+ */
+std::shared_ptr<const TcpManager::UavRoute> TcpManager::createRoute(const UAVConfig& uav) {
+    auto route = std::make_shared<UavRoute>();
+    route->uav = uav;
+
+    // PULL socket for receiving telemetry data from UAV (none when it uses the shared ROUTER)
+    std::string telemetry_addr = "shared";
+    if (uav.tcp_telemetry_port > 0) {
+        route->telemetrySocket = std::make_shared<zmq::socket_t>(context, zmq::socket_type::pull);
+        route->telemetrySocket->set(zmq::sockopt::linger, 0);
+        telemetry_addr = "tcp://*:" + std::to_string(uav.tcp_telemetry_port);
+        route->telemetrySocket->bind(telemetry_addr);
+    }
+
+    // PUSH socket for sending commands to UAV (none when it uses the shared ROUTER)
+    std::string command_addr = "shared";
+    if (uav.tcp_command_port > 0) {
+        route->commandSocket = std::make_shared<zmq::socket_t>(context, zmq::socket_type::push);
+        route->commandSocket->set(zmq::sockopt::linger, 0);
+        command_addr = "tcp://*:" + std::to_string(uav.tcp_command_port);
+        route->commandSocket->bind(command_addr);
+    }
+
+    std::string config_msg;
+    config_msg.reserve(50 + telemetry_addr.size() + command_addr.size());
+    config_msg += "Telemetry: ";
+    config_msg += telemetry_addr;
+    config_msg += ", Commands: ";
+    config_msg += command_addr;
+
+    std::string uav_msg = "UAV " + uav.name + " configured";
+    Logger::statusWithDetails("TCP", StatusMessage(uav_msg), DetailMessage(config_msg));
+    return route;
+}
+
+/**
+ * @brief Helper to build an immutable routing table from a list of routes
+ * @param routes Routes to include
+ * @param groups Configured groups (members without a route are left out)
+ * @return New routing table with its name and selector indexes filled in
+ *
+ * Group and tag selectors are expanded here, when the table changes, rather than
+ * per command. A UAV listed twice in a group is only addressed once.
+ */
+std::shared_ptr<const TcpManager::RoutingTable> TcpManager::buildRoutingTable(
+    std::vector<std::shared_ptr<const UavRoute>> routes,
+    const std::map<std::string, std::vector<std::string>>& groups) {
+    auto table = std::make_shared<RoutingTable>();
+    table->routes = std::move(routes);
+    table->indexByName.reserve(table->routes.size());
+    table->allIndices.reserve(table->routes.size());
+    for (size_t i = 0; i < table->routes.size(); ++i) {
+        table->indexByName.emplace(table->routes[i]->uav.name, i);
+        table->allIndices.push_back(i);
+        for (const auto& tag : table->routes[i]->uav.tags) {
+            auto& tagged = table->tagIndices[tag];
+            if (tagged.empty() || tagged.back() != i) {
+                tagged.push_back(i);
+            }
+        }
+    }
+
+    for (const auto& [group_name, members] : groups) {
+        auto& indices = table->groupIndices[group_name];
+        for (const auto& member : members) {
+            auto uav_it = table->indexByName.find(member);
+            if (uav_it != table->indexByName.end()
+                && std::find(indices.begin(), indices.end(), uav_it->second) == indices.end()) {
+                indices.push_back(uav_it->second);
+            }
+        }
+    }
+    return table;
+}
+
+/**
+ * @brief Bind the dedicated sockets for a UAV and add it to the routing table
+ * @param uav UAV to add
+ *
+ * Sockets are bound before the new table is published, so by the time any
+ * thread can see the UAV its endpoints are ready. Threads holding the previous
+ * snapshot keep working on it undisturbed.
+ */
+void TcpManager::addUav(const UAVConfig& uav) {
+    std::lock_guard<std::mutex> lock(registrationMutex);
+    auto current = routingTable.load();
+    if (current->indexByName.count(uav.name) != 0) {
+        throw std::runtime_error("UAV " + uav.name + " is already registered");
+    }
+
+    auto routes = current->routes;
+    routes.push_back(createRoute(uav));
+    routingTable.store(buildRoutingTable(std::move(routes), config.load()->getGroups()));
+}
+
+/**
+ * @brief Remove a UAV from the routing table
+ * @param name UAV name
+ * @return true if the UAV was routed
+ *
+ * The UAV disappears from lookups as soon as the new table is published. Its
+ * sockets are owned by the route and close when the last snapshot holding it
+ * is dropped: the receiver and forwarder threads both refresh their snapshot
+ * every poll cycle, so within about 100 ms the port can be bound again.
+ */
+bool TcpManager::removeUav(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registrationMutex);
+    auto current = routingTable.load();
+    auto uav_it = current->indexByName.find(name);
+    if (uav_it == current->indexByName.end()) {
+        return false;
+    }
+
+    auto routes = current->routes;
+    routes.erase(routes.begin() + static_cast<std::ptrdiff_t>(uav_it->second));
+    routingTable.store(buildRoutingTable(std::move(routes), config.load()->getGroups()));
+    Logger::statusWithDetails("TCP", StatusMessage("UAV " + name + " removed"), DetailMessage("routing table updated"));
+    return true;
+}
+
+/**
+ * @brief Replace the settings of routed UAVs whose sockets stay as they are
+ * @param uavs New settings (same names and ports)
+ */
+void TcpManager::updateUavs(const std::vector<UAVConfig>& uavs) {
+    std::lock_guard<std::mutex> lock(registrationMutex);
+    auto current = routingTable.load();
+    auto routes = current->routes;
+    for (const auto& uav : uavs) {
+        auto uav_it = current->indexByName.find(uav.name);
+        if (uav_it == current->indexByName.end()) {
+            continue;
+        }
+        auto route = std::make_shared<UavRoute>(*routes[uav_it->second]);
+        route->uav = uav;
+        routes[uav_it->second] = std::move(route);
+    }
+    routingTable.store(buildRoutingTable(std::move(routes), config.load()->getGroups()));
+    Logger::statusWithDetails("TCP",
+                              StatusMessage("UAV settings updated"),
+                              DetailMessage(std::to_string(uavs.size()) + " UAVs, sockets kept"));
+}
+
+/**
+ * @brief Rebuild the group index after the configured groups changed
+ *
+ * Publishes a new table over the same routes, so no socket is touched.
+ */
+void TcpManager::refreshGroups() {
+    std::lock_guard<std::mutex> lock(registrationMutex);
+    auto current = routingTable.load();
+    auto groups_config = config.load();
+    routingTable.store(buildRoutingTable(current->routes, groups_config->getGroups()));
+    Logger::statusWithDetails("TCP",
+                              StatusMessage("Command groups updated"),
+                              DetailMessage(std::to_string(groups_config->getGroups().size()) + " groups"));
+}
+
 /**
  * @brief Publish telemetry data to UI subscribers
  * @param topic The topic to publish on (e.g., "telemetry.UAV_1.camera.location" or "telemetry.UAV_2.mapping.status")
  * @param data The telemetry data to send
+ * @param stream Derived-stream subscription the message belongs to ("" for telemetry packets)
  *
  * Uses ZMQ multipart messaging: first frame is topic, second frame is data.
  * UI components subscribe to specific topics to receive relevant data.
  * ZMQ handles subscription filtering automatically based on topic prefixes.
- * Thread-safe through mutex protection.
+ * Content-based filters are evaluated before the lock is taken; the packet is
+ * sent once more on the prefixed topic of every filter it passes. Derived-stream
+ * messages are sent only on the filter topics registered with exactly their
+ * subscription string.
+ * Thread-safe through mutex protection; only the send itself holds the lock.
  */
-void TcpManager::publishTelemetry(const std::string& topic, const std::vector<uint8_t>& data) {
+void TcpManager::publishTelemetry(const std::string& topic,
+                                  const std::vector<uint8_t>& data,
+                                  const std::string& stream) {
     try {
-        std::lock_guard<std::mutex> lock(socketMutex);
-        if (pubToUi && running) {
-            pubToUi->send(zmq::buffer(topic), zmq::send_flags::sndmore);
-            pubToUi->send(zmq::buffer(data.data(), data.size()), zmq::send_flags::none);
+        std::vector<std::string> filtered_topics;
+        auto filters = filters_.load();
+        for (const auto& filter : *filters) {
+            if (stream.empty() ? filter.filter.matches(topic, data) : filter.subscription == stream) {
+                filtered_topics.push_back(filter.topicPrefix + topic);
+            }
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(publishMutex);
+            if (!pubToUi || !running) {
+                return;
+            }
+            if (stream.empty()) {
+                pubToUi->send(zmq::buffer(topic), zmq::send_flags::sndmore);
+                pubToUi->send(zmq::buffer(data.data(), data.size()), zmq::send_flags::none);
+            }
+            for (const auto& filtered_topic : filtered_topics) {
+                pubToUi->send(zmq::buffer(filtered_topic), zmq::send_flags::sndmore);
+                pubToUi->send(zmq::buffer(data.data(), data.size()), zmq::send_flags::none);
+            }
+        }
 
+        // The log line is built after the socket is released so it never delays the next publish
+        if (Logger::isEnabled(LogLevel::INFO)) {
             // Decode packet info from binary data
             std::string packetInfo = "";
             if (data.size() >= sizeof(PacketHeader)) {
@@ -197,6 +408,47 @@ void TcpManager::publishTelemetry(const std::string& topic, const std::vector<ui
     }
 }
 
+/**
+ * @brief Publish a command result or admin reply to UI subscribers
+ * @param topic The topic to publish on (e.g., "ack.camera-ui-1234" or "admin.reply")
+ * @param data The binary payload to publish
+ */
+void TcpManager::publishReply(const std::string& topic, const std::vector<uint8_t>& data) {
+    try {
+        std::lock_guard<std::mutex> lock(publishMutex);
+        if (pubToUi && running) {
+            pubToUi->send(zmq::buffer(topic), zmq::send_flags::sndmore);
+            pubToUi->send(zmq::buffer(data.data(), data.size()), zmq::send_flags::none);
+        }
+    } catch (const zmq::error_t& e) {
+        Logger::error("Failed to publish reply on " + topic + ": " + std::string(e.what()));
+    }
+}
+
+/**
+ * @brief Hand command results and admin replies to a sink instead of publishing them directly
+ * @param sink Function receiving topic and payload (an empty function restores direct publishing)
+ */
+void TcpManager::setCommandReplySink(TcpReplySink sink) {
+    replySink_ = std::move(sink);
+}
+
+/**
+ * @brief Set the function answering "QUERY|" messages
+ * @param handler Query handler
+ */
+void TcpManager::setQueryHandler(TcpQueryCallback handler) {
+    queryHandler_ = std::move(handler);
+}
+
+/**
+ * @brief Set the function registering derived-stream filters
+ * @param handler Stream registration handler
+ */
+void TcpManager::setStreamHandler(TcpStreamCallback handler) {
+    streamHandler_ = std::move(handler);
+}
+
 /**
  * @brief Main loop for receiving telemetry data from UAVs
  *
@@ -208,9 +460,17 @@ void TcpManager::publishTelemetry(const std::string& topic, const std::vector<ui
  */
 void TcpManager::receiverLoop() {
     try {
-        std::vector<zmq::pollitem_t> poll_items = setupTelemetryPolling();
+        SnapshotReader<RoutingTable> table_reader(routingTable);
+        std::vector<const UavRoute*> poll_owners;
+        std::vector<zmq::pollitem_t> poll_items;
 
         while (running) {
+            // Pick up a new routing table if one was published since the last cycle
+            if (table_reader.refresh()) {
+                poll_items = setupTelemetryPolling(*table_reader.cached(), poll_owners);
+            }
+            const RoutingTable& table = *table_reader.cached();
+
             // Handle case where no UAVs are configured
             if (poll_items.empty()) {
                 std::this_thread::sleep_for(std::chrono::milliseconds(50));
@@ -223,7 +483,11 @@ void TcpManager::receiverLoop() {
             // Check each socket for incoming data
             for (size_t i = 0; i < poll_items.size() && running; ++i) {
                 if ((poll_items[i].revents & ZMQ_POLLIN) != 0) {
-                    processIncomingTelemetry(i);
+                    if (poll_owners[i] == nullptr) {
+                        processSharedTelemetry(table);
+                    } else {
+                        processIncomingTelemetry(*poll_owners[i]);
+                    }
                 }
             }
         }
@@ -235,47 +499,114 @@ void TcpManager::receiverLoop() {
 
 /**
  * @brief Helper to set up polling items for UAV telemetry sockets
+ * @param table Routing table snapshot to poll (must outlive the returned items)
+ * @param owners Filled with the route behind each polling item
  * @return Vector of polling items for zmq::poll
+ *
+ * UAVs without a dedicated PULL socket are skipped; the shared ROUTER socket,
+ * if any, has a null owner.
  */
-std::vector<zmq::pollitem_t> TcpManager::setupTelemetryPolling() const {
+std::vector<zmq::pollitem_t> TcpManager::setupTelemetryPolling(const RoutingTable& table,
+                                                               std::vector<const UavRoute*>& owners) const {
     std::vector<zmq::pollitem_t> poll_items;
     std::lock_guard<std::mutex> lock(socketMutex);
-    poll_items.reserve(uavTelemetrySockets.size());
-    for (const auto& sock_ptr : uavTelemetrySockets) {
-        poll_items.push_back({*sock_ptr, 0, ZMQ_POLLIN, 0});
+    poll_items.reserve(table.routes.size() + 1);
+    owners.clear();
+    owners.reserve(table.routes.size() + 1);
+    for (const auto& route : table.routes) {
+        if (route->telemetrySocket) {
+            poll_items.push_back({*route->telemetrySocket, 0, ZMQ_POLLIN, 0});
+            owners.push_back(route.get());
+        }
+    }
+    if (sharedTelemetrySocket) {
+        poll_items.push_back({*sharedTelemetrySocket, 0, ZMQ_POLLIN, 0});
+        owners.push_back(nullptr);
     }
     return poll_items;
 }
 
 /**
  * @brief Helper to process incoming telemetry from a specific UAV socket
- * @param socket_index Index of the socket that received data
+ * @param route Route whose telemetry socket received data
  */
-void TcpManager::processIncomingTelemetry(size_t socket_index) {
+void TcpManager::processIncomingTelemetry(const UavRoute& route) {
     zmq::message_t message;
     zmq::recv_result_t received;
 
     {
         std::lock_guard<std::mutex> lock(socketMutex);
-        if (socket_index < uavTelemetrySockets.size()) {
-            received = uavTelemetrySockets[socket_index]->recv(message, zmq::recv_flags::none);
-        }
+        received = route.telemetrySocket->recv(message, zmq::recv_flags::none);
     }
 
     if (received.has_value()) {
-        // Extract binary message data and identify source UAV
+        if (consumeCommandAck(route.uav.name, message)) {
+            return;
+        }
+
+        // Extract binary message data; the route identifies the source UAV
         std::vector<uint8_t> data(static_cast<uint8_t*>(message.data()),
                                   static_cast<uint8_t*>(message.data()) + message.size());
-        std::string uav_name =
-            (socket_index < config.getUAVs().size()) ? config.getUAVs()[socket_index].name : "UNKNOWN";
 
         // Call the registered callback with UAV name directly
         if (messageCallback_) {
-            messageCallback_(uav_name, data);
+            messageCallback_(route.uav.name, data);
         }
     }
 }
 
+/**
+ * @brief Helper to process one message from the shared telemetry ROUTER socket
+ * @param table Routing table snapshot used to resolve the routing ID
+ *
+ * ROUTER prepends the sender's routing ID to every message, so a message is
+ * [routing_id][payload]. The routing ID is looked up in the table's name index
+ * (O(1)); messages from unknown peers are dropped with a warning.
+ */
+void TcpManager::processSharedTelemetry(const RoutingTable& table) {
+    zmq::message_t identity;
+    zmq::message_t payload;
+    bool complete = false;
+
+    {
+        std::lock_guard<std::mutex> lock(socketMutex);
+        if (!sharedTelemetrySocket || !sharedTelemetrySocket->recv(identity, zmq::recv_flags::none)) {
+            return;
+        }
+        if (identity.more() && sharedTelemetrySocket->recv(payload, zmq::recv_flags::none)) {
+            complete = true;
+        }
+        // Drain any unexpected trailing frames so the next recv starts at a routing ID
+        while (payload.more()) {
+            zmq::message_t extra;
+            if (!sharedTelemetrySocket->recv(extra, zmq::recv_flags::none) || !extra.more()) {
+                break;
+            }
+        }
+    }
+
+    std::string_view routing_id(static_cast<const char*>(identity.data()), identity.size());
+    if (!complete) {
+        Logger::warn("Malformed shared ingest message from " + std::string(routing_id));
+        return;
+    }
+
+    auto uav_it = table.indexByName.find(routing_id);
+    if (uav_it == table.indexByName.end()) {
+        Logger::warn("Shared ingest message from unknown UAV routing ID: " + std::string(routing_id));
+        return;
+    }
+    if (consumeCommandAck(table.routes[uav_it->second]->uav.name, payload)) {
+        return;
+    }
+
+    std::vector<uint8_t> data(static_cast<uint8_t*>(payload.data()),
+                              static_cast<uint8_t*>(payload.data()) + payload.size());
+    if (messageCallback_) {
+        messageCallback_(table.routes[uav_it->second]->uav.name, data);
+    }
+}
+
 /**
  * @brief Main loop for forwarding commands from UI to UAVs
  *
@@ -287,24 +618,64 @@ void TcpManager::processIncomingTelemetry(size_t socket_index) {
  */
 void TcpManager::forwarderLoop() {
     try {
-        // Set up polling for UI command socket
-        zmq::pollitem_t ui_poll{*pullFromUi, 0, ZMQ_POLLIN, 0};
+        // Set up polling for the UI command socket, plus the shared command ROUTER where
+        // UAVs without a dedicated telemetry port send their command acknowledgements
+        std::vector<zmq::pollitem_t> poll_items{{*pullFromUi, 0, ZMQ_POLLIN, 0}};
+        if (sharedCommandSocket) {
+            poll_items.push_back({*sharedCommandSocket, 0, ZMQ_POLLIN, 0});
+        }
+        SnapshotReader<RoutingTable> table_reader(routingTable);
 
         while (running) {
-            // Poll UI socket with 100ms timeout
-            zmq::poll(&ui_poll, 1, std::chrono::milliseconds(100));
-            if ((ui_poll.revents & ZMQ_POLLIN) != 0) {
+            // Poll with 100ms timeout; the same tick drives acknowledgement timeouts
+            zmq::poll(poll_items.data(), poll_items.size(), std::chrono::milliseconds(100));
+            // Drop the previous table every cycle so removed routes release their sockets
+            table_reader.refresh();
+            expirePendingCommands();
+            if (poll_items.size() > 1 && (poll_items[1].revents & ZMQ_POLLIN) != 0) {
+                processSharedCommandReply(table_reader.get());
+            }
+            if ((poll_items[0].revents & ZMQ_POLLIN) != 0) {
                 zmq::message_t ui_msg;
                 auto recv_result = pullFromUi->recv(ui_msg, zmq::recv_flags::none);
                 if (recv_result.has_value()) {
-                    std::string msg(static_cast<char*>(ui_msg.data()), ui_msg.size());
-                    Logger::info("RECEIVED FROM UI [" + extractUISource(msg) + "]: " + msg);
+                    // View the message in place; nothing is copied until a command is actually sent
+                    std::string_view msg(static_cast<const char*>(ui_msg.data()), ui_msg.size());
+                    if (Logger::isEnabled(LogLevel::DEBUG)) {
+                        Logger::debug("RECEIVED FROM UI [" + extractUISource(msg) + "]: " + std::string(msg));
+                    }
 
+                    if (msg.substr(0, 4) == "CMD|") {
+                        forwardTrackedCommand(msg.substr(4));
+                        continue;
+                    }
+                    if (msg.substr(0, 6) == "QUERY|") {
+                        handleQuery(msg.substr(6));
+                        continue;
+                    }
+                    if (msg.substr(0, 7) == "FILTER|") {
+                        handleFilter(msg.substr(7), true);
+                        continue;
+                    }
+                    if (msg.substr(0, 9) == "UNFILTER|") {
+                        handleFilter(msg.substr(9), false);
+                        continue;
+                    }
                     auto [target_uav, actual_cmd] = parseUICommand(msg);
+                    if (target_uav == "ADMIN") {
+                        handleAdminCommand(std::string(actual_cmd));
+                        continue;
+                    }
+                    if (isMultiTarget(target_uav)) {
+                        if (forwardCommandToGroup(target_uav, actual_cmd) < 0) {
+                            Logger::warn("Command target group not found: " + std::string(target_uav));
+                        }
+                        continue;
+                    }
                     bool success = forwardCommandToUAV(target_uav, actual_cmd);
 
                     if (!success) {
-                        Logger::warn("Command target UAV not found: " + target_uav);
+                        Logger::warn("Command not delivered to UAV: " + std::string(target_uav));
                     }
                 }
             }
@@ -323,10 +694,10 @@ void TcpManager::forwarderLoop() {
  * Analyzes the message content to determine which UI component sent the command.
  * This is used for logging and debugging purposes.
  */
-std::string TcpManager::extractUISource(const std::string& message) {
-    if (message.find("[camera-ui]") != std::string::npos)
+std::string TcpManager::extractUISource(std::string_view message) {
+    if (message.find("[camera-ui]") != std::string_view::npos)
         return "camera";
-    if (message.find("[mapping-ui]") != std::string::npos)
+    if (message.find("[mapping-ui]") != std::string_view::npos)
         return "mapping";
     return "unknown";
 }
@@ -334,15 +705,34 @@ std::string TcpManager::extractUISource(const std::string& message) {
 /**
  * @brief Helper to parse UI command and extract target UAV and command
  * @param message The raw UI command message
- * @return Pair of target_uav and actual_command
+ * @return Pair of target_uav and actual_command, both viewing into message
+ *
+ * For "group:<name>:cmd" and "tag:<tag>:cmd" the target spans up to the second colon.
  */
-std::pair<std::string, std::string> TcpManager::parseUICommand(const std::string& message) {
+std::pair<std::string_view, std::string_view> TcpManager::parseUICommand(std::string_view message) {
     // Parse command to extract target UAV and actual command
     // Expected format: "UAV_NAME:command_data"
     size_t colon_pos = message.find(':');
-    std::string target_uav = (colon_pos != std::string::npos) ? message.substr(0, colon_pos) : "UAV_1";
-    std::string actual_cmd = (colon_pos != std::string::npos) ? message.substr(colon_pos + 1) : message;
-    return {target_uav, actual_cmd};
+    if (colon_pos == std::string_view::npos) {
+        return {"UAV_1", message};
+    }
+    std::string_view prefix = message.substr(0, colon_pos);
+    if (prefix == "group" || prefix == "tag") {
+        size_t selector_end = message.find(':', colon_pos + 1);
+        if (selector_end != std::string_view::npos) {
+            colon_pos = selector_end;
+        }
+    }
+    return {message.substr(0, colon_pos), message.substr(colon_pos + 1)};
+}
+
+/**
+ * @brief Check whether a command target selects several UAVs
+ * @param target Command target from parseUICommand()
+ * @return true for "*", "group:<name>" and "tag:<tag>"
+ */
+bool TcpManager::isMultiTarget(std::string_view target) {
+    return target == "*" || target.substr(0, 6) == "group:" || target.substr(0, 4) == "tag:";
 }
 
 /**
@@ -350,26 +740,431 @@ std::pair<std::string, std::string> TcpManager::parseUICommand(const std::string
  * @param target_uav The UAV name to send command to
  * @param command The command to send
  * @return true if command was forwarded successfully
+ *
+ * The target is resolved with one hash lookup in the routing table's name
+ * index (no per-command scan of the UAV list, no key allocation). Sends do
+ * not block: this runs on the forwarder thread, which also expires pending
+ * acknowledgements, so a UAV without a connected peer (or with a full queue)
+ * fails the command instead of stalling every other one.
  */
-bool TcpManager::forwardCommandToUAV(const std::string& target_uav, const std::string& command) {
-    const auto& uavs = config.getUAVs();
-
-    for (size_t i = 0; i < uavs.size(); ++i) {
-        if (uavs[i].name == target_uav) {
-            std::lock_guard<std::mutex> lock(socketMutex);
-            if (i < uavCommandSockets.size() && running) {
-                std::string forward_msg;
-                forward_msg.reserve(25 + target_uav.size() + command.size());
-                forward_msg += "FORWARDING TO ";
-                forward_msg += target_uav;
-                forward_msg += ": ";
-                forward_msg += command;
-                Logger::info(forward_msg);
-                uavCommandSockets[i]->send(zmq::buffer(command), zmq::send_flags::none);
+bool TcpManager::forwardCommandToUAV(std::string_view target_uav, std::string_view command) {
+    // The snapshot keeps the route's sockets alive even if the UAV is removed meanwhile
+    auto table = routingTable.load();
+    auto uav_it = table->indexByName.find(target_uav);
+    if (uav_it == table->indexByName.end()) {
+        return false;
+    }
+    const UavRoute& route = *table->routes[uav_it->second];
+
+    std::lock_guard<std::mutex> lock(commandMutex);
+    if (!running) {
+        return false;
+    }
+    // Per-command logging is DEBUG only: at INFO it dominated the cost of scripted command streams
+    if (Logger::isEnabled(LogLevel::DEBUG)) {
+        std::string forward_msg;
+        forward_msg.reserve(25 + target_uav.size() + command.size());
+        forward_msg += "FORWARDING TO ";
+        forward_msg += target_uav;
+        forward_msg += ": ";
+        forward_msg += command;
+        Logger::debug(forward_msg);
+    }
+
+    if (route.commandSocket) {
+        if (route.commandSocket->send(zmq::buffer(command), zmq::send_flags::dontwait)) {
+            return true;
+        }
+        Logger::warn("Command to " + std::string(target_uav) + " not sent: UAV not connected or its queue is full");
+        return false;
+    }
+    if (sharedCommandSocket) {
+        // ROUTER addresses the peer by routing ID; router_mandatory makes unknown peers an error
+        try {
+            if (sharedCommandSocket->send(zmq::buffer(target_uav), zmq::send_flags::sndmore | zmq::send_flags::dontwait)
+                && sharedCommandSocket->send(zmq::buffer(command), zmq::send_flags::dontwait)) {
                 return true;
             }
-            break;
+            Logger::warn("Command to " + std::string(target_uav) + " not sent: shared command queue is full");
+        } catch (const zmq::error_t& e) {
+            Logger::warn("UAV " + std::string(target_uav) + " not connected to shared command port: " + e.what());
         }
     }
     return false;
 }
+
+/**
+ * @brief Helper to send one command to every UAV selected by a multi-UAV target
+ * @param target "*", "group:<name>" or "tag:<tag>"
+ * @param command The command to send
+ * @return Number of UAVs the command was handed to, or -1 if the selector is unknown
+ *
+ * The selector is resolved with one lookup into lists precomputed by
+ * buildRoutingTable(), then every target socket is written in a single pass
+ * under one lock. The payload is copied into a ZeroMQ message once; each send
+ * takes a reference to it. Sends do not block, so one UAV with a full queue
+ * cannot hold up the rest of the group.
+ */
+int TcpManager::forwardCommandToGroup(std::string_view target, std::string_view command) {
+    auto table = routingTable.load();
+    const std::vector<size_t>* indices = nullptr;
+    if (target == "*") {
+        indices = &table->allIndices;
+    } else {
+        bool is_group = target.substr(0, 6) == "group:";
+        const auto& selector_index = is_group ? table->groupIndices : table->tagIndices;
+        auto selector_it = selector_index.find(std::string(target.substr(is_group ? 6 : 4)));
+        if (selector_it == selector_index.end()) {
+            return -1;
+        }
+        indices = &selector_it->second;
+    }
+
+    zmq::message_t payload(command.data(), command.size());
+    int delivered = 0;
+    std::lock_guard<std::mutex> lock(commandMutex);
+    if (!running) {
+        return 0;
+    }
+    for (size_t index : *indices) {
+        const UavRoute& route = *table->routes[index];
+        zmq::message_t part;
+        part.copy(payload);
+        try {
+            if (route.commandSocket) {
+                delivered += route.commandSocket->send(part, zmq::send_flags::dontwait) ? 1 : 0;
+            } else if (sharedCommandSocket
+                       && sharedCommandSocket->send(zmq::buffer(route.uav.name),
+                                                    zmq::send_flags::sndmore | zmq::send_flags::dontwait)) {
+                // Counted only when the payload frame was queued too
+                delivered += sharedCommandSocket->send(part, zmq::send_flags::dontwait) ? 1 : 0;
+            }
+        } catch (const zmq::error_t& e) {
+            Logger::warn("UAV " + route.uav.name + " not connected to shared command port: " + e.what());
+        }
+    }
+
+    if (delivered < static_cast<int>(indices->size())) {
+        Logger::warn("Command to " + std::string(target) + " reached " + std::to_string(delivered) + " of "
+                     + std::to_string(indices->size()) + " UAVs");
+    } else if (Logger::isEnabled(LogLevel::DEBUG)) {
+        Logger::debug("FORWARDING TO " + std::string(target) + " (" + std::to_string(delivered)
+                      + " UAVs): " + std::string(command));
+    }
+    return delivered;
+}
+
+/**
+ * @brief Helper to forward a command that asks for an acknowledgement
+ * @param message UI message after the "CMD|" prefix: "<client_id>|<command_id>|<target>:<command>"
+ *
+ * The command is registered with the tracker before it is sent, so an
+ * acknowledgement can never arrive for a command the tracker does not know.
+ */
+void TcpManager::forwardTrackedCommand(std::string_view message) {
+    size_t client_end = message.find('|');
+    size_t id_end = client_end == std::string_view::npos ? client_end : message.find('|', client_end + 1);
+    if (id_end == std::string_view::npos) {
+        Logger::warn("Malformed tracked command: " + std::string(message));
+        return;
+    }
+    std::string_view client_id = message.substr(0, client_end);
+    uint32_t command_id = 0;
+    try {
+        std::string id_text(message.substr(client_end + 1, id_end - client_end - 1));
+        command_id = static_cast<uint32_t>(std::stoul(id_text));
+    } catch (const std::exception&) {
+        Logger::warn("Malformed tracked command id from " + std::string(client_id));
+        return;
+    }
+
+    auto [target_uav, actual_cmd] = parseUICommand(message.substr(id_end + 1));
+    if (target_uav == "ADMIN" || isMultiTarget(target_uav)) {
+        Logger::warn("Acknowledged commands need a single UAV target, got " + std::string(target_uav));
+        publishCommandResult(client_id, command_id, CommandStatus::UNDELIVERED);
+        return;
+    }
+
+    uint32_t sequence = commandTracker_.track(std::string(client_id), command_id, std::string(target_uav));
+    std::string wire_command;
+    wire_command.reserve(16 + actual_cmd.size());
+    wire_command += "CMD|";
+    wire_command += std::to_string(sequence);
+    wire_command += '|';
+    wire_command += actual_cmd;
+    if (!forwardCommandToUAV(target_uav, wire_command)) {
+        Logger::warn("Tracked command not delivered to UAV: " + std::string(target_uav));
+        if (commandTracker_.cancel(sequence)) {
+            publishCommandResult(client_id, command_id, CommandStatus::UNDELIVERED);
+        }
+    }
+}
+
+/**
+ * @brief Helper to consume a command acknowledgement packet from a UAV
+ * @param uav_name UAV the packet came from
+ * @param message Packet (PacketHeader + CommandAckPayload)
+ * @return true if the packet was a command acknowledgement (and must not be routed as telemetry)
+ *
+ * Late acknowledgements (after TIMEOUT was reported) and acknowledgements for
+ * commands sent to another UAV are dropped.
+ */
+bool TcpManager::consumeCommandAck(const std::string& uav_name, const zmq::message_t& message) {
+    if (message.size() < sizeof(PacketHeader)) {
+        return false;
+    }
+    const auto* header = static_cast<const PacketHeader*>(message.data());
+    if (header->packetType != PacketTypes::COMMAND_ACK) {
+        return false;
+    }
+    if (message.size() < sizeof(PacketHeader) + sizeof(CommandAckPayload)) {
+        Logger::warn("Truncated command acknowledgement from " + uav_name);
+        return true;
+    }
+
+    CommandAckPayload ack{};
+    std::memcpy(&ack, static_cast<const uint8_t*>(message.data()) + sizeof(PacketHeader), sizeof(ack));
+    auto pending = commandTracker_.acknowledge(uav_name, ack.commandId);
+    if (!pending) {
+        Logger::debug("Ignoring acknowledgement " + std::to_string(ack.commandId) + " from " + uav_name);
+        return true;
+    }
+
+    if (Logger::isEnabled(LogLevel::DEBUG)) {
+        auto rtt = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now()
+                                                                          - pending->sentAt);
+        Logger::debug("ACK from " + uav_name + " for " + pending->clientId + "#"
+                      + std::to_string(pending->clientCommandId) + " status " + std::to_string(ack.status) + " in "
+                      + std::to_string(rtt.count()) + " us");
+    }
+    publishCommandResult(pending->clientId, pending->clientCommandId, ack.status);
+    return true;
+}
+
+/**
+ * @brief Helper to read one acknowledgement sent back on the shared command ROUTER
+ * @param table Routing table snapshot used to resolve the routing ID
+ *
+ * UAVs on the shared command endpoint talk through a DEALER, which lets them
+ * answer on the same connection the command arrived on.
+ */
+void TcpManager::processSharedCommandReply(const RoutingTable& table) {
+    zmq::message_t identity;
+    zmq::message_t payload;
+    {
+        std::lock_guard<std::mutex> lock(commandMutex);
+        if (!sharedCommandSocket->recv(identity, zmq::recv_flags::none) || !identity.more()
+            || !sharedCommandSocket->recv(payload, zmq::recv_flags::none)) {
+            return;
+        }
+        // Drain any unexpected trailing frames so the next recv starts at a routing ID
+        while (payload.more()) {
+            zmq::message_t extra;
+            if (!sharedCommandSocket->recv(extra, zmq::recv_flags::none) || !extra.more()) {
+                break;
+            }
+        }
+    }
+
+    std::string_view routing_id(static_cast<const char*>(identity.data()), identity.size());
+    auto uav_it = table.indexByName.find(routing_id);
+    if (uav_it == table.indexByName.end() || !consumeCommandAck(table.routes[uav_it->second]->uav.name, payload)) {
+        Logger::warn("Unexpected message on shared command port from " + std::string(routing_id));
+    }
+}
+
+/**
+ * @brief Helper to publish the outcome of a tracked command to its client
+ * @param client_id Client that sent the command
+ * @param command_id The client's command id
+ * @param status One of CommandStatus
+ *
+ * Published as a bare CommandAckPayload on "ack.<client_id>", through the reply
+ * sink when one is set.
+ */
+void TcpManager::publishCommandResult(std::string_view client_id, uint32_t command_id, uint8_t status) {
+    std::string topic = "ack.";
+    topic += client_id;
+    CommandAckPayload result{command_id, status};
+    const auto* bytes = reinterpret_cast<const uint8_t*>(&result);
+    std::vector<uint8_t> data(bytes, bytes + sizeof(result));
+    if (replySink_) {
+        replySink_(topic, std::move(data));
+    } else {
+        publishReply(topic, data);
+    }
+}
+
+/**
+ * @brief Helper to report every tracked command whose acknowledgement timed out
+ */
+void TcpManager::expirePendingCommands() {
+    for (const auto& expired : commandTracker_.expire(std::chrono::steady_clock::now())) {
+        Logger::warn("Command " + expired.clientId + "#" + std::to_string(expired.clientCommandId) + " to "
+                     + expired.uavName + " was not acknowledged in time");
+        publishCommandResult(expired.clientId, expired.clientCommandId, CommandStatus::TIMEOUT);
+    }
+}
+
+/**
+ * @brief Helper to run an admin command and publish its result
+ * @param payload Command payload after "ADMIN:"
+ *
+ * The result line (e.g. "OK registered UAV_4" or "ERROR ...") is published on
+ * the "admin.reply" topic so the sender can observe the outcome; the UI command
+ * channel itself is one-way.
+ */
+void TcpManager::handleAdminCommand(const std::string& payload) {
+    std::string result;
+    if (!adminCallback_) {
+        result = "ERROR admin commands are not enabled";
+    } else {
+        try {
+            result = adminCallback_(payload);
+        } catch (const std::exception& e) {
+            result = "ERROR " + std::string(e.what());
+        }
+    }
+    Logger::info("ADMIN [" + payload + "] -> " + result);
+
+    std::vector<uint8_t> data(result.begin(), result.end());
+    if (replySink_) {
+        replySink_("admin.reply", std::move(data));
+    } else {
+        publishReply("admin.reply", data);
+    }
+}
+
+/**
+ * @brief Helper to answer a fleet query and publish the result to its client
+ * @param message UI message after the "QUERY|" prefix: "<client_id>|<query_id>|<query>"
+ *
+ * The reply is {"id":<query_id>,"uavs":[...]} or {"id":<query_id>,"error":"..."}
+ * on "query.<client_id>". Like command results it takes the command lane, so a
+ * query is answered ahead of queued bulk telemetry.
+ */
+void TcpManager::handleQuery(std::string_view message) {
+    size_t client_end = message.find('|');
+    size_t id_end = client_end == std::string_view::npos ? client_end : message.find('|', client_end + 1);
+    if (id_end == std::string_view::npos) {
+        Logger::warn("Malformed query: " + std::string(message));
+        return;
+    }
+    std::string_view client_id = message.substr(0, client_end);
+    nlohmann::json reply;
+    try {
+        reply["id"] = std::stoul(std::string(message.substr(client_end + 1, id_end - client_end - 1)));
+    } catch (const std::exception&) {
+        Logger::warn("Malformed query id from " + std::string(client_id));
+        return;
+    }
+
+    std::string query(message.substr(id_end + 1));
+    if (!queryHandler_) {
+        reply["error"] = "queries are not enabled";
+    } else {
+        try {
+            reply["uavs"] = queryHandler_(query);
+        } catch (const std::exception& e) {
+            reply["error"] = e.what();
+        }
+    }
+    Logger::debug("QUERY [" + std::string(client_id) + "] " + query);
+
+    std::string topic = "query.";
+    topic += client_id;
+    std::string text = reply.dump();
+    std::vector<uint8_t> data(text.begin(), text.end());
+    if (replySink_) {
+        replySink_(topic, std::move(data));
+    } else {
+        publishReply(topic, data);
+    }
+}
+
+/**
+ * @brief Helper to register or remove a content-based subscription
+ * @param message UI message after the "FILTER|" or "UNFILTER|" prefix
+ * @param add true for FILTER, false for UNFILTER
+ *
+ * The filter is compiled once here. Invalid filters and registrations beyond
+ * MAX_FILTERS are logged and ignored; the client then receives nothing for
+ * that subscription. Filters of clients that vanish without UNFILTER stay
+ * until the service restarts.
+ */
+void TcpManager::handleFilter(std::string_view message, bool add) {
+    constexpr size_t MAX_FILTERS = 1024;
+
+    size_t client_end = message.find('|');
+    if (client_end == std::string_view::npos) {
+        Logger::warn("Malformed filter request: " + std::string(message));
+        return;
+    }
+    size_t id_end = message.find('|', client_end + 1);
+    std::string key(message.substr(0, id_end));
+    std::string_view client_id = message.substr(0, client_end);
+    std::string_view filter_id = message.substr(client_end + 1, id_end - client_end - 1);
+    if (client_id.empty() || filter_id.empty() || client_id.find('.') != std::string_view::npos
+        || filter_id.find('.') != std::string_view::npos) {
+        Logger::warn("Malformed filter request: " + std::string(message));
+        return;
+    }
+
+    auto current = filters_.load();
+    auto next = std::make_shared<std::vector<TcpFilter>>();
+    next->reserve(current->size() + 1);
+    const TcpFilter* replaced = nullptr;
+    for (const auto& filter : *current) {
+        if (filter.key != key) {
+            next->push_back(filter);
+        } else {
+            replaced = &filter;
+        }
+    }
+
+    if (add) {
+        if (id_end == std::string_view::npos) {
+            Logger::warn("Malformed filter request: " + std::string(message));
+            return;
+        }
+        std::string subscription(message.substr(id_end + 1));
+        TcpFilter filter;
+        try {
+            filter.filter = SubscriptionFilter::parse(subscription);
+        } catch (const std::exception& e) {
+            Logger::warn("Filter from " + std::string(client_id) + " rejected: " + subscription + " (" + e.what()
+                         + ")");
+            return;
+        }
+        if (next->size() >= MAX_FILTERS) {
+            Logger::warn("Filter from " + std::string(client_id) + " rejected: too many filters");
+            return;
+        }
+        if (!filter.filter.derivedSuffix.empty()) {
+            // The service computes the stream; the filter only delivers it to this client
+            try {
+                if (!streamHandler_) {
+                    throw std::runtime_error("derived streams are not available");
+                }
+                streamHandler_(subscription, true);
+            } catch (const std::exception& e) {
+                Logger::warn("Filter from " + std::string(client_id) + " rejected: " + subscription + " ("
+                             + e.what() + ")");
+                return;
+            }
+        }
+        filter.key = key;
+        filter.topicPrefix = "filter." + std::string(client_id) + "." + std::string(filter_id) + ".";
+        filter.subscription = std::move(subscription);
+        Logger::info("Filter [" + key + "] registered: " + filter.subscription);
+        next->push_back(std::move(filter));
+    } else if (!replaced) {
+        return;  // Unknown filter
+    } else {
+        Logger::info("Filter [" + key + "] removed");
+    }
+    if (replaced && !replaced->filter.derivedSuffix.empty() && streamHandler_) {
+        streamHandler_(replaced->subscription, false);
+    }
+    filters_.store(std::move(next));
+}
@@ -12,27 +12,85 @@
 
 #include <atomic>
 #include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <string>
+#include <string_view>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include <zmq.hpp>
 
+#include "CommandTracker.h"
 #include "Config.h"
+#include "Snapshot.h"
+#include "SubscriptionFilter.h"
 
 // Callback function type for handling incoming TCP messages
 // Parameters: source description, binary message data
 using TcpMessageCallback = std::function<void(const std::string&, const std::vector<uint8_t>&)>;
 
+// Callback function type for handling admin commands ("ADMIN:<payload>" on the UI command port)
+// Parameters: payload after "ADMIN:"; returns a result line published on the "admin.reply" topic
+using TcpAdminCallback = std::function<std::string(const std::string&)>;
+
+// Callback function type for answering fleet queries ("QUERY|<client_id>|<query_id>|<query>" on the UI command port)
+// Parameters: query text; returns the matching UAVs as a JSON array (throws on invalid queries)
+using TcpQueryCallback = std::function<nlohmann::json(const std::string&)>;
+
+// Callback function type registering subscribers of derived streams ("<pattern>@<spec>" filters)
+// Parameters: subscription, true to add / false to remove; throws std::runtime_error on invalid streams
+using TcpStreamCallback = std::function<void(const std::string&, bool)>;
+
+// Callback function type that takes over publishing of command results and admin replies
+// Parameters: topic, binary payload
+using TcpReplySink = std::function<void(const std::string&, std::vector<uint8_t>)>;
+
 /**
  * @class TcpManager
  * @brief Manages all TCP communication for the telemetry service
  *
  * The TcpManager handles:
- * - Receiving telemetry data from UAVs (PULL sockets)
+ * - Receiving telemetry data from UAVs (PULL sockets, or one shared ROUTER socket)
  * - Publishing telemetry data to UI components (PUB socket)
  * - Receiving commands from UI components (PULL socket)
- * - Forwarding commands to UAVs (PUSH sockets)
+ * - Forwarding commands to UAVs (PUSH sockets, or one shared ROUTER socket)
+ *
+ * On the shared ROUTER endpoints a UAV is identified by its ZeroMQ routing ID,
+ * which must equal its configured name.
+ *
+ * A command target may also select several UAVs: "*" (every UAV), "group:<name>"
+ * (a group from the configuration) or "tag:<tag>" (every UAV with that tag).
+ * Selectors are resolved against index lists precomputed in the routing table.
+ *
+ * A UI message of the form "CMD|<client_id>|<command_id>|<target>:<command>"
+ * asks for an acknowledgement. The command reaches the UAV as "CMD|<seq>|<command>",
+ * the UAV answers with a COMMAND_ACK packet (on its telemetry channel, or on the
+ * shared command ROUTER), and the outcome is published on "ack.<client_id>".
+ * Commands without an acknowledgement in time are reported as TIMEOUT.
+ *
+ * A UI message of the form "QUERY|<client_id>|<query_id>|<query>" asks about the
+ * fleet (e.g. "radius <lat> <lon> <meters>"); the answer is published as JSON on
+ * "query.<client_id>".
+ *
+ * A UI message of the form "FILTER|<client_id>|<filter_id>|<pattern>?<expression>"
+ * registers a content-based subscription: every published telemetry packet that
+ * matches the pattern and the payload expression is also published on
+ * "filter.<client_id>.<filter_id>.<topic>". Clients subscribe to that prefix
+ * only, so packets failing the expression never reach them. "UNFILTER|<client_id>|
+ * <filter_id>" removes the filter. A filter ending in "@<spec>" (e.g.
+ * "telemetry.*.mapping.location@1Hz") asks for a derived stream: the service
+ * computes it and publishes it on "<topic>@<spec>", which is sent on the filter
+ * topics only.
+ *
+ * Telemetry ingest, publishing and command delivery each have their own socket
+ * mutex, so a burst of published telemetry never holds up a command on its way
+ * to a UAV.
+ *
+ * UAVs can be added and removed at runtime. The per-UAV sockets live in an
+ * immutable routing table that is swapped atomically (read-copy-update), so the
+ * receiver and forwarder threads never wait on a registration.
  *
  * Uses two background threads:
  * - Receiver thread: Handles incoming telemetry from UAVs
@@ -43,13 +101,17 @@ class TcpManager {
     /**
      * @brief Constructor
      * @param ctx ZeroMQ context to use for all sockets
-     * @param cfg Configuration containing UAV and UI port settings
+     * @param cfg Configuration snapshot containing UAV and UI port settings
      * @param callback Function to call when telemetry messages are received
+     * @param adminCallback Function to call for "ADMIN:" commands (optional; admin commands are rejected without it)
      *
      * Initializes the TcpManager with the necessary configuration and sets up
      * the callback for handling incoming telemetry messages.
      */
-    TcpManager(zmq::context_t& ctx, const Config& cfg, TcpMessageCallback callback);
+    TcpManager(zmq::context_t& ctx,
+               const Snapshot<Config>& cfg,
+               TcpMessageCallback callback,
+               TcpAdminCallback adminCallback = nullptr);
 
     /**
      * @brief Destructor - ensures proper cleanup
@@ -90,14 +152,113 @@ class TcpManager {
      * @brief Publish telemetry data to UI subscribers
      * @param topic The topic to publish on (e.g., "telemetry.UAV_1.camera.location" or "telemetry.UAV_2.mapping.status")
      * @param data The binary telemetry data to publish
+     * @param stream Derived-stream subscription the message belongs to ("" for telemetry packets)
      *
      * Sends telemetry data to all UI components subscribed to the given topic.
      * This method is thread-safe and can be called from callback functions.
      * Uses ZMQ multipart messaging with topic-based filtering.
      */
-    void publishTelemetry(const std::string& topic, const std::vector<uint8_t>& data);
+    void publishTelemetry(const std::string& topic, const std::vector<uint8_t>& data, const std::string& stream = "");
+
+    /**
+     * @brief Publish a command result or admin reply to UI subscribers
+     * @param topic The topic to publish on (e.g., "ack.camera-ui-1234" or "admin.reply")
+     * @param data The binary payload to publish
+     *
+     * Same as publishTelemetry() but without the per-packet telemetry log line.
+     * This method is thread-safe.
+     */
+    void publishReply(const std::string& topic, const std::vector<uint8_t>& data);
+
+    /**
+     * @brief Hand command results and admin replies to a sink instead of publishing them directly
+     * @param sink Function receiving topic and payload (an empty function restores direct publishing)
+     *
+     * Must be called before start(). The sink is called on the forwarder thread and
+     * should not block; it is expected to end up calling publishReply().
+     */
+    void setCommandReplySink(TcpReplySink sink);
+
+    /**
+     * @brief Set the function answering "QUERY|" messages
+     * @param handler Query handler (queries are answered with an error without one)
+     *
+     * Must be called before start(). The handler runs on the forwarder thread.
+     */
+    void setQueryHandler(TcpQueryCallback handler);
+
+    /**
+     * @brief Set the function registering derived-stream filters
+     * @param handler Stream registration handler (derived-stream filters are rejected without one)
+     *
+     * Must be called before start(). The handler runs on the forwarder thread.
+     */
+    void setStreamHandler(TcpStreamCallback handler);
+
+    /**
+     * @brief Bind the dedicated sockets for a UAV and add it to the routing table
+     * @param uav UAV to add (its name must not already be routed)
+     * @throws zmq::error_t if a dedicated port cannot be bound
+     * @throws std::runtime_error if the UAV is already routed
+     *
+     * The receiver thread picks up the new table on its next poll cycle.
+     */
+    void addUav(const UAVConfig& uav);
+
+    /**
+     * @brief Remove a UAV from the routing table
+     * @param name UAV name
+     * @return true if the UAV was routed
+     *
+     * The UAV's dedicated sockets are closed once no thread holds a table snapshot
+     * that still references them.
+     */
+    bool removeUav(const std::string& name);
+
+    /**
+     * @brief Replace the settings of routed UAVs whose sockets stay as they are
+     * @param uavs New settings (same names and ports; address, id or tags may differ)
+     *
+     * Publishes one new table in which the routes share the old sockets, so tag
+     * selectors follow the new tags without a rebind. UAVs that are not routed
+     * are skipped.
+     */
+    void updateUavs(const std::vector<UAVConfig>& uavs);
+
+    /**
+     * @brief Rebuild the group index after the configured groups changed
+     *
+     * Routes and sockets are kept; only the routing table's group index is recomputed
+     * from the current configuration snapshot.
+     */
+    void refreshGroups();
 
    private:
+    /**
+     * @struct UavRoute
+     * @brief Configuration and dedicated sockets of one routed UAV
+     */
+    struct UavRoute {
+        UAVConfig uav;                                   ///< UAV configuration
+        std::shared_ptr<zmq::socket_t> telemetrySocket;  ///< PULL socket for telemetry (null when shared)
+        std::shared_ptr<zmq::socket_t> commandSocket;    ///< PUSH socket for commands (null when shared)
+    };
+
+    /**
+     * @struct RoutingTable
+     * @brief Immutable snapshot of all routed UAVs
+     */
+    struct RoutingTable {
+        std::vector<std::shared_ptr<const UavRoute>> routes;  ///< Routed UAVs
+        // UAV name (= routing ID) -> index into routes. Keys view the names owned by the routes,
+        // so lookups with a string_view into a received message need no allocation.
+        std::unordered_map<std::string_view, size_t> indexByName;
+        // Command selectors, expanded once per table so a group command needs a single lookup
+        std::vector<size_t> allIndices;                                     ///< "*": every route
+        std::unordered_map<std::string, std::vector<size_t>> groupIndices;  ///< Group name -> live members
+        std::unordered_map<std::string, std::vector<size_t>> tagIndices;    ///< Tag -> routes with that tag
+    };
+
     /**
      * @brief Main loop for the receiver thread
      *
@@ -117,30 +278,142 @@ class TcpManager {
 
     /**
      * @brief Helper to set up polling items for UAV telemetry sockets
+     * @param table Routing table snapshot to poll
+     * @param owners Filled with the route behind each polling item (nullptr for the shared ROUTER)
      * @return Vector of polling items for zmq::poll
      */
-    std::vector<zmq::pollitem_t> setupTelemetryPolling() const;
+    std::vector<zmq::pollitem_t> setupTelemetryPolling(const RoutingTable& table,
+                                                       std::vector<const UavRoute*>& owners) const;
 
     /**
      * @brief Helper to process incoming telemetry from a specific UAV socket
-     * @param socket_index Index of the socket that received data
+     * @param route Route whose telemetry socket received data
      */
-    void processIncomingTelemetry(size_t socket_index);
+    void processIncomingTelemetry(const UavRoute& route);
+
+    /**
+     * @brief Helper to process one message from the shared telemetry ROUTER socket
+     * @param table Routing table snapshot used to resolve the routing ID
+     *
+     * Reads the routing ID frame, resolves it to a routed UAV and forwards the
+     * payload frame to the callback.
+     */
+    void processSharedTelemetry(const RoutingTable& table);
+
+    /**
+     * @brief Helper to create the dedicated sockets for one UAV
+     * @param uav UAV configuration
+     * @return New route (sockets are null for channels served by shared ingest)
+     */
+    std::shared_ptr<const UavRoute> createRoute(const UAVConfig& uav);
+
+    /**
+     * @brief Helper to build an immutable routing table from a list of routes
+     * @param routes Routes to include
+     * @param groups Configured groups (members without a route are left out)
+     * @return New routing table with its name and selector indexes filled in
+     */
+    static std::shared_ptr<const RoutingTable> buildRoutingTable(
+        std::vector<std::shared_ptr<const UavRoute>> routes,
+        const std::map<std::string, std::vector<std::string>>& groups);
+
+    /**
+     * @brief Helper to run an admin command and publish its result
+     * @param payload Command payload after "ADMIN:"
+     */
+    void handleAdminCommand(const std::string& payload);
+
+    /**
+     * @brief Helper to answer a fleet query and publish the result to its client
+     * @param message UI message after the "QUERY|" prefix: "<client_id>|<query_id>|<query>"
+     */
+    void handleQuery(std::string_view message);
+
+    /**
+     * @struct TcpFilter
+     * @brief One registered content-based subscription
+     */
+    struct TcpFilter {
+        std::string key;            ///< "<client_id>|<filter_id>"
+        std::string topicPrefix;    ///< "filter.<client_id>.<filter_id>."
+        std::string subscription;   ///< Subscription as sent by the client
+        SubscriptionFilter filter;  ///< Topic pattern and payload predicate (or derived stream)
+    };
+
+    /**
+     * @brief Helper to register or remove a content-based subscription
+     * @param message UI message after the "FILTER|" or "UNFILTER|" prefix: "<client_id>|<filter_id>[|<filter>]"
+     * @param add true for FILTER, false for UNFILTER
+     *
+     * Runs on the forwarder thread, the only writer of the filter list.
+     * Filters for derived streams are also registered with the stream handler.
+     */
+    void handleFilter(std::string_view message, bool add);
 
     /**
      * @brief Helper to parse UI command and extract target UAV and command
      * @param message The raw UI command message
-     * @return Pair of target_uav and actual_command
+     * @return Pair of target_uav and actual_command, both viewing into message (no copies)
      */
-    static std::pair<std::string, std::string> parseUICommand(const std::string& message);
+    static std::pair<std::string_view, std::string_view> parseUICommand(std::string_view message);
 
     /**
      * @brief Helper to forward command to specific UAV
      * @param target_uav The UAV name to send command to
      * @param command The command to send
-     * @return true if command was forwarded successfully
+     * @return true if command was forwarded successfully (false: unknown UAV, or the send would block)
+     */
+    bool forwardCommandToUAV(std::string_view target_uav, std::string_view command);
+
+    /**
+     * @brief Check whether a command target selects several UAVs
+     * @param target Command target from parseUICommand()
+     * @return true for "*", "group:<name>" and "tag:<tag>"
+     */
+    static bool isMultiTarget(std::string_view target);
+
+    /**
+     * @brief Helper to send one command to every UAV selected by a multi-UAV target
+     * @param target "*", "group:<name>" or "tag:<tag>"
+     * @param command The command to send
+     * @return Number of UAVs the command was handed to, or -1 if the selector is unknown
+     */
+    int forwardCommandToGroup(std::string_view target, std::string_view command);
+
+    /**
+     * @brief Helper to forward a command that asks for an acknowledgement
+     * @param message UI message after the "CMD|" prefix: "<client_id>|<command_id>|<target>:<command>"
+     *
+     * Only single-UAV targets can be tracked; anything else is answered with UNDELIVERED.
+     */
+    void forwardTrackedCommand(std::string_view message);
+
+    /**
+     * @brief Helper to consume a command acknowledgement packet from a UAV
+     * @param uav_name UAV the packet came from
+     * @param message Packet (PacketHeader + CommandAckPayload)
+     * @return true if the packet was a command acknowledgement (and must not be routed as telemetry)
+     */
+    bool consumeCommandAck(const std::string& uav_name, const zmq::message_t& message);
+
+    /**
+     * @brief Helper to read one acknowledgement sent back on the shared command ROUTER
+     * @param table Routing table snapshot used to resolve the routing ID
+     */
+    void processSharedCommandReply(const RoutingTable& table);
+
+    /**
+     * @brief Helper to publish the outcome of a tracked command to its client
+     * @param client_id Client that sent the command
+     * @param command_id The client's command id
+     * @param status One of CommandStatus
+     */
+    void publishCommandResult(std::string_view client_id, uint32_t command_id, uint8_t status);
+
+    /**
+     * @brief Helper to report every tracked command whose acknowledgement timed out
      */
-    bool forwardCommandToUAV(const std::string& target_uav, const std::string& command);
+    void expirePendingCommands();
 
     /**
      * @brief Extract the UI source type from a command message
@@ -151,20 +424,34 @@ class TcpManager {
      * This is used for logging and debugging purposes.
      * Expected format: "[ui-type]: command_data"
      */
-    static std::string extractUISource(const std::string& message);
+    static std::string extractUISource(std::string_view message);
 
     // Core components
     zmq::context_t& context;              ///< Reference to the ZeroMQ context
-    const Config& config;                 ///< Reference to configuration data
+    const Snapshot<Config>& config;       ///< Published configuration (read at start())
     std::atomic<bool> running{false};     ///< Flag controlling thread execution
     TcpMessageCallback messageCallback_;  ///< Callback for incoming messages
-    mutable std::mutex socketMutex;       ///< Mutex for thread-safe socket operations
+    TcpAdminCallback adminCallback_;      ///< Callback for admin commands (may be empty)
+    TcpReplySink replySink_;              ///< Sink for command results and admin replies (may be empty)
+    TcpQueryCallback queryHandler_;       ///< Handler for fleet queries (may be empty)
+    TcpStreamCallback streamHandler_;     ///< Handler for derived-stream registrations (may be empty)
+    mutable std::mutex socketMutex;       ///< Guards the telemetry ingest sockets
+    std::mutex publishMutex;              ///< Guards the UI PUB socket
+    std::mutex commandMutex;              ///< Guards the command sockets (dedicated PUSH and shared ROUTER)
+    std::mutex registrationMutex;         ///< Serializes routing table writers (readers never lock it)
+    CommandTracker commandTracker_;       ///< Commands awaiting a UAV acknowledgement
 
     // ZeroMQ sockets for different communication patterns
-    std::unique_ptr<zmq::socket_t> pubToUi;                           ///< PUB socket for publishing to UI
-    std::unique_ptr<zmq::socket_t> pullFromUi;                        ///< PULL socket for receiving UI commands
-    std::vector<std::unique_ptr<zmq::socket_t>> uavTelemetrySockets;  ///< PULL sockets for UAV telemetry
-    std::vector<std::unique_ptr<zmq::socket_t>> uavCommandSockets;    ///< PUSH sockets for UAV commands
+    std::unique_ptr<zmq::socket_t> pubToUi;                ///< PUB socket for publishing to UI
+    std::unique_ptr<zmq::socket_t> pullFromUi;             ///< PULL socket for receiving UI commands
+    std::unique_ptr<zmq::socket_t> sharedTelemetrySocket;  ///< ROUTER socket for shared telemetry ingest
+    std::unique_ptr<zmq::socket_t> sharedCommandSocket;    ///< ROUTER socket for shared command delivery
+
+    // Per-UAV sockets and name lookup, swapped atomically on registration
+    Snapshot<RoutingTable> routingTable;
+
+    // Content-based subscriptions, swapped atomically so publishing never waits on a registration
+    Snapshot<std::vector<TcpFilter>> filters_;
 
     // Background processing threads
     std::thread receiverThread;   ///< Thread for receiving telemetry data
@@ -3,7 +3,9 @@
  * @brief Binary packet header definitions for telemetry routing
  *
  * This file defines only the packet header structure needed by the telemetry service
- * for routing binary packets. The service treats payload data as opaque binary data.
+ * for routing binary packets. The service treats payload data as opaque binary data,
+ * except for command acknowledgements, which it consumes itself, and the two status
+ * bytes used to give emergency packets priority.
  */
 
 #ifndef TELEMETRY_PACKETS_H
@@ -25,18 +27,94 @@ struct PacketHeader {
     uint8_t packetType;  ///< Packet type (4: Location, 5: Status)
 };
 
+/**
+ * @brief Envelope prepended to datagrams sent to the shared UDP ingest port
+ *
+ * The shared port serves every UAV, so the sender identifies itself with the numeric
+ * id from service_config.json. The PacketHeader and payload follow unchanged and the
+ * envelope is stripped before routing.
+ */
+struct IngestHeader {
+    uint8_t magic;   ///< Always SharedIngest::MAGIC
+    uint16_t uavId;  ///< UAV id as configured in service_config.json
+};
+
+/**
+ * @brief STATUS packet payload (as sent by the UAVs)
+ *
+ * The priority lanes read only the two leading bytes; the fleet state store
+ * reads the whole payload. The service forwards the payload unchanged.
+ */
+struct StatusPayload {
+    uint8_t systemHealth;  ///< System health (0: Critical, 1: Warning, 2: Good, 3: Excellent)
+    uint8_t missionState;  ///< Mission state (0: Idle, 1: Takeoff, 2: Mission, 3: Landing, 4: Emergency)
+    uint16_t flightTime;   ///< Flight time in seconds
+    float cpuUsage;        ///< CPU usage percentage (0.0-100.0)
+    float memoryUsage;     ///< Memory usage percentage (0.0-100.0)
+};
+
+/**
+ * @brief LOCATION packet payload (as sent by the UAVs)
+ *
+ * Only read by the fleet state store; the service forwards the payload unchanged.
+ */
+struct LocationPayload {
+    double latitude;   ///< Latitude in decimal degrees
+    double longitude;  ///< Longitude in decimal degrees
+    float altitude;    ///< Altitude in meters above sea level
+    float heading;     ///< Heading in degrees (0-359)
+    float speed;       ///< Ground speed in m/s
+};
+
+/**
+ * @brief Command acknowledgement payload
+ *
+ * A UAV answers a tracked command ("CMD|<id>|<command>") with a packet of type
+ * COMMAND_ACK carrying this payload after the PacketHeader. The service relays
+ * the outcome to the UI client as a bare payload on the "ack.<client_id>" topic,
+ * with commandId replaced by the client's own id.
+ */
+struct CommandAckPayload {
+    uint32_t commandId;  ///< Command id being acknowledged (little-endian)
+    uint8_t status;      ///< One of CommandStatus
+};
+
 #pragma pack(pop)
 
 // Packet type constants
 namespace PacketTypes {
     constexpr uint8_t LOCATION = 4;
     constexpr uint8_t STATUS = 5;
+    constexpr uint8_t COMMAND_ACK = 8;
 }  // namespace PacketTypes
 
 // Target ID constants
 namespace TargetIDs {
     constexpr uint8_t CAMERA = 1;
     constexpr uint8_t MAPPING = 2;
+    constexpr uint8_t SERVICE = 0;  ///< Packets consumed by the service itself (command acknowledgements)
 }  // namespace TargetIDs
 
+// Command outcome constants (CommandAckPayload::status)
+namespace CommandStatus {
+    constexpr uint8_t ACKNOWLEDGED = 0;  ///< UAV accepted the command
+    constexpr uint8_t REJECTED = 1;      ///< UAV refused the command
+    constexpr uint8_t TIMEOUT = 2;       ///< No acknowledgement before the deadline
+    constexpr uint8_t UNDELIVERED = 3;   ///< Unknown target or the command could not be queued
+}  // namespace CommandStatus
+
+// Status payload values that make a packet critical
+namespace SystemHealth {
+    constexpr uint8_t CRITICAL = 0;
+}  // namespace SystemHealth
+
+namespace MissionState {
+    constexpr uint8_t EMERGENCY = 4;
+}  // namespace MissionState
+
+// Shared ingest envelope constants
+namespace SharedIngest {
+    constexpr uint8_t MAGIC = 0xA7;
+}  // namespace SharedIngest
+
 #endif  // TELEMETRY_PACKETS_H
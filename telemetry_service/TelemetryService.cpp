@@ -8,9 +8,12 @@
 
 #include "TelemetryService.h"
 
+#include <algorithm>
 #include <array>
+#include <chrono>
 #include <cstdlib>
 #include <filesystem>
+#include <sstream>
 #include <stdexcept>
 #include <string>
 #include <thread>
@@ -26,6 +29,26 @@
 #include <unistd.h>
 #endif
 
+namespace {
+    /**
+     * @brief Wall-clock time in milliseconds since the epoch (aligns the aggregate windows)
+     */
+    int64_t currentTimeMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::system_clock::now().time_since_epoch())
+            .count();
+    }
+
+    /**
+     * @brief Monotonic time in milliseconds (link timeouts must not follow wall-clock jumps)
+     */
+    int64_t steadyTimeMs() {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+}  // namespace
+
 /**
  * @brief Constructor - initializes ZeroMQ context for TCP communication
  *
@@ -43,23 +66,27 @@ TelemetryService::TelemetryService() try : zmqContext_(1) {
 /**
  * @brief Main service execution method
  * @param app_running Reference to atomic boolean controlling service lifecycle
+ * @param reload_requested Reference to atomic flag requesting a configuration reload
  *
  * This is the main service loop that:
  * 1. Loads configuration and initializes logging
  * 2. Creates and starts communication managers
- * 3. Runs until shutdown is requested
+ * 3. Runs until shutdown is requested, reloading the configuration when asked to
  * 4. Performs graceful cleanup
  */
-void TelemetryService::run(std::atomic<bool>& app_running) {
+void TelemetryService::run(std::atomic<bool>& app_running, std::atomic<bool>& reload_requested) {
     try {
         // Load configuration from file (checks environment variable first)
         std::string cfg_path = resolveConfigPath();
-        if (!config_.loadFromFile(cfg_path)) {
+        auto initial_config = std::make_shared<Config>();
+        if (!initial_config->loadFromFile(cfg_path)) {
             throw std::runtime_error("Could not load config file: " + cfg_path);
         }
+        config_.store(std::move(initial_config));
+        auto config = config_.load();
 
         // Set up logging system - resolve log file path relative to executable if needed
-        std::filesystem::path log_path(config_.getLogFile());
+        std::filesystem::path log_path(config->getLogFile());
         if (!log_path.is_absolute()) {
             log_path = std::filesystem::path(getExecutableDir()) / log_path;
         }
@@ -70,28 +97,96 @@ void TelemetryService::run(std::atomic<bool>& app_running) {
         }
 
         // Initialize logging system and log startup information
-        Logger::init(log_path.string());
+        Logger::init(log_path.string(), config->getLogLevel());
         Logger::statusWithDetails("SERVICE", StatusMessage("STARTING"), DetailMessage("Multi-UAV Telemetry Service"));
-        Logger::info("Config loaded successfully. Found " + std::to_string(config_.getUAVs().size()) + " UAVs");
+        Logger::info("Config loaded successfully. Found " + std::to_string(config->getUAVs().size()) + " UAVs");
+
+        // Start the telemetry journal before any packet can arrive. Recording is an
+        // add-on: if the journal cannot be opened the service routes without it.
+        const auto& recorder_config = config->getRecorder();
+        if (recorder_config.enabled) {
+            std::filesystem::path journal_path(recorder_config.directory);
+            if (!journal_path.is_absolute()) {
+                journal_path = std::filesystem::path(getExecutableDir()) / journal_path;
+            }
+            try {
+                recorder_ = std::make_unique<JournalRecorder>(
+                    journal_path,
+                    static_cast<uint64_t>(recorder_config.segment_size_mb) << 20,
+                    static_cast<size_t>(recorder_config.buffer_mb) << 20);
+                for (const auto& uav : config->getUAVs()) {
+                    recorder_->setUavId(uav.name, uav.id);
+                }
+                recorder_->start();
+            } catch (const std::exception& e) {
+                Logger::error("Telemetry journal disabled: " + std::string(e.what()));
+                recorder_.reset();
+            }
+        }
+
+        // The fleet state store is filled by the routing stage like the journal
+        if (config->getStateStore().enabled) {
+            fleetState_ = std::make_unique<FleetState>(config->getStateStore().grid_cell_deg);
+            for (const auto& uav : config->getUAVs()) {
+                fleetState_->setUav(uav.name, uav.id);
+            }
+        }
+        if (config->getLinkMonitor().enabled) {
+            linkMonitor_ = std::make_unique<LinkMonitor>(config->getLinkMonitor().timeout_ms, steadyTimeMs());
+        }
+        if (config->getAnalytics().enabled) {
+            analytics_ = std::make_unique<FleetAnalytics>(config->getAnalytics());
+        }
+        if (!config->getGeofences().empty()) {
+            geofences_ = std::make_unique<GeofenceEngine>(config->getGeofences());
+            Logger::info("Geofences loaded: " + std::to_string(geofences_->size()));
+        }
 
         // Create managers with proper error handling
         bool zmq_started = false;
         bool udp_started = false;
 
         try {
+            // Create the outbound priority lanes; the dispatcher publishes through the managers
+            router_ = std::make_unique<PriorityRouter>([this](PriorityLane lane, const OutboundMessage& message) {
+                if (lane == PriorityLane::COMMAND && tcpManager_) {
+                    tcpManager_->publishReply(message.topic, message.data);
+                } else if (message.channel == OutboundChannel::TCP && tcpManager_) {
+                    tcpManager_->publishTelemetry(message.topic, message.data, message.stream);
+                } else if (message.channel == OutboundChannel::UDP && udpManager_) {
+                    udpManager_->publishTelemetry(message.topic, message.data, message.stream);
+                }
+            });
+            router_->start();
+
             // Create TCP manager with callback for incoming messages
             tcpManager_ = std::make_unique<TcpManager>(
-                zmqContext_, config_, [this](const std::string& source, const std::vector<uint8_t>& data) {
+                zmqContext_,
+                config_,
+                [this](const std::string& source, const std::vector<uint8_t>& data) {
                     this->onZmqMessage(source, data);
-                });
+                },
+                [this](const std::string& payload) { return this->handleAdminCommand(payload); });
+            // Command results and admin replies take the command lane ahead of all telemetry
+            tcpManager_->setCommandReplySink([this](const std::string& topic, std::vector<uint8_t> data) {
+                router_->enqueue(PriorityLane::COMMAND, OutboundMessage{OutboundChannel::TCP, topic, std::move(data)});
+            });
+            tcpManager_->setQueryHandler([this](const std::string& query) { return this->handleFleetQuery(query); });
+            tcpManager_->setStreamHandler([this](const std::string& subscription, bool add) {
+                this->registerDerivedStream(OutboundChannel::TCP, subscription, add);
+            });
 
             // Create UDP manager with callback for incoming messages
             udpManager_ = std::make_unique<UdpManager>(
                 config_, [this](const std::string& source, const std::vector<uint8_t>& data) {
                     this->onUdpMessage(source, data);
                 });
+            udpManager_->setStreamHandler([this](const std::string& subscription, bool add) {
+                this->registerDerivedStream(OutboundChannel::UDP, subscription, add);
+            });
 
             // Start both communication managers with error handling
+            liveUavs_ = config->getUAVs();
             tcpManager_->start();
             zmq_started = true;
 
@@ -110,25 +205,51 @@ void TelemetryService::run(std::atomic<bool>& app_running) {
                 tcpManager_->stop();
                 tcpManager_->join();
             }
+            if (router_) {
+                router_->stop();
+                router_->join();
+            }
+            if (recorder_) {
+                recorder_->stop();
+                recorder_->join();
+            }
             throw;
         }
 
         // Collect port information for startup summary
         std::vector<int> tcp_ports;
         std::vector<int> udp_ports;
-        for (const auto& uav : config_.getUAVs()) {
-            tcp_ports.push_back(uav.tcp_telemetry_port);
-            tcp_ports.push_back(uav.tcp_command_port);
-            udp_ports.push_back(uav.udp_telemetry_port);
+        for (const auto& uav : config->getUAVs()) {
+            if (uav.tcp_telemetry_port > 0)
+                tcp_ports.push_back(uav.tcp_telemetry_port);
+            if (uav.tcp_command_port > 0)
+                tcp_ports.push_back(uav.tcp_command_port);
+            if (uav.udp_telemetry_port > 0)
+                udp_ports.push_back(uav.udp_telemetry_port);
         }
-        tcp_ports.push_back(config_.getUiPorts().tcp_publish_port);
-        tcp_ports.push_back(config_.getUiPorts().tcp_command_port);
-        udp_ports.push_back(config_.getUiPorts().udp_publish_port);
+        const auto& shared = config->getSharedIngest();
+        if (shared.tcp_telemetry_port > 0)
+            tcp_ports.push_back(shared.tcp_telemetry_port);
+        if (shared.tcp_command_port > 0)
+            tcp_ports.push_back(shared.tcp_command_port);
+        if (shared.udp_telemetry_port > 0)
+            udp_ports.push_back(shared.udp_telemetry_port);
+        tcp_ports.push_back(config->getUiPorts().tcp_publish_port);
+        tcp_ports.push_back(config->getUiPorts().tcp_command_port);
+        udp_ports.push_back(config->getUiPorts().udp_publish_port);
 
-        Logger::serviceStarted(static_cast<int>(config_.getUAVs().size()), tcp_ports, udp_ports);
+        Logger::serviceStarted(static_cast<int>(config->getUAVs().size()), tcp_ports, udp_ports);
 
-        // Main service loop - just sleep and wait for shutdown signal
+        // Main service loop - wait for shutdown, reloading the configuration when requested,
+        // closing the windows of the aggregate streams, publishing the fleet analytics and
+        // reporting silent links
         while (app_running) {
+            if (reload_requested.exchange(false)) {
+                reloadConfig();
+            }
+            flushDerivedStreams();
+            publishFleetAnalytics();
+            checkLinks();
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
 
@@ -153,6 +274,17 @@ void TelemetryService::run(std::atomic<bool>& app_running) {
             tcpManager_->join();
         }
 
+        // Stop the priority dispatcher last: no ingest thread can queue messages any more
+        if (router_) {
+            router_->stop();
+            router_->join();
+        }
+        // The recorder writes out what is still buffered and seals its segment
+        if (recorder_) {
+            recorder_->stop();
+            recorder_->join();
+        }
+
         Logger::statusWithDetails(
             "SERVICE", StatusMessage("SHUTDOWN COMPLETE"), DetailMessage("All services stopped gracefully"));
 
@@ -200,12 +332,21 @@ void TelemetryService::onZmqMessage(const std::string& uav_name, const std::vect
  * 1. Parses the binary packet header to determine target and type
  * 2. Uses the UAV name directly from service_config.json
  * 3. Creates a single hierarchical topic for efficient routing
- * 4. Routes the complete binary packet to matching wildcard subscriptions
+ * 4. Queues the complete binary packet for matching wildcard subscriptions
+ *
+ * The packet is not published here: it is queued in its priority lane and the
+ * router's dispatcher thread publishes it, so ingest threads never wait on a
+ * publishing socket and critical status packets overtake bulk telemetry.
  */
 void TelemetryService::processAndPublishTelemetry(const std::vector<uint8_t>& data,
                                                   const std::string& uav_name,
                                                   const std::string& protocol) {
     try {
+        // Packets received just before the UAV was unregistered
+        if (!removedUavs_.empty() && removedUavs_.count(uav_name) != 0) {
+            return;
+        }
+
         // Ensure we have at least enough data for a packet header
         if (data.size() < sizeof(PacketHeader)) {
             Logger::warn("Received packet too small for header from " + uav_name
@@ -244,6 +385,16 @@ void TelemetryService::processAndPublishTelemetry(const std::vector<uint8_t>& da
                 break;
         }
 
+        if (recorder_) {
+            recorder_->record(uav_name, protocol == "TCP" ? JournalProtocol::TCP : JournalProtocol::UDP, data);
+        }
+        if (fleetState_) {
+            fleetState_->update(uav_name, data);
+        }
+        if (analytics_) {
+            analytics_->update(uav_name, data, currentTimeMs());
+        }
+
         // Log packet information
         Logger::info("Received " + type_name + " packet for " + target_name + " from " + uav_name + " ("
                      + std::to_string(data.size()) + " bytes)");
@@ -254,14 +405,38 @@ void TelemetryService::processAndPublishTelemetry(const std::vector<uint8_t>& da
         // Example: "telemetry.UAV_1.camera.location"
 
         // Route to UIs using the same protocol as the source
+        OutboundChannel channel;
         if (protocol == "TCP" && tcpManager_) {
             // Single topic publish - ZeroMQ handles wildcard subscriptions natively
-            tcpManager_->publishTelemetry(topic, data);
+            channel = OutboundChannel::TCP;
         } else if (protocol == "UDP" && udpManager_) {
             // Single topic publish - UDP manager handles wildcard pattern matching
-            udpManager_->publishTelemetry(topic, data);
+            channel = OutboundChannel::UDP;
         } else {
             Logger::error("Cannot publish telemetry - manager not available for protocol: " + protocol);
+            return;
+        }
+        if (linkMonitor_) {
+            std::vector<LinkEvent> link_events;
+            linkMonitor_->seen(uav_name, topic, steadyTimeMs(), link_events);
+            if (!link_events.empty()) {
+                publishLinkEvents(link_events);
+            }
+        }
+
+        // Derived streams are published on every channel that has subscribers, whatever the source protocol
+        if (!derivedStreams_.empty()) {
+            std::vector<DerivedMessage> derived;
+            derivedStreams_.process(uav_name, topic, data, currentTimeMs(), derived);
+            publishDerived(derived);
+        }
+        router_->enqueue(PriorityRouter::classify(data), OutboundMessage{channel, std::move(topic), data});
+
+        if (geofences_) {
+            auto alerts = geofences_->evaluate(uav_name, data);
+            if (!alerts.empty()) {
+                publishGeofenceAlerts(uav_name, alerts);
+            }
         }
 
     } catch (const std::exception& e) {
@@ -270,6 +445,592 @@ void TelemetryService::processAndPublishTelemetry(const std::vector<uint8_t>& da
     }
 }
 
+/**
+ * @brief Register or remove a subscriber of a derived stream
+ * @param channel Channel the subscriber uses
+ * @param subscription "<pattern>[?<expression>]@<spec>"
+ * @param add true to register, false to remove
+ */
+void TelemetryService::registerDerivedStream(OutboundChannel channel,
+                                             const std::string& subscription,
+                                             bool add) {
+    std::lock_guard<std::mutex> lock(processingMutex_);
+    if (add) {
+        derivedStreams_.add(channel, subscription);
+        Logger::info("Derived stream subscribed: " + subscription);
+    } else {
+        derivedStreams_.remove(channel, subscription);
+        Logger::info("Derived stream unsubscribed: " + subscription);
+    }
+}
+
+/**
+ * @brief Publish the aggregate windows that have ended
+ */
+void TelemetryService::flushDerivedStreams() {
+    std::lock_guard<std::mutex> lock(processingMutex_);
+    if (derivedStreams_.empty() || !router_) {
+        return;
+    }
+    std::vector<DerivedMessage> derived;
+    derivedStreams_.flush(currentTimeMs(), derived);
+    publishDerived(derived);
+}
+
+/**
+ * @brief Publish the fleet analytics report when it is due
+ */
+void TelemetryService::publishFleetAnalytics() {
+    std::lock_guard<std::mutex> lock(processingMutex_);
+    int64_t now_ms = currentTimeMs();
+    if (!analytics_ || !router_ || !analytics_->due(now_ms)) {
+        return;
+    }
+    for (const auto& [topic, text] : analytics_->publish(now_ms)) {
+        std::vector<uint8_t> bytes(text.begin(), text.end());
+        if (tcpManager_) {
+            router_->enqueue(PriorityLane::BULK, OutboundMessage{OutboundChannel::TCP, topic, bytes});
+        }
+        if (udpManager_) {
+            router_->enqueue(PriorityLane::BULK, OutboundMessage{OutboundChannel::UDP, topic, std::move(bytes)});
+        }
+    }
+}
+
+/**
+ * @brief Report the links whose timeout expired
+ */
+void TelemetryService::checkLinks() {
+    std::lock_guard<std::mutex> lock(processingMutex_);
+    if (!linkMonitor_ || !router_) {
+        return;
+    }
+    std::vector<LinkEvent> events;
+    linkMonitor_->advance(steadyTimeMs(), events);
+    if (!events.empty()) {
+        publishLinkEvents(events);
+    }
+}
+
+/**
+ * @brief Queue link events for publishing
+ * @param events Transitions reported by the link monitor
+ */
+void TelemetryService::publishLinkEvents(const std::vector<LinkEvent>& events) {
+    for (const auto& event : events) {
+        std::string topic = "uav." + event.uav + ".link";
+        nlohmann::json payload = {
+            {"uav", event.uav}, {"state", event.up ? "up" : "down"}, {"silent_ms", event.silentMs}};
+        if (!event.topic.empty()) {
+            // "telemetry.<UAV>.<target>.<type>" -> "uav.<UAV>.link.<target>.<type>"
+            std::string prefix = "telemetry." + event.uav;
+            topic += event.topic.substr(std::min(prefix.size(), event.topic.size()));
+            payload["topic"] = event.topic;
+        } else if (event.up) {
+            Logger::info("Link up: " + event.uav);
+        } else {
+            Logger::warn("Link down: " + event.uav + " (silent for " + std::to_string(event.silentMs) + " ms)");
+        }
+
+        std::string text = payload.dump();
+        std::vector<uint8_t> bytes(text.begin(), text.end());
+        if (tcpManager_) {
+            router_->enqueue(PriorityLane::CRITICAL, OutboundMessage{OutboundChannel::TCP, topic, bytes});
+        }
+        if (udpManager_) {
+            router_->enqueue(PriorityLane::CRITICAL, OutboundMessage{OutboundChannel::UDP, topic, std::move(bytes)});
+        }
+    }
+}
+
+/**
+ * @brief Queue derived-stream messages in their lanes
+ * @param messages Messages produced by the derived streams
+ */
+void TelemetryService::publishDerived(std::vector<DerivedMessage>& messages) {
+    for (auto& derived : messages) {
+        router_->enqueue(derived.lane, std::move(derived.message));
+    }
+}
+
+/**
+ * @brief Queue geofence alerts for publishing
+ * @param uav_name UAV the alerts are about
+ * @param alerts Transitions reported by the geofence engine
+ */
+void TelemetryService::publishGeofenceAlerts(const std::string& uav_name, const std::vector<GeofenceAlert>& alerts) {
+    for (const auto& alert : alerts) {
+        nlohmann::json payload = {{"uav", uav_name},
+                                  {"fence", alert.fence},
+                                  {"type", alert.keepIn ? "keep_in" : "keep_out"},
+                                  {"event", alert.violation ? "violation" : "cleared"},
+                                  {"latitude", alert.latitude},
+                                  {"longitude", alert.longitude},
+                                  {"altitude", alert.altitude}};
+        std::string text = payload.dump();
+        std::vector<uint8_t> bytes(text.begin(), text.end());
+        std::string topic = "alert." + uav_name + ".geofence." + alert.fence;
+
+        if (alert.violation) {
+            Logger::warn("Geofence violation: " + uav_name + " " + (alert.keepIn ? "left " : "entered ") + alert.fence);
+        } else {
+            Logger::info("Geofence cleared: " + uav_name + " / " + alert.fence);
+        }
+        if (tcpManager_) {
+            router_->enqueue(PriorityLane::CRITICAL, OutboundMessage{OutboundChannel::TCP, topic, bytes});
+        }
+        if (udpManager_) {
+            router_->enqueue(PriorityLane::CRITICAL, OutboundMessage{OutboundChannel::UDP, topic, bytes});
+        }
+    }
+}
+
+/**
+ * @brief Reload the configuration file and apply the differences
+ *
+ * Runs on the main service thread. The new snapshot is published before the
+ * UAV changes are applied, so admin registrations racing with the reload are
+ * validated against the new settings. UAVs registered at runtime are not part
+ * of either file snapshot and are left alone.
+ *
+ * UAV changes are applied in phases: every removed UAV and every UAV whose
+ * sockets must be rebound is unregistered first, then the in-place updates
+ * are applied together, and only then are the new sockets registered. So an
+ * id or port freed by one UAV can be taken by another, whatever their order
+ * in the file.
+ */
+void TelemetryService::reloadConfig() {
+    std::string cfg_path = resolveConfigPath();
+    Logger::statusWithDetails("SERVICE", StatusMessage("RELOADING CONFIG"), DetailMessage(cfg_path));
+
+    auto next = std::make_shared<Config>();
+    try {
+        if (!next->loadFromFile(cfg_path)) {
+            throw std::runtime_error("could not open " + cfg_path);
+        }
+    } catch (const std::exception& e) {
+        Logger::error("Config reload failed, keeping current configuration: " + std::string(e.what()));
+        return;
+    }
+
+    auto current = config_.load();
+    ConfigDiff diff = diffConfigs(*current, *next);
+    if (diff.empty()) {
+        Logger::info("Config reload: no changes");
+        return;
+    }
+    if (diff.endpointsChanged) {
+        Logger::warn("Config reload rejected: ui_ports or shared_ingest changed (restart required)");
+        return;
+    }
+    if (!diff.shiftedIds.empty()) {
+        // A defaulted id follows the list position; the UAVs themselves still send their old id
+        std::string names;
+        for (const auto& name : diff.shiftedIds) {
+            names += (names.empty() ? "" : ", ") + name;
+        }
+        Logger::warn("Config reload rejected: inserting or reordering UAVs would change the id of " + names
+                     + " (give these UAVs an explicit \"id\")");
+        return;
+    }
+    if (diff.logFileChanged) {
+        Logger::warn("Config reload: log_file change takes effect after restart");
+    }
+    if (diff.recorderChanged) {
+        Logger::warn("Config reload: recorder change takes effect after restart");
+    }
+    if (diff.stateStoreChanged) {
+        Logger::warn("Config reload: state_store change takes effect after restart");
+    }
+    if (diff.analyticsChanged) {
+        Logger::warn("Config reload: analytics change takes effect after restart");
+    }
+    if (diff.linkMonitorChanged) {
+        Logger::warn("Config reload: link_monitor change takes effect after restart");
+    }
+
+    config_.store(next);
+    if (diff.logLevelChanged) {
+        Logger::setLevel(next->getLogLevel());
+    }
+    if (diff.geofencesChanged) {
+        auto engine = next->getGeofences().empty() ? nullptr : std::make_unique<GeofenceEngine>(next->getGeofences());
+        std::lock_guard<std::mutex> lock(processingMutex_);
+        geofences_ = std::move(engine);
+    }
+
+    // Apply UAV changes: every removal first, so freed ids and ports can be reused by the rest
+    for (const auto& name : diff.removedUavs) {
+        unregisterUav(name);
+    }
+    for (const auto& uav : diff.changedUavs) {
+        unregisterUav(uav.name);
+    }
+    size_t failures = diff.updatedUavs.empty() ? 0 : updateUavs(diff.updatedUavs);
+    for (const auto& uav : diff.changedUavs) {
+        failures += registerUavWithRetry(uav) ? 0 : 1;
+    }
+    for (const auto& uav : diff.addedUavs) {
+        failures += registerUavWithRetry(uav) ? 0 : 1;
+    }
+    // UAV changes above already rebuilt the groups; this covers edits to "groups" alone
+    if (diff.groupsChanged) {
+        tcpManager_->refreshGroups();
+    }
+
+    Logger::statusWithDetails("SERVICE",
+                              StatusMessage("CONFIG RELOADED"),
+                              DetailMessage("+" + std::to_string(diff.addedUavs.size()) + " -"
+                                            + std::to_string(diff.removedUavs.size()) + " ~"
+                                            + std::to_string(diff.changedUavs.size() + diff.updatedUavs.size())
+                                            + " UAVs, "
+                                            + std::to_string(failures) + " failed"));
+}
+
+/**
+ * @brief Register a UAV whose ports may still be held by its previous sockets
+ * @param uav UAV configuration
+ * @return true if the UAV was registered
+ *
+ * Removed sockets are closed by the threads that last used them, which happens
+ * within one poll cycle, so a few short retries cover the handover.
+ */
+bool TelemetryService::registerUavWithRetry(const UAVConfig& uav) {
+    constexpr int max_attempts = 5;
+    for (int attempt = 1;; ++attempt) {
+        try {
+            registerUav(uav);
+            return true;
+        } catch (const std::exception& e) {
+            if (attempt == max_attempts) {
+                Logger::error("Config reload: could not register UAV " + uav.name + ": " + std::string(e.what()));
+                return false;
+            }
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+}
+
+/**
+ * @brief Handle an admin command received on the UI command port
+ * @param payload JSON text after "ADMIN:"
+ * @return Result line published on "admin.reply"
+ *
+ * Called on the TCP forwarder thread. Exceptions are turned into "ERROR ..."
+ * replies by the TcpManager.
+ */
+std::string TelemetryService::handleAdminCommand(const std::string& payload) {
+    nlohmann::json request = nlohmann::json::parse(payload);
+    std::string op = request.value("op", "");
+
+    if (op == "register") {
+        if (!request.contains("uav")) {
+            throw std::runtime_error("register requires a 'uav' object");
+        }
+        int next_id = 1;
+        {
+            std::lock_guard<std::mutex> lock(registrationMutex_);
+            for (const auto& uav : liveUavs_) {
+                next_id = std::max(next_id, static_cast<int>(uav.id) + 1);
+            }
+        }
+        UAVConfig uav = Config::parseUAV(request["uav"], config_.load()->getSharedIngest(), next_id);
+        registerUav(uav);
+        return "OK registered " + uav.name + " (id " + std::to_string(uav.id) + ")";
+    }
+    if (op == "unregister") {
+        std::string name = request.value("name", "");
+        if (!unregisterUav(name)) {
+            throw std::runtime_error("UAV '" + name + "' is not registered");
+        }
+        return "OK unregistered " + name;
+    }
+    if (op == "list") {
+        std::lock_guard<std::mutex> lock(registrationMutex_);
+        std::string names;
+        for (const auto& uav : liveUavs_) {
+            names += (names.empty() ? "" : ",") + uav.name;
+        }
+        return "OK " + names;
+    }
+    if (op == "state") {
+        if (!fleetState_) {
+            throw std::runtime_error("Fleet state store is disabled (add a 'state_store' section to the config)");
+        }
+        nlohmann::json uavs = nlohmann::json::array();
+        fleetState_->read([&uavs](const FleetColumns& fleet) {
+            for (size_t row = 0; row < fleet.size(); ++row) {
+                if (!fleet.registered[row]) {
+                    continue;
+                }
+                nlohmann::json uav = {{"name", fleet.names[row]}, {"id", row}};
+                if (fleet.locationNs[row] != 0) {
+                    uav["location"] = {{"received_ns", fleet.locationNs[row]},
+                                       {"latitude", fleet.latitude[row]},
+                                       {"longitude", fleet.longitude[row]},
+                                       {"altitude", fleet.altitude[row]},
+                                       {"heading", fleet.heading[row]},
+                                       {"speed", fleet.speed[row]}};
+                }
+                if (fleet.statusNs[row] != 0) {
+                    uav["status"] = {{"received_ns", fleet.statusNs[row]},
+                                     {"system_health", fleet.systemHealth[row]},
+                                     {"mission_state", fleet.missionState[row]},
+                                     {"flight_time", fleet.flightTime[row]},
+                                     {"cpu_usage", fleet.cpuUsage[row]},
+                                     {"memory_usage", fleet.memoryUsage[row]}};
+                }
+                uavs.push_back(std::move(uav));
+            }
+        });
+        return "OK " + uavs.dump();
+    }
+    throw std::runtime_error("Unknown admin op '" + op + "' (expected register, unregister, list or state)");
+}
+
+/**
+ * @brief Answer a fleet query received on the UI command port
+ * @param query "radius <lat> <lon> <meters>" or "bbox <min_lat> <min_lon> <max_lat> <max_lon>"
+ * @return JSON array with the latest position of each matching UAV
+ *
+ * Called on the TCP forwarder thread. Each entry holds the UAV name, its latest
+ * location and the age of that location in milliseconds. Exceptions are turned
+ * into error replies by the TcpManager.
+ */
+nlohmann::json TelemetryService::handleFleetQuery(const std::string& query) const {
+    if (!fleetState_) {
+        throw std::runtime_error("Fleet state store is disabled (add a 'state_store' section to the config)");
+    }
+    std::istringstream input(query);
+    std::string kind;
+    input >> kind;
+
+    std::vector<UavState> found;
+    if (kind == "radius") {
+        double latitude = 0;
+        double longitude = 0;
+        double meters = 0;
+        if (!(input >> latitude >> longitude >> meters) || meters < 0) {
+            throw std::runtime_error("expected 'radius <lat> <lon> <meters>'");
+        }
+        found = fleetState_->withinRadius(latitude, longitude, meters);
+    } else if (kind == "bbox") {
+        double min_latitude = 0;
+        double min_longitude = 0;
+        double max_latitude = 0;
+        double max_longitude = 0;
+        if (!(input >> min_latitude >> min_longitude >> max_latitude >> max_longitude)
+            || min_latitude > max_latitude) {
+            throw std::runtime_error("expected 'bbox <min_lat> <min_lon> <max_lat> <max_lon>'");
+        }
+        found = fleetState_->withinBox(min_latitude, min_longitude, max_latitude, max_longitude);
+    } else {
+        throw std::runtime_error("Unknown query '" + kind + "' (expected radius or bbox)");
+    }
+
+    int64_t now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::system_clock::now().time_since_epoch())
+                         .count();
+    nlohmann::json uavs = nlohmann::json::array();
+    for (const auto& uav : found) {
+        uavs.push_back({{"name", uav.name},
+                        {"latitude", uav.latitude},
+                        {"longitude", uav.longitude},
+                        {"altitude", uav.altitude},
+                        {"heading", uav.heading},
+                        {"speed", uav.speed},
+                        {"age_ms", (now_ns - uav.locationNs) / 1000000}});
+    }
+    return uavs;
+}
+
+/**
+ * @brief Add a UAV to the running service
+ * @param uav Validated UAV configuration
+ *
+ * Checks the UAV against every live UAV and every service port, then binds its
+ * sockets. Each manager publishes the UAV only after its sockets are ready, so
+ * telemetry from other UAVs keeps flowing throughout.
+ */
+void TelemetryService::registerUav(const UAVConfig& uav) {
+    std::lock_guard<std::mutex> lock(registrationMutex_);
+
+    // Ports already bound by the service (0 entries are harmless: UAV ports are never 0 when dedicated)
+    auto config = config_.load();
+    const auto& ui = config->getUiPorts();
+    const auto& shared = config->getSharedIngest();
+    std::vector<int> used_ports = {ui.tcp_command_port,
+                                   ui.tcp_publish_port,
+                                   ui.udp_publish_port,
+                                   shared.tcp_telemetry_port,
+                                   shared.tcp_command_port,
+                                   shared.udp_telemetry_port};
+    for (const auto& live : liveUavs_) {
+        if (live.name == uav.name) {
+            throw std::runtime_error("UAV '" + uav.name + "' is already registered");
+        }
+        if (live.id == uav.id) {
+            throw std::runtime_error("UAV id " + std::to_string(uav.id) + " is already used by " + live.name);
+        }
+        used_ports.insert(used_ports.end(), {live.tcp_telemetry_port, live.tcp_command_port, live.udp_telemetry_port});
+    }
+    for (int port : {uav.tcp_telemetry_port, uav.tcp_command_port, uav.udp_telemetry_port}) {
+        if (port > 0 && std::find(used_ports.begin(), used_ports.end(), port) != used_ports.end()) {
+            throw std::runtime_error("Port " + std::to_string(port) + " is already in use");
+        }
+    }
+
+    tcpManager_->addUav(uav);
+    try {
+        udpManager_->addUav(uav);
+    } catch (const std::exception&) {
+        tcpManager_->removeUav(uav.name);
+        throw;
+    }
+    liveUavs_.push_back(uav);
+    {
+        std::lock_guard<std::mutex> processing_lock(processingMutex_);
+        removedUavs_.erase(uav.name);
+    }
+    if (recorder_) {
+        recorder_->setUavId(uav.name, uav.id);
+    }
+    if (fleetState_) {
+        fleetState_->setUav(uav.name, uav.id);
+    }
+    Logger::statusWithDetails("SERVICE",
+                              StatusMessage("UAV " + uav.name + " registered"),
+                              DetailMessage("UAVs: " + std::to_string(liveUavs_.size())));
+}
+
+/**
+ * @brief Remove a UAV from the running service
+ * @param name UAV name
+ * @return true if the UAV was registered
+ *
+ * The UAV is unpublished from the routing tables first, so no new traffic is
+ * routed to it; its sockets close once in-flight users have let go of them.
+ * Its link, analytics, geofence and journal state is dropped as well, so it
+ * is not reported as a link going down, and packets already on their way are
+ * discarded instead of recreating that state.
+ */
+bool TelemetryService::unregisterUav(const std::string& name) {
+    std::lock_guard<std::mutex> lock(registrationMutex_);
+    auto uav_it = std::find_if(
+        liveUavs_.begin(), liveUavs_.end(), [&name](const UAVConfig& uav) { return uav.name == name; });
+    if (uav_it == liveUavs_.end()) {
+        return false;
+    }
+
+    tcpManager_->removeUav(name);
+    udpManager_->removeUav(name);
+    if (fleetState_) {
+        fleetState_->removeUav(name);
+    }
+    if (recorder_) {
+        recorder_->removeUav(name);
+    }
+    {
+        std::lock_guard<std::mutex> processing_lock(processingMutex_);
+        removedUavs_.insert(name);
+        if (linkMonitor_) {
+            linkMonitor_->removeUav(name);
+        }
+        if (analytics_) {
+            analytics_->removeUav(name);
+        }
+        if (geofences_) {
+            geofences_->removeUav(name);
+        }
+    }
+    liveUavs_.erase(uav_it);
+    Logger::statusWithDetails("SERVICE",
+                              StatusMessage("UAV " + name + " unregistered"),
+                              DetailMessage("UAVs: " + std::to_string(liveUavs_.size())));
+    return true;
+}
+
+/**
+ * @brief Apply new settings to registered UAVs without rebinding their sockets
+ * @param uavs New settings (same names and ports as the registered UAVs)
+ * @return Number of UAVs left unchanged because their new id is taken
+ *
+ * An entry whose new id belongs to a UAV outside the batch (e.g. one
+ * registered at runtime) is dropped, and so, in turn, is any entry that would
+ * take the id of a dropped one. The rest is applied as one step per component:
+ * old ids are released before new ones are claimed.
+ */
+size_t TelemetryService::updateUavs(std::vector<UAVConfig> uavs) {
+    std::lock_guard<std::mutex> lock(registrationMutex_);
+    auto live_of = [this](const std::string& name) {
+        return std::find_if(
+            liveUavs_.begin(), liveUavs_.end(), [&name](const UAVConfig& live) { return live.name == name; });
+    };
+    size_t skipped = 0;
+    for (auto it = uavs.begin(); it != uavs.end();) {
+        if (live_of(it->name) == liveUavs_.end()) {
+            Logger::error("Config reload: UAV " + it->name + " is not registered, update skipped");
+            it = uavs.erase(it);
+            ++skipped;
+        } else {
+            ++it;
+        }
+    }
+
+    // Ids held after the update by UAVs outside the batch; grows as entries are dropped
+    std::unordered_map<uint16_t, std::string> taken;
+    for (const auto& live : liveUavs_) {
+        taken.emplace(live.id, live.name);
+    }
+    for (const auto& uav : uavs) {
+        taken.erase(live_of(uav.name)->id);
+    }
+    for (bool dropped = true; dropped;) {
+        dropped = false;
+        for (auto it = uavs.begin(); it != uavs.end(); ++it) {
+            auto taken_it = taken.find(it->id);
+            if (taken_it != taken.end()) {
+                Logger::error("Config reload: UAV " + it->name + " keeps its settings, id " + std::to_string(it->id)
+                              + " is used by " + taken_it->second);
+                taken.emplace(live_of(it->name)->id, it->name);
+                uavs.erase(it);
+                ++skipped;
+                dropped = true;
+                break;
+            }
+        }
+    }
+    if (uavs.empty()) {
+        return skipped;
+    }
+
+    tcpManager_->updateUavs(uavs);
+    udpManager_->updateUavs(uavs);
+    std::vector<const UAVConfig*> moved;
+    for (const auto& uav : uavs) {
+        auto live = live_of(uav.name);
+        if (live->id != uav.id) {
+            moved.push_back(&uav);
+            if (fleetState_) {
+                fleetState_->removeUav(uav.name);
+            }
+        }
+        *live = uav;
+    }
+    for (const UAVConfig* uav : moved) {
+        if (recorder_) {
+            recorder_->setUavId(uav->name, uav->id);
+        }
+        if (fleetState_) {
+            fleetState_->setUav(uav->name, uav->id);
+        }
+    }
+    Logger::statusWithDetails("SERVICE",
+                              StatusMessage(std::to_string(uavs.size()) + " UAV(s) updated in place"),
+                              DetailMessage(std::to_string(moved.size()) + " with a new id"));
+    return skipped;
+}
+
 /**
  * @brief Resolves the configuration file path from environment or defaults
  * @return Full path to the configuration file to use
@@ -15,9 +15,18 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "Config.h"
+#include "DerivedStreams.h"
+#include "FleetAnalytics.h"
+#include "FleetState.h"
+#include "Geofence.h"
+#include "JournalRecorder.h"
+#include "LinkMonitor.h"
+#include "PriorityRouter.h"
+#include "Snapshot.h"
 #include "TcpManager.h"
 #include "UdpManager.h"
 
@@ -26,10 +35,17 @@
  * @brief Main service class that orchestrates the telemetry communication system
  *
  * The TelemetryService class is responsible for:
- * - Loading configuration from JSON files
+ * - Loading configuration from JSON files (and reloading it on request)
  * - Managing TCP and UDP communication channels
  * - Processing and routing telemetry messages between UAVs and UI components
+ * - Publishing through priority lanes so commands and critical status overtake bulk telemetry
+ * - Recording every ingested packet to the telemetry journal (optional)
+ * - Keeping the latest location and status of every UAV in the fleet state store (optional)
+ * - Computing downsampled and aggregated streams requested by subscribers
+ * - Publishing rolling fleet health statistics (optional)
+ * - Reporting UAVs and topics that go silent or come back ("uav.<UAV>.link")
  * - Logging service activities
+ * - Adding and removing UAVs at runtime (admin commands)
  * - Coordinating graceful shutdown
  */
 class TelemetryService {
@@ -42,15 +58,16 @@ class TelemetryService {
     /**
      * @brief Main service execution loop
      * @param app_running Reference to atomic boolean that controls the service lifecycle
+     * @param reload_requested Reference to atomic flag set (e.g. by SIGHUP) to reload the configuration
      *
      * This method:
      * 1. Loads configuration from file
      * 2. Initializes logging system
      * 3. Creates and starts TCP and UDP managers
-     * 4. Runs the main service loop until shutdown is requested
+     * 4. Runs the main service loop until shutdown is requested, reloading the configuration on request
      * 5. Performs graceful cleanup
      */
-    void run(std::atomic<bool>& app_running);
+    void run(std::atomic<bool>& app_running, std::atomic<bool>& reload_requested);
 
    private:
     /**
@@ -80,15 +97,148 @@ class TelemetryService {
      * @param protocol The protocol used (TCP or UDP)
      *
      * This method:
-     * 1. Parses the binary packet header to determine target and type
+     * 1. Parses the binary packet header to determine target and type (records the packet and updates
+     *    the fleet state)
      * 2. Uses the UAV name directly
      * 3. Creates appropriate topic names for flexible routing
-     * 4. Routes the complete binary packet to UI components
+     * 4. Queues the complete binary packet for UI components in its priority lane (and feeds the
+     *    derived streams)
      */
     void processAndPublishTelemetry(const std::vector<uint8_t>& data,
                                     const std::string& uav_name,
                                     const std::string& protocol);
 
+    /**
+     * @brief Reload the configuration file and apply the differences
+     *
+     * Loads a new Config, diffs it against the current snapshot and applies
+     * UAV additions, removals and changes plus tuning knobs (log_level). Changes
+     * to ui_ports or shared_ingest need a restart, and a UAV whose defaulted id
+     * would change with its list position must be given an explicit id, so such
+     * reloads are rejected. On any load error the current configuration stays
+     * in effect.
+     */
+    void reloadConfig();
+
+    /**
+     * @brief Register a UAV whose ports may still be held by its previous sockets
+     * @param uav UAV configuration
+     * @return true if the UAV was registered
+     *
+     * Used by reloadConfig() after a UAV was removed and re-added with new
+     * settings: the old sockets close asynchronously, so binding is retried briefly.
+     */
+    bool registerUavWithRetry(const UAVConfig& uav);
+
+    /**
+     * @brief Handle an admin command received on the UI command port
+     * @param payload JSON text after "ADMIN:", e.g. {"op":"register","uav":{...}}
+     * @return Result line published on "admin.reply"
+     * @throws std::exception on malformed or rejected commands (reported as "ERROR ...")
+     *
+     * Supported operations:
+     * - {"op":"register","uav":{...}}   - same fields as an entry of "uavs" in service_config.json
+     * - {"op":"unregister","name":"..."}
+     * - {"op":"list"}
+     * - {"op":"state"}                  - latest location and status of every UAV (needs "state_store")
+     */
+    std::string handleAdminCommand(const std::string& payload);
+
+    /**
+     * @brief Answer a fleet query received on the UI command port
+     * @param query Query text, one of:
+     *              - "radius <lat> <lon> <meters>"                 - UAVs within a great-circle distance, nearest first
+     *              - "bbox <min_lat> <min_lon> <max_lat> <max_lon>" - UAVs inside a box (min_lon > max_lon crosses
+     *                                                                 the antimeridian)
+     * @return JSON array with the latest position of each matching UAV
+     * @throws std::runtime_error on malformed queries or when the fleet state store is disabled
+     *
+     * Answered from the fleet state store's spatial index.
+     */
+    nlohmann::json handleFleetQuery(const std::string& query) const;
+
+    /**
+     * @brief Register or remove a subscriber of a derived stream
+     * @param channel Channel the subscriber uses
+     * @param subscription "<pattern>[?<expression>]@<spec>"
+     * @param add true to register, false to remove
+     * @throws std::runtime_error if the stream spec is invalid
+     *
+     * Called by the managers when a client asks for a derived stream.
+     */
+    void registerDerivedStream(OutboundChannel channel, const std::string& subscription, bool add);
+
+    /**
+     * @brief Publish the aggregate windows that have ended (called from the main loop)
+     */
+    void flushDerivedStreams();
+
+    /**
+     * @brief Publish the fleet analytics report when it is due (called from the main loop)
+     *
+     * Every message goes out on every running channel in the bulk lane.
+     */
+    void publishFleetAnalytics();
+
+    /**
+     * @brief Report the links whose timeout expired (called from the main loop)
+     */
+    void checkLinks();
+
+    /**
+     * @brief Queue link events for publishing
+     * @param events Transitions reported by the link monitor
+     *
+     * A UAV's events go to "uav.<UAV>.link", a topic's to
+     * "uav.<UAV>.link.<target>.<type>", as JSON in the critical lane on every
+     * running channel.
+     */
+    void publishLinkEvents(const std::vector<LinkEvent>& events);
+
+    /**
+     * @brief Queue derived-stream messages in their lanes
+     * @param messages Messages produced by the derived streams
+     */
+    void publishDerived(std::vector<DerivedMessage>& messages);
+
+    /**
+     * @brief Queue geofence alerts for publishing
+     * @param uav_name UAV the alerts are about
+     * @param alerts Transitions reported by the geofence engine
+     *
+     * Each alert is published as JSON on "alert.<UAV>.geofence.<fence>" in the
+     * critical lane, on every running channel, so UIs see it whichever protocol
+     * the UAV uses.
+     */
+    void publishGeofenceAlerts(const std::string& uav_name, const std::vector<GeofenceAlert>& alerts);
+
+    /**
+     * @brief Add a UAV to the running service
+     * @param uav Validated UAV configuration
+     * @throws std::runtime_error if the name, id or a dedicated port is already in use
+     *
+     * Binds the UAV's sockets in both managers; a failure in the UDP manager
+     * rolls back the TCP registration.
+     */
+    void registerUav(const UAVConfig& uav);
+
+    /**
+     * @brief Remove a UAV from the running service
+     * @param name UAV name
+     * @return true if the UAV was registered
+     */
+    bool unregisterUav(const std::string& name);
+
+    /**
+     * @brief Apply new settings to registered UAVs without rebinding their sockets
+     * @param uavs New settings of UAVs whose ports (and dedicated UDP address) are unchanged
+     * @return Number of UAVs left unchanged because their new id is taken
+     *
+     * Used by reloadConfig() for changes to address, id or tags. All entries
+     * are applied together, so UAVs may swap ids.
+     */
+    size_t updateUavs(std::vector<UAVConfig> uavs);
+
     /**
      * @brief Resolves the configuration file path
      * @return Full path to the configuration file
@@ -107,11 +257,23 @@ class TelemetryService {
     static std::string getExecutableDir();
 
     // Core service components
-    Config config_;                           ///< Configuration data loaded from JSON
-    zmq::context_t zmqContext_;               ///< ZeroMQ context for all ZMQ operations
-    std::unique_ptr<TcpManager> tcpManager_;  ///< Manages TCP communications
-    std::unique_ptr<UdpManager> udpManager_;  ///< Manages UDP communications
-    mutable std::mutex processingMutex_;      ///< Mutex for thread-safe message processing
+    Snapshot<Config> config_;    ///< Current configuration (replaced as a whole on reload)
+    zmq::context_t zmqContext_;  ///< ZeroMQ context for all ZMQ operations
+    // Declared before the managers so it outlives their ingest threads
+    std::unique_ptr<JournalRecorder> recorder_;  ///< Telemetry journal (null when recording is off)
+    std::unique_ptr<FleetState> fleetState_;     ///< Latest state per UAV (null when the store is off)
+    std::unique_ptr<GeofenceEngine> geofences_;  ///< Fence checks (null without fences; guarded by processingMutex_)
+    DerivedStreams derivedStreams_;              ///< Downsampled/aggregated streams (guarded by processingMutex_)
+    std::unique_ptr<FleetAnalytics> analytics_;  ///< Fleet statistics (null when off; guarded by processingMutex_)
+    std::unique_ptr<LinkMonitor> linkMonitor_;   ///< Stale-link detection (null when off; guarded by processingMutex_)
+    std::unique_ptr<TcpManager> tcpManager_;     ///< Manages TCP communications
+    std::unique_ptr<UdpManager> udpManager_;     ///< Manages UDP communications
+    // Declared after the managers so its dispatcher thread is gone before they are destroyed
+    std::unique_ptr<PriorityRouter> router_;       ///< Outbound priority lanes (commands, critical, bulk)
+    mutable std::mutex processingMutex_;           ///< Mutex for thread-safe message processing
+    std::vector<UAVConfig> liveUavs_;              ///< UAVs currently served (startup config + runtime changes)
+    std::unordered_set<std::string> removedUavs_;  ///< Unregistered UAVs, late packets dropped (processingMutex_)
+    std::mutex registrationMutex_;                 ///< Serializes registerUav/unregisterUav
 };
 
 #endif  // TELEMETRYSERVICE_H
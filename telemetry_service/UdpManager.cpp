@@ -9,7 +9,9 @@
 
 #include "UdpManager.h"
 
-#include <sstream>
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
 
 #include "Logger.h"
 #include "TelemetryPackets.h"
@@ -33,6 +35,34 @@ UdpServer::UdpServer(boost::asio::io_context& io_context,
                      const std::string& uav_name,
                      UdpMessageCallback callback)
     : socket_(io_context), uav_name_(uav_name), messageCallback_(std::move(callback)) {
+    bindAndReceive(io_context, address, port);
+}
+
+/**
+ * @brief Constructor - initializes the shared UDP ingest server
+ * @param io_context Boost.Asio I/O context for async operations
+ * @param address IP address to bind to
+ * @param port UDP port number to listen on
+ * @param resolver Maps the IngestHeader UAV id to a UAV name
+ * @param callback Function to call when messages are received
+ */
+UdpServer::UdpServer(boost::asio::io_context& io_context,
+                     const std::string& address,
+                     short port,
+                     UavIdResolver resolver,
+                     UdpMessageCallback callback)
+    : socket_(io_context), uav_name_("shared ingest"), resolver_(std::move(resolver)),
+      messageCallback_(std::move(callback)) {
+    bindAndReceive(io_context, address, port);
+}
+
+/**
+ * @brief Bind the socket and start the asynchronous receive loop
+ * @param io_context Boost.Asio I/O context used for address resolution
+ * @param address IP address to bind to ("*" for all interfaces)
+ * @param port UDP port number to listen on
+ */
+void UdpServer::bindAndReceive(boost::asio::io_context& io_context, const std::string& address, short port) {
     try {
         udp::endpoint bind_endpoint;
 
@@ -51,17 +81,49 @@ UdpServer::UdpServer(boost::asio::io_context& io_context,
         socket_.bind(bind_endpoint);
 
         Logger::statusWithDetails("UDP",
-                                  StatusMessage("Server bound for " + uav_name),
+                                  StatusMessage("Server bound for " + uav_name_),
                                   DetailMessage((address == "*" ? "0.0.0.0" : address) + ":" + std::to_string(port)));
 
         // Start the asynchronous receive loop
         doReceive();
     } catch (const std::exception& e) {
-        Logger::error("UDP Server setup failed for " + uav_name + ": " + std::string(e.what()));
+        Logger::error("UDP Server setup failed for " + uav_name_ + ": " + std::string(e.what()));
         throw;
     }
 }
 
+/**
+ * @brief Strip the IngestHeader from a shared-port datagram and dispatch it
+ * @param bytes_recvd Number of bytes received into data_
+ *
+ * The UAV id is resolved through the manager's id table; datagrams with a bad
+ * magic byte or an unknown id are dropped.
+ */
+void UdpServer::dispatchShared(std::size_t bytes_recvd) {
+    if (bytes_recvd < sizeof(IngestHeader)) {
+        Logger::warn("Shared UDP datagram too small for ingest header (" + std::to_string(bytes_recvd) + " bytes)");
+        return;
+    }
+
+    IngestHeader ingest{};
+    std::memcpy(&ingest, data_.data(), sizeof(IngestHeader));
+    if (ingest.magic != SharedIngest::MAGIC) {
+        Logger::warn("Shared UDP datagram with invalid ingest magic from " + remote_endpoint_.address().to_string());
+        return;
+    }
+
+    const std::string* uav_name = resolver_(ingest.uavId);
+    if (uav_name == nullptr) {
+        Logger::warn("Shared UDP datagram from unknown UAV id " + std::to_string(ingest.uavId));
+        return;
+    }
+
+    std::vector<uint8_t> received_data(data_.data() + sizeof(IngestHeader), data_.data() + bytes_recvd);
+    if (messageCallback_) {
+        messageCallback_(*uav_name, received_data);
+    }
+}
+
 /**
  * @brief Start asynchronous receive operation
  *
@@ -76,11 +138,16 @@ void UdpServer::doReceive() {
         [this](boost::system::error_code error_code, std::size_t bytes_recvd) {
             if (!error_code && bytes_recvd > 0) {
                 try {
-                    // Process received binary data if no error occurred
-                    std::vector<uint8_t> received_data(data_.data(), data_.data() + bytes_recvd);
-                    // Call callback with UAV name directly
-                    if (messageCallback_) {
-                        messageCallback_(uav_name_, received_data);
+                    if (resolver_) {
+                        // Shared port: identity comes from the ingest header
+                        dispatchShared(bytes_recvd);
+                    } else {
+                        // Process received binary data if no error occurred
+                        std::vector<uint8_t> received_data(data_.data(), data_.data() + bytes_recvd);
+                        // Call callback with UAV name directly
+                        if (messageCallback_) {
+                            messageCallback_(uav_name_, received_data);
+                        }
                     }
                 } catch (const std::exception& e) {
                     Logger::error("UDP receive processing error for " + uav_name_ + ": " + std::string(e.what()));
@@ -89,24 +156,36 @@ void UdpServer::doReceive() {
                 Logger::error("UDP receive error for " + uav_name_ + ": " + error_code.message());
             }
 
-            // Continue the receive loop only if no critical error
-            if (!error_code || error_code == boost::asio::error::message_size) {
+            // Continue the receive loop only if no critical error and the server was not closed meanwhile
+            if ((!error_code || error_code == boost::asio::error::message_size) && socket_.is_open()) {
                 doReceive();
             }
         });
 }
 
+/**
+ * @brief Close the socket and end the receive loop
+ *
+ * The outstanding async_receive_from completes with operation_aborted, which
+ * doReceive() treats as the end of the loop. A receive that had already
+ * completed does not start another one once the socket is closed.
+ */
+void UdpServer::close() {
+    boost::system::error_code ignored;
+    socket_.close(ignored);
+}
+
 // --- UdpManager Implementation ---
 
 /**
  * @brief Constructor - initializes UDP manager with configuration
- * @param config Configuration containing UAV and UI port settings
+ * @param config Configuration snapshot containing UAV and UI port settings
  * @param callback Function to call when UDP messages are received
  *
  * Initializes the UDP manager with the necessary configuration and sets up
  * the callback for handling incoming telemetry messages.
  */
-UdpManager::UdpManager(const Config& config, UdpMessageCallback callback)
+UdpManager::UdpManager(const Snapshot<Config>& config, UdpMessageCallback callback)
     : config_(config), messageCallback_(std::move(callback)) {}
 
 /**
@@ -127,7 +206,8 @@ UdpManager::~UdpManager() {
         }
         publishSocket_.reset();
         subscriptionSocket_.reset();
-        servers_.clear();
+        uavServers_.clear();
+        sharedServer_.reset();
     } catch (const std::exception& e) {
         Logger::error("UDP cleanup error: " + std::string(e.what()));
     }
@@ -138,36 +218,57 @@ UdpManager::~UdpManager() {
  *
  * This method:
  * 1. Creates UDP servers for all UAVs with valid UDP ports
- * 2. Sets up UDP publishing socket for UI communication
- * 3. Starts a background thread to run the I/O context
- * 4. Handles any errors that occur during UDP operations
+ * 2. Creates the shared ingest UDP server if configured
+ * 3. Sets up UDP publishing socket for UI communication
+ * 4. Starts a background thread to run the I/O context
+ * 5. Handles any errors that occur during UDP operations
  */
 void UdpManager::start() {
     running_ = true;
 
     try {
         std::lock_guard<std::mutex> lock(socketMutex_);
+        auto cfg = config_.load();
 
-        // Create UDP servers for each UAV with UDP telemetry enabled
-        for (const auto& uav : config_.getUAVs()) {
+        // Create UDP servers for each UAV with a dedicated UDP telemetry port
+        for (const auto& uav : cfg->getUAVs()) {
             if (uav.udp_telemetry_port > 0 && uav.udp_telemetry_port <= 65535) {
-                servers_.push_back(std::make_unique<UdpServer>(
-                    io_context_, uav.ip, uav.udp_telemetry_port, uav.name, messageCallback_));
+                uavServers_[uav.name] = std::make_unique<UdpServer>(
+                    io_context_, uav.ip, uav.udp_telemetry_port, uav.name, messageCallback_);
             } else if (uav.udp_telemetry_port > 0) {
                 Logger::warn("Invalid UDP port for " + uav.name + ": " + std::to_string(uav.udp_telemetry_port));
             }
         }
 
+        // Create the shared ingest server; UAV ids index directly into uavNamesById_
+        int shared_port = cfg->getSharedIngest().udp_telemetry_port;
+        for (const auto& uav : cfg->getUAVs()) {
+            if (uav.id >= uavNamesById_.size()) {
+                uavNamesById_.resize(static_cast<size_t>(uav.id) + 1);
+            }
+            uavNamesById_[uav.id] = uav.name;
+        }
+        if (shared_port > 0) {
+            auto resolver = [this](uint16_t uav_id) -> const std::string* {
+                if (uav_id >= uavNamesById_.size() || uavNamesById_[uav_id].empty()) {
+                    return nullptr;
+                }
+                return &uavNamesById_[uav_id];
+            };
+            sharedServer_ = std::make_unique<UdpServer>(
+                io_context_, "*", static_cast<short>(shared_port), resolver, messageCallback_);
+        }
+
         // Set up UDP publishing socket (random port for sending data to clients)
         publishSocket_ = std::make_unique<udp::socket>(io_context_, udp::endpoint(udp::v4(), 0));
 
         // Set up subscription management socket (well-known port for receiving subscription requests)
         subscriptionSocket_ =
-            std::make_unique<udp::socket>(io_context_, udp::endpoint(udp::v4(), config_.getUiPorts().udp_publish_port));
+            std::make_unique<udp::socket>(io_context_, udp::endpoint(udp::v4(), cfg->getUiPorts().udp_publish_port));
 
         Logger::statusWithDetails("UDP",
                                   StatusMessage("UI Publisher bound"),
-                                  DetailMessage("Port: " + std::to_string(config_.getUiPorts().udp_publish_port)));
+                                  DetailMessage("Port: " + std::to_string(cfg->getUiPorts().udp_publish_port)));
 
         // Start receiving subscription requests on the subscription socket
         startSubscriptionReceive();
@@ -178,7 +279,7 @@ void UdpManager::start() {
     }
 
     // Start the I/O service thread if we have any UDP servers or publishing socket
-    if (!servers_.empty() || publishSocket_) {
+    if (!uavServers_.empty() || sharedServer_ || publishSocket_) {
         serviceThread_ = std::thread([this]() {
             while (running_) {
                 try {
@@ -228,21 +329,35 @@ void UdpManager::join() {
     }
 }
 
+/**
+ * @brief Set the function registering derived-stream subscriptions
+ * @param handler Stream registration handler
+ */
+void UdpManager::setStreamHandler(UdpStreamCallback handler) {
+    streamHandler_ = std::move(handler);
+}
+
 /**
  * @brief Publish telemetry data to subscribed UI components via UDP
  * @param topic The topic being published (e.g., "telemetry.UAV_1.camera.location" or "telemetry.UAV_2.mapping.status")
  * @param data The binary telemetry data to send
+ * @param stream Derived-stream subscription the message belongs to ("" for telemetry packets)
  *
- * Sends telemetry data only to UI clients that have subscribed to this topic.
+ * Sends telemetry data only to UI clients that have subscribed to this topic
+ * and, for subscriptions with a "?<expression>" filter, whose filter matches.
+ * Derived-stream messages reach only the clients subscribed with exactly their
+ * subscription string.
  * This provides the same subscription functionality as TCP but over UDP.
  * Thread-safe through mutex protection.
  */
-void UdpManager::publishTelemetry(const std::string& topic, const std::vector<uint8_t>& data) {
+void UdpManager::publishTelemetry(const std::string& topic,
+                                  const std::vector<uint8_t>& data,
+                                  const std::string& stream) {
     try {
         std::lock_guard<std::mutex> lock(socketMutex_);
         if (publishSocket_ && running_) {
             // Get subscribers for this topic
-            std::vector<udp::endpoint> subscribers = getSubscribers(topic);
+            std::vector<udp::endpoint> subscribers = getSubscribers(topic, data, stream);
 
             if (subscribers.empty()) {
                 return;  // No subscribers, don't send anything
@@ -302,6 +417,74 @@ void UdpManager::publishTelemetry(const std::string& topic, const std::vector<ui
     }
 }
 
+/**
+ * @brief Start receiving UDP telemetry from a UAV registered at runtime
+ * @param uav UAV configuration
+ *
+ * Binding happens here so the caller sees port conflicts immediately. The new
+ * server starts receiving right away; its ownership and the id table entry are
+ * handed to the I/O thread, which is the only thread reading those tables once
+ * the manager is running. Traffic for other UAVs is never paused.
+ */
+void UdpManager::addUav(const UAVConfig& uav) {
+    std::unique_ptr<UdpServer> server;
+    if (uav.udp_telemetry_port > 0) {
+        server = std::make_unique<UdpServer>(io_context_, uav.ip, uav.udp_telemetry_port, uav.name, messageCallback_);
+    }
+
+    boost::asio::post(io_context_, [this, uav, server = std::move(server)]() mutable {
+        if (server) {
+            uavServers_[uav.name] = std::move(server);
+        }
+        if (uav.id >= uavNamesById_.size()) {
+            uavNamesById_.resize(static_cast<size_t>(uav.id) + 1);
+        }
+        uavNamesById_[uav.id] = uav.name;
+    });
+}
+
+/**
+ * @brief Stop receiving UDP telemetry from a UAV
+ * @param name UAV name
+ *
+ * Runs on the I/O thread. Closing queues the aborted receive handler, so the
+ * server is destroyed by a follow-up handler that runs after it.
+ */
+void UdpManager::removeUav(const std::string& name) {
+    boost::asio::post(io_context_, [this, name]() {
+        auto server_it = uavServers_.find(name);
+        if (server_it != uavServers_.end()) {
+            server_it->second->close();
+            boost::asio::post(io_context_, [closed = std::move(server_it->second)]() {});
+            uavServers_.erase(server_it);
+        }
+        for (auto& uav_name : uavNamesById_) {
+            if (uav_name == name) {
+                uav_name.clear();
+            }
+        }
+        Logger::statusWithDetails("UDP", StatusMessage("UAV " + name + " removed"), DetailMessage("server closed"));
+    });
+}
+
+/**
+ * @brief Apply new shared-ingest ids of UAVs whose sockets stay as they are
+ * @param uavs New settings (same names and ports)
+ */
+void UdpManager::updateUavs(const std::vector<UAVConfig>& uavs) {
+    boost::asio::post(io_context_, [this, uavs]() {
+        for (const auto& uav : uavs) {
+            std::replace(uavNamesById_.begin(), uavNamesById_.end(), uav.name, std::string());
+        }
+        for (const auto& uav : uavs) {
+            if (uav.id >= uavNamesById_.size()) {
+                uavNamesById_.resize(static_cast<size_t>(uav.id) + 1);
+            }
+            uavNamesById_[uav.id] = uav.name;
+        }
+    });
+}
+
 // === Simple Subscription Management Implementation ===
 
 void UdpManager::startSubscriptionReceive() {
@@ -372,17 +555,76 @@ void UdpManager::handleSubscriptionRequest(const std::vector<uint8_t>& data, con
             client_endpoint = sender;
         }
 
-        std::lock_guard<std::mutex> lock(subscriptionMutex_);
-
         if (command == "SUBSCRIBE") {
-            clients_[client_id] = client_endpoint;
-            subscriptions_[topic].insert(client_id);
-            Logger::info("UDP Client " + client_id + " subscribed to: " + topic + " (endpoint: "
-                         + client_endpoint.address().to_string() + ":" + std::to_string(client_endpoint.port()) + ")");
+            // "<pattern>?<expression>" filters by payload; compile it once, outside the lock
+            SubscriptionFilter filter;
+            try {
+                filter = SubscriptionFilter::parse(topic);
+            } catch (const std::exception& e) {
+                Logger::warn("UDP Client " + client_id + " subscription rejected: " + topic + " (" + e.what() + ")");
+                return;
+            }
+
+            // A derived stream is computed by the service from its first client until its last one leaves.
+            // Only this (I/O) thread changes the subscription table, so the lookup stays valid unlocked.
+            if (!filter.derivedSuffix.empty()) {
+                bool first_client;
+                {
+                    std::lock_guard<std::mutex> lock(subscriptionMutex_);
+                    first_client = subscriptions_.find(topic) == subscriptions_.end();
+                }
+                try {
+                    if (!streamHandler_) {
+                        throw std::runtime_error("derived streams are not available");
+                    }
+                    if (first_client) {
+                        streamHandler_(topic, true);
+                    }
+                } catch (const std::exception& e) {
+                    Logger::warn("UDP Client " + client_id + " subscription rejected: " + topic + " (" + e.what()
+                                 + ")");
+                    return;
+                }
+            }
+
+            bool added;
+            {
+                std::lock_guard<std::mutex> lock(subscriptionMutex_);
+                clients_[client_id] = client_endpoint;
+                auto& subscription = subscriptions_[topic];
+                if (subscription.clients.empty()) {
+                    subscription.filter = std::move(filter);
+                }
+                added = subscription.clients.insert(client_id).second;
+            }
+            // Clients renew their subscriptions periodically; only log new ones
+            if (added) {
+                Logger::info("UDP Client " + client_id + " subscribed to: " + topic + " (endpoint: "
+                             + client_endpoint.address().to_string() + ":" + std::to_string(client_endpoint.port())
+                             + ")");
+            }
+
+            // Confirm to the sender, which tells the client the service is reachable (and still has its
+            // subscription after a restart)
+            auto reply = std::make_shared<std::string>("SUBSCRIBED|" + topic);
+            subscriptionSocket_->async_send_to(boost::asio::buffer(*reply),
+                                               sender,
+                                               [reply](const boost::system::error_code&, std::size_t) {});
         } else if (command == "UNSUBSCRIBE") {
-            subscriptions_[topic].erase(client_id);
-            if (subscriptions_[topic].empty()) {
-                subscriptions_.erase(topic);
+            bool last_client = false;
+            {
+                std::lock_guard<std::mutex> lock(subscriptionMutex_);
+                auto subscription_it = subscriptions_.find(topic);
+                if (subscription_it != subscriptions_.end()) {
+                    subscription_it->second.clients.erase(client_id);
+                    if (subscription_it->second.clients.empty()) {
+                        last_client = !subscription_it->second.filter.derivedSuffix.empty();
+                        subscriptions_.erase(subscription_it);
+                    }
+                }
+            }
+            if (last_client && streamHandler_) {
+                streamHandler_(topic, false);
             }
             Logger::info("UDP Client " + client_id + " unsubscribed from: " + topic);
         }
@@ -391,18 +633,33 @@ void UdpManager::handleSubscriptionRequest(const std::vector<uint8_t>& data, con
     }
 }
 
-std::vector<udp::endpoint> UdpManager::getSubscribers(const std::string& topic) const {
+std::vector<udp::endpoint> UdpManager::getSubscribers(const std::string& topic,
+                                                      const std::vector<uint8_t>& data,
+                                                      const std::string& stream) const {
     std::lock_guard<std::mutex> lock(subscriptionMutex_);
     std::vector<udp::endpoint> result;
     std::unordered_set<std::string> matched_clients;
 
-    // Check all subscription patterns for wildcard matches
+    // A derived-stream message belongs to one subscription string
+    if (!stream.empty()) {
+        auto subscription_it = subscriptions_.find(stream);
+        if (subscription_it != subscriptions_.end()) {
+            for (const auto& client_id : subscription_it->second.clients) {
+                auto client_it = clients_.find(client_id);
+                if (client_it != clients_.end()) {
+                    result.push_back(client_it->second);
+                }
+            }
+        }
+        return result;
+    }
+
+    // Check all subscriptions for wildcard matches (and payload predicates, if any)
     for (const auto& subscription : subscriptions_) {
-        const std::string& pattern = subscription.first;
-        const std::unordered_set<std::string>& client_ids = subscription.second;
+        const std::unordered_set<std::string>& client_ids = subscription.second.clients;
 
-        // Check if topic matches this pattern (exact match or wildcard)
-        if (matchesWildcardPattern(pattern, topic)) {
+        // Check if topic matches this pattern (exact match or wildcard) and the packet passes the filter
+        if (subscription.second.filter.matches(topic, data)) {
             for (const auto& client_id : client_ids) {
                 // Avoid duplicate clients
                 if (matched_clients.find(client_id) == matched_clients.end()) {
@@ -422,48 +679,3 @@ std::vector<udp::endpoint> UdpManager::getSubscribers(const std::string& topic)
 std::string UdpManager::endpointToString(const udp::endpoint& endpoint) const {
     return endpoint.address().to_string() + ":" + std::to_string(endpoint.port());
 }
-
-bool UdpManager::matchesWildcardPattern(const std::string& pattern, const std::string& topic) const {
-    // Exact match
-    if (pattern == topic) {
-        return true;
-    }
-
-    // Handle "telemetry.*" as prefix match for --all-targets
-    if (pattern == "telemetry.*") {
-        return topic.rfind("telemetry.", 0) == 0;
-    }
-
-    // If no wildcard, must be exact match (already checked)
-    if (pattern.find('*') == std::string::npos) {
-        return false;
-    }
-
-    // Split by dots for segment matching
-    std::vector<std::string> pattern_parts;
-    std::stringstream pss(pattern);
-    std::string part;
-    while (std::getline(pss, part, '.')) {
-        pattern_parts.push_back(part);
-    }
-
-    std::vector<std::string> topic_parts;
-    std::stringstream tss(topic);
-    while (std::getline(tss, part, '.')) {
-        topic_parts.push_back(part);
-    }
-
-    // Must have same number of segments for exact wildcard matching
-    if (pattern_parts.size() != topic_parts.size()) {
-        return false;
-    }
-
-    // Compare each segment
-    for (size_t i = 0; i < pattern_parts.size(); ++i) {
-        if (pattern_parts[i] != "*" && pattern_parts[i] != topic_parts[i]) {
-            return false;
-        }
-    }
-
-    return true;
-}
@@ -23,6 +23,8 @@
 #include <vector>
 
 #include "Config.h"
+#include "Snapshot.h"
+#include "SubscriptionFilter.h"
 
 using boost::asio::ip::udp;
 
@@ -30,12 +32,20 @@ using boost::asio::ip::udp;
 // Parameters: source description, binary message data
 using UdpMessageCallback = std::function<void(const std::string&, const std::vector<uint8_t>&)>;
 
+// Callback function type registering derived streams ("<pattern>@<spec>" subscriptions)
+// Parameters: subscription, true to add / false to remove; throws std::runtime_error on invalid streams
+using UdpStreamCallback = std::function<void(const std::string&, bool)>;
+
+// Resolves a shared-ingest UAV id to its name; returns nullptr for unknown ids
+using UavIdResolver = std::function<const std::string*(uint16_t)>;
+
 /**
  * @class UdpServer
- * @brief Manages a single UDP listening socket for one UAV
+ * @brief Manages a single UDP listening socket for one UAV or for the shared ingest port
  *
- * Each UdpServer instance handles UDP communication with one specific UAV.
- * It listens on a dedicated port and uses asynchronous I/O to receive
+ * A dedicated UdpServer handles UDP communication with one specific UAV on its own port.
+ * A shared UdpServer accepts datagrams from every UAV and identifies the sender from the
+ * IngestHeader at the start of each datagram. Both use asynchronous I/O to receive
  * telemetry data without blocking.
  */
 class UdpServer {
@@ -57,7 +67,43 @@ class UdpServer {
               const std::string& uav_name,
               UdpMessageCallback callback);
 
+    /**
+     * @brief Constructor - sets up the shared UDP ingest server
+     * @param io_context Boost.Asio I/O context for async operations
+     * @param address IP address to bind to
+     * @param port UDP port number to listen on
+     * @param resolver Maps the IngestHeader UAV id to a UAV name
+     * @param callback Function to call when messages are received
+     */
+    UdpServer(boost::asio::io_context& io_context,
+              const std::string& address,
+              short port,
+              UavIdResolver resolver,
+              UdpMessageCallback callback);
+
+    /**
+     * @brief Close the socket and end the receive loop
+     *
+     * The pending receive completes with operation_aborted, so the server must
+     * stay alive until the I/O context has run that handler.
+     */
+    void close();
+
    private:
+    /**
+     * @brief Bind the socket and start receiving
+     * @param io_context Boost.Asio I/O context used for address resolution
+     * @param address IP address to bind to ("*" for all interfaces)
+     * @param port UDP port number to listen on
+     */
+    void bindAndReceive(boost::asio::io_context& io_context, const std::string& address, short port);
+
+    /**
+     * @brief Strip the IngestHeader from a shared-port datagram and dispatch it
+     * @param bytes_recvd Number of bytes received into data_
+     */
+    void dispatchShared(std::size_t bytes_recvd);
+
     /**
      * @brief Start asynchronous receive operation
      *
@@ -70,7 +116,8 @@ class UdpServer {
     udp::endpoint remote_endpoint_;              ///< Endpoint of the last sender
     enum : std::uint16_t { max_length = 1024 };  ///< Maximum UDP packet size
     std::array<char, max_length> data_{};        ///< Buffer for incoming data
-    std::string uav_name_;                       ///< Name of the UAV this server handles
+    std::string uav_name_;                       ///< Name of the UAV this server handles (dedicated mode)
+    UavIdResolver resolver_;                     ///< UAV id lookup (shared mode only)
     UdpMessageCallback messageCallback_;         ///< Callback for received messages
 };
 
@@ -79,20 +126,21 @@ class UdpServer {
  * @brief Manages multiple UDP servers for all configured UAVs
  *
  * The UdpManager creates and manages one UdpServer for each UAV that
- * has UDP telemetry enabled. It runs a single I/O context in a background
+ * has a dedicated UDP telemetry port, plus one shared UdpServer when shared
+ * ingest is configured. It runs a single I/O context in a background
  * thread to handle all UDP communication asynchronously.
  */
 class UdpManager {
    public:
     /**
      * @brief Constructor
-     * @param config Configuration containing UAV settings
+     * @param config Configuration snapshot containing UAV settings
      * @param callback Function to call when UDP messages are received
      *
      * Initializes the UDP manager with configuration data and sets up
      * the callback for handling incoming messages.
      */
-    UdpManager(const Config& config, UdpMessageCallback callback);
+    UdpManager(const Snapshot<Config>& config, UdpMessageCallback callback);
 
     /**
      * @brief Destructor - ensures clean shutdown
@@ -133,20 +181,70 @@ class UdpManager {
      * @brief Publish telemetry data to UI components via UDP
      * @param topic The topic to publish on (e.g., "telemetry.UAV_1.camera.location" or "telemetry.UAV_2.mapping.status")
      * @param data The binary telemetry data to send
+     * @param stream Derived-stream subscription the message belongs to ("" for telemetry packets)
      *
      * Sends telemetry data to UI endpoints using UDP multicast.
      * This method is thread-safe and can be called from callback functions.
      */
-    void publishTelemetry(const std::string& topic, const std::vector<uint8_t>& data);
+    void publishTelemetry(const std::string& topic, const std::vector<uint8_t>& data, const std::string& stream = "");
+
+    /**
+     * @brief Set the function registering derived-stream subscriptions
+     * @param handler Called once when a "<pattern>@<spec>" subscription gets its first client
+     *                and once when it loses its last (such subscriptions are rejected without one)
+     *
+     * Must be called before start(). The handler runs on the I/O thread.
+     */
+    void setStreamHandler(UdpStreamCallback handler);
+
+    /**
+     * @brief Start receiving UDP telemetry from a UAV registered at runtime
+     * @param uav UAV configuration
+     * @throws boost::system::system_error if the dedicated port cannot be bound
+     *
+     * The dedicated socket is bound on the calling thread so errors reach the caller;
+     * the server tables are only touched on the I/O thread.
+     */
+    void addUav(const UAVConfig& uav);
+
+    /**
+     * @brief Stop receiving UDP telemetry from a UAV
+     * @param name UAV name
+     *
+     * Closes the dedicated server and forgets the shared-ingest id on the I/O thread.
+     */
+    void removeUav(const std::string& name);
+
+    /**
+     * @brief Apply new shared-ingest ids of UAVs whose sockets stay as they are
+     * @param uavs New settings (same names and ports)
+     *
+     * All old ids are forgotten before the new ones are set, in one handler on
+     * the I/O thread, so UAVs may swap ids.
+     */
+    void updateUavs(const std::vector<UAVConfig>& uavs);
 
    private:
+    /**
+     * @struct UdpSubscription
+     * @brief Compiled filter of one subscription string and the clients holding it
+     */
+    struct UdpSubscription {
+        SubscriptionFilter filter;                ///< Topic pattern and optional payload predicate
+        std::unordered_set<std::string> clients;  ///< Subscribed client_ids
+    };
+
     boost::asio::io_context io_context_;  ///< Boost.Asio I/O context for async operations
-    const Config& config_;                ///< Reference to configuration data
+    const Snapshot<Config>& config_;      ///< Published configuration (read at start())
     UdpMessageCallback messageCallback_;  ///< Callback for incoming messages
+    UdpStreamCallback streamHandler_;     ///< Derived-stream registration (may be empty)
     std::atomic<bool> running_{false};    ///< Flag controlling thread execution
     mutable std::mutex socketMutex_;      ///< Mutex for thread-safe socket operations
 
-    std::vector<std::unique_ptr<UdpServer>> servers_;  ///< UDP servers for each UAV
+    // Server tables: built in start(), afterwards modified only on the I/O thread (see addUav/removeUav)
+    std::unordered_map<std::string, std::unique_ptr<UdpServer>> uavServers_;  ///< Dedicated server per UAV name
+    std::unique_ptr<UdpServer> sharedServer_;                                 ///< Shared ingest server (or null)
+    std::vector<std::string> uavNamesById_;  ///< UAV id -> name table for shared ingest (O(1) lookup)
     std::thread serviceThread_;                        ///< Background thread running I/O context
 
     // Publishing socket
@@ -154,20 +252,18 @@ class UdpManager {
     udp::endpoint publishEndpoint_;               ///< Multicast endpoint for UI communication
 
     // Simple subscription management
-    std::unique_ptr<udp::socket> subscriptionSocket_;  ///< Socket for receiving subscription requests
-    mutable std::mutex subscriptionMutex_;             ///< Mutex for subscription data
-    std::unordered_map<std::string, std::unordered_set<std::string>>
-        subscriptions_;                                       ///< topic -> set of client_ids
-    std::unordered_map<std::string, udp::endpoint> clients_;  ///< client_id -> endpoint
+    std::unique_ptr<udp::socket> subscriptionSocket_;                 ///< Socket for receiving subscription requests
+    mutable std::mutex subscriptionMutex_;                            ///< Mutex for subscription data
+    std::unordered_map<std::string, UdpSubscription> subscriptions_;  ///< subscription string -> filter, client_ids
+    std::unordered_map<std::string, udp::endpoint> clients_;          ///< client_id -> endpoint
 
     // Helper methods for subscription
     void startSubscriptionReceive();
     void handleSubscriptionRequest(const std::vector<uint8_t>& data, const udp::endpoint& sender);
-    std::vector<udp::endpoint> getSubscribers(const std::string& topic) const;
+    std::vector<udp::endpoint> getSubscribers(const std::string& topic,
+                                              const std::vector<uint8_t>& data,
+                                              const std::string& stream) const;
     std::string endpointToString(const udp::endpoint& endpoint) const;
-
-    // Wildcard pattern matching for efficient subscriptions
-    bool matchesWildcardPattern(const std::string& pattern, const std::string& topic) const;
 };
 
 #endif  // UDPMANAGER_H
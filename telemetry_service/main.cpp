@@ -21,6 +21,8 @@
 // This is set to false when a shutdown signal is received
 std::atomic<bool> g_running(true);
 std::atomic<int> g_signal_received(0);
+// Set by SIGHUP; the service reloads its configuration and clears it
+std::atomic<bool> g_reload_requested(false);
 std::mutex g_signal_mutex;
 
 /**
@@ -41,6 +43,22 @@ void signalHandler(int signum) {
     (void)result;  // Suppress unused variable warning
 }
 
+/**
+ * @brief Signal handler for configuration reload (SIGHUP)
+ * @param signum The signal number received (unused)
+ *
+ * Only raises a flag; the service thread performs the actual reload outside
+ * of signal context.
+ */
+void reloadHandler(int signum) {
+    (void)signum;
+    g_reload_requested.store(true);
+
+    const char* msg = "SIGHUP received. Reloading configuration...\n";
+    ssize_t result = write(STDERR_FILENO, msg, strlen(msg));
+    (void)result;  // Suppress unused variable warning
+}
+
 /**
  * @brief Main entry point of the telemetry service application
  * @return Exit code (0 for success, 1 for error)
@@ -60,8 +78,8 @@ int main() {
         // Register signal handlers for graceful shutdown
         // SIGINT: Ctrl+C interrupt signal
         // SIGTERM: Termination request signal (used by systemd)
-        // SIGHUP: Hangup signal (terminal closed)
         // SIGUSR1: User-defined signal for custom shutdown
+        // SIGHUP is the conventional daemon reload signal: it reloads service_config.json
         if (std::signal(SIGINT, signalHandler) == SIG_ERR) {
             Logger::error("Failed to register SIGINT handler");
             return 1;
@@ -70,7 +88,7 @@ int main() {
             Logger::error("Failed to register SIGTERM handler");
             return 1;
         }
-        if (std::signal(SIGHUP, signalHandler) == SIG_ERR) {
+        if (std::signal(SIGHUP, reloadHandler) == SIG_ERR) {
             Logger::error("Failed to register SIGHUP handler");
             return 1;
         }
@@ -83,7 +101,7 @@ int main() {
 
         // Create and start the telemetry service
         TelemetryService service;
-        service.run(g_running);
+        service.run(g_running, g_reload_requested);
 
         // Log which signal caused shutdown
         int signal_num = g_signal_received.load();
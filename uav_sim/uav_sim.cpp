@@ -7,10 +7,12 @@
  * and can also receive commands from UI components via TCP.
  */
 
+#include <array>
 #include <atomic>
 #include <boost/asio.hpp>
 #include <chrono>
 #include <csignal>
+#include <cerrno>
 #include <cstdlib>
 #include <cstring>
 #include <ctime>
@@ -18,6 +20,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include <sstream>
 #include <string>
@@ -30,10 +33,13 @@
 #pragma pack(push, 1)
 
 // Target IDs - must match what service expects
-enum TargetIDs : uint8_t { CAMERA = 1, MAPPING = 2 };
+enum TargetIDs : uint8_t { SERVICE = 0, CAMERA = 1, MAPPING = 2 };
 
 // Packet Types - must match what service expects
-enum PacketTypes : uint8_t { LOCATION = 4, STATUS = 5, IMU_PACKET = 6, BATTERY_PACKET = 7 };
+enum PacketTypes : uint8_t { LOCATION = 4, STATUS = 5, IMU_PACKET = 6, BATTERY_PACKET = 7, COMMAND_ACK = 8 };
+
+// Command acknowledgement status codes - must match what service expects
+enum CommandStatus : uint8_t { ACKNOWLEDGED = 0, REJECTED = 1 };
 
 // Packet header structure (must match service)
 struct UAVPacketHeader {
@@ -69,6 +75,19 @@ struct UAVStatusPacket {
     UAVStatusPayload payload;
 };
 
+// Answer to a tracked command ("CMD|<id>|<command>"), consumed by the service
+struct UAVCommandAckPacket {
+    UAVPacketHeader header;
+    uint32_t commandId;  ///< Id from the tracked command
+    uint8_t status;      ///< CommandStatus
+};
+
+// Envelope prepended to datagrams sent to the service's shared UDP ingest port (must match service)
+struct UAVIngestHeader {
+    uint8_t magic;   ///< Always ingest_magic
+    uint16_t uavId;  ///< UAV id from service_config.json
+};
+
 #pragma pack(pop)
 
 // Helper functions to create packets
@@ -121,7 +140,9 @@ namespace {
     constexpr int default_telemetry_iterations = 50;
     constexpr int base_sleep_interval_ms = 500;
     constexpr int data_send_interval_ms = 100;
-    constexpr int command_poll_interval_ms = 10;
+    constexpr uint8_t ingest_magic = 0xA7;
+    // In-process endpoint the main thread uses to wake the command receiver for shutdown
+    constexpr const char* shutdown_endpoint = "inproc://uav-sim-shutdown";
 }  // namespace
 
 /**
@@ -130,13 +151,18 @@ namespace {
  *
  * Contains all the network configuration needed for the UAV simulator to
  * connect to the telemetry service using either TCP or UDP protocols.
+ * Channels without a dedicated port use the service's shared ingest endpoints.
  */
 struct UAVConfig {
-    std::string name;           ///< UAV identifier (e.g., "UAV_1")
-    std::string ip;             ///< IP address of the telemetry service
-    int tcp_telemetry_port{0};  ///< TCP port for sending telemetry data
-    int tcp_command_port{0};    ///< TCP port for receiving commands
-    int udp_telemetry_port{0};  ///< UDP port for sending telemetry data (service-side port)
+    std::string name;                  ///< UAV identifier (e.g., "UAV_1")
+    std::string ip;                    ///< IP address of the telemetry service
+    uint16_t id{0};                    ///< Numeric UAV id used in shared-ingest UDP packets
+    int tcp_telemetry_port{0};         ///< TCP port for sending telemetry data (0 = shared)
+    int tcp_command_port{0};           ///< TCP port for receiving commands (0 = shared)
+    int udp_telemetry_port{0};         ///< UDP port for sending telemetry data (0 = shared)
+    int shared_tcp_telemetry_port{0};  ///< Service's shared telemetry ROUTER port
+    int shared_tcp_command_port{0};    ///< Service's shared command ROUTER port
+    int shared_udp_telemetry_port{0};  ///< Service's shared UDP ingest port
 };
 
 /**
@@ -219,7 +245,9 @@ UAVConfig loadUavConfig(const std::string& config_file, const std::string& uav_n
         throw std::runtime_error("Config file missing 'uavs' array");
     }
 
+    int position = 0;
     for (const auto& uav_json : json_data["uavs"]) {
+        ++position;
         if (!uav_json.contains("name") || !uav_json["name"].is_string()) {
             continue;  // Skip invalid entries
         }
@@ -228,11 +256,12 @@ UAVConfig loadUavConfig(const std::string& config_file, const std::string& uav_n
             try {
                 config.name = uav_json["name"];
                 config.ip = uav_json.value("ip", "localhost");
+                config.id = static_cast<uint16_t>(uav_json.value("id", position));
 
-                // Extract TCP port configuration with validation
-                config.tcp_telemetry_port = uav_json.at("tcp_telemetry_port");
-                config.tcp_command_port = uav_json.at("tcp_command_port");
-                config.udp_telemetry_port = uav_json.at("udp_telemetry_port");
+                // Dedicated ports are optional when the service exposes shared ingest endpoints
+                config.tcp_telemetry_port = uav_json.value("tcp_telemetry_port", 0);
+                config.tcp_command_port = uav_json.value("tcp_command_port", 0);
+                config.udp_telemetry_port = uav_json.value("udp_telemetry_port", 0);
 
                 uav_found = true;
                 break;
@@ -246,9 +275,126 @@ UAVConfig loadUavConfig(const std::string& config_file, const std::string& uav_n
         throw std::runtime_error("UAV '" + uav_name + "' not found in config file!");
     }
 
+    if (json_data.contains("shared_ingest")) {
+        const auto& shared_json = json_data["shared_ingest"];
+        config.shared_tcp_telemetry_port = shared_json.value("tcp_telemetry_port", 0);
+        config.shared_tcp_command_port = shared_json.value("tcp_command_port", 0);
+        config.shared_udp_telemetry_port = shared_json.value("udp_telemetry_port", 0);
+    }
+
+    // Every channel needs either a dedicated or a shared endpoint
+    if ((config.tcp_telemetry_port == 0 && config.shared_tcp_telemetry_port == 0)
+        || (config.tcp_command_port == 0 && config.shared_tcp_command_port == 0)
+        || (config.udp_telemetry_port == 0 && config.shared_udp_telemetry_port == 0)) {
+        throw std::runtime_error("UAV '" + uav_name + "' has neither dedicated ports nor shared ingest configured");
+    }
+
     return config;
 }
 
+/**
+ * @brief Describe a port for display, marking shared ingest endpoints
+ * @param dedicated_port The UAV's own port (0 if not configured)
+ * @param shared_port The service's shared ingest port for the same channel
+ * @return Human-readable port description
+ */
+std::string describePort(int dedicated_port, int shared_port) {
+    if (dedicated_port > 0) {
+        return std::to_string(dedicated_port);
+    }
+    return std::to_string(shared_port) + " (shared)";
+}
+
+/**
+ * @brief Create the TCP telemetry socket for this UAV
+ * @param context ZeroMQ context to create the socket in
+ * @param config UAV configuration
+ * @return Connected socket ready for sending telemetry
+ *
+ * Dedicated ports use a PUSH socket. The shared ingest endpoint is a ROUTER, so the
+ * simulator connects a DEALER whose routing ID is the UAV name; the service uses
+ * that ID to identify the sender.
+ */
+zmq::socket_t connectTelemetrySocket(zmq::context_t& context, const UAVConfig& config) {
+    const bool shared = config.tcp_telemetry_port == 0;
+    zmq::socket_t socket(context, shared ? zmq::socket_type::dealer : zmq::socket_type::push);
+
+    // Set socket options for better responsiveness
+    int linger = 0;  // Don't wait on close
+    socket.set(zmq::sockopt::linger, linger);
+    if (shared) {
+        socket.set(zmq::sockopt::routing_id, config.name);
+    }
+
+    int port = shared ? config.shared_tcp_telemetry_port : config.tcp_telemetry_port;
+    socket.connect("tcp://" + config.ip + ":" + std::to_string(port));
+    return socket;
+}
+
+/**
+ * @brief Resolve the service's UDP telemetry endpoint for this UAV
+ * @param io_context Boost.Asio I/O context for the resolver
+ * @param config UAV configuration
+ * @return Dedicated UDP endpoint, or the shared ingest endpoint
+ */
+udp::endpoint resolveUdpEndpoint(boost::asio::io_context& io_context, const UAVConfig& config) {
+    int port = config.udp_telemetry_port > 0 ? config.udp_telemetry_port : config.shared_udp_telemetry_port;
+    udp::resolver resolver(io_context);
+    udp::resolver::results_type endpoints = resolver.resolve(udp::v4(), config.ip, std::to_string(port));
+    return *endpoints.begin();
+}
+
+/**
+ * @brief Send one telemetry packet over UDP
+ * @param socket UDP socket to send from
+ * @param endpoint Service endpoint from resolveUdpEndpoint()
+ * @param config UAV configuration
+ * @param packet Pointer to the packed telemetry packet
+ * @param size Packet size in bytes
+ *
+ * On the shared ingest port the packet is prefixed with the ingest header
+ * (gather write, no extra copy).
+ */
+void sendUdpPacket(udp::socket& socket,
+                   const udp::endpoint& endpoint,
+                   const UAVConfig& config,
+                   const void* packet,
+                   size_t size) {
+    if (config.udp_telemetry_port > 0) {
+        socket.send_to(boost::asio::buffer(packet, size), endpoint);
+        return;
+    }
+    UAVIngestHeader ingest{ingest_magic, config.id};
+    std::array<boost::asio::const_buffer, 2> buffers{boost::asio::buffer(&ingest, sizeof(ingest)),
+                                                     boost::asio::buffer(packet, size)};
+    socket.send_to(buffers, endpoint);
+}
+
+/**
+ * @brief Split a tracked command ("CMD|<id>|<command>") into its id and command
+ * @param message Raw command received from the service
+ * @param command_id Set to the command id for tracked commands
+ * @param command Set to the command text (the whole message for untracked commands)
+ * @return true if the message is a tracked command that must be acknowledged
+ */
+bool parseTrackedCommand(const std::string& message, uint32_t& command_id, std::string& command) {
+    command = message;
+    if (message.rfind("CMD|", 0) != 0) {
+        return false;
+    }
+    size_t id_end = message.find('|', 4);
+    if (id_end == std::string::npos) {
+        return false;
+    }
+    try {
+        command_id = static_cast<uint32_t>(std::stoul(message.substr(4, id_end - 4)));
+    } catch (const std::exception&) {
+        return false;
+    }
+    command = message.substr(id_end + 1);
+    return true;
+}
+
 /**
  * @brief Print a list of available UAVs from the configuration file
  * @param config_file Path to the JSON configuration file
@@ -279,12 +425,22 @@ void printAvailableUaVs(const std::string& config_file) {
                 continue;
 
             try {
-                int tcp_telemetry_port = uav_json.at("tcp_telemetry_port");
-                int tcp_command_port = uav_json.at("tcp_command_port");
-                int udp_telemetry_port = uav_json.at("udp_telemetry_port");
-
-                std::cout << "  - " << uav_json["name"] << " (TCP Telemetry: " << tcp_telemetry_port
-                          << ", TCP Commands: " << tcp_command_port << ", UDP Telemetry: " << udp_telemetry_port << ")"
+                int shared_tcp_telemetry_port = 0;
+                int shared_tcp_command_port = 0;
+                int shared_udp_telemetry_port = 0;
+                if (json_data.contains("shared_ingest")) {
+                    shared_tcp_telemetry_port = json_data["shared_ingest"].value("tcp_telemetry_port", 0);
+                    shared_tcp_command_port = json_data["shared_ingest"].value("tcp_command_port", 0);
+                    shared_udp_telemetry_port = json_data["shared_ingest"].value("udp_telemetry_port", 0);
+                }
+                int tcp_telemetry_port = uav_json.value("tcp_telemetry_port", 0);
+                int tcp_command_port = uav_json.value("tcp_command_port", 0);
+                int udp_telemetry_port = uav_json.value("udp_telemetry_port", 0);
+
+                std::cout << "  - " << uav_json["name"]
+                          << " (TCP Telemetry: " << describePort(tcp_telemetry_port, shared_tcp_telemetry_port)
+                          << ", TCP Commands: " << describePort(tcp_command_port, shared_tcp_command_port)
+                          << ", UDP Telemetry: " << describePort(udp_telemetry_port, shared_udp_telemetry_port) << ")"
                           << '\n';
             } catch (const json::exception&) {
                 std::cout << "  - " << uav_json["name"] << " (invalid configuration)\n";
@@ -481,16 +637,21 @@ int main(int argc, char* argv[]) {
     std::cout << "Starting UAV Simulator: " << config.name << '\n';
     if (protocol == "udp") {
         std::cout << "Protocol: UDP" << '\n';
-        std::cout << "Service UDP Port: " << config.udp_telemetry_port << '\n';
+        std::cout << "Service UDP Port: " << describePort(config.udp_telemetry_port, config.shared_udp_telemetry_port)
+                  << '\n';
     } else if (protocol == "tcp") {
         std::cout << "Protocol: TCP" << '\n';
-        std::cout << "Telemetry Port: " << config.tcp_telemetry_port << '\n';
-        std::cout << "Command Port: " << config.tcp_command_port << '\n';
+        std::cout << "Telemetry Port: " << describePort(config.tcp_telemetry_port, config.shared_tcp_telemetry_port)
+                  << '\n';
+        std::cout << "Command Port: " << describePort(config.tcp_command_port, config.shared_tcp_command_port) << '\n';
     } else if (protocol == "both") {
         std::cout << "Protocol: Both TCP and UDP (Default)" << '\n';
-        std::cout << "TCP Telemetry Port: " << config.tcp_telemetry_port << '\n';
-        std::cout << "TCP Command Port: " << config.tcp_command_port << '\n';
-        std::cout << "UDP Service Port: " << config.udp_telemetry_port << '\n';
+        std::cout << "TCP Telemetry Port: "
+                  << describePort(config.tcp_telemetry_port, config.shared_tcp_telemetry_port) << '\n';
+        std::cout << "TCP Command Port: " << describePort(config.tcp_command_port, config.shared_tcp_command_port)
+                  << '\n';
+        std::cout << "UDP Service Port: " << describePort(config.udp_telemetry_port, config.shared_udp_telemetry_port)
+                  << '\n';
     }
     std::cout << "===========================================" << '\n';
 
@@ -537,10 +698,7 @@ int main(int argc, char* argv[]) {
                 udp::socket socket(io_context, udp::endpoint(udp::v4(), 0));
 
                 // Resolve the service hostname to get an IP address
-                udp::resolver resolver(io_context);
-                udp::resolver::results_type endpoints =
-                    resolver.resolve(udp::v4(), config.ip, std::to_string(config.udp_telemetry_port));
-                udp::endpoint remote_endpoint = *endpoints.begin();
+                udp::endpoint remote_endpoint = resolveUdpEndpoint(io_context, config);
 
                 // Send telemetry data for configured iterations
                 for (int i = 0; i < default_telemetry_iterations && g_running; ++i) {
@@ -554,7 +712,7 @@ int main(int argc, char* argv[]) {
                                              10.0f + (rand() % 50) / 10.0f        // 10-15 m/s speed
                         );
 
-                    socket.send_to(boost::asio::buffer(&locationPacket, sizeof(UAVLocationPacket)), remote_endpoint);
+                    sendUdpPacket(socket, remote_endpoint, config, &locationPacket, sizeof(UAVLocationPacket));
                     std::cout << "[" << getTimestamp() << "] [" << config.name
                               << "] Sent Location Data (UDP): Lat=" << std::fixed << std::setprecision(6)
                               << locationPacket.payload.latitude << ", Lon=" << locationPacket.payload.longitude
@@ -573,7 +731,7 @@ int main(int argc, char* argv[]) {
                                                                       30.0f + (rand() % 40)   // Memory usage 30-70%
                     );
 
-                    socket.send_to(boost::asio::buffer(&statusPacket, sizeof(UAVStatusPacket)), remote_endpoint);
+                    sendUdpPacket(socket, remote_endpoint, config, &statusPacket, sizeof(UAVStatusPacket));
                     std::cout << "[" << getTimestamp() << "] [" << config.name
                               << "] Sent Status Data (UDP): Health=" << (int)statusPacket.payload.systemHealth
                               << ", CPU=" << statusPacket.payload.cpuUsage << "%" << '\n';
@@ -582,14 +740,7 @@ int main(int argc, char* argv[]) {
             } else if (protocol == "tcp") {
                 // TCP only implementation with proper resource management
                 zmq::context_t context(1);
-                zmq::socket_t push_to_service(context, zmq::socket_type::push);
-
-                // Set socket options for better responsiveness
-                int linger = 0;  // Don't wait on close
-                push_to_service.set(zmq::sockopt::linger, linger);
-
-                std::string telemetry_addr = "tcp://" + config.ip + ":" + std::to_string(config.tcp_telemetry_port);
-                push_to_service.connect(telemetry_addr);
+                zmq::socket_t push_to_service = connectTelemetrySocket(context, config);
 
                 // Small delay to allow connection establishment
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -659,21 +810,11 @@ int main(int argc, char* argv[]) {
                 udp::socket udp_socket(io_context, udp::endpoint(udp::v4(), 0));
 
                 // Set up UDP endpoint
-                udp::resolver resolver(io_context);
-                udp::resolver::results_type endpoints =
-                    resolver.resolve(udp::v4(), config.ip, std::to_string(config.udp_telemetry_port));
-                udp::endpoint remote_endpoint = *endpoints.begin();
+                udp::endpoint remote_endpoint = resolveUdpEndpoint(io_context, config);
 
                 // Set up TCP connection
                 zmq::context_t context(1);
-                zmq::socket_t push_to_service(context, zmq::socket_type::push);
-
-                // Set socket options for better responsiveness
-                int linger = 0;
-                push_to_service.set(zmq::sockopt::linger, linger);
-
-                std::string telemetry_addr = "tcp://" + config.ip + ":" + std::to_string(config.tcp_telemetry_port);
-                push_to_service.connect(telemetry_addr);
+                zmq::socket_t push_to_service = connectTelemetrySocket(context, config);
 
                 // Small delay to allow connection establishment
                 std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -695,8 +836,7 @@ int main(int argc, char* argv[]) {
 
                     // UDP send (this should be fast)
                     try {
-                        udp_socket.send_to(boost::asio::buffer(&locationPacket, sizeof(UAVLocationPacket)),
-                                           remote_endpoint);
+                        sendUdpPacket(udp_socket, remote_endpoint, config, &locationPacket, sizeof(UAVLocationPacket));
                     } catch (const std::exception& e) {
                         std::cerr << "[" << getTimestamp() << "] [" << config.name << "] UDP send error: " << e.what()
                                   << '\n';
@@ -733,8 +873,7 @@ int main(int argc, char* argv[]) {
 
                     // UDP send
                     try {
-                        udp_socket.send_to(boost::asio::buffer(&statusPacket, sizeof(UAVStatusPacket)),
-                                           remote_endpoint);
+                        sendUdpPacket(udp_socket, remote_endpoint, config, &statusPacket, sizeof(UAVStatusPacket));
                     } catch (const std::exception& e) {
                         std::cerr << "[" << getTimestamp() << "] [" << config.name << "] UDP send error: " << e.what()
                                   << '\n';
@@ -767,27 +906,77 @@ int main(int argc, char* argv[]) {
         std::cout << "[" << getTimestamp() << "] [" << config.name << "] Telemetry sending completed." << '\n';
     });
 
+    // The command receiver blocks in zmq::poll; shutdown is signalled over an inproc PAIR
+    // (the signal handler itself cannot touch ZeroMQ, so the main thread sends the wakeup)
+    zmq::context_t command_context(1);
+    zmq::socket_t shutdown_signal(command_context, zmq::socket_type::pair);
+    shutdown_signal.set(zmq::sockopt::linger, 0);
+    shutdown_signal.bind(shutdown_endpoint);
+
     /**
      * @brief Command receiver thread (TCP only)
      *
      * This thread listens for commands from UI components via the telemetry service.
      * Commands are only supported when using TCP protocol (tcp or both modes).
      * UDP is unidirectional in this implementation.
+     *
+     * The thread sleeps in zmq::poll until a command or the shutdown signal
+     * arrives, so a command is handled as soon as it is received.
      */
     std::thread command_receiver;
     if (protocol == "tcp" || protocol == "both") {
         command_receiver = std::thread([&]() {
             try {
-                zmq::context_t context(1);
-                zmq::socket_t pull_commands(context, zmq::socket_type::pull);
-                std::string command_addr = "tcp://" + config.ip + ":" + std::to_string(config.tcp_command_port);
+                zmq::socket_t shutdown_listener(command_context, zmq::socket_type::pair);
+                shutdown_listener.set(zmq::sockopt::linger, 0);
+                shutdown_listener.connect(shutdown_endpoint);
+
+                // The shared command endpoint is a ROUTER: connect a DEALER identified by the UAV name
+                const bool shared = config.tcp_command_port == 0;
+                zmq::socket_t pull_commands(command_context,
+                                            shared ? zmq::socket_type::dealer : zmq::socket_type::pull);
+                if (shared) {
+                    pull_commands.set(zmq::sockopt::routing_id, config.name);
+                }
+                int command_port = shared ? config.shared_tcp_command_port : config.tcp_command_port;
+                std::string command_addr = "tcp://" + config.ip + ":" + std::to_string(command_port);
                 pull_commands.connect(command_addr);
 
+                // Acknowledgements go back on the shared command DEALER, or through an extra PUSH to
+                // the dedicated telemetry port (the telemetry socket belongs to the sender thread)
+                std::unique_ptr<zmq::socket_t> ack_socket;
+                if (!shared && config.tcp_telemetry_port > 0) {
+                    ack_socket = std::make_unique<zmq::socket_t>(command_context, zmq::socket_type::push);
+                    ack_socket->set(zmq::sockopt::linger, 0);
+                    ack_socket->connect("tcp://" + config.ip + ":" + std::to_string(config.tcp_telemetry_port));
+                } else if (!shared) {
+                    std::cout << "[" << getTimestamp() << "] [" << config.name
+                              << "] Note: commands cannot be acknowledged (dedicated command port, shared telemetry)\n";
+                }
+                zmq::socket_t* ack_target = shared ? &pull_commands : ack_socket.get();
+
+                std::array<zmq::pollitem_t, 2> poll_items{{{pull_commands, 0, ZMQ_POLLIN, 0},
+                                                           {shutdown_listener, 0, ZMQ_POLLIN, 0}}};
                 while (g_running) {
+                    try {
+                        zmq::poll(poll_items.data(), poll_items.size(), std::chrono::milliseconds(-1));
+                    } catch (const zmq::error_t& e) {
+                        if (e.num() == EINTR) {
+                            continue;  // Interrupted by a signal; g_running tells whether to stop
+                        }
+                        throw;
+                    }
+                    if ((poll_items[1].revents & ZMQ_POLLIN) != 0) {
+                        break;
+                    }
+
+                    // Handle every command that is already queued before polling again
                     zmq::message_t command;
-                    // Use non-blocking receive to allow periodic checks of g_running
-                    if (pull_commands.recv(command, zmq::recv_flags::dontwait)) {
-                        std::string cmd(static_cast<char*>(command.data()), command.size());
+                    while (g_running && pull_commands.recv(command, zmq::recv_flags::dontwait)) {
+                        std::string raw(static_cast<char*>(command.data()), command.size());
+                        uint32_t command_id = 0;
+                        std::string cmd;
+                        bool tracked = parseTrackedCommand(raw, command_id, cmd);
 
                         // Display received command with visual emphasis
                         std::cout << '\n';
@@ -797,14 +986,29 @@ int main(int argc, char* argv[]) {
                         std::cout << "============================================" << '\n';
                         std::cout << '\n';
 
-                        // Note: A complete implementation would process the command
-                        // and potentially send responses back to the service
+                        // The simulator accepts every non-empty command
+                        if (tracked && ack_target != nullptr) {
+                            UAVCommandAckPacket ack{};
+                            ack.header.targetID = TargetIDs::SERVICE;
+                            ack.header.packetType = PacketTypes::COMMAND_ACK;
+                            ack.commandId = command_id;
+                            ack.status = cmd.empty() ? CommandStatus::REJECTED : CommandStatus::ACKNOWLEDGED;
+                            try {
+                                ack_target->send(zmq::buffer(&ack, sizeof(ack)), zmq::send_flags::dontwait);
+                            } catch (const zmq::error_t& e) {
+                                std::cerr << "[" << getTimestamp() << "] [" << config.name
+                                          << "] Command ack send error: " << e.what() << '\n';
+                            }
+                        }
                     }
-                    std::this_thread::sleep_for(std::chrono::milliseconds(command_poll_interval_ms));
                 }
 
                 // Explicit cleanup
+                if (ack_socket) {
+                    ack_socket->close();
+                }
                 pull_commands.close();
+                shutdown_listener.close();
             } catch (const std::exception& e) {
                 std::cerr << "[" << getTimestamp() << "] [" << config.name << "] Command receiver error: " << e.what()
                           << '\n';
@@ -821,11 +1025,17 @@ int main(int argc, char* argv[]) {
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
-    // Ensure threads are properly joined
+    // Wake the command receiver out of zmq::poll, then ensure threads are properly joined
+    try {
+        shutdown_signal.send(zmq::str_buffer("stop"), zmq::send_flags::dontwait);
+    } catch (const zmq::error_t& e) {
+        std::cerr << "[" << getTimestamp() << "] [" << config.name << "] Shutdown signal error: " << e.what() << '\n';
+    }
     if (telemetry_sender.joinable())
         telemetry_sender.join();
     if (command_receiver.joinable())
         command_receiver.join();
+    shutdown_signal.close();
 
     // Log shutdown reason if caused by signal
     int signal_num = g_signal_received.load();